@@ -8,10 +8,18 @@
 #include <QMap>
 #include <QList>
 #include <QStringList>
+#include <QWebEngineHttpRequest>
+#include <QElapsedTimer>
+#include <map>
 #include "MYSQL.h"
-
-class MainWindow;
-namespace Ui { class MainWindow; }
+#include "CrawlScheduler.h"
+#include "HouseExtractor.h"
+#include "CrawlFrontier.h"
+#include "UrlDedupStore.h"
+#include "PageArchive.h"
+#include "ListingPipeline.h"
+#include "HostRateLimiter.h"
+#include "CrawlTask.h"
 
 #include "HouseInfo.h"
 
@@ -20,42 +28,86 @@ class AliCrawl : public QObject
     Q_OBJECT
 private:
     QWebEnginePage *webPage;
-    Ui::MainWindow* m_ui;
-    MainWindow* m_mainWindow;
 
-    QQueue<QString> urlQueue;
-    QQueue<QString> searchUrlQueue;
-    QSet<QString> crawledUrls;
-    QMap<QString, int> urlDepth;
+    CrawlFrontier urlFrontier;     // 普通页面队列（含深度），持久化在 frontier/ali_pages.*
+    CrawlFrontier searchFrontier;  // 房源页队列（标签为所属城市/区县），持久化在 frontier/ali_search.*
+    QString currentPageUrl;        // 正在加载的普通页面
     int currentPageCount = 0;
     int targetPageCount = 1;
 
     QString cookieStr;
-    QList<HouseInfo> houseDataList;
-    QSet<QString> houseIdSet;
     QString currentCity;
-    bool isHomeLoadedForSearch = false;
-    QString pendingSearchKeyword;
-    bool isProcessingSearchTask = false;
 
     Mysql *mysql;
     QString generateRandomPvid();
     QString generateLogId();
     QString getRandomUA();
-    int getRandomInterval();
+    int getRandomInterval(const QString& url);
     // 补充类声明（需添加到AliCrawl.h中）
     QMap<QString, QMap<QString, QString>>getRegionCodeMap();
     QString regionToCode(const QString& cityName, const QString& districtName);
 
+    // 并发调度相关
+    CrawlScheduler *m_scheduler = nullptr;
+    bool riskAborted = false;   // 本轮已触发风控：不再提交/重试房源页，直到重新开始或继续爬取
+
+    // 爬取流程（协程）：加载到哪一步、当前URL都是协程内的局部状态
+    CrawlTask searchFlow;   // 房源爬取（调度器模式下只负责派发）
+    CrawlTask pageFlow;     // 普通页面爬取（城市链接）
+    std::map<QString, CrawlTask> searchPages;   // 调度器模式：每个房源页一个流程，按页URL登记（含已结束待清理的）
+    CrawlTask runSearchFlow();
+    CrawlTask runPageFlow();
+    CrawlTask runSearchPage(QString requestUrl);
+    void reportRiskPage(const QString& url);
+
+    bool isRiskUrl(const QString& url) const;
+    QWebEngineHttpRequest buildPageRequest(const QUrl& url);
+    QWebEngineHttpRequest buildSearchRequest(const QUrl& url);
+    QString buildSearchUrl(const QString& locationCode);
+    void dispatchSearchJobs();
+    int runningSearchPages();
+    void finishSearchTask();
+
+    ExtractMode extractMode = ExtractMode::InPageJson;  // 房源页默认页面内提取，失败时回退整页HTML
+    PageArchive *m_archive = nullptr;    // 录制模式：抓到的房源页追加到归档（不归爬虫所有）
+    void archivePage(const QString& requestUrl, const QString& city, const CrawlResult& result);
+
+    // 分页：房源页的 depth 即页码-1；第N页抓到后立即排入第N+1页（调度器模式下与第N页的提取并行加载）
+    QSet<QString> exhaustedScopes;      // 已到末页或只剩往期已收录房源的目标，不再翻页
+    QString pageUrl(const QString& url, int page);
+    void enqueueNextPage(const QString& url);
+    void onPageStored(const QString& url, int houseCount, int newCount);
+
+    // 提取流水线（去重、增量重爬、入库与安居客共用）：指纹文件 frontier/ali_search.pagefp、.housefp、.simhash；
+    // 页面URL的指纹不含 pvid/logid，同一目标同一页码跨运行稳定
+    using Listings = ListingPipeline<HouseInfo>;
+    Listings listings{this};
+    static Listings::Extracted extractPage(const Listings::Page& page);  // 工作线程
+
 public:
-    explicit AliCrawl(MainWindow *mainWindow, QWebEnginePage *webPage, Ui::MainWindow* ui);
+    explicit AliCrawl(QWebEnginePage *webPage = nullptr, QObject *parent = nullptr);
     ~AliCrawl() override;
 
     //QString cityToPinyin(const QString& cityName);
     QString getFirstLetter(int index);
-    void extractHouseData(const QString& html);
+    void extractHouseData(const QString& html, const QString& city = QString());
+    bool extractHouseJson(const QString& json, const QString& city = QString());
     void showHouseCompareResult();
     void startHouseCrawl(const QString& city, int targetPages);
+    void setScheduler(CrawlScheduler *scheduler);
+    void setExtractMode(ExtractMode mode);
+    // 录制：之后抓到的房源页都写入archive（nullptr 关闭录制）
+    void setArchive(PageArchive *archive);
+    // 回放：把归档中本站点的页面按原样送入提取与入库流程（无网络、无渲染等待），返回回放页数，失败返回-1
+    int replayArchive(PageArchive& archive);
+
+    // 继续上次中断（崩溃/风控/重启）的房源爬取任务，只加载尚未完成的房源页
+    bool hasUnfinishedCrawl() const { return searchFrontier.hasUnfinished(); }
+    void resumeHouseCrawl();
+    static const QString SITE_KEY;
+    static const QString RATE_HOST;         // 限速键
+    static const QString LISTING_SELECTOR;  // 房源节点选择器（渲染就绪探测用）
+    static const int RENDER_TIMEOUT_MS;     // 房源页渲染探测超时上限
 
     static const int REQUEST_INTERVAL;
     static const int MAX_DEPTH;
@@ -63,19 +115,25 @@ public:
     static const int MAX_REQUEST_INTERVAL;
     static const QStringList USER_AGENT_POOL;
 
-    QQueue<QString> getSearchUrl(){ return searchUrlQueue; }
+    QQueue<QString> getSearchUrl(){
+        QQueue<QString> queue;
+        for (const QString& url : searchFrontier.queuedUrls()) queue.enqueue(url);
+        return queue;
+    }
     int getCurrentPage(){ return currentPageCount; }
 
 signals:
     void appendLogSignal(const QString& log);
     // 新增：触发爬取的信号（参数和startHouseCrawl一致）
     void startCrawlSignal(const QString& city, int targetPages);
+    // 一次房源爬取结束；completed=false 表示有房源页未完成（风控/失败/无有效目标）
+    void crawlFinished(int houseCount, bool completed);
+    // 往期已收录的房源内容有变化（已提交更新入库）
+    void listingUpdated(const QString& houseUrl);
 
 private slots:
     void onInitFinishedLog();
-    void onPageLoadFinished(bool ok);
     void processNextUrl();
-    void processSearchUrl();
     void simulateHumanBehavior();
     void loadCookiesFromFile(const QString& filePath = "");
     void saveCookiesToFile(const QString& filePath = "");
@@ -1,4 +1,8 @@
 #include "AliCrawl.h"
+#include "StringPool.h"
+#include "EntityResolver.h"
+#include "PatternRegistry.h"
+#include "GumboArena.h"
 #include <QUrl>
 #include <QTimer>
 #include <QWebEngineSettings>
@@ -11,12 +15,22 @@
 #include <QFile>
 #include <QTextStream>
 #include<QUrlQuery>
+#include <QElapsedTimer>
+#include <memory>
+#include "HouseExtractor.h"
+#include "PageReadyProbe.h"
+#include "CrawlRequestInterceptor.h"
+#include <limits>
 
 // 类内静态常量初始化（保持不变）
 const int AliCrawl::REQUEST_INTERVAL = 3500;
 const int AliCrawl::MAX_DEPTH = 1;
 const int AliCrawl::MIN_REQUEST_INTERVAL = 9000;
 const int AliCrawl::MAX_REQUEST_INTERVAL = 16000;
+const QString AliCrawl::SITE_KEY = "ali";
+const QString AliCrawl::RATE_HOST = "taobao.com";
+const QString AliCrawl::LISTING_SELECTOR = "span[numberoflines=\"2\"], div.house-item, div.item-wrap, div.property-item";
+const int AliCrawl::RENDER_TIMEOUT_MS = 30000;
 const QStringList AliCrawl::USER_AGENT_POOL = {
     "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/139.0.0.0 Safari/537.36",
     "Mozilla/5.0 (Macintosh; Intel Mac OS X 14_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/139.0.0.0 Safari/537.36",
@@ -189,24 +203,34 @@ QString AliCrawl::getRandomUA() {
     return USER_AGENT_POOL.at(index);
 }
 
-int AliCrawl::getRandomInterval() {
-    return QRandomGenerator::global()->bounded(MIN_REQUEST_INTERVAL, MAX_REQUEST_INTERVAL);
+// 下一个房源页前的等待：按目标主机当前的限速（HostRateLimiter）计算，叠加±15%随机抖动
+int AliCrawl::getRandomInterval(const QString& url) {
+    const qint64 delay = HostRateLimiter::shared().delayBeforeNext(HostRateLimiter::hostKey(QUrl(url)));
+    const double jitter = 0.85 + QRandomGenerator::global()->generateDouble() * 0.3;
+    return static_cast<int>(qMin<qint64>(static_cast<qint64>(delay * jitter), std::numeric_limits<int>::max()));
 }
 
 //构造函数
-AliCrawl::AliCrawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::MainWindow* ui)
-    : QObject(nullptr)
+AliCrawl::AliCrawl(QWebEnginePage *webPageParam, QObject *parent)
+    : QObject(parent)
     , webPage(nullptr)
-    , m_ui(ui)
-    , m_mainWindow(mainWindow)
-    , isProcessingSearchTask(false)
     , currentPageCount(0)
     , targetPageCount(1)
-    , isHomeLoadedForSearch(false)
 {
     mysql = new Mysql();
     mysql->connectDatabase();
 
+    // 实体簇编号随房源入库：第一个创建的爬虫从库里恢复最近的已识别房源，重爬到的房源沿用原编号
+    if (EntityResolver::shared().claimSeed()) {
+        EntityResolver::shared().restore(mysql->getClusteredHouses(EntityResolver::MAX_LISTINGS / 2));
+    }
+    // 去重库是新建的：用库里已收录的房源链接补齐，否则往期房源会被当成新房源重复入库
+    if (UrlDedupStore::shared().claimSeed()) {
+        for (const QString& url : mysql->normalizeHouseUrls()) {
+            UrlDedupStore::shared().insert(url);
+        }
+    }
+
     if (webPageParam != nullptr) {
         webPage = webPageParam;
         webPage->setParent(this);
@@ -220,28 +244,49 @@ AliCrawl::AliCrawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::Mai
     settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, false);
     settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
     settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
-    settings->setAttribute(QWebEngineSettings::AutoLoadImages, true);
+    // 不自动加载图片，其余子资源交给下面的资源拦截策略
+    settings->setAttribute(QWebEngineSettings::AutoLoadImages, false);
     settings->setAttribute(QWebEngineSettings::AllowRunningInsecureContent, true);
 
-    connect(webPage, &QWebEnginePage::loadFinished, this, &AliCrawl::onPageLoadFinished);
+    // 资源拦截：房源页只需要HTML和渲染列表的脚本，图片/字体/统计请求一律不发
+    CrawlRequestInterceptor::instance()->setSitePolicy(SITE_KEY, {"huodong.taobao.com"}, ResourcePolicy::listingDefaults());
+
+    // 按主机自适应限速：起始节奏沿用原先的9~16秒请求间隔
+    HostRateLimiter::shared().setPolicy(RATE_HOST, HostPolicy::fromIntervals(MIN_REQUEST_INTERVAL, MAX_REQUEST_INTERVAL));
+
+    listings.start("阿里二手房", &AliCrawl::extractPage,
+                   {[this](const QString& line) { emit appendLogSignal(line); },
+                    [this](const QString& url, int houseCount, int newCount) { onPageStored(url, houseCount, newCount); },
+                    [this](const QString& houseUrl) { emit listingUpdated(houseUrl); }});
+
     loadCookiesFromFile();
 
+    // 恢复持久化的爬取队列（上次崩溃时在途的URL会重新排队）
+    urlFrontier.open("frontier/ali_pages");
+    searchFrontier.open("frontier/ali_search");
+    listings.open("frontier/ali_search");
+
     int delayMs = 1500 + QRandomGenerator::global()->bounded(2500);
     QTimer::singleShot(delayMs, this, &AliCrawl::onInitFinishedLog);
 }
 
 AliCrawl::~AliCrawl() {
+    // 先取消挂起中的爬取流程（它们还在等本页面的信号/回调）
+    searchFlow.cancel();
+    pageFlow.cancel();
+    searchPages.clear();
+
+    // 先排空流水线，已交给写线程的房源全部入库
+    listings.stop();
+
     if (webPage != nullptr) {
         webPage->deleteLater();
         webPage = nullptr;
     }
 
-    urlQueue.clear();
-    searchUrlQueue.clear();
-    crawledUrls.clear();
-    urlDepth.clear();
-    houseDataList.clear();
-    houseIdSet.clear();
+    urlFrontier.close();
+    searchFrontier.close();
+    listings.close();
     mysql->close();
 
     emit appendLogSignal("🔌 阿里房产爬虫实例已销毁");
@@ -250,19 +295,20 @@ AliCrawl::~AliCrawl() {
 void AliCrawl::onInitFinishedLog() {
     emit appendLogSignal("✅ 阿里房产爬虫初始化完成");
     emit appendLogSignal("💡 使用说明：输入城市名+区名（可选），点击爬取按钮（支持：北京-朝阳区、上海-浦东新区等）");
+    if (searchFrontier.hasUnfinished()) {
+        emit appendLogSignal(QString("📂 发现上次未完成的爬取任务（已完成%1个房源页，剩余%2个），再次搜索相同目标将从中断处继续")
+                                 .arg(searchFrontier.doneCount()).arg(searchFrontier.queuedCount() + searchFrontier.inFlightCount()));
+    }
 }
 
 // 处理普通URL
 void AliCrawl::processNextUrl() {
-    if (urlQueue.isEmpty()) {
-        emit appendLogSignal("\n=== 阿里房产首页爬取完成 ===");
-        return;
-    }
-
-    QString currentUrl = urlQueue.dequeue();
-    emit appendLogSignal("\n📌 加载页面：" + currentUrl);
+    pageFlow = runPageFlow();
+}
 
-    QUrl reqUrl(currentUrl);
+// 普通页面请求头
+QWebEngineHttpRequest AliCrawl::buildPageRequest(const QUrl& reqUrl)
+{
     QWebEngineHttpRequest request{reqUrl};
 
     QString randomUA = getRandomUA();
@@ -280,95 +326,167 @@ void AliCrawl::processNextUrl() {
 
     if (!cookieStr.isEmpty()) {
         request.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
-    } else {
-        emit appendLogSignal("⚠️ 无阿里Cookie，可能触发风控！");
     }
 
-    webPage->load(request);
+    return request;
 }
 
-// 页面加载完成
-void AliCrawl::onPageLoadFinished(bool ok) {
-    if (this == nullptr || webPage == nullptr) return;
+// 普通页面流程：逐个加载队列里的页面，解析出城市链接后继续排队（深度受 MAX_DEPTH 限制）
+CrawlTask AliCrawl::runPageFlow()
+{
+    while (urlFrontier.hasQueued()) {
+        const QString currentUrl = urlFrontier.takeNext();
+        currentPageUrl = currentUrl;
+        emit appendLogSignal("\n📌 加载页面：" + currentUrl);
+        if (cookieStr.isEmpty()) {
+            emit appendLogSignal("⚠️ 无阿里Cookie，可能触发风控！");
+        }
 
-    QString currentUrl = webPage->url().toString();
-    bool isSearchTask = isProcessingSearchTask;
+        const bool ok = co_await CrawlAwait::load(webPage, buildPageRequest(QUrl(currentUrl)));
+        const QString finalUrl = webPage->url().toString();
+        if (isRiskUrl(finalUrl)) {
+            reportRiskPage(finalUrl);
+            // 当前页退回队列（不计入重试次数），更新Cookie后可从这里继续
+            urlFrontier.markFailed(currentUrl, false);
+            co_return;
+        }
+        if (!ok) {
+            emit appendLogSignal("❌ 加载失败：" + finalUrl);
+            urlFrontier.markFailed(currentUrl);
+            co_await CrawlAwait::sleep(this, 9000);
+            continue;
+        }
 
-    bool isRiskPage = currentUrl.contains("safe.ali.com") ||
-                      currentUrl.contains("verify") ||
-                      currentUrl.contains("security") ||
-                      currentUrl.contains("captcha") ||
-                      currentUrl.contains("antispam");
-    if (isRiskPage) {
-        emit appendLogSignal("❌ 触发阿里风控：" + currentUrl);
-        emit appendLogSignal("💡 解决方案：1.更新ali_cookies.txt 2.降低爬取频率 3.更换IP");
-        searchUrlQueue.clear();
-        isProcessingSearchTask = false;
-        return;
-    }
+        emit appendLogSignal("✅ 页面加载成功：" + finalUrl);
+        simulateHumanBehavior();
+        co_await CrawlAwait::sleep(this, 5000 + QRandomGenerator::global()->bounded(3000));
 
-    if (!ok) {
-        emit appendLogSignal("❌ 加载失败：" + currentUrl);
-        if (isSearchTask) {
-            QTimer::singleShot(16000, this, &AliCrawl::processSearchUrl);
-        } else {
-            QTimer::singleShot(9000, this, &AliCrawl::processNextUrl);
-        }
-        return;
+        const QString html = co_await CrawlAwait::toHtml(webPage);
+        extractAliData(html, currentUrl);
+        urlFrontier.markDone(currentUrl);
+        co_await CrawlAwait::sleep(this, 9000);
     }
+    emit appendLogSignal("\n=== 阿里房产首页爬取完成 ===");
+}
 
-    emit appendLogSignal("✅ 页面加载成功：" + currentUrl);
-    simulateHumanBehavior();
+void AliCrawl::reportRiskPage(const QString& url)
+{
+    emit appendLogSignal("❌ 触发阿里风控：" + url);
+    emit appendLogSignal("💡 解决方案：1.更新ali_cookies.txt 2.降低爬取频率 3.更换IP");
+}
 
-    int renderDelay = currentUrl.contains("ershoufang") || currentUrl.contains("pm/default/pc/4b05fb")
-                          ? 22000 + QRandomGenerator::global()->bounded(8000)
-                          : 5000 + QRandomGenerator::global()->bounded(3000);
-    if (currentUrl.contains("pm/default/pc/4b05fb")) {
-        emit appendLogSignal("⏳ 等待房源渲染：" + QString::number(renderDelay/1000) + "秒");
+// 房源爬取流程：调度器模式把房源页整批交给页面池；单页模式在本页面上逐页
+// 加载 → 等渲染 → 提取 → 按限速等待 → 下一页
+CrawlTask AliCrawl::runSearchFlow()
+{
+    if (m_scheduler != nullptr) {
+        dispatchSearchJobs();
+        co_return;
     }
 
-    QTimer::singleShot(renderDelay, this, [this, currentUrl, isSearchTask]() {
-        if (this == nullptr || webPage == nullptr) return;
+    while (searchFrontier.hasQueued()) {
+        const QString url = searchFrontier.takeNext();
+        const QString city = searchFrontier.tag(url);
+        emit appendLogSignal("\n📌 加载房源页：" + url);
+
+        // 加载结果（含耗时）反馈给限速器
+        const QString hostKey = HostRateLimiter::hostKey(QUrl(url));
+        HostRateLimiter::shared().acquire(hostKey);
+        QElapsedTimer loadTimer;
+        loadTimer.start();
+        const QWebEngineHttpRequest request = buildSearchRequest(QUrl(url));
+        const bool ok = co_await CrawlAwait::load(webPage, request);
+        const QString finalUrl = webPage->url().toString();
+        const bool riskHit = isRiskUrl(finalUrl);
+        HostRateLimiter::shared().onFinished(hostKey, riskHit ? HostRateLimiter::Outcome::Challenged
+                                                     : (ok ? HostRateLimiter::Outcome::Ok : HostRateLimiter::Outcome::Failed),
+                                             loadTimer.elapsed());
+
+        if (riskHit) {
+            reportRiskPage(finalUrl);
+            // 当前页退回队列（不计入重试次数），更新Cookie后可从这里继续
+            searchFrontier.markFailed(url, false);
+            emit appendLogSignal(QString("💾 爬取进度已保存：剩余%1个房源页待爬").arg(searchFrontier.queuedCount()));
+            co_return;
+        }
 
-        webPage->toHtml([this, currentUrl, isSearchTask](const QString& html) {
-            bool hasHouseNode = html.contains("div class=\"house-item\"") ||
-                                html.contains("div class=\"item-wrap\"") ||
-                                html.contains("div class=\"property-item\"");
-            emit appendLogSignal(QString("📋 HTML包含房源节点：%1").arg(hasHouseNode ? "是" : "否"));
+        if (!ok) {
+            emit appendLogSignal("❌ 加载失败：" + finalUrl);
+            if (!searchFrontier.markFailed(url)) {
+                emit appendLogSignal("⚠️ 房源页多次加载失败，已放弃：" + url);
+            }
+            co_await CrawlAwait::sleep(this, getRandomInterval(url));
+            continue;
+        }
 
-            if (isSearchTask && currentUrl.contains("pm/default/pc/4b05fb")) {
-                extractHouseData(html);
-                currentPageCount++;
-
-                isProcessingSearchTask = false;
-                QString nextLog = QString("✅ 第%1页爬取完成，准备显示结果...").arg(targetPageCount);
-                QTimer::singleShot(1000, this, &AliCrawl::showHouseCompareResult);
-                emit appendLogSignal(nextLog);
-            } else if (!isSearchTask) {
-                extractAliData(html, currentUrl);
-                QTimer::singleShot(9000, this, &AliCrawl::processNextUrl);
+        // 房源卡片数稳定即提取，最长等待RENDER_TIMEOUT_MS
+        emit appendLogSignal("✅ 页面加载成功：" + finalUrl);
+        simulateHumanBehavior();
+        emit appendLogSignal(QString("⏳ 等待房源渲染（最长%1秒）...").arg(RENDER_TIMEOUT_MS / 1000));
+        const CrawlAwait::ListingsState rendered =
+            co_await CrawlAwait::listingsReady(webPage, LISTING_SELECTOR, RENDER_TIMEOUT_MS, this);
+        if (rendered.ready) {
+            emit appendLogSignal(QString("⚡ 房源渲染完成：%1个房源节点，用时%2秒").arg(rendered.count).arg(rendered.elapsedMs / 1000.0, 0, 'f', 1));
+        } else {
+            emit appendLogSignal(QString("⏳ 渲染探测超时（%1个房源节点），按当前页面提取").arg(rendered.count));
+        }
+
+        // 页面内提取：只回传房源字段JSON，脚本没找到房源卡片时再取整页HTML；
+        // 结果与调度器模式一样交给提取线程（页指纹跳过、翻页判断、录制都走同一条路径）
+        // 录制时JSON提取成功也保存整页HTML
+        CrawlResult result;
+        result.ok = true;
+        result.finalUrl = webPage->url();
+        result.request = request;
+        if (extractMode == ExtractMode::InPageJson) {
+            const QString json = (co_await CrawlAwait::runJavaScript(webPage, HouseExtractor::aliInPageScript())).toString();
+            if (CrawlScheduler::hasInPageRows(json)) {
+                result.json = json;
+            } else {
+                emit appendLogSignal("⚠️ 页面内提取未找到房源卡片，改为获取整页HTML");
             }
-        });
-    });
+        }
+        if (result.json.isEmpty() || m_archive != nullptr) {
+            result.html = co_await CrawlAwait::toHtml(webPage);
+            bool hasHouseNode = result.html.contains("div class=\"house-item\"") ||
+                                result.html.contains("div class=\"item-wrap\"") ||
+                                result.html.contains("div class=\"property-item\"");
+            emit appendLogSignal(QString("📋 HTML包含房源节点：%1").arg(hasHouseNode ? "是" : "否"));
+        }
+        archivePage(url, city, result);
+        listings.submit(url, city.isEmpty() ? currentCity : city, result.html, result.json);
+        currentPageCount++;
+        enqueueNextPage(url);
+
+        // 还有其他目标或下一页时间隔后串行加载
+        if (searchFrontier.hasQueued()) {
+            const int interval = getRandomInterval(url);
+            emit appendLogSignal(QString("✅ 房源页爬取完成，%1秒后加载下一个目标（剩余%2个）...")
+                                     .arg(interval / 1000).arg(searchFrontier.queuedCount()));
+            co_await CrawlAwait::sleep(this, interval);
+        }
+    }
+
+    emit appendLogSignal(QString("✅ 全部房源页爬取完成（每个目标最多%1页），准备显示结果...").arg(targetPageCount));
+    finishSearchTask();
 }
 
 // 解析普通页面
 void AliCrawl::extractAliData(const QString& html, const QString& currentUrl) {
     emit appendLogSignal("🔍 解析阿里页面...");
 
-    QRegularExpression cityRegex(R"(<a\s+href=["'](https?://huodong.taobao.com/[^"']*)["']\s+class=["']city-item["'].*?>([\s\S]*?)</a>)",
-                                 QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpressionMatchIterator cityIt = cityRegex.globalMatch(html);
-    while (cityIt.hasNext()) {
-        QRegularExpressionMatch match = cityIt.next();
+    static const PatternRegistry::Pattern& cityRegex = PatternRegistry::shared().add(
+        "ali", "cityLink",
+        R"(<a\s+href=["'](https?://huodong.taobao.com/[^"']*)["']\s+class=["']city-item["'].*?>([\s\S]*?)</a>)",
+        QRegularExpression::DotMatchesEverythingOption);
+    static const PatternRegistry::Pattern& tagRegex = PatternRegistry::shared().add("common", "tag", "<[^>]*>");
+    for (const QRegularExpressionMatch& match : cityRegex.matchAll(html)) {
         QString cityUrl = match.captured(1).trimmed();
         QString cityName = match.captured(2).trimmed();
-        cityName.remove(QRegularExpression("<[^>]*>"));
+        tagRegex.remove(cityName);
 
-        if (!crawledUrls.contains(cityUrl) && urlDepth[currentUrl] < MAX_DEPTH) {
-            crawledUrls.insert(cityUrl);
-            urlQueue.enqueue(cityUrl);
-            urlDepth[cityUrl] = urlDepth[currentUrl] + 1;
+        const int baseDepth = urlFrontier.depth(currentUrl);
+        if (baseDepth < MAX_DEPTH && urlFrontier.enqueue(cityUrl, baseDepth + 1)) {
             emit appendLogSignal("🏙️ 城市：" + cityName + " | 链接：" + cityUrl);
         }
     }
@@ -376,405 +494,107 @@ void AliCrawl::extractAliData(const QString& html, const QString& currentUrl) {
     emit appendLogSignal("✅ 解析完成：" + currentUrl);
 }
 
-// 提取房源数据（
-void AliCrawl::extractHouseData(const QString& html)
+// 提取房源数据（同步，回放用；在线爬取经 listings.submit 交给流水线）
+void AliCrawl::extractHouseData(const QString& html, const QString& city)
 {
-    emit appendLogSignal("🔍 开始提取阿里二手房房源数据...");
-
-    // houseRegex：去掉价格锚点（?:起拍价|当前价）
-    QRegularExpression houseRegex(
-        R"(<div\s+[^>]*?>[\s\S]*?)"
-        R"(<span\s+class=["']text["']\s+numberoflines=["']2["'])"  // 稳定锚点1：标题span
-        R"([\s\S]{0,2000}?)"  // 宽泛匹配：标题span → 24px价格span（无需关心价格关键词）
-        R"(<span\s+class=["']text["'].*?font-size:\s*24px)"  // 稳定锚点2：24px价格span
-        R"([\s\S]*?</div>)",
-        QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption
-        );
-
-
-    QRegularExpressionMatchIterator houseIt = houseRegex.globalMatch(html);
-    int extractCount = 0;
-    int totalBlockCount = 0;
-
-    QRegularExpressionMatchIterator countIt = houseRegex.globalMatch(html);
-    while (countIt.hasNext()) {
-        countIt.next();
-        totalBlockCount++;
-    }
-    emit appendLogSignal(QString("📋 共识别到%1个房源容器").arg(totalBlockCount));
-
-    bool hasTitleSpan = html.contains(QRegularExpression(R"(<span\s+class=["']text["']\s+numberoflines=["']2["'])"));
-    bool hasCurrentPrice = html.contains("当前价");
-    bool has24pxPrice = html.contains(QRegularExpression(R"(<span\s+class=["']text["'].*?font-size:\s*24px)"));
-    emit appendLogSignal(QString("📌 调试：HTML包含标题span=%1，包含当前价=%2，包含24px价格span=%3")
-                             .arg(hasTitleSpan ? "是" : "否")
-                             .arg(hasCurrentPrice ? "是" : "否")
-                             .arg(has24pxPrice ? "是" : "否"));
-
-    if (totalBlockCount == 0 && hasTitleSpan && hasCurrentPrice && has24pxPrice) {
-        emit appendLogSignal("⚠️  警告：HTML包含核心锚点，但未匹配到房源容器，可能是正则范围过窄");
-    } else if (totalBlockCount == 0) {
-        emit appendLogSignal("⚠️  警告：HTML未包含核心锚点，可能是页面加载失败或HTML结构变化");
-        emit appendLogSignal(QString("📌 调试：HTML长度=%1字符").arg(html.length()));
-        return;
-    }
-
-    while (houseIt.hasNext()) {
-        QRegularExpressionMatch houseMatch = houseIt.next();
-        QString houseHtml = houseMatch.captured(0).trimmed();
-        //状态获取
-        QRegularExpression endFlagRegex(
-            R"(<div[^>]*?>[\s\S]*?已结束[\s\S]*?<span\s+class=["']text["'][\s\S]*?</span>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption
-            );
-        QRegularExpressionMatch endMatch = endFlagRegex.match(houseHtml);
-        if (endMatch.hasMatch()) {
-            emit appendLogSignal("🚫 识别到“已结束”标识，标记为无效房源，跳过处理");
-            continue; // 跳过当前房源，处理下一个
-        }
-
-        extractCount++;
-        emit appendLogSignal(QString("\n=================================================="));
-        emit appendLogSignal(QString("🏠 正在处理第%1个房源").arg(extractCount));
-        emit appendLogSignal(QString("=================================================="));
-
-        QString title = "未知";
-        QString communityName = "未知";
-        QString totalPrice = "未知";
-        QString evalPrice = "未知";
-        QString unitPrice = "未知";
-        QString houseType = "未知";
-        QString area = "未知";
-        QString orientation = "未知";
-        QString floor = "未知";
-        QString buildingYear = "未知";
-        QString houseUrl = "未知";
-        QString city = "未知";
-        QString region = "未知";
-        QString location = "未知";
-
-        QRegularExpression titleRegex(
-            R"(<span\s+class=["']text["']\s+numberoflines=["']2["']\s+title=["']([^"']+)["'])",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch titleMatch = titleRegex.match(houseHtml);
-        if (titleMatch.hasMatch()) {
-            title = titleMatch.captured(1).trimmed();
-            emit appendLogSignal(QString("✅ 房源标题：%1").arg(title));
-        } else {
-            QRegularExpression titleTextRegex(
-                R"(<span\s+class=["']text["']\s+numberoflines=["']2["'].*?>([\s\S]*?)</span>)",
-                QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-                );
-            QRegularExpressionMatch titleTextMatch = titleTextRegex.match(houseHtml);
-            if (titleTextMatch.hasMatch()) {
-                title = titleTextMatch.captured(1).trimmed();
-                title.remove(QRegularExpression("<[^>]*>"));
-                title.replace(QRegularExpression("\\s+"), " ");
-                emit appendLogSignal(QString("✅ 兜底提取标题：%1").arg(title));
-            } else {
-                emit appendLogSignal("❌ 标题提取失败");
-            }
-        }
-
-        QStringList nonHouseKeywords = {
-            "车位", "车库", "商用", "店面", "门市",
-            "写字楼", "办公", "厂房", "仓库", "工业",
-            "公寓式办公", "商办", "商住两用", "摊位", "柜台","储藏间",
-            "广场","商场"
-        };
-
-        bool isNonHouse = false;
-        foreach (const QString& keyword, nonHouseKeywords) {
-            if (title.contains(keyword, Qt::CaseInsensitive)) {
-                isNonHouse = true;
-                break;
-            }
-        }
-        if (isNonHouse) {
-            emit appendLogSignal(QString("🚫 过滤非住宅房源：标题包含关键词（%1），跳过处理").arg(title));
-            continue;
-        }
-
-        QRegularExpression baseInfoRegex(
-            R"(<span\s+class=["']text["']\s+numberoflines=["']1["'].*?>([\s\S]*?)</span>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch baseInfoMatch = baseInfoRegex.match(houseHtml);
-        if (baseInfoMatch.hasMatch()) {
-            QString baseText = baseInfoMatch.captured(1).trimmed();
-            baseText.remove(QRegularExpression("<[^>]*>"));
-            baseText.replace(QRegularExpression("\\s+"), " ");
-            emit appendLogSignal(QString("📋 基础信息原始文本：%1").arg(baseText));
-
-            QStringList baseList = baseText.split("|", Qt::SkipEmptyParts);
-            QList<bool> isItemMatched(baseList.size(), false);
-            for (int i = 0; i < baseList.size(); ++i) {
-                baseList[i] = baseList[i].trimmed();
-            }
-
-            // 优先按固定索引提取小区名
-            if (!baseList.isEmpty()) {
-                QString firstItem = baseList[0];
-                if (!firstItem.isEmpty()) {
-                    communityName = firstItem;
-                    emit appendLogSignal(QString("✅ 小区名（优先索引提取）：%1").arg(communityName));
-                    isItemMatched[0] = true; // 标记为已匹配
-                }
-            }
-
-            // 优先按固定索引提取面积
-            int listSize = baseList.size();
-
-            for (int i = 1; i <= (listSize >= 3 ? listSize - 3 : listSize - 1); ++i) {
-                QString item = baseList[i];
-                if (isItemMatched[i] || item.isEmpty()) continue;
-
-                bool isArea = item.contains(QRegularExpression("\\d+(\\.\\d+)?")) && (item.contains("㎡") || item.contains("m²"));
-                if (isArea) {
-                    QRegularExpression areaNumRegex(R"(\d+(\.\d+)?)");
-                    QRegularExpressionMatch areaNumMatch = areaNumRegex.match(item);
-                    area = areaNumMatch.hasMatch() ? areaNumMatch.captured(0) + " ㎡" : item.replace("m²", "㎡");
-                    emit appendLogSignal(QString("✅ 面积（中间元素匹配）：%1").arg(area));
-                    isItemMatched[i] = true;
-                    break;
-                }
-            }
-
-            // 优先按固定索引提取房型
-            QRegularExpression houseTypeRegex("^(?:(\\d+|多)室)?(?:(\\d+|多)厅)(?:(\\d+|多)卫)?$",
-                                              QRegularExpression::CaseInsensitiveOption);
-            // 遍历中间元素匹配户型
-            for (int i = 1; i <= (listSize >= 3 ? listSize - 3 : listSize - 1); ++i) {
-                QString item = baseList[i];
-                if (isItemMatched[i] || item.isEmpty()) {
-                    continue;
-                }
-
-                // 使用优化后的正则匹配户型
-                if (houseTypeRegex.match(item).hasMatch()) {
-                    houseType = item;
-                    emit appendLogSignal(QString("✅ 户型（中间元素匹配）：%1").arg(houseType));
-                    isItemMatched[i] = true;
-                    break;
-                }
-            }
-
-            // 优先按固定索引提取区域信息
-            if (listSize >= 2) {
-                // 倒数第二个元素：优先作为城市
-                QString penultimateItem = baseList[listSize - 2];
-                if (!penultimateItem.isEmpty() && city == "未知") {
-                    city = penultimateItem;
-                    emit appendLogSignal(QString("✅ 城市（倒数第二个元素提取）：%1").arg(city));
-                    isItemMatched[listSize - 2] = true;
-                }
-                // 倒数第一个元素：优先作为区域
-                QString lastItem = baseList[listSize - 1];
-                if (!lastItem.isEmpty() && region == "未知") {
-                    region = lastItem;
-                    emit appendLogSignal(QString("✅ 区域（倒数第一个元素提取）：%1").arg(region));
-                    isItemMatched[listSize - 1] = true;
-                }
-            }
-
-
-            // 小区名兜底
-            if (communityName == "未知" || communityName.isEmpty()) {
-                QList<QString> communityCandidates;
-                QRegularExpression hasChineseRegex("\\p{Script=Han}+", QRegularExpression::CaseInsensitiveOption);
-                for (int i = 0; i < baseList.size(); ++i) {
-                    QString item = baseList[i];
-                    if (!isItemMatched[i] && !item.isEmpty() && hasChineseRegex.match(item).hasMatch()) {
-                        if (!item.contains("室") && !item.contains("厅") && !item.contains("卫")) {
-                            communityCandidates.append(item);
-                        }
-                    }
-                }
-                if (!communityCandidates.isEmpty()) {
-                    QString longestCommunity = communityCandidates.first();
-                    foreach (QString candidate, communityCandidates) {
-                        if (candidate.length() > longestCommunity.length()) {
-                            longestCommunity = candidate;
-                        }
-                    }
-                    communityName = longestCommunity;
-                    emit appendLogSignal(QString("✅ 小区名（兜底提取）：%1（长度：%2字）").arg(communityName).arg(communityName.length()));
-                } else {
-                    communityName = "未知";
-                    emit appendLogSignal("✅ 小区名（兜底提取）：未知（无有效候选项）");
-                }
-            }
-
-            //  城市/区域兜底
-            if (city == "未知" || region == "未知") {
-                QRegularExpression pureChineseRegex("^\\p{Script=Han}+$", QRegularExpression::CaseInsensitiveOption);
-                for (int i = 0; i < baseList.size(); ++i) {
-                    QString item = baseList[i];
-                    if (isItemMatched[i] || item.isEmpty()) continue;
-
-                    if (pureChineseRegex.match(item).hasMatch()) {
-                        if (city == "未知" && item.length() <= 4) {
-                            city = item;
-                            emit appendLogSignal(QString("✅ 城市（兜底提取）：%1").arg(city));
-                            isItemMatched[i] = true;
-                        } else if (region == "未知") {
-                            region = item;
-                            emit appendLogSignal(QString("✅ 区域（兜底提取）：%1").arg(region));
-                            isItemMatched[i] = true;
-                        }
-                    }
-                }
-            }
-
+    Listings::Page page;
+    page.city = city.isEmpty() ? currentCity : city;
+    page.html = html;
+    listings.process(extractPage(page));
+}
 
+// 页面内提取结果入库；JSON无效或页面上没有房源卡片时返回false
+bool AliCrawl::extractHouseJson(const QString& json, const QString& city)
+{
+    Listings::Page page;
+    page.city = city.isEmpty() ? currentCity : city;
+    page.json = json;
+    Listings::Extracted result = extractPage(page);
+    if (!result.fromJson) {
+        return false;
+    }
+    listings.process(result);
+    return true;
+}
 
-            // 位置拼接
-            location = city != "未知" && region != "未知" ? QString("%1市%2区").arg(city, region) :
-                           city != "未知" ? QString("%1市").arg(city) : "未知";
-            if (location != "未知") {
-                emit appendLogSignal(QString("✅ 位置：%1").arg(location));
-            }
-        } else {
-            emit appendLogSignal("❌ 未找到基础信息容器（numberoflines=1的text span）");
-        }
-        QRegularExpression totalPriceRegex(
-            R"((?:当前价|起拍价|一口价)[\s\S]*?)"
-            R"(<span\s+class=["']text["'].*?font-size:\s*24px.*?>(\s*[\d.]+)\s*</span>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch priceMatch = totalPriceRegex.match(houseHtml);
-        if (priceMatch.hasMatch()) {
-            QString priceNum = priceMatch.captured(1).trimmed();
-            totalPrice = QString("%1 万").arg(priceNum);
-            emit appendLogSignal(QString("✅ 总价：%1").arg(totalPrice));
-        } else {
-            emit appendLogSignal("❌ 总价提取失败（未找到24px价格数字）");
-        }
+// 单页提取（工作线程，只用参数）：页面内JSON → Gumbo DOM → 正则
+AliCrawl::Listings::Extracted AliCrawl::extractPage(const Listings::Page& page)
+{
+    static const Listings::Parsers parsers{&HouseExtractor::fromAliJson, &HouseExtractor::extractAli,
+                                           &HouseExtractor::extractAliRegex, "numberoflines",
+                                           "<div class=\"item-wrap\""};
+    return Listings::extractWith(page, parsers);
+}
 
-        QRegularExpression evalPriceRegex(
-            R"((?:评估价|市场价))"
-            R"([\s\S]{0,300}?)"
-            R"(<span\s+class=["']text["'].*?>(\d+(?:\.\d+)?)万</span>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch evalMatch = evalPriceRegex.match(houseHtml);
-        if (evalMatch.hasMatch()) {
-            QString priceType = evalMatch.captured(1).trimmed();
-            QString evalNum = evalMatch.captured(2).trimmed();
-            evalPrice = QString("%1 万").arg(evalNum);
-            emit appendLogSignal(QString("✅ %1：%2").arg(priceType, evalPrice));
-        } else {
-            emit appendLogSignal("❌ 评估价/市场价提取失败");
-        }
+// 同一目标的第page页：替换page参数，pvid/logid 与浏览器翻页一样重新生成
+QString AliCrawl::pageUrl(const QString& url, int page)
+{
+    QUrl next(url);
+    QUrlQuery query(next);
+    query.removeAllQueryItems("page");
+    query.removeAllQueryItems("pvid");
+    query.removeAllQueryItems("logid");
+    query.addQueryItem("page", QString::number(page));
+    query.addQueryItem("pvid", generateRandomPvid());
+    query.addQueryItem("logid", generateLogId());
+    next.setQuery(query);
+    return next.toString();
+}
 
-        QRegularExpression floorRegex(R"((\d+层))", QRegularExpression::CaseInsensitiveOption);
-        QRegularExpressionMatch floorMatch = floorRegex.match(title);
-        if (floorMatch.hasMatch()) {
-            floor = floorMatch.captured(1).trimmed();
-            emit appendLogSignal(QString("✅ 楼层：%1").arg(floor));
-        } else {
-            emit appendLogSignal("❌ 楼层提取失败（标题中无明确楼层）");
-        }
+// 第N页已抓到：排入第N+1页（不超过targetPageCount，目标已无新房源时不再翻页）
+void AliCrawl::enqueueNextPage(const QString& url)
+{
+    const int page = searchFrontier.depth(url) + 1;
+    const QString scope = searchFrontier.tag(url);
+    if (page >= targetPageCount || exhaustedScopes.contains(scope)) return;
 
-        QStringList dirWords = {"东南", "西南", "东北", "西北", "南", "北", "东", "西"};
-        QString dirResult;
-        foreach (const QString& dir, dirWords) {
-            if (title.contains(dir) || (baseInfoMatch.hasMatch() && baseInfoMatch.captured(1).contains(dir))) {
-                dirResult += dir + " ";
-            }
-        }
-        orientation = dirResult.trimmed().isEmpty() ? "未知" : dirResult.trimmed();
-        if (orientation != "未知") {
-            emit appendLogSignal(QString("✅ 朝向：%1").arg(orientation));
-        } else {
-            emit appendLogSignal("❌ 朝向提取失败");
-        }
+    const QString next = pageUrl(url, page + 1);
+    if (searchFrontier.enqueue(next, page, scope)) {
+        emit appendLogSignal(QString("⏭️ 预取「%1」第%2页").arg(scope).arg(page + 1));
+    }
+}
 
-        QRegularExpression urlRegex(
-            R"(<a\s+[^>]*?href=["']([^"']+)["'].*?>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch urlMatch = urlRegex.match(houseHtml);
-        if (urlMatch.hasMatch()) {
-            houseUrl = urlMatch.captured(1).trimmed();
-            if (houseUrl.startsWith("//")) {
-                houseUrl = "https:" + houseUrl;
-            } else if (!houseUrl.startsWith("http") && !houseUrl.isEmpty()) {
-                houseUrl = "https://huodong.taobao.com" + houseUrl;
-            }
-            emit appendLogSignal(QString("✅ 房源链接：%1").arg(houseUrl));
-        } else {
-            emit appendLogSignal("❌ 房源链接提取失败");
-        }
+// 本页提取入库后判断是否提前结束翻页：没有房源说明已过末页，全是往期已收录且未变化的房源说明后面的页只会更旧
+// （houseCount<0：页面内容与上次一致，未提取）
+void AliCrawl::onPageStored(const QString& url, int houseCount, int newCount)
+{
+    // 房源已交给写线程才算完成：提取/汇总途中崩溃的页重启后仍在队列里，会重新抓取
+    searchFrontier.markDone(url);
 
-        if (totalPrice != "未知" && area != "未知") {
-            QString priceStr = totalPrice.remove(" 万").trimmed();
-            QString areaStr = area.remove(" ㎡").trimmed();
-            bool priceOk = false, areaOk = false;
-            double price = priceStr.toDouble(&priceOk);
-            double areaVal = areaStr.toDouble(&areaOk);
-            if (priceOk && areaOk && areaVal > 0) {
-                unitPrice = QString("%1 元/㎡").arg(QString::number((price * 10000) / areaVal, 'f', 0));
-                emit appendLogSignal(QString("✅ 单价（计算）：%1").arg(unitPrice));
-            } else {
-                unitPrice = "计算失败";
-                emit appendLogSignal("❌ 单价计算失败");
-            }
-        } else {
-            unitPrice = "计算失败";
-            emit appendLogSignal("❌ 单价计算失败（总价或面积缺失）");
-        }
+    const QString scope = searchFrontier.tag(url);
+    if (newCount > 0 || scope.isEmpty() || exhaustedScopes.contains(scope)) return;
+    exhaustedScopes.insert(scope);
 
-        if (unitPrice!="计算失败" && !houseUrl.isEmpty() && !houseIdSet.contains(houseUrl)) {
-            houseIdSet.insert(houseUrl);
-            HouseInfo data;
-            data.city = currentCity;
-            data.houseTitle = title;
-            data.communityName = communityName;
-            data.price = totalPrice;
-            data.evalPrice = evalPrice;
-            data.unitPrice = unitPrice;
-            data.houseType = houseType;
-            data.area = area;
-            data.orientation = orientation;
-            data.floor = floor;
-            data.buildingYear = buildingYear;
-            data.houseUrl = houseUrl;
-            data.region = region;
-            data.decoration = "未知";
-            data.location = location;
-            data.rent = "未知";
-
-            houseDataList.append(data);
-            emit appendLogSignal(QString("🎉 房源存储成功：%1").arg(title));
-        } else {
-            if (houseIdSet.contains(houseUrl)) {
-                emit appendLogSignal("⚠️  房源已重复，跳过存储");
-            } else {
-                emit appendLogSignal("⚠️  核心字段缺失，跳过存储");
-            }
-        }
+    const int page = searchFrontier.depth(url) + 1;
+    if (houseCount < 0) {
+        emit appendLogSignal(QString("⏹️ 「%1」第%2页内容与上次一致，停止翻页").arg(scope).arg(page));
+    } else {
+        emit appendLogSignal(houseCount == 0
+                                 ? QString("⏹️ 「%1」第%2页没有房源，停止翻页").arg(scope).arg(page)
+                                 : QString("⏹️ 「%1」第%2页的%3条房源均已收录且未变化，停止翻页").arg(scope).arg(page).arg(houseCount));
     }
 
-    emit appendLogSignal(QString("\n=================================================="));
-    emit appendLogSignal(QString("📊 提取完成：共识别%1个房源容器，成功存储%2条有效房源").arg(totalBlockCount).arg(houseDataList.size()));
-    emit appendLogSignal("==================================================\n");
-}
-
-//  处理搜索URL
-void AliCrawl::processSearchUrl() {
-    if (searchUrlQueue.isEmpty()) {
-        if (currentPageCount >= targetPageCount) {
-            showHouseCompareResult();
+    // 已预取但还没开始加载的下一页直接跳过（下一页URL含随机pvid，按目标和页码查找）
+    for (const QString& queued : searchFrontier.queuedUrls()) {
+        if (searchFrontier.tag(queued) == scope && searchFrontier.depth(queued) == page) {
+            searchFrontier.markDone(queued);
         }
-        return;
     }
+}
 
-    QString currentSearchUrl = searchUrlQueue.dequeue();
-    emit appendLogSignal("\n📌 加载房源页：" + currentSearchUrl);
+// 风控验证页检测
+bool AliCrawl::isRiskUrl(const QString& url) const
+{
+    return url.contains("safe.ali.com") ||
+           url.contains("verify") ||
+           url.contains("security") ||
+           url.contains("captcha") ||
+           url.contains("antispam");
+}
 
-    QUrl reqUrl(currentSearchUrl);
+// 构造房源页请求（单页模式与调度器共用）
+QWebEngineHttpRequest AliCrawl::buildSearchRequest(const QUrl& reqUrl)
+{
     QWebEngineHttpRequest request{reqUrl};
     QString randomUA = getRandomUA();
     request.setHeader(QByteArray("User-Agent"), randomUA.toUtf8());
@@ -797,28 +617,255 @@ void AliCrawl::processSearchUrl() {
     if (!cookieStr.isEmpty()) {
         request.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
     }
+    return request;
+}
+
+void AliCrawl::setExtractMode(ExtractMode mode)
+{
+    extractMode = mode;
+    emit appendLogSignal(QString("🧩 房源提取方式：%1").arg(mode == ExtractMode::InPageJson ? "页面内脚本（JSON）" : "整页HTML"));
+}
+
+void AliCrawl::setScheduler(CrawlScheduler *scheduler)
+{
+    m_scheduler = scheduler;
+    if (m_scheduler == nullptr) return;
+
+    m_scheduler->configureSite(SITE_KEY, 3, 2, [](QWebEnginePage *page) {
+        QWebEngineSettings *settings = page->settings();
+        settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, false);
+        settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
+        settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
+        // 池内页面同样不自动加载图片
+        settings->setAttribute(QWebEngineSettings::AutoLoadImages, false);
+        settings->setAttribute(QWebEngineSettings::AllowRunningInsecureContent, true);
+    });
+}
+
+// 调度器模式：每个房源页起一个流程，交给页面池并发加载
+void AliCrawl::dispatchSearchJobs()
+{
+    // 风控中断后排队的页留待更新Cookie后继续，其他在途页完成时也不能再提交
+    if (riskAborted) return;
+    if (!searchFrontier.hasQueued()) {
+        if (runningSearchPages() == 0) {
+            finishSearchTask();
+        }
+        return;
+    }
+
+    // 背压：提取线程跟不上时暂停提交，稍后再试
+    if (listings.saturated()) {
+        QTimer::singleShot(500, this, &AliCrawl::dispatchSearchJobs);
+        return;
+    }
+
+    emit appendLogSignal(QString("🧵 提交%1个房源页到调度器并行爬取...").arg(searchFrontier.queuedCount()));
+    runningSearchPages();   // 先清理已结束的流程，重试的页可以沿用原来的URL登记
+    while (searchFrontier.hasQueued()) {
+        const QString url = searchFrontier.takeNext();
+        searchPages.insert_or_assign(url, runSearchPage(url));
+    }
+}
+
+// 清理已结束的房源页流程，返回仍在等待调度器的页数
+int AliCrawl::runningSearchPages()
+{
+    std::erase_if(searchPages, [](const auto& entry) { return !entry.second.isRunning(); });
+    return static_cast<int>(searchPages.size());
+}
+
+// 单个房源页（调度器模式）：交给页面池加载/等渲染/提取，结果交给提取线程，失败重试或风控中断
+CrawlTask AliCrawl::runSearchPage(QString requestUrl)
+{
+    CrawlJob job;
+    job.site = SITE_KEY;
+    job.request = buildSearchRequest(QUrl(requestUrl));
+    job.renderDelayMs = RENDER_TIMEOUT_MS;
+    job.readySelector = LISTING_SELECTOR;
+    if (extractMode == ExtractMode::InPageJson) {
+        job.extractScript = HouseExtractor::aliInPageScript();
+        job.keepHtml = m_archive != nullptr;
+    }
+    job.isChallenge = [this](const QUrl& finalUrl) {
+        return isRiskUrl(finalUrl.toString());
+    };
+    const CrawlResult result = co_await CrawlAwait::scheduled(m_scheduler, job);
+
+    QString city = searchFrontier.tag(requestUrl);
+    if (city.isEmpty()) city = currentCity;
+
+    const bool riskHit = isRiskUrl(result.finalUrl.toString());
+    if (riskHit) {
+        emit appendLogSignal("❌ 触发阿里风控：" + result.finalUrl.toString());
+        emit appendLogSignal("💡 已停止提交剩余房源页，请更新ali_cookies.txt后重试");
+        // 本页和排队中的页退回队列（不计入重试次数），更新Cookie后可从中断处继续
+        // 被丢弃的任务不会再回来，它们的流程一并取消
+        riskAborted = true;
+        searchFrontier.markFailed(requestUrl, false);
+        const QList<CrawlJob> cancelled = m_scheduler->cancelPending(SITE_KEY);
+        for (const CrawlJob& pending : cancelled) {
+            const QString pendingUrl = pending.request.url().toString();
+            searchFrontier.markFailed(pendingUrl, false);
+            searchPages.erase(pendingUrl);
+        }
+        emit appendLogSignal(QString("💾 爬取进度已保存：剩余%1个房源页待爬").arg(searchFrontier.queuedCount()));
+    } else if (!result.ok) {
+        emit appendLogSignal("❌ 房源页加载失败：" + requestUrl);
+        if (searchFrontier.markFailed(requestUrl) && !riskAborted) {
+            emit appendLogSignal(QString("🔁 重新提交（第%1次尝试）").arg(searchFrontier.attempts(requestUrl) + 1));
+            // 重试的页用同一个URL登记新流程，要等本流程结束后再派发
+            QTimer::singleShot(0, this, &AliCrawl::dispatchSearchJobs);
+        }
+    } else {
+        emit appendLogSignal(QString("✅ 房源页加载成功（%1）").arg(city));
+        archivePage(requestUrl, city, result);
+        listings.submit(requestUrl, city, result.html, result.json);
+        currentPageCount++;
+        // 本页交给提取线程的同时，下一页占用另一个池页面开始加载
+        enqueueNextPage(requestUrl);
+        if (searchFrontier.hasQueued()) {
+            dispatchSearchJobs();
+        }
+    }
+
+    // 风控中断时队列里的页留待下次继续；否则要等排队的页（如限速/背压推迟提交的）也处理完。
+    // 本流程自己仍登记在 searchPages 里
+    if (runningSearchPages() <= 1 && (riskAborted || !searchFrontier.hasQueued())) {
+        finishSearchTask();
+    }
+}
+
+void AliCrawl::setArchive(PageArchive *archive)
+{
+    m_archive = archive;
+    if (m_archive != nullptr) {
+        emit appendLogSignal(QString("📼 录制模式：房源页将写入归档 %1（已有%2页）").arg(m_archive->path()).arg(m_archive->size()));
+    }
+}
+
+void AliCrawl::archivePage(const QString& requestUrl, const QString& city, const CrawlResult& result)
+{
+    if (m_archive == nullptr) return;
+    ArchivedPage page;
+    page.site = SITE_KEY;
+    page.url = requestUrl;
+    page.finalUrl = result.finalUrl.toString();
+    page.tag = city;
+    page.fetchedAt = QDateTime::currentDateTime();
+    page.headers = PageArchive::headersOf(result.request);
+    page.html = result.html;
+    page.json = result.json;
+    if (!m_archive->append(page)) {
+        emit appendLogSignal("⚠️  房源页写入归档失败：" + requestUrl);
+    }
+}
+
+// 回放归档：与在线爬取走同一套提取、去重、入库和结果展示流程
+int AliCrawl::replayArchive(PageArchive& archive)
+{
+    if (!archive.isOpen()) {
+        emit appendLogSignal("❌ 归档未打开，无法回放");
+        return -1;
+    }
+
+    listings.resetRun();
+    currentPageCount = 0;
+    QStringList scopes;
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < archive.size(); ++i) {
+        if (archive.entry(i).site != SITE_KEY) continue;
+        ArchivedPage page;
+        if (!archive.read(i, page)) {
+            emit appendLogSignal("⚠️  归档记录损坏，跳过：" + archive.entry(i).url);
+            continue;
+        }
+        if (page.json.isEmpty() || !extractHouseJson(page.json, page.tag)) {
+            extractHouseData(page.html, page.tag);
+        }
+        bytes += page.html.size() + page.json.size();
+        currentPageCount++;
+        if (!page.tag.isEmpty() && !scopes.contains(page.tag)) scopes.append(page.tag);
+    }
+
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    currentCity = scopes.join("、");
+    emit appendLogSignal(QString("📼 回放完成：%1个房源页（%2 KB），耗时%3 ms，%4页/秒，识别房源%5条")
+                             .arg(currentPageCount).arg(bytes * 2 / 1024).arg(elapsed)
+                             .arg(QString::number(currentPageCount * 1000.0 / elapsed, 'f', 1))
+                             .arg(listings.houses().size()));
+    showHouseCompareResult();
+    return currentPageCount;
+}
+
+// 继续上次中断的房源爬取：已完成的房源页不再加载
+void AliCrawl::resumeHouseCrawl()
+{
+    if (!searchFrontier.hasUnfinished()) {
+        emit appendLogSignal("📂 没有未完成的爬取任务");
+        return;
+    }
 
-    webPage->load(request);
+    listings.resetRun();
+    exhaustedScopes.clear();
+    currentCity = searchFrontier.tags().join("、");
+    currentPageCount = searchFrontier.doneCount();
+    searchPages.clear();
+    riskAborted = false;
+
+    emit appendLogSignal(QString("♻️ 从中断处继续爬取「%1」：已完成%2个房源页，剩余%3个（其中%4个为上次崩溃时在途的页面）")
+                             .arg(currentCity).arg(searchFrontier.doneCount())
+                             .arg(searchFrontier.queuedCount()).arg(searchFrontier.recoveredCount()));
+    searchFlow = runSearchFlow();
+}
+
+void AliCrawl::finishSearchTask()
+{
+    // 流水线里还有页面在提取：等最后一页的结果回来再结束
+    if (listings.pendingPages() > 0) {
+        emit appendLogSignal(QString("🧮 房源页已全部抓取，等待%1个页面提取完成...").arg(listings.pendingPages()));
+        listings.whenDrained([this]() { finishSearchTask(); });
+        return;
+    }
+    for (const QString& line : listings.summary()) {
+        emit appendLogSignal(line);
+    }
+    emit appendLogSignal(StringPool::shared().summary());
+    emit appendLogSignal(EntityResolver::shared().summary());
+    const QString patternSummary = PatternRegistry::shared().summary();
+    if (!patternSummary.isEmpty()) {
+        emit appendLogSignal(patternSummary);
+    }
+    const QString arenaSummary = GumboArena::summary();
+    if (!arenaSummary.isEmpty()) {
+        emit appendLogSignal(arenaSummary);
+    }
+    emit appendLogSignal(CrawlRequestInterceptor::instance()->summary(SITE_KEY));
+    emit appendLogSignal(HostRateLimiter::shared().summary(RATE_HOST));
+    CrawlRequestInterceptor::instance()->resetStats(SITE_KEY);
+    QTimer::singleShot(1000, this, &AliCrawl::showHouseCompareResult);
 }
 
 //展示结果
 void AliCrawl::showHouseCompareResult() {
+    QList<HouseInfo>& houseDataList = listings.houses();
     emit appendLogSignal("\n" + QString("=").repeated(80));
     emit appendLogSignal("=== " + currentCity + "阿里二手房对比结果（共" + QString::number(houseDataList.size()) + "条）===");
     emit appendLogSignal(QString("=").repeated(80));
+    if (listings.unchangedPages() > 0) {
+        emit appendLogSignal(QString("♻️ 另有%1个房源页与上次抓取时相同，未重新解析，其房源不计入本次对比（已在数据库中）")
+                                 .arg(listings.unchangedPages()));
+    }
 
+    // 按总价升序，总价未知的排在最后
     std::sort(houseDataList.begin(), houseDataList.end(), [](const HouseInfo& a, const HouseInfo& b) {
-        auto parsePrice = [](const QString& priceStr) -> double {
-            QString temp = priceStr;
-            if (temp == "未知" || !temp.contains(QRegularExpression(R"(\d+)"))) {
-                return 1e18;
-            }
-            temp.remove("万").remove(",").remove(" ").trimmed();
-            bool ok;
-            double price = temp.toDouble(&ok);
-            return ok ? price : 1e18;
-        };
-        return parsePrice(a.price) < parsePrice(b.price);
+        const bool hasA = a.record.has(HouseRecord::Price);
+        const bool hasB = b.record.has(HouseRecord::Price);
+        if (hasA != hasB) return hasA;
+        return a.record.priceWan < b.record.priceWan;
     });
 
     for (int i = 0; i < houseDataList.size(); i++) {
@@ -839,7 +886,7 @@ void AliCrawl::showHouseCompareResult() {
         emit appendLogSignal("\n🔥 对比总结：");
 
         HouseInfo cheapest = houseDataList.first();
-        if (cheapest.price != "未知") {
+        if (cheapest.record.has(HouseRecord::Price)) {
             emit appendLogSignal("✅ 最低价：" + cheapest.communityName + " - " + cheapest.price +
                                  "（区域：" + cheapest.region + " | 单价：" + cheapest.unitPrice + "）");
         } else {
@@ -851,30 +898,20 @@ void AliCrawl::showHouseCompareResult() {
         double totalUnitPrice = 0;
         int validUnitPriceCount = 0;
 
-        for (auto& house : houseDataList) {
-            QString priceStr = house.price;
-            if (priceStr != "未知" && priceStr.contains(QRegularExpression(R"(\d+)"))) {
-                priceStr.remove("万").remove(",").remove(" ").trimmed();
-                bool ok;
-                double price = priceStr.toDouble(&ok);
-                if (ok) {
-                    totalPrice += price;
-                    validPriceCount++;
-                }
+        // 同一套房子（同一实体簇）的多条房源只计一次
+        QSet<quint32> countedClusters;
+        for (const auto& house : houseDataList) {
+            const quint32 cluster = house.record.clusterId;
+            if (cluster != 0 && countedClusters.contains(cluster)) continue;
+            countedClusters.insert(cluster);
+            if (house.record.has(HouseRecord::Price)) {
+                totalPrice += house.record.priceWan;
+                validPriceCount++;
             }
-
-            QString unitPriceStr = house.unitPrice;
-            if (unitPriceStr != "未知" && unitPriceStr != "计算失败" && unitPriceStr.contains(QRegularExpression(R"(\d+)"))) {
-                unitPriceStr.remove("元/㎡").remove(",").remove(" ").trimmed();
-                bool ok;
-                double unitPrice = unitPriceStr.toDouble(&ok);
-                if (ok) {
-                    totalUnitPrice += unitPrice;
-                    validUnitPriceCount++;
-                }
+            if (house.record.has(HouseRecord::UnitPrice)) {
+                totalUnitPrice += house.record.unitPriceYuan;
+                validUnitPriceCount++;
             }
-            //mysql->insertAlInfo(house); // 需启用时取消注释
-
         }
 
         if (validPriceCount > 0) {
@@ -888,6 +925,10 @@ void AliCrawl::showHouseCompareResult() {
         } else {
             emit appendLogSignal("✅ 单价均价：暂无有效单价数据");
         }
+        if (countedClusters.size() < houseDataList.size()) {
+            emit appendLogSignal(QString("✅ 去重后共%1套（%2条为同一房源的重复发布，均价只计一次）")
+                                     .arg(countedClusters.size()).arg(houseDataList.size() - countedClusters.size()));
+        }
 
         int rentHouseCount = std::count_if(houseDataList.begin(), houseDataList.end(), [](const HouseInfo& house) {
             return house.rent != "未知" && !house.rent.isEmpty();
@@ -902,75 +943,92 @@ void AliCrawl::showHouseCompareResult() {
     emit appendLogSignal("\n" + QString("=").repeated(80));
     emit appendLogSignal("=== 阿里房源对比完成 ===");
     emit appendLogSignal(QString("=").repeated(80));
+    emit crawlFinished(houseDataList.size(), !searchFrontier.hasUnfinished());
 }
 
-//用QUrlQuery构建URL
-void AliCrawl::startHouseCrawl(const QString& cityWithDistrict, int targetPages) {
-    // 拆分城市和区名（格式："北京-朝阳区" 或 "北京"）
-    QStringList cityDistrict = cityWithDistrict.split("-", Qt::SkipEmptyParts);
-    QString cityName = cityDistrict.size() >= 1 ? cityDistrict[0].trimmed() : "";
-    QString districtName = cityDistrict.size() >= 2 ? cityDistrict[1].trimmed() : "";
-
-    if (cityName.isEmpty()) {
-        emit appendLogSignal("❌ 请输入城市名（格式：城市名 或 城市名-区名，如：北京-朝阳区）！");
-        return;
-    }
-
-    currentCity = districtName.isEmpty() ? cityName : QString("%1-%2").arg(cityName, districtName);
-    targetPageCount = qBound(1, targetPages, 5);
-    emit appendLogSignal("=== 爬取「" + currentCity + "」阿里二手房（第" + QString::number(targetPageCount) + "页）===");
-
-    // 清空旧数据
-    searchUrlQueue.clear();
-    houseDataList.clear();
-    houseIdSet.clear();
-    currentPageCount = 0;
-    isProcessingSearchTask = true;
-
-    // 获取区级/城市级编码
-    QString locationCode = regionToCode(cityName, districtName);
-    if (locationCode.isEmpty()) {
-        emit appendLogSignal("❌ 编码获取失败，无法生成URL！");
-        isProcessingSearchTask = false;
-        return;
-    }
-    emit appendLogSignal("🏙️ 编码：" + currentCity + " → " + locationCode);
-
-    // 生成随机参数
-    QString pvid = generateRandomPvid();
-    QString logId = generateLogId();
-
-
+// 生成阿里房源页URL（用QUrlQuery构建，保证参数合法编码）
+QString AliCrawl::buildSearchUrl(const QString& locationCode)
+{
     QUrl baseUrl("https://huodong.taobao.com/wow/pm/default/pc/4b05fb");
     QUrlQuery query;
 
     QString keywordRaw = "二手房";
     query.addQueryItem("keyword", keywordRaw);
 
-
     query.addQueryItem("fcatV4Ids", "[\"206058503\"]"); // 原始JSON格式，更易读
     query.addQueryItem("locationCodes", QString("[\"%1\"]").arg(locationCode));
-    query.addQueryItem("page", QString::number(targetPageCount));
-    query.addQueryItem("pvid", pvid);
-    query.addQueryItem("logid", logId);
+    query.addQueryItem("page", "1");  // 从第1页开始，后续页抓到上一页后由 pageUrl() 生成
+    query.addQueryItem("pvid", generateRandomPvid());
+    query.addQueryItem("logid", generateLogId());
     query.addQueryItem("h_n_purpose", "[\"1\"]");
     query.addQueryItem("structFieldMap", "{\"h_n_purpose\": [\"1\"]}");
 
-
     baseUrl.setQuery(query);
-    QString houseUrl = baseUrl.toString(); // 生成最终合法URL
+    return baseUrl.toString(); // 生成最终合法URL
+}
 
+// 启动阿里房源爬取（支持用逗号/顿号分隔多个目标）
+void AliCrawl::startHouseCrawl(const QString& cityWithDistrict, int targetPages) {
+    static const QRegularExpression targetSeparator("[,，、;；]");
+    QStringList targets = cityWithDistrict.split(targetSeparator, Qt::SkipEmptyParts);
+    for (QString& target : targets) {
+        target = target.trimmed();
+    }
+    targets.removeAll("");
 
-    searchUrlQueue.enqueue(houseUrl);
-    emit appendLogSignal("📌 待爬URL（阿里巴巴普通住宅页面）：" + houseUrl);
+    if (targets.isEmpty()) {
+        emit appendLogSignal("❌ 请输入城市名（格式：城市名 或 城市名-区名，如：北京-朝阳区，多个目标用逗号分隔）！");
+        emit crawlFinished(0, false);
+        return;
+    }
 
-    QWebEngineHttpRequest request{baseUrl}; // 直接传入QUrl，无需手动转换
-    request.setHeader(QByteArray("User-Agent"), getRandomUA().toUtf8());
-    if (!cookieStr.isEmpty()) {
-        request.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
+    targetPageCount = qBound(1, targetPages, 5);
+
+    // 与上次中断的任务相同（目标和页码一致）时从中断处继续；阿里URL含随机pvid，不能重新生成
+    const QString jobKey = QString("%1|%2|p%3").arg(SITE_KEY, targets.join(",")).arg(targetPageCount);
+    if (searchFrontier.jobKey() == jobKey && searchFrontier.hasUnfinished()) {
+        resumeHouseCrawl();
+        return;
+    }
+
+    // 清空旧数据
+    searchFrontier.reset(jobKey);
+    listings.resetRun();
+    exhaustedScopes.clear();
+    currentPageCount = 0;
+    searchPages.clear();
+    riskAborted = false;
+
+    QStringList crawlScopes;
+    for (const QString& target : targets) {
+        // 拆分城市和区名（格式："北京-朝阳区" 或 "北京"）
+        QStringList cityDistrict = target.split("-", Qt::SkipEmptyParts);
+        QString cityName = cityDistrict.size() >= 1 ? cityDistrict[0].trimmed() : "";
+        QString districtName = cityDistrict.size() >= 2 ? cityDistrict[1].trimmed() : "";
+        QString scope = districtName.isEmpty() ? cityName : QString("%1-%2").arg(cityName, districtName);
+
+        // 获取区级/城市级编码
+        QString locationCode = regionToCode(cityName, districtName);
+        if (locationCode.isEmpty()) {
+            emit appendLogSignal("❌ 「" + scope + "」编码获取失败，跳过该目标！");
+            continue;
+        }
+        emit appendLogSignal("🏙️ 编码：" + scope + " → " + locationCode);
+
+        QString houseUrl = buildSearchUrl(locationCode);
+        searchFrontier.enqueue(houseUrl, 0, scope);
+        crawlScopes.append(scope);
+        emit appendLogSignal("📌 待爬URL（阿里巴巴普通住宅页面）：" + houseUrl);
     }
 
-    webPage->load(request);
-    isHomeLoadedForSearch = false;
-    pendingSearchKeyword.clear();
+    if (!searchFrontier.hasQueued()) {
+        emit appendLogSignal("❌ 编码获取失败，无法生成URL！");
+        emit crawlFinished(0, false);
+        return;
+    }
+
+    currentCity = crawlScopes.join("、");
+    emit appendLogSignal("=== 爬取「" + currentCity + "」阿里二手房（每个目标最多" + QString::number(targetPageCount) + "页）===");
+
+    searchFlow = runSearchFlow();
 }
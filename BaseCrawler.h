@@ -9,6 +9,8 @@
 #include<QRandomGenerator>
 #include "HouseData.h"
 #include "MYSQL.h"
+#include "CrawlFrontier.h"
+#include "ListingPipeline.h"
 
 class BaseCrawler : public QObject {
     Q_OBJECT
@@ -20,6 +22,7 @@ public:
     }
 
     virtual ~BaseCrawler() {
+        listings.stop();
         webPage->deleteLater();
         delete mysql;
     }
@@ -33,12 +36,15 @@ signals:
 protected:
     QWebEnginePage *webPage;
     Mysql *mysql;
-    QQueue<QString> urlQueue;       // 待爬URL队列
-    QSet<QString> crawledUrls;      // 已爬URL去重
-    QList<HouseData> houseDataList; // 房源数据列表
+    CrawlFrontier frontier;         // 待爬URL队列（持久化，含深度/尝试次数，已知URL不会重复入队）
     QString currentCity;            // 当前城市
     int targetPageCount;            // 目标页数
 
+    // 提取流水线：抓取留在本线程，提取/规范化在线程池，去重汇总回到本线程，入库在专用写线程；
+    // 本轮房源列表为 listings.houses()
+    using Listings = ListingPipeline<HouseData>;
+    Listings listings{this};
+
     // 通用工具函数（子类可复用）
     QString generateRandomUA() {
         static const QStringList UA_POOL = {
@@ -48,9 +54,10 @@ protected:
         return UA_POOL.at(QRandomGenerator::global()->bounded(UA_POOL.size()));
     }
 
-    // 通用数据存储（插入数据库）
-    void saveToDB(const HouseData& data) {
-        mysql->insertInfo(data);
+    // 打开站点的持久化队列与增量重爬/近重复指纹（frontier/<site>.*），上次中断时的进度随之恢复
+    void openFrontier(const QString& site) {
+        frontier.open("frontier/" + site);
+        listings.open("frontier/" + site);
     }
 };
 
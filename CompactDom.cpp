@@ -0,0 +1,200 @@
+#include "CompactDom.h"
+#include "gumbo.h"
+#include <cctype>
+#include <cstring>
+
+const CompactDom::Index CompactDom::NONE = 0xffffffffu;
+const quint32 CompactDom::DECODED = 0x80000000u;
+
+void CompactDom::build(const GumboOutput* output, const char* utf8, size_t length)
+{
+    *this = CompactDom();
+    source = utf8;
+    sourceSize = length;
+
+    // 按节点数粗估一次容量，避免建树过程中反复扩容
+    const size_t estimate = length / 48 + 16;
+    types.reserve(estimate);
+    tags.reserve(estimate);
+    parents.reserve(estimate);
+    firstChildren.reserve(estimate);
+    nextSiblings.reserve(estimate);
+    spans.reserve(estimate);
+    attrBegins.reserve(estimate + 1);
+    classBegins.reserve(estimate + 1);
+
+    struct Pending {
+        const GumboNode* node;
+        Index parent;
+    };
+    std::vector<Pending> stack;
+    std::vector<Index> lastChildren;    // 建树过程中每个节点目前的最后一个子节点
+    stack.push_back({output->document, NONE});
+
+    while (!stack.empty()) {
+        const Pending pending = stack.back();
+        stack.pop_back();
+        const GumboNode* node = pending.node;
+
+        Type nodeType;
+        switch (node->type) {
+        case GUMBO_NODE_DOCUMENT: nodeType = Document; break;
+        case GUMBO_NODE_ELEMENT: nodeType = Element; break;
+        case GUMBO_NODE_TEMPLATE: nodeType = Template; break;
+        case GUMBO_NODE_TEXT:
+        case GUMBO_NODE_CDATA:
+        case GUMBO_NODE_WHITESPACE: nodeType = Text; break;
+        default: continue;              // 注释不保留
+        }
+
+        const Index index = size();
+        types.push_back(nodeType);
+        parents.push_back(pending.parent);
+        firstChildren.push_back(NONE);
+        nextSiblings.push_back(NONE);
+        lastChildren.push_back(NONE);
+        attrBegins.push_back(static_cast<quint32>(attrNames.size()));
+        classBegins.push_back(static_cast<quint32>(classes.size()));
+        if (pending.parent != NONE) {
+            Index& last = lastChildren[pending.parent];
+            if (last == NONE) firstChildren[pending.parent] = index;
+            else nextSiblings[last] = index;
+            last = index;
+        }
+        if (node == output->root) rootIndex = index;
+
+        const GumboVector* children = nullptr;
+        if (nodeType == Text) {
+            const GumboText& text = node->v.text;
+            tags.push_back(GUMBO_TAG_LAST);
+            spans.push_back(span(text.original_text.data, text.original_text.length, text.text));
+        } else if (nodeType == Document) {
+            tags.push_back(GUMBO_TAG_LAST);
+            spans.push_back(Span());
+            children = &node->v.document.children;
+        } else {
+            const GumboElement& element = node->v.element;
+            tags.push_back(static_cast<quint16>(element.tag));
+            Span range;
+            range.offset = element.start_pos.offset;
+            const size_t end = element.end_pos.offset + element.original_end_tag.length;
+            range.length = end > range.offset ? static_cast<quint32>(end - range.offset) : 0;
+            spans.push_back(range);
+
+            for (unsigned int i = 0; i < element.attributes.length; ++i) {
+                const GumboAttribute* attr = static_cast<const GumboAttribute*>(element.attributes.data[i]);
+                // original_value 带引号（有的话），去掉引号后与解码结果相同就直接引用原始缓冲
+                const char* raw = attr->original_value.data;
+                size_t rawLength = attr->original_value.length;
+                if (rawLength >= 2 && (raw[0] == '"' || raw[0] == '\'') && raw[rawLength - 1] == raw[0]) {
+                    ++raw;
+                    rawLength -= 2;
+                }
+                attrNames.push_back(intern(attrIds, attr->name, static_cast<int>(std::strlen(attr->name))));
+                attrValues.push_back(span(raw, rawLength, attr->value));
+                if (std::strcmp(attr->name, "class") == 0) addClasses(attr->value);
+            }
+            children = &element.children;
+        }
+
+        // 逆序压栈，保证出栈（编号）顺序与文档顺序一致
+        if (children != nullptr) {
+            for (int i = static_cast<int>(children->length) - 1; i >= 0; --i) {
+                stack.push_back({static_cast<const GumboNode*>(children->data[i]), index});
+            }
+        }
+    }
+    attrBegins.push_back(static_cast<quint32>(attrNames.size()));
+    classBegins.push_back(static_cast<quint32>(classes.size()));
+
+    // 先序编号下，子树结束于下一个兄弟；没有兄弟时与父节点的子树同时结束
+    subtreeEnds.resize(types.size());
+    for (Index i = 0; i < size(); ++i) {
+        if (nextSiblings[i] != NONE) subtreeEnds[i] = nextSiblings[i];
+        else subtreeEnds[i] = parents[i] == NONE ? size() : subtreeEnds[parents[i]];
+    }
+}
+
+// 解码后的值与原始缓冲里的片段相同就只记偏移，否则追加到 decoded
+CompactDom::Span CompactDom::span(const char* raw, size_t rawLength, const char* value)
+{
+    const size_t length = std::strlen(value);
+    Span s;
+    s.length = static_cast<quint32>(length);
+    if (raw != nullptr && raw >= source && rawLength <= sourceSize - static_cast<size_t>(raw - source) &&
+        rawLength == length && std::memcmp(raw, value, length) == 0) {
+        s.offset = static_cast<quint32>(raw - source);
+    } else {
+        s.offset = DECODED | static_cast<quint32>(decoded.size());
+        decoded.append(value, static_cast<int>(length));
+    }
+    return s;
+}
+
+QByteArray CompactDom::view(Span s) const
+{
+    const char* base = (s.offset & DECODED) ? decoded.constData() + (s.offset & ~DECODED) : source + s.offset;
+    return QByteArray::fromRawData(base, static_cast<int>(s.length));
+}
+
+int CompactDom::intern(QHash<QByteArray, int>& table, const char* data, int size)
+{
+    const auto it = table.constFind(QByteArray::fromRawData(data, size));
+    if (it != table.constEnd()) return it.value();
+    const int id = table.size();
+    table.insert(QByteArray(data, size), id);
+    return id;
+}
+
+// class 属性按空白切分，与 GumboDom::classListContains 的切分方式一致
+void CompactDom::addClasses(const char* value)
+{
+    const char* p = value;
+    while (*p) {
+        while (*p && std::isspace(static_cast<unsigned char>(*p))) ++p;
+        const char* start = p;
+        while (*p && !std::isspace(static_cast<unsigned char>(*p))) ++p;
+        if (p > start) classes.push_back(intern(classIds, start, static_cast<int>(p - start)));
+    }
+}
+
+bool CompactDom::hasClass(Index node, int classId) const
+{
+    if (classId < 0) return false;
+    for (quint32 k = classBegins[node]; k < classBegins[node + 1]; ++k) {
+        if (classes[k] == classId) return true;
+    }
+    return false;
+}
+
+bool CompactDom::attribute(Index node, int attrId, QByteArray *value) const
+{
+    if (attrId < 0) return false;
+    for (quint32 k = attrBegins[node]; k < attrBegins[node + 1]; ++k) {
+        if (attrNames[k] != attrId) continue;
+        if (value) *value = view(attrValues[k]);
+        return true;
+    }
+    return false;
+}
+
+QByteArray CompactDom::text(Index node) const
+{
+    QByteArray out;
+    const Index end = subtreeEnds[node];
+    for (Index i = node; i < end; ++i) {
+        if (types[i] == Text) out.append(view(spans[i]));
+    }
+    return out;
+}
+
+size_t CompactDom::byteSize() const
+{
+    const size_t perNode = sizeof(quint8) + sizeof(quint16) + 4 * sizeof(Index) + sizeof(Span) + 2 * sizeof(quint32);
+    const size_t perHashEntry = sizeof(QByteArray) + sizeof(int) + 16;
+    size_t bytes = types.size() * perNode;
+    bytes += attrNames.size() * (sizeof(int) + sizeof(Span)) + classes.size() * sizeof(int);
+    for (auto it = attrIds.constBegin(); it != attrIds.constEnd(); ++it) bytes += perHashEntry + it.key().size();
+    for (auto it = classIds.constBegin(); it != classIds.constEnd(); ++it) bytes += perHashEntry + it.key().size();
+    return bytes + static_cast<size_t>(decoded.size());
+}
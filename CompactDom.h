@@ -0,0 +1,119 @@
+#ifndef COMPACTDOM_H
+#define COMPACTDOM_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+struct GumboInternalOutput;
+
+/**
+ * @brief 解析结果的紧凑表示（结构数组），供选择器匹配这类反复扫描 class/属性的提取逻辑使用
+ *
+ * GumboNode 是一个大 union，子节点放在各自的 GumboVector 里，节点、属性、源码位置散落在堆上，
+ * 逐节点比较 class 时几乎每一步都是缓存未命中。这里从 Gumbo 的输出一趟遍历建成：
+ *   - 节点按文档顺序（先序）编号，类型、标签、父/首子/下一兄弟下标各自是一个连续数组；
+ *     子树 i 就是下标区间 [i, subtreeEnd(i))，遍历子树、收集文本都是顺序扫描；
+ *   - 标签沿用 GumboTag 枚举；属性名和 class 名在本页内驻留成整数编号，
+ *     每个元素的属性、class 各是一段连续的编号数组，比较 class 只是比较整数；
+ *   - 文本和属性值记录为原始 UTF-8 缓冲里的偏移 + 长度，不复制；只有被实体解码/换行规范化
+ *     改写过的值才另存一份解码结果。
+ *
+ * 注释节点不保留。原始缓冲（build 时传入的 utf8）必须比 CompactDom 活得长；
+ * 建好之后与 Gumbo 的树无关，可以先析构 GumboArena::Document 再使用。
+ *
+ * 用法：
+ *   CompactDom dom;
+ *   {
+ *       GumboArena::Document doc(utf8.constData(), utf8.size());
+ *       dom.build(doc.output(), utf8.constData(), utf8.size());
+ *   }
+ *   const int cls = dom.classId("property");
+ *   for (CompactDom::Index i = 0; i < dom.size(); ++i) {
+ *       if (dom.hasClass(i, cls)) ...
+ *   }
+ */
+class CompactDom
+{
+public:
+    using Index = quint32;
+    static const Index NONE;
+
+    enum Type : quint8 {
+        Document,
+        Element,
+        Template,
+        Text            // 含空白文本与 CDATA
+    };
+
+    // 从 Gumbo 的解析结果建立；utf8/length 是解析时传给 Gumbo 的同一份缓冲
+    void build(const GumboInternalOutput* output, const char* utf8, size_t length);
+
+    Index size() const { return static_cast<Index>(types.size()); }
+    Index root() const { return rootIndex; }                 // <html>；空文档时为 NONE
+
+    Type type(Index node) const { return static_cast<Type>(types[node]); }
+    int tag(Index node) const { return tags[node]; }         // GumboTag；非元素节点为 GUMBO_TAG_LAST
+    Index parent(Index node) const { return parents[node]; }
+    Index firstChild(Index node) const { return firstChildren[node]; }
+    Index nextSibling(Index node) const { return nextSiblings[node]; }
+    Index subtreeEnd(Index node) const { return subtreeEnds[node]; }
+
+    // 名称在本页的编号；本页没有任何元素用到这个名称时返回 -1（此时相关匹配必然失败）
+    int attrId(const QByteArray& name) const { return attrIds.value(name, -1); }
+    int classId(const QByteArray& name) const { return classIds.value(name, -1); }
+
+    bool hasClass(Index node, int classId) const;
+    // 属性存在时返回 true，value 指向原始缓冲（或解码结果）里的数据，不复制
+    bool attribute(Index node, int attrId, QByteArray *value = nullptr) const;
+    // 子树内全部文本按文档顺序拼接
+    QByteArray text(Index node) const;
+
+    // 元素在原始缓冲里的范围（开始标签到结束标签）
+    quint32 sourceOffset(Index node) const { return spans[node].offset; }
+    quint32 sourceLength(Index node) const { return spans[node].length; }
+
+    // 各数组与解码结果占用的字节数（基准测试对比用）
+    size_t byteSize() const;
+
+private:
+    // 最高位为 1 时偏移指向 decoded，否则指向原始缓冲
+    struct Span {
+        quint32 offset = 0;
+        quint32 length = 0;
+    };
+    static const quint32 DECODED;
+
+    Span span(const char* raw, size_t rawLength, const char* value);
+    QByteArray view(Span s) const;
+    int intern(QHash<QByteArray, int>& table, const char* data, int size);
+    void addClasses(const char* value);
+
+    const char* source = nullptr;
+    size_t sourceSize = 0;
+    Index rootIndex = NONE;
+
+    // 节点（下标即先序编号）
+    std::vector<quint8> types;
+    std::vector<quint16> tags;
+    std::vector<Index> parents;
+    std::vector<Index> firstChildren;
+    std::vector<Index> nextSiblings;
+    std::vector<Index> subtreeEnds;
+    std::vector<Span> spans;            // 元素：源码范围；文本：文本值
+    std::vector<quint32> attrBegins;    // 节点 i 的属性是 [attrBegins[i], attrBegins[i + 1])
+    std::vector<quint32> classBegins;   // 节点 i 的 class 是 [classBegins[i], classBegins[i + 1])
+
+    // 属性与 class
+    std::vector<int> attrNames;
+    std::vector<Span> attrValues;
+    std::vector<int> classes;
+
+    QHash<QByteArray, int> attrIds;
+    QHash<QByteArray, int> classIds;
+    QByteArray decoded;
+};
+
+#endif // COMPACTDOM_H
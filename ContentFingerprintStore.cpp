@@ -0,0 +1,164 @@
+#include "ContentFingerprintStore.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+const QByteArray kMagic("CFPSTOR1");
+const int kRecordBytes = 16;
+
+quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+const int ContentFingerprintStore::FLUSH_EVERY = 256;
+
+ContentFingerprintStore::~ContentFingerprintStore()
+{
+    close();
+}
+
+bool ContentFingerprintStore::open(const QString& filePath)
+{
+    close();
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+
+    if (file.size() == 0) {
+        file.write(kMagic);
+        file.flush();
+        return true;
+    }
+    if (file.read(kMagic.size()) != kMagic) {
+        file.close();
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    const int records = data.size() / kRecordBytes;
+    hashes.reserve(records);
+    const char *p = data.constData();
+    for (int i = 0; i < records; ++i, p += kRecordBytes) {
+        quint64 key = 0, hash = 0;
+        std::memcpy(&key, p, sizeof(key));
+        std::memcpy(&hash, p + sizeof(key), sizeof(hash));
+        if (hashes.contains(key)) staleRecords++;
+        hashes.insert(key, hash);
+    }
+
+    // 崩溃时写了一半的末尾记录
+    const qint64 validEnd = kMagic.size() + static_cast<qint64>(records) * kRecordBytes;
+    if (file.size() > validEnd) {
+        file.resize(validEnd);
+    }
+    if (staleRecords > hashes.size() && staleRecords > 1024) {
+        compact();
+    }
+    file.seek(file.size());
+    return true;
+}
+
+void ContentFingerprintStore::close()
+{
+    if (file.isOpen()) {
+        file.flush();
+        file.close();
+    }
+    hashes.clear();
+    staleRecords = 0;
+    unflushed = 0;
+}
+
+ContentFingerprintStore::Change ContentFingerprintStore::compare(quint64 key, quint64 hash) const
+{
+    auto it = hashes.constFind(key);
+    if (it == hashes.constEnd()) return Change::New;
+    return it.value() == hash ? Change::Unchanged : Change::Changed;
+}
+
+ContentFingerprintStore::Change ContentFingerprintStore::record(quint64 key, quint64 hash)
+{
+    const Change change = compare(key, hash);
+    if (change == Change::Unchanged) return change;
+
+    if (change == Change::Changed) staleRecords++;
+    hashes.insert(key, hash);
+    if (file.isOpen()) {
+        char buffer[kRecordBytes];
+        std::memcpy(buffer, &key, sizeof(key));
+        std::memcpy(buffer + sizeof(key), &hash, sizeof(hash));
+        file.write(buffer, kRecordBytes);
+        if (++unflushed >= FLUSH_EVERY) {
+            file.flush();
+            unflushed = 0;
+        }
+    }
+    return change;
+}
+
+quint64 ContentFingerprintStore::hashText(QStringView text)
+{
+    if (text.isEmpty()) return 0;
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (const QChar c : text) {
+        h ^= c.unicode();
+        h *= 0x100000001b3ULL;
+    }
+    h = mix64(h);
+    return h == 0 ? 1 : h;
+}
+
+quint64 ContentFingerprintStore::hashBytes(QByteArrayView bytes)
+{
+    if (bytes.isEmpty()) return 0;
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (const char c : bytes) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    h = mix64(h);
+    return h == 0 ? 1 : h;
+}
+
+quint64 ContentFingerprintStore::hashSlice(QStringView text, QLatin1String begin, QLatin1String end)
+{
+    const qsizetype first = text.indexOf(begin);
+    if (first < 0) return 0;
+    const qsizetype last = text.lastIndexOf(begin);
+    qsizetype stop = text.indexOf(end, last + begin.size());
+    if (stop < 0) stop = text.size();
+    return hashText(text.mid(first, stop - first));
+}
+
+// 只保留每个键的最新哈希，原子替换原文件
+void ContentFingerprintStore::compact()
+{
+    const QString path = file.fileName();
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) return;
+    out.write(kMagic);
+    char buffer[kRecordBytes];
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it) {
+        const quint64 key = it.key();
+        const quint64 hash = it.value();
+        std::memcpy(buffer, &key, sizeof(key));
+        std::memcpy(buffer + sizeof(key), &hash, sizeof(hash));
+        out.write(buffer, kRecordBytes);
+    }
+    file.close();
+    if (out.commit()) {
+        staleRecords = 0;
+    }
+    file.open(QIODevice::ReadWrite);
+}
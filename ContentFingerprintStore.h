@@ -0,0 +1,68 @@
+#ifndef CONTENTFINGERPRINTSTORE_H
+#define CONTENTFINGERPRINTSTORE_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArrayView>
+#include <QHash>
+#include <QFile>
+
+/**
+ * @brief 持久化的内容指纹表（键指纹 → 内容哈希），用于增量重爬
+ *
+ * 爬虫为每个站点打开两份，与 frontier 放在一起：
+ *   - 房源页：页面URL → 房源容器源码（或页面内提取JSON）的哈希，未变化的页跳过入库；
+ *   - 房源：房源URL → 规范化字段的哈希，未变化的房源跳过写库，有变化的改为更新已有记录。
+ *
+ * 磁盘格式：文件头 "CFPSTOR1"，之后是连续的16字节记录（quint64 键 | quint64 哈希，本机字节序），
+ * 同一个键后写的记录覆盖先写的。打开时整表读入内存，写了一半的末尾记录直接截掉；
+ * 过期记录超过一半时用QSaveFile重写压缩。追加写按批flush，崩溃丢失的只是最后几条指纹，
+ * 下次运行时这些页/房源会被当作有变化重新处理，不会漏数据。
+ */
+class ContentFingerprintStore
+{
+public:
+    enum class Change {
+        New,            // 从未记录过
+        Unchanged,      // 与上次记录的哈希相同
+        Changed         // 有记录但哈希不同
+    };
+
+    ContentFingerprintStore() = default;
+    ~ContentFingerprintStore();
+    ContentFingerprintStore(const ContentFingerprintStore&) = delete;
+    ContentFingerprintStore& operator=(const ContentFingerprintStore&) = delete;
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    // 只比较不记录
+    Change compare(quint64 key, quint64 hash) const;
+    // 比较并记录新哈希（未变化时不写盘）
+    Change record(quint64 key, quint64 hash);
+    // 上次记录的哈希，没有记录返回0
+    quint64 lookup(quint64 key) const { return hashes.value(key, 0); }
+
+    int size() const { return hashes.size(); }
+
+    // 内容哈希（64位FNV-1a + 末尾混合，直接按UTF-16码元计算，不做编码转换）；0 保留表示“没有内容”
+    static quint64 hashText(QStringView text);
+    // 同一算法按字节计算（提取线程直接对解析用的UTF-8缓冲取指纹）
+    static quint64 hashBytes(QByteArrayView bytes);
+    // 只做字符串查找、不解析：从第一个 begin 到最后一个 begin 之后第一个 end（没有则到末尾）之间的文本哈希，
+    // 用于解析前判断房源列表区域是否变化；找不到 begin 返回0
+    static quint64 hashSlice(QStringView text, QLatin1String begin, QLatin1String end);
+
+    static const int FLUSH_EVERY;   // 每追加多少条记录flush一次
+
+private:
+    void compact();
+
+    QFile file;
+    QHash<quint64, quint64> hashes;
+    int staleRecords = 0;           // 文件中被后续记录覆盖的条数
+    int unflushed = 0;
+};
+
+#endif // CONTENTFINGERPRINTSTORE_H
@@ -1,10 +1,13 @@
 #include "Crawl.h"
+#include "StringPool.h"
+#include "EntityResolver.h"
+#include "PatternRegistry.h"
+#include "GumboArena.h"
 #include <QUrl>
 #include <QTimer>
 #include <QWebEngineSettings>
 #include <QWebEngineHttpRequest>
 #include <QRegularExpressionMatchIterator>
-#include <QMessageBox>
 #include <QDateTime>
 #include <QRandomGenerator>
 #include <QByteArray>
@@ -17,12 +20,22 @@
 #include <QFile>
 #include <QTextStream>
 #include<QChar>
+#include <QElapsedTimer>
+#include <memory>
+#include "HouseExtractor.h"
+#include "PageReadyProbe.h"
+#include "CrawlRequestInterceptor.h"
+#include <limits>
 
 // 类内静态常量初始化
 const int Crawl::REQUEST_INTERVAL = 3000;
 const int Crawl::MAX_DEPTH = 1;
 const int Crawl::MIN_REQUEST_INTERVAL = 8000;
 const int Crawl::MAX_REQUEST_INTERVAL = 15000;
+const QString Crawl::SITE_KEY = "anjuke";
+const QString Crawl::RATE_HOST = "anjuke.com";
+const QString Crawl::LISTING_SELECTOR = "div.property, div.house-item, li.house-list-item";
+const int Crawl::RENDER_TIMEOUT_MS = 20000;
 const QStringList Crawl::USER_AGENT_POOL = {
     "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/138.0.0.0 Safari/537.36",
     "Mozilla/5.0 (Windows NT 11.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/138.0.0.0 Safari/537.36",
@@ -32,8 +45,6 @@ const QStringList Crawl::USER_AGENT_POOL = {
 QList<HouseData> houseDataList;
 QSet<QString> houseIdSet;
 QString currentCity;
-bool isHomeLoadedForSearch = false;
-QString pendingSearchKeyword;
 
 //嵌套映射：城市→区→对应拼音
 QMap<QString, QMap<QString, QString>> Crawl::getRegionCodeMap() {
@@ -199,16 +210,16 @@ QString Crawl::getRandomUA() {
     return USER_AGENT_POOL.at(index);
 }
 
-int Crawl::getRandomInterval() {
-    return QRandomGenerator::global()->bounded(MIN_REQUEST_INTERVAL, MAX_REQUEST_INTERVAL);
+// 下一个房源页前的等待：按目标主机当前的限速（HostRateLimiter）计算，叠加±15%随机抖动
+int Crawl::getRandomInterval(const QString& url) {
+    const qint64 delay = HostRateLimiter::shared().delayBeforeNext(HostRateLimiter::hostKey(QUrl(url)));
+    const double jitter = 0.85 + QRandomGenerator::global()->generateDouble() * 0.3;
+    return static_cast<int>(qMin<qint64>(static_cast<qint64>(delay * jitter), std::numeric_limits<int>::max()));
 }
 
-Crawl::Crawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::MainWindow* ui)
-    : QObject(nullptr)
+Crawl::Crawl(QWebEnginePage *webPageParam, QObject *parent)
+    : QObject(parent)
     , webPage(nullptr)
-    , m_ui(ui)
-    , m_mainWindow(mainWindow)
-    , isProcessingSearchTask(false)
     , currentPageCount(0)
     , targetPageCount(1)
 {
@@ -217,6 +228,17 @@ Crawl::Crawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::MainWindo
     //连接数据库
     mysql->connectDatabase();
 
+    // 实体簇编号随房源入库：第一个创建的爬虫从库里恢复最近的已识别房源，重爬到的房源沿用原编号
+    if (EntityResolver::shared().claimSeed()) {
+        EntityResolver::shared().restore(mysql->getClusteredHouses(EntityResolver::MAX_LISTINGS / 2));
+    }
+    // 去重库是新建的：用库里已收录的房源链接补齐，否则往期房源会被当成新房源重复入库
+    if (UrlDedupStore::shared().claimSeed()) {
+        for (const QString& url : mysql->normalizeHouseUrls()) {
+            UrlDedupStore::shared().insert(url);
+        }
+    }
+
     // webPage 初始化
     if (webPageParam != nullptr) {
         webPage = webPageParam;
@@ -231,16 +253,31 @@ Crawl::Crawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::MainWindo
     settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, false);
     settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
     settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
-    settings->setAttribute(QWebEngineSettings::AutoLoadImages, true);
+    // 爬取页不自动加载图片；其余子资源是否放行由 CrawlRequestInterceptor 按站点策略决定
+    settings->setAttribute(QWebEngineSettings::AutoLoadImages, false);
     settings->setAttribute(QWebEngineSettings::PluginsEnabled, false);
     settings->setAttribute(QWebEngineSettings::JavascriptCanAccessClipboard, false);
 
-    // 连接页面加载完成信号
-    connect(webPage, &QWebEnginePage::loadFinished, this, &Crawl::onPageLoadFinished);
+    // 资源拦截：房源页只需要HTML和渲染列表的脚本，图片/字体/统计请求一律不发
+    CrawlRequestInterceptor::instance()->setSitePolicy(SITE_KEY, {"anjuke.com"}, ResourcePolicy::listingDefaults());
+
+    // 按主机自适应限速：起始节奏沿用原先的8~15秒请求间隔，之后按响应情况加速或退避
+    HostRateLimiter::shared().setPolicy(RATE_HOST, HostPolicy::fromIntervals(MIN_REQUEST_INTERVAL, MAX_REQUEST_INTERVAL));
+
+    // 提取在线程池、入库在专用写线程，抓取回调不再被解析和数据库写入阻塞
+    listings.start("安居客二手房", &Crawl::extractPage,
+                   {[this](const QString& line) { emit appendLogSignal(line); },
+                    [this](const QString& url, int houseCount, int newCount) { onPageStored(url, houseCount, newCount); },
+                    [this](const QString& houseUrl) { emit listingUpdated(houseUrl); }});
 
     // 加载 Cookie（保留ke_cookies.txt）
     loadCookiesFromFile();
 
+    // 恢复持久化的爬取队列（上次崩溃时在途的URL会重新排队）
+    urlFrontier.open("frontier/anjuke_pages");
+    searchFrontier.open("frontier/anjuke_search");
+    listings.open("frontier/anjuke_search");
+
     int delayMs = 1000 + QRandomGenerator::global()->bounded(2000);
     QTimer::singleShot(
         delayMs,
@@ -250,19 +287,24 @@ Crawl::Crawl(MainWindow *mainWindow, QWebEnginePage *webPageParam, Ui::MainWindo
 }
 
 Crawl::~Crawl() {
+    // 先取消挂起中的爬取流程（它们还在等本页面的信号/回调）
+    searchFlow.cancel();
+    pageFlow.cancel();
+    searchPages.clear();
+
+    // 先排空流水线：已交给写线程的房源全部入库后再释放资源
+    listings.stop();
+
     // 清理 Web
     if (webPage != nullptr) {
         webPage->deleteLater();
         webPage = nullptr;
     }
 
-    // 清空队列，释放资源
-    urlQueue.clear();
-    searchUrlQueue.clear();
-    crawledUrls.clear();
-    urlDepth.clear();
-    houseDataList.clear();
-    houseIdSet.clear();
+    // 关闭持久化队列（进度已逐条落盘），释放资源
+    urlFrontier.close();
+    searchFrontier.close();
+    listings.close();
     //与数据库断联
     mysql->close();
 
@@ -272,140 +314,174 @@ Crawl::~Crawl() {
 void Crawl::onInitFinishedLog() {
     emit appendLogSignal("✅ 浏览器环境初始化完成，可开始爬取安居客（低风控模式）");
     emit appendLogSignal("💡 使用说明：在输入框输入城市名（如：北京、上海），点击搜索对比按钮");
+    if (searchFrontier.hasUnfinished()) {
+        emit appendLogSignal(QString("📂 发现上次未完成的爬取任务（已完成%1个房源页，剩余%2个），再次搜索相同目标将从中断处继续")
+                                 .arg(searchFrontier.doneCount()).arg(searchFrontier.queuedCount() + searchFrontier.inFlightCount()));
+    }
 }
 
 //处理普通URL（适配安居客首页）
 void Crawl::processNextUrl() {
-    if (urlQueue.isEmpty()) {
-        emit appendLogSignal("\n=== 安居客首页爬取完成 ===");
-        return;
-    }
+    pageFlow = runPageFlow();
+}
 
-    QString currentUrl = urlQueue.dequeue();
-    emit appendLogSignal("\n📌 正在加载：" + currentUrl);
+// 普通页面流程：逐个加载队列里的页面，解析出城市链接后继续排队（深度受 MAX_DEPTH 限制）
+CrawlTask Crawl::runPageFlow()
+{
+    while (urlFrontier.hasQueued()) {
+        const QString currentUrl = urlFrontier.takeNext();
+        currentPageUrl = currentUrl;
+        emit appendLogSignal("\n📌 正在加载：" + currentUrl);
 
-    QUrl url(currentUrl);
-    QWebEngineHttpRequest request(url);
+        if (cookieStr.isEmpty()) {
+            emit appendLogSignal("⚠️ 无有效Cookie，可能触发风控！");
+        }
+        const bool ok = co_await CrawlAwait::load(webPage, buildSearchRequest(QUrl(currentUrl)));
+        const QString finalUrl = webPage->url().toString();
+        if (isRiskUrl(finalUrl)) {
+            reportRiskPage(finalUrl);
+            // 当前页退回队列（不计入重试次数），更新Cookie后可从这里继续
+            urlFrontier.markFailed(currentUrl, false);
+            co_return;
+        }
+        if (!ok) {
+            emit appendLogSignal("❌ 加载失败：" + finalUrl);
+            urlFrontier.markFailed(currentUrl);
+            co_await CrawlAwait::sleep(this, 8000);
+            continue;
+        }
 
-    QString randomUA = getRandomUA();
-    request.setHeader(QByteArray("User-Agent"), randomUA.toUtf8());
-    request.setHeader(QByteArray("Referer"), QByteArray("https://www.anjuke.com/"));
-    request.setHeader(QByteArray("Accept"), QByteArray("text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8"));
-    request.setHeader(QByteArray("Accept-Encoding"), QByteArray("gzip, deflate, br"));
-    request.setHeader(QByteArray("Accept-Language"), QByteArray("zh-CN,zh;q=0.9,en;q=0.8"));
-    request.setHeader(QByteArray("Cache-Control"), QByteArray("no-cache"));
-    request.setHeader(QByteArray("Connection"), QByteArray("keep-alive"));
-    request.setHeader(QByteArray("Pragma"), QByteArray("no-cache"));
-    request.setHeader(QByteArray("Sec-Ch-Ua"), QByteArray("\"Chromium\";v=\"138\", \"Not=A?Brand\";v=\"8\", \"Google Chrome\";v=\"138\""));
-    request.setHeader(QByteArray("Sec-Ch-Ua-Mobile"), QByteArray("?0"));
-    request.setHeader(QByteArray("Sec-Ch-Ua-Platform"), QByteArray("\"Windows\""));
-    request.setHeader(QByteArray("Sec-Fetch-Dest"), QByteArray("document"));
-    request.setHeader(QByteArray("Sec-Fetch-Mode"), QByteArray("navigate"));
-    request.setHeader(QByteArray("Sec-Fetch-Site"), QByteArray("same-origin"));
-    request.setHeader(QByteArray("Upgrade-Insecure-Requests"), QByteArray("1"));
+        // 加载成功 模拟真人行为，停留几秒后取HTML
+        emit appendLogSignal("✅ 页面加载成功：" + finalUrl);
+        simulateHumanBehavior();
+        co_await CrawlAwait::sleep(this, 4000 + QRandomGenerator::global()->bounded(3000));
 
-    if (!cookieStr.isEmpty()) {
-        request.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
-    } else {
-        emit appendLogSignal("⚠️ 无有效Cookie，可能触发风控！");
+        const QString html = co_await CrawlAwait::toHtml(webPage);
+        extractKeData(html, currentUrl);
+        urlFrontier.markDone(currentUrl);
+        co_await CrawlAwait::sleep(this, 8000);
     }
-
-    webPage->load(request);
+    emit appendLogSignal("\n=== 安居客首页爬取完成 ===");
 }
 
-//页面加载完成槽函数（适配安居客风控检测）
-void Crawl::onPageLoadFinished(bool ok) {
-    if (this == nullptr || webPage == nullptr) return;
-
-    QString currentUrl = webPage->url().toString();
-    bool isSearchTask = isProcessingSearchTask;
+// 风控验证页提示（安居客验证页URL关键词适配）
+void Crawl::reportRiskPage(const QString& url)
+{
+    emit appendLogSignal("❌ 触发安居客风控！跳转至验证页：" + url);
+    emit appendLogSignal("💡 解决方案：");
+    emit appendLogSignal("  1. 关闭VPN/代理，使用本地IP；");
+    emit appendLogSignal("  2. 降低爬取频率，单次仅爬1页；");
+    emit appendLogSignal("  3. 重新获取安居客Cookie并更新ke_cookies.txt。");
+}
 
-    // 处理首页加载完成后的搜索任务（安居客首页）
-    if (isHomeLoadedForSearch && currentUrl.contains("anjuke.com") && !currentUrl.contains("sale")) {
+// 房源爬取流程：（可选）先访问首页建立会话，之后调度器模式把房源页整批交给页面池，
+// 单页模式在本页面上逐页 加载 → 等渲染 → 提取 → 按限速等待 → 下一页
+CrawlTask Crawl::runSearchFlow(bool visitHome)
+{
+    if (visitHome) {
+        emit appendLogSignal("🏠 第一步：先访问安居客首页建立会话...");
+        co_await CrawlAwait::load(webPage, buildHomeRequest());
         emit appendLogSignal("✅ 安居客首页加载完成，延迟4-6秒后开始爬取二手房...");
-        int homeDelay = 4000 + QRandomGenerator::global()->bounded(2000);
-
-        QTimer::singleShot(
-            homeDelay,
-            this,
-            [this]() {
-                emit appendLogSignal("🔍 开始执行二手房爬取任务...");
-                processSearchUrl();
-            }
-            );
-
-        isHomeLoadedForSearch = false;
-        pendingSearchKeyword.clear();
-        return;
+        co_await CrawlAwait::sleep(this, 4000 + QRandomGenerator::global()->bounded(2000));
+        emit appendLogSignal("🔍 开始执行二手房爬取任务...");
     }
 
-    // 安居客风控检测（验证页关键词适配）
-    bool isRiskPage = currentUrl.contains("verify", Qt::CaseInsensitive) ||
-                      currentUrl.contains("captcha", Qt::CaseInsensitive) ||
-                      currentUrl.contains("security", Qt::CaseInsensitive) ||
-                      currentUrl.contains("antispam", Qt::CaseInsensitive) ||
-                      currentUrl.contains("safe", Qt::CaseInsensitive);
-    if (isRiskPage) {
-        emit appendLogSignal("❌ 触发安居客风控！跳转至验证页：" + currentUrl);
-        emit appendLogSignal("💡 解决方案：");
-        emit appendLogSignal("  1. 关闭VPN/代理，使用本地IP；");
-        emit appendLogSignal("  2. 降低爬取频率，单次仅爬1页；");
-        emit appendLogSignal("  3. 重新获取安居客Cookie并更新ke_cookies.txt。");
-        searchUrlQueue.clear();
-        isProcessingSearchTask = false;
-        return;
+    if (m_scheduler != nullptr) {
+        dispatchSearchJobs();
+        co_return;
     }
 
-    // 加载失败处理
-    if (!ok) {
-        emit appendLogSignal("❌ 加载失败：" + currentUrl);
-        if (isSearchTask) {
-            emit appendLogSignal("⚠️ 房源页加载失败，15秒后重试...");
-            QTimer::singleShot(15000, this, &Crawl::processSearchUrl);
+    while (searchFrontier.hasQueued()) {
+        const QString url = searchFrontier.takeNext();
+        const QString city = searchFrontier.tag(url);
+        emit appendLogSignal("\n📌 正在加载房源页：" + url);
+        if (!cookieStr.isEmpty()) {
+            emit appendLogSignal("🍪 本次请求携带Cookie（前50字符）: " + cookieStr.left(50) + "...");
         } else {
-            QTimer::singleShot(8000, this, &Crawl::processNextUrl);
+            emit appendLogSignal("⚠️ 无有效Cookie，可能触发风控！");
         }
-        return;
-    }
 
-    // 加载成功 模拟真人行为
-    emit appendLogSignal("✅ 页面加载成功：" + currentUrl);
-    simulateHumanBehavior();
+        // 加载结果（含耗时）反馈给限速器
+        const QString hostKey = HostRateLimiter::hostKey(QUrl(url));
+        HostRateLimiter::shared().acquire(hostKey);
+        QElapsedTimer loadTimer;
+        loadTimer.start();
+        const QWebEngineHttpRequest request = buildSearchRequest(QUrl(url));
+        const bool ok = co_await CrawlAwait::load(webPage, request);
+        const QString finalUrl = webPage->url().toString();
+        const bool riskHit = isRiskUrl(finalUrl);
+        HostRateLimiter::shared().onFinished(hostKey, riskHit ? HostRateLimiter::Outcome::Challenged
+                                                     : (ok ? HostRateLimiter::Outcome::Ok : HostRateLimiter::Outcome::Failed),
+                                             loadTimer.elapsed());
+
+        if (riskHit) {
+            reportRiskPage(finalUrl);
+            // 当前页退回队列（不计入重试次数），更新Cookie后可从这里继续
+            searchFrontier.markFailed(url, false);
+            emit appendLogSignal(QString("💾 爬取进度已保存：剩余%1个房源页待爬").arg(searchFrontier.queuedCount()));
+            co_return;
+        }
 
-    // 渲染延迟
-    int renderDelay = currentUrl.contains("sale")
-                          ? 15000 + QRandomGenerator::global()->bounded(5000)
-                          : 4000 + QRandomGenerator::global()->bounded(3000);
-    if (currentUrl.contains("sale")) {
-        emit appendLogSignal("⏳ 房源页等待完全渲染（" + QString::number(renderDelay/1000) + "秒）...");
-    }
+        if (!ok) {
+            emit appendLogSignal("❌ 加载失败：" + finalUrl);
+            const int retryDelay = getRandomInterval(url);
+            if (searchFrontier.markFailed(url)) {
+                emit appendLogSignal(QString("⚠️ 房源页加载失败，%1秒后重试（第%2次）...").arg(retryDelay / 1000).arg(searchFrontier.attempts(url)));
+            } else {
+                emit appendLogSignal("⚠️ 房源页多次加载失败，已放弃：" + url);
+            }
+            co_await CrawlAwait::sleep(this, retryDelay);
+            continue;
+        }
 
-    // 渲染延迟后提取数据
-    QTimer::singleShot(renderDelay, this, [this, currentUrl, isSearchTask]() {
-        if (this == nullptr || webPage == nullptr) return;
+        // 加载成功 模拟真人行为；房源节点数稳定即提取，最长等待RENDER_TIMEOUT_MS
+        emit appendLogSignal("✅ 页面加载成功：" + finalUrl);
+        simulateHumanBehavior();
+        emit appendLogSignal(QString("⏳ 房源页等待渲染（最长%1秒）...").arg(RENDER_TIMEOUT_MS / 1000));
+        const CrawlAwait::ListingsState rendered =
+            co_await CrawlAwait::listingsReady(webPage, LISTING_SELECTOR, RENDER_TIMEOUT_MS, this);
+        if (rendered.ready) {
+            emit appendLogSignal(QString("⚡ 房源渲染完成：%1个房源节点，用时%2秒").arg(rendered.count).arg(rendered.elapsedMs / 1000.0, 0, 'f', 1));
+        } else {
+            emit appendLogSignal(QString("⏳ 渲染探测超时（%1个房源节点），按当前页面提取").arg(rendered.count));
+        }
 
-        webPage->toHtml([this, currentUrl, isSearchTask](const QString& html) {
-            bool hasHouseNode = html.contains("div class=\"house-item\"") || html.contains("li class=\"house-list-item\"");
+        // 页面内提取：只回传房源字段JSON，脚本没找到房源节点时再取整页HTML；
+        // 结果与调度器模式一样交给提取线程（页指纹跳过、翻页判断、录制都走同一条路径）
+        // 录制时JSON提取成功也保存整页HTML
+        CrawlResult result;
+        result.ok = true;
+        result.finalUrl = webPage->url();
+        result.request = request;
+        if (extractMode == ExtractMode::InPageJson) {
+            const QString json = (co_await CrawlAwait::runJavaScript(webPage, HouseExtractor::anjukeInPageScript())).toString();
+            if (CrawlScheduler::hasInPageRows(json)) {
+                result.json = json;
+            } else {
+                emit appendLogSignal("⚠️ 页面内提取未找到房源节点，改为获取整页HTML");
+            }
+        }
+        if (result.json.isEmpty() || m_archive != nullptr) {
+            result.html = co_await CrawlAwait::toHtml(webPage);
+            bool hasHouseNode = result.html.contains("div class=\"house-item\"") || result.html.contains("li class=\"house-list-item\"");
             emit appendLogSignal(QString("📋 获取到HTML：%1房源节点").arg(hasHouseNode ? "包含" : "不包含"));
+        }
+        archivePage(url, city, result);
+        listings.submit(url, city.isEmpty() ? currentCity : city, result.html, result.json);
+        currentPageCount++;
+        enqueueNextPage(url);
+
+        // 队列里还有其他城市/区县或下一页时，间隔一段时间后串行加载
+        if (searchFrontier.hasQueued()) {
+            const int interval = getRandomInterval(url);
+            emit appendLogSignal(QString("✅ 房源页爬取完成，%1秒后加载下一个目标（剩余%2个）...")
+                                     .arg(interval / 1000).arg(searchFrontier.queuedCount()));
+            co_await CrawlAwait::sleep(this, interval);
+        }
+    }
 
-            // 提取安居客房源数据
-            if (isSearchTask && currentUrl.contains("sale")) {
-                extractHouseData(html);
-                currentPageCount++;
-
-                // 处理下一页或结束
-                QString nextLog;
-                isProcessingSearchTask = false;
-                nextLog = QString("✅ 第%1页爬取完成，无下一页（一次只爬1页），准备显示结果...").arg(targetPageCount);
-                QTimer::singleShot(1000, this, &Crawl::showHouseCompareResult);
-
-                emit appendLogSignal(nextLog);
-            } else if (!isSearchTask) {
-                extractKeData(html, currentUrl);
-                QTimer::singleShot(8000, this, &Crawl::processNextUrl);
-            }
-        });
-    });
+    emit appendLogSignal(QString("✅ 全部房源页爬取完成（每个目标最多%1页），准备显示结果...").arg(targetPageCount));
+    finishSearchTask();
 }
 
 //解析普通页面（适配安居客）
@@ -413,19 +489,18 @@ void Crawl::extractKeData(const QString& html, const QString& baseUrl)
 {
     emit appendLogSignal("🔍 开始解析安居客页面...");
 
-    QRegularExpression cityRegex(R"(<a\s+href=["'](https?://[^.]+.anjuke.com/)["']\s+class=["']city-item["'].*?>([\s\S]*?)</a>)",
-                                 QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpressionMatchIterator cityIt = cityRegex.globalMatch(html);
-    while (cityIt.hasNext()) {
-        QRegularExpressionMatch match = cityIt.next();
+    static const PatternRegistry::Pattern& cityRegex = PatternRegistry::shared().add(
+        "anjuke", "cityLink",
+        R"(<a\s+href=["'](https?://[^.]+.anjuke.com/)["']\s+class=["']city-item["'].*?>([\s\S]*?)</a>)",
+        QRegularExpression::DotMatchesEverythingOption);
+    static const PatternRegistry::Pattern& tagRegex = PatternRegistry::shared().add("common", "tag", "<[^>]*>");
+    for (const QRegularExpressionMatch& match : cityRegex.matchAll(html)) {
         QString cityUrl = match.captured(1).trimmed();
         QString cityName = match.captured(2).trimmed();
-        cityName.remove(QRegularExpression("<[^>]*>"));
+        tagRegex.remove(cityName);
 
-        if (!crawledUrls.contains(cityUrl) && urlDepth[baseUrl] < MAX_DEPTH) {
-            crawledUrls.insert(cityUrl);
-            urlQueue.enqueue(cityUrl);
-            urlDepth[cityUrl] = urlDepth[baseUrl] + 1;
+        const int baseDepth = urlFrontier.depth(baseUrl);
+        if (baseDepth < MAX_DEPTH && urlFrontier.enqueue(cityUrl, baseDepth + 1)) {
             emit appendLogSignal("🏙️  城市：" + cityName + " | 链接：" + cityUrl);
         }
     }
@@ -434,353 +509,121 @@ void Crawl::extractKeData(const QString& html, const QString& baseUrl)
     emit appendLogSignal("————————————————");
 }
 
-// 提取安居客房源数据（核心修改：适配安居客页面结构）
-void Crawl::extractHouseData(const QString& html)
+// 提取安居客房源数据（同步，回放用；在线爬取经 listings.submit 交给流水线）
+void Crawl::extractHouseData(const QString& html, const QString& city)
 {
-    emit appendLogSignal("🔍 开始提取安居客二手房房源数据...");
-
-    // ========== 修正后的外层房源正则：捕获完整标签，优化标志 ==========
-    QRegularExpression houseRegex(
-        R"(<div[^>]*?class=["']\s*property\s*["'][^>]*>([\s\S]*?)(?=<div[^>]*?class=["']\s*property\s*["']|$))",
-        QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-        );
-    QRegularExpressionMatchIterator houseIt = houseRegex.globalMatch(html);
-    int extractCount = 0;
-
-    while (houseIt.hasNext()) {
-        QRegularExpressionMatch houseMatch = houseIt.next();
-        QString houseHtml = houseMatch.captured(0).trimmed();
-
-        // 调试日志（保留）
-        bool hasH3CoreClass = houseHtml.contains("property-content-title-name");
-        bool hasPriceClass = houseHtml.contains("property-price-total-num");
-        bool hasCommunityClass = houseHtml.contains("property-content-info-comm-name");
-        bool hasHouseTypeClass = houseHtml.contains("property-content-info-attribute");
-        emit appendLogSignal(QString("\n🔍 房源片段调试：长度=%1 | 包含h3核心class=%2 | 包含总价class=%3 | 包含小区名class=%4 | 包含户型class=%5")
-                                 .arg(houseHtml.length())
-                                 .arg(hasH3CoreClass ? "是" : "否")
-                                 .arg(hasPriceClass ? "是" : "否")
-                                 .arg(hasCommunityClass ? "是" : "否")
-                                 .arg(hasHouseTypeClass ? "是" : "否"));
-
-        // 跳过空片段 + 无效片段（无核心标题class，或缺少关键字段class）
-        if (houseHtml.isEmpty() || !hasH3CoreClass) {
-            continue;
-        }
-        // ========== 初始化字段（关键修改1：将面积、朝向等初始化为空字符串，而非“未知”） ==========
-        QString title = "未知";
-        QString communityName = "未知";
-        QString totalPrice = "未知";
-        QString unitPrice = "未知";
-        QString houseType = "未知";
-        QString area = ""; // 初始化为空，确保 isEmpty() 返回 true
-        QString orientation = ""; // 初始化为空，确保 isEmpty() 返回 true
-        QString floor = ""; // 初始化为空，确保 isEmpty() 返回 true
-        QString buildingYear = ""; // 初始化为空，确保 isEmpty() 返回 true
-        QString houseUrl = "未知";
-
-        // ========== 标题提取：父容器+h3双重锁定（兼容所有3种样式） ==========
-        // 主正则：兼容title和class属性任意顺序，提取title属性值（优先级更高）
-        QRegularExpression titleRegex(
-            R"(<h3[^>]*?(?:title=["']([^"']+)["'][^>]*?class|class=["'][^"']*property-content-title-name[^"']*["'][^>]*?title=["']([^"']+)["'])[^>]*>.*?</h3>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch titleMatch = titleRegex.match(houseHtml);
-        if (titleMatch.hasMatch()) {
-            // 捕获组1（title在前）或捕获组2（class在前），取非空值
-            QString title1 = titleMatch.captured(1).trimmed();
-            QString title2 = titleMatch.captured(2).trimmed();
-            title = !title1.isEmpty() ? title1 : title2;
-            // 清理连续空格（保留有效空格）
-            title.replace(QRegularExpression(R"(\s+)"), " ");
-            emit appendLogSignal(QString("✅ 标题提取成功：%1").arg(title));
-        } else {
-            // 兜底：匹配带目标class的h3，提取标签内文本（兼容任意属性顺序）
-            QRegularExpression titleFallbackRegex(
-                R"(<h3[^>]*class=["'][^"']*property-content-title-name[^"']*["'][^>]*>(.*?)</h3>)",
-                QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-                );
-            QRegularExpressionMatch fallbackMatch = titleFallbackRegex.match(houseHtml);
-            if (fallbackMatch.hasMatch()) {
-                title = fallbackMatch.captured(1).trimmed();
-                title.replace(QRegularExpression(R"(\s+)"), " ");
-                emit appendLogSignal(QString("✅ 标题提取成功（来自标签内文本）：%1").arg(title));
-            } else {
-                emit appendLogSignal("❌ 未匹配到带property-content-title-name的h3标签");
-            }
-        }
-
-        //小区名提取
-        QRegularExpression communityRegex(
-            R"(<p\s+[^>]*class=["'][^"']*?property-content-info-comm-name[^"']*?["'][^>]*>([\s\S]*?)</p>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch communityMatch = communityRegex.match(houseHtml);
-        if (communityMatch.hasMatch()) {
-            communityName = communityMatch.captured(1).trimmed();
-            communityName.remove(QRegularExpression("<[^>]*>"));
-            communityName.replace(QRegularExpression(R"(\s+)"), " ");
-            emit appendLogSignal(QString("✅ 小区名提取成功：%1").arg(communityName));
-        } else {
-            emit appendLogSignal("❌ 小区名提取失败");
-            communityName = "未知";
-        }
-
-        //总价提取
-        QRegularExpression totalPriceNumRegex(
-            R"(<span\s+[^>]*class=["'][^"']*?property-price-total-num[^"']*?["'][^>]*>([\d.]+)</span>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch totalPriceNumMatch = totalPriceNumRegex.match(houseHtml);
-        if (totalPriceNumMatch.hasMatch()) {
-            QString priceNum = totalPriceNumMatch.captured(1).trimmed();
-            QRegularExpression totalPriceTextRegex(
-                R"(<span\s+[^>]*class=["'][^"']*?property-price-total-text[^"']*?["'][^>]*>(万)</span>)",
-                QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-                );
-            QRegularExpressionMatch unitMatch = totalPriceTextRegex.match(houseHtml);
-            QString priceUnit = unitMatch.hasMatch() ? unitMatch.captured(1).trimmed() : "";
-            totalPrice = priceNum + priceUnit;
-            emit appendLogSignal(QString("✅ 房源总价提取成功：%1").arg(totalPrice));
-        } else {
-            emit appendLogSignal("❌ 房源总价提取失败（未匹配到总价数字）");
-        }
-
-        //单价提取
-        QRegularExpression unitPriceRegex(
-            R"(<p\s+[^>]*class=["'][^"']*?property-price-average[^"']*?["'][^>]*>([\s\S]*?)</p>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch unitPriceMatch = unitPriceRegex.match(houseHtml);
-        if (unitPriceMatch.hasMatch()) {
-            QString priceText = unitPriceMatch.captured(1).trimmed();
-            priceText.replace(QRegularExpression(R"(\s+)"), " ");
-            priceText = priceText.trimmed();
-            if (!priceText.isEmpty()) {
-                unitPrice = priceText;
-                emit appendLogSignal(QString("✅ 房源单价提取成功：%1").arg(unitPrice));
-            } else {
-                emit appendLogSignal("❌ 房源单价提取失败（提取文本为空）");
-            }
-        } else {
-            emit appendLogSignal("❌ 房源单价提取失败（未匹配到单价容器）");
-        }
+    Listings::Page page;
+    page.city = city.isEmpty() ? currentCity : city;
+    page.html = html;
+    listings.process(extractPage(page));
+}
 
-        // 户型提取
-        QRegularExpression houseTypeRegex(
-            R"(<p\s+[^>]*class=["'][^"']*property-content-info-text[^"']*property-content-info-attribute[^"']*["'][^>]*>([\s\S]*?)</p>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatch houseTypeMatch = houseTypeRegex.match(houseHtml);
-        if (houseTypeMatch.hasMatch()) {
-            QString typeHtml = houseTypeMatch.captured(1).trimmed();
-            typeHtml.remove(QRegularExpression("<span[^>]*>"));
-            typeHtml.remove(QRegularExpression("</span>"));
-            typeHtml.replace(QRegularExpression(R"(\s+)"), "");
-            typeHtml = typeHtml.trimmed();
-            if (!typeHtml.isEmpty()) {
-                houseType = typeHtml;
-                emit appendLogSignal(QString("✅ 户型提取成功：%1").arg(houseType));
-            } else {
-                emit appendLogSignal("❌ 户型提取失败（文本为空）");
-            }
-        } else {
-            emit appendLogSignal("❌ 户型提取失败（未匹配到户型容器）");
-        }
+// 页面内提取结果入库；JSON无效或页面上没有房源节点时返回false
+bool Crawl::extractHouseJson(const QString& json, const QString& city)
+{
+    Listings::Page page;
+    page.city = city.isEmpty() ? currentCity : city;
+    page.json = json;
+    Listings::Extracted result = extractPage(page);
+    if (!result.fromJson) {
+        return false;
+    }
+    listings.process(result);
+    return true;
+}
 
-        // 基础信息列表构建
-        QRegularExpression baseInfoRegex(
-            R"(<p\s+[^>]*class=["'][^"']*property-content-info-text[^"']*["'][^>]*>([\s\S]*?)</p>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-        QRegularExpressionMatchIterator baseInfoIt = baseInfoRegex.globalMatch(houseHtml);
-        QList<QString> baseInfoList;
-
-        while (baseInfoIt.hasNext()) {
-            QRegularExpressionMatch infoMatch = baseInfoIt.next();
-            QString infoHtml = infoMatch.captured(1).trimmed();
-            infoHtml.remove(QRegularExpression("<[^>]*>"));       // 移除所有HTML标签
-            infoHtml.replace(QRegularExpression(R"(\s+)"), " ");  // 多个空白替换为单个空格
-            infoHtml = infoHtml.trimmed();
-            if (!infoHtml.isEmpty()) {
-                baseInfoList.append(infoHtml);
-            }
-        }
+// 单页提取（在工作线程执行，只能用参数，不能访问成员）：页面内JSON → Gumbo DOM → 正则
+Crawl::Listings::Extracted Crawl::extractPage(const Listings::Page& page)
+{
+    static const Listings::Parsers parsers{&HouseExtractor::fromAnjukeJson, &HouseExtractor::extractAnjuke,
+                                           &HouseExtractor::extractAnjukeRegex, "property-content-title-name",
+                                           "<div class=\"property\""};
+    return Listings::extractWith(page, parsers);
+}
 
-        // 调试日志：确认baseInfoList内容（保留）
-        emit appendLogSignal(QString("📝 基础信息列表长度：%1").arg(baseInfoList.size()));
-        for (int i = 0; i < baseInfoList.size(); i++) {
-            emit appendLogSignal(QString("📝 索引%1：%2").arg(i).arg(baseInfoList.at(i)));
-        }
+// 同一目标的第page页：https://bj.anjuke.com/sale/chaoyang/p1/ → .../p<page>/
+QString Crawl::pageUrl(const QString& url, int page)
+{
+    static const QRegularExpression pageSegment("/p\\d+/");
+    QString next = url;
+    next.replace(pageSegment, QString("/p%1/").arg(page));
+    return next;
+}
 
-        // 定义朝向关键字列表
-        QStringList dirWords = {"东南", "西南", "东北", "西北", "南", "北", "东", "西"};
-
-        // ========== 关键修改2：改用带索引的for循环，获取元素索引值 + 成功提取数据 ==========
-        // 遍历baseInfoList，同时获取索引i和对应info（解决“获取索引值”需求）
-        for (int i = 0; i < baseInfoList.size(); i++) {
-            QString info = baseInfoList.at(i); // 当前元素
-            int currentIndex = i; // 当前元素的索引（你需要的索引值）
-
-            // 1. 提取面积（兼容数字与㎡之间有空格，同时打印索引）
-            if (area.isEmpty()) {
-                QRegularExpression areaFormatRegex(R"(^\d+(\.\d+)?\s*㎡$)");
-                QRegularExpressionMatch areaMatch = areaFormatRegex.match(info);
-                if (areaMatch.hasMatch()) {
-                    area = info;
-                    // 打印面积对应的索引值，满足你的需求
-                    emit appendLogSignal(QString("✅ 面积提取成功：%1 | 对应索引：%2").arg(area).arg(currentIndex));
-                    continue;
-                }
-            }
+// 第N页已抓到：排入第N+1页（不超过targetPageCount，目标已无新房源时不再翻页）
+void Crawl::enqueueNextPage(const QString& url)
+{
+    const int page = searchFrontier.depth(url) + 1;
+    const QString scope = searchFrontier.tag(url);
+    if (page >= targetPageCount || exhaustedScopes.contains(scope)) return;
 
-            // 2. 提取朝向（兼容组合朝向，同时打印索引）
-            if (orientation.isEmpty()) {
-                bool isDirection = false;
-                foreach (QString dir, dirWords) {
-                    if (info.contains(dir)) {
-                        isDirection = true;
-                        orientation = info;
-                        break;
-                    }
-                }
-                if (isDirection) {
-                    // 打印朝向对应的索引值，满足你的需求
-                    emit appendLogSignal(QString("✅ 朝向提取成功：%1 | 对应索引：%2").arg(orientation).arg(currentIndex));
-                    continue;
-                }
-            }
+    const QString next = pageUrl(url, page + 1);
+    if (next != url && searchFrontier.enqueue(next, page, scope)) {
+        emit appendLogSignal(QString("⏭️ 预取「%1」第%2页：%3").arg(scope).arg(page + 1).arg(next));
+    }
+}
 
-            // 3. 提取建造年份（兼容空格，同时打印索引）
-            if (buildingYear.isEmpty()) {
-                QRegularExpression yearRegex(R"(^\d{4}\s*年建造$)");
-                QRegularExpressionMatch yearMatch = yearRegex.match(info);
-                if (yearMatch.hasMatch()) {
-                    buildingYear = info;
-                    // 打印年份对应的索引值，满足你的需求
-                    emit appendLogSignal(QString("✅ 建造年份提取成功：%1 | 对应索引：%2").arg(buildingYear).arg(currentIndex));
-                    continue;
-                }
-            }
+// 本页提取入库后判断是否提前结束翻页：没有房源说明已过末页，全是往期已收录且未变化的房源说明后面的页只会更旧
+// （houseCount<0：页面内容与上次一致，未提取）
+void Crawl::onPageStored(const QString& url, int houseCount, int newCount)
+{
+    // 房源已交给写线程才算完成：提取/汇总途中崩溃的页重启后仍在队列里，会重新抓取
+    searchFrontier.markDone(url);
 
-            // 4. 提取楼层（同时打印索引）
-            if (floor.isEmpty()) {
-                QRegularExpression floorRegex(R"(\层)");
-                QRegularExpressionMatch floorMatch = floorRegex.match(info);
-                if (floorMatch.hasMatch()) {
-                    floor = info;
-                    // 打印楼层对应的索引值，满足你的需求
-                    emit appendLogSignal(QString("✅ 楼层提取成功：%1 | 对应索引：%2").arg(floor).arg(currentIndex));
-                    continue;
-                }
-            }
-        }
+    const QString scope = searchFrontier.tag(url);
+    if (newCount > 0 || scope.isEmpty() || exhaustedScopes.contains(scope)) return;
+    exhaustedScopes.insert(scope);
 
-        // ========== 关键修改3：提取完成后，给空变量赋值“未知”（兜底） ==========
-        if (area.isEmpty()) {
-            area = "未知";
-        }
-        if (orientation.isEmpty()) {
-            orientation = "未知";
-        }
-        if (floor.isEmpty()) {
-            floor = "未知";
-        }
-        if (buildingYear.isEmpty()) {
-            buildingYear = "未知";
-        }
+    const int page = searchFrontier.depth(url) + 1;
+    if (houseCount < 0) {
+        emit appendLogSignal(QString("⏹️ 「%1」第%2页内容与上次一致，停止翻页").arg(scope).arg(page));
+    } else {
+        emit appendLogSignal(houseCount == 0
+                                 ? QString("⏹️ 「%1」第%2页没有房源，停止翻页").arg(scope).arg(page)
+                                 : QString("⏹️ 「%1」第%2页的%3条房源均已收录且未变化，停止翻页").arg(scope).arg(page).arg(houseCount));
+    }
 
-        // 原有提示逻辑（可保留，也可删除，不影响核心功能）
-        if (baseInfoList.size() >= 1) {
-            if (area == "未知") {
-                emit appendLogSignal(QString("⚠️  第1个基础信息非面积格式：%1").arg(baseInfoList.at(0)));
-            }
-        } else {
-            emit appendLogSignal(QString("⚠️  基础信息列表为空，无法提取面积"));
-        }
+    // 已预取但还没开始加载的下一页直接跳过（已在加载的照常完成）
+    const QString next = pageUrl(url, page + 1);
+    if (searchFrontier.isQueued(next)) {
+        searchFrontier.markDone(next);
+    }
+}
 
-        if (baseInfoList.size() >= 2) {
-            if (orientation == "未知") {
-                emit appendLogSignal(QString("⚠️  第2个基础信息非朝向格式：%1").arg(baseInfoList.at(1)));
-            }
-        } else if (baseInfoList.size() >= 1) {
-            emit appendLogSignal(QString("⚠️  基础信息列表长度不足2条，无法提取朝向"));
-        }
+// 风控验证页检测（安居客验证页URL关键词）
+bool Crawl::isRiskUrl(const QString& url) const
+{
+    return url.contains("verify", Qt::CaseInsensitive) ||
+           url.contains("captcha", Qt::CaseInsensitive) ||
+           url.contains("security", Qt::CaseInsensitive) ||
+           url.contains("antispam", Qt::CaseInsensitive) ||
+           url.contains("safe", Qt::CaseInsensitive);
+}
 
-        if (baseInfoList.size() >= 3) {
-            if (floor == "未知") {
-                emit appendLogSignal(QString("⚠️  第3个基础信息非楼层格式：%1").arg(baseInfoList.at(2)));
-            }
-            if (buildingYear == "未知") {
-                if (baseInfoList.size() >= 4) {
-                    emit appendLogSignal(QString("⚠️  第4个基础信息非建造年份格式：%1").arg(baseInfoList.at(3)));
-                } else {
-                    emit appendLogSignal(QString("⚠️  基础信息列表长度不足4条，无法提取建造年份"));
-                }
-            }
-        } else {
-            emit appendLogSignal(QString("⚠️  基础信息列表长度不足3条，无法提取楼层/建造年份"));
-        }
+// 构造首页请求（建立会话用，不带Referer）
+QWebEngineHttpRequest Crawl::buildHomeRequest()
+{
+    QString homeUrl = "https://www.anjuke.com/"; // 安居客首页
+    QWebEngineHttpRequest homeRequest(homeUrl);
+    QString homeUA = getRandomUA();
 
-        // ========== 链接提取（原有逻辑，保留） ==========
-        QRegularExpression urlRegex(
-            R"(<a\s+[^>]*?href=["']([^"']+)["'][^>]*>)",
-            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption
-            );
-
-        QRegularExpressionMatch urlMatch = urlRegex.match(houseHtml);
-        if (urlMatch.hasMatch()) {
-            houseUrl = urlMatch.captured(1).trimmed();
-            if (!houseUrl.startsWith("http")) {
-                houseUrl = "https://beijing.anjuke.com" + houseUrl;
-            }
-            emit appendLogSignal(QString("✅ 提取链接成功：%1").arg(houseUrl));
-        } else {
-            emit appendLogSignal("❌ 链接提取失败）");
-        }
+    // 设置请求头
+    homeRequest.setHeader(QByteArray("User-Agent"), homeUA.toUtf8());
+    homeRequest.setHeader(QByteArray("Referer"), QByteArray(""));
+    homeRequest.setHeader(QByteArray("Accept"), QByteArray("text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7"));
+    homeRequest.setHeader(QByteArray("Accept-Encoding"), QByteArray("gzip, deflate, br"));
+    homeRequest.setHeader(QByteArray("Accept-Language"), QByteArray("zh-CN,zh;q=0.9,en;q=0.8,en-GB;q=0.7,en-US;q=0.6"));
 
-        // ========== 过滤无效房源并存储 ==========
-        if (!title.isEmpty() && title != "未知" && !houseUrl.isEmpty() && !houseIdSet.contains(houseUrl)) {
-            houseIdSet.insert(houseUrl);
-            HouseData data;
-            data.city = currentCity;
-            data.houseTitle = title;
-            data.communityName = communityName;
-            data.price = totalPrice;
-            data.unitPrice = unitPrice;
-            data.houseType = houseType;
-            data.area = area;
-            data.orientation = orientation;
-            data.floor = floor;
-            data.buildingYear = buildingYear;
-            data.houseUrl = houseUrl;
-            houseDataList.append(data);
-            extractCount++;
-
-            emit appendLogSignal(QString("🎉 最终提取成功：小区=%1 | 总价=%2 | 户型=%3 | 面积=%4 | 朝向=%5")
-                                     .arg(communityName, totalPrice, houseType, area, orientation));
-        } else {
-            emit appendLogSignal("🚫 该房源无有效信息，已过滤");
-        }
+    // 携带Cookie
+    if (!cookieStr.isEmpty()) {
+        homeRequest.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
     }
-
-    emit appendLogSignal(QString("\n📊 提取完成：共%1条有效房源").arg(extractCount));
+    return homeRequest;
 }
 
-// 处理安居客房源页URL
-void Crawl::processSearchUrl()
+// 构造房源页请求（单页模式、调度器与普通页面流程共用同一套请求头）
+QWebEngineHttpRequest Crawl::buildSearchRequest(const QUrl& url)
 {
-    if (searchUrlQueue.isEmpty()) {
-        if (currentPageCount >= targetPageCount) {
-            showHouseCompareResult();
-        }
-        return;
-    }
-
-    QString currentSearchUrl = searchUrlQueue.dequeue();
-    emit appendLogSignal("\n📌 正在加载房源页：" + currentSearchUrl);
-
-    QUrl url(currentSearchUrl);
     QWebEngineHttpRequest request(url);
     QString randomUA = getRandomUA();
     request.setHeader(QByteArray("User-Agent"), randomUA.toUtf8());
@@ -801,27 +644,261 @@ void Crawl::processSearchUrl()
 
     if (!cookieStr.isEmpty()) {
         request.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
-        emit appendLogSignal("🍪 本次请求携带Cookie（前50字符）: " + cookieStr.left(50) + "...");
+    }
+    return request;
+}
+
+void Crawl::setExtractMode(ExtractMode mode)
+{
+    extractMode = mode;
+    emit appendLogSignal(QString("🧩 房源提取方式：%1").arg(mode == ExtractMode::InPageJson ? "页面内脚本（JSON）" : "整页HTML"));
+}
+
+void Crawl::setScheduler(CrawlScheduler *scheduler)
+{
+    m_scheduler = scheduler;
+    if (m_scheduler == nullptr) return;
+
+    // 池内页面与单页模式使用相同的WebEngine配置
+    m_scheduler->configureSite(SITE_KEY, 3, 2, [](QWebEnginePage *page) {
+        QWebEngineSettings *settings = page->settings();
+        settings->setAttribute(QWebEngineSettings::AutoLoadIconsForPage, false);
+        settings->setAttribute(QWebEngineSettings::LocalStorageEnabled, true);
+        settings->setAttribute(QWebEngineSettings::JavascriptEnabled, true);
+        // 池内页面同样不自动加载图片
+        settings->setAttribute(QWebEngineSettings::AutoLoadImages, false);
+        settings->setAttribute(QWebEngineSettings::PluginsEnabled, false);
+        settings->setAttribute(QWebEngineSettings::JavascriptCanAccessClipboard, false);
+    });
+}
+
+// 调度器模式：每个待爬房源页起一个流程提交给页面池，由调度器控制并发
+void Crawl::dispatchSearchJobs()
+{
+    // 风控中断后排队的页留待更新Cookie后继续，其他在途页完成时也不能再提交
+    if (riskAborted) return;
+    if (!searchFrontier.hasQueued()) {
+        if (runningSearchPages() == 0) {
+            finishSearchTask();
+        }
+        return;
+    }
+
+    // 背压：提取线程跟不上时暂停提交，稍后再试
+    if (listings.saturated()) {
+        QTimer::singleShot(500, this, &Crawl::dispatchSearchJobs);
+        return;
+    }
+
+    emit appendLogSignal(QString("🧵 提交%1个房源页到调度器并行爬取...").arg(searchFrontier.queuedCount()));
+    runningSearchPages();   // 先清理已结束的流程，重试的页可以沿用原来的URL登记
+    while (searchFrontier.hasQueued()) {
+        const QString url = searchFrontier.takeNext();
+        searchPages.insert_or_assign(url, runSearchPage(url));
+    }
+}
+
+// 清理已结束的房源页流程，返回仍在等待调度器的页数
+int Crawl::runningSearchPages()
+{
+    std::erase_if(searchPages, [](const auto& entry) { return !entry.second.isRunning(); });
+    return static_cast<int>(searchPages.size());
+}
+
+// 单个房源页（调度器模式）：交给页面池加载/等渲染/提取，结果交给提取线程，失败重试或风控中断
+CrawlTask Crawl::runSearchPage(QString requestUrl)
+{
+    CrawlJob job;
+    job.site = SITE_KEY;
+    job.request = buildSearchRequest(QUrl(requestUrl));
+    job.renderDelayMs = RENDER_TIMEOUT_MS;
+    job.readySelector = LISTING_SELECTOR;
+    if (extractMode == ExtractMode::InPageJson) {
+        job.extractScript = HouseExtractor::anjukeInPageScript();
+        job.keepHtml = m_archive != nullptr;
+    }
+    job.isChallenge = [this](const QUrl& finalUrl) {
+        return isRiskUrl(finalUrl.toString());
+    };
+    const CrawlResult result = co_await CrawlAwait::scheduled(m_scheduler, job);
+
+    QString city = searchFrontier.tag(requestUrl);
+    if (city.isEmpty()) city = currentCity;
+
+    const bool riskHit = isRiskUrl(result.finalUrl.toString());
+    if (riskHit) {
+        emit appendLogSignal("❌ 触发安居客风控！跳转至验证页：" + result.finalUrl.toString());
+        emit appendLogSignal("💡 已停止提交剩余房源页，请更新ke_cookies.txt后重试");
+        // 本页和排队中的页退回队列（不计入重试次数），更新Cookie后可从中断处继续
+        // 被丢弃的任务不会再回来，它们的流程一并取消
+        riskAborted = true;
+        searchFrontier.markFailed(requestUrl, false);
+        const QList<CrawlJob> cancelled = m_scheduler->cancelPending(SITE_KEY);
+        for (const CrawlJob& pending : cancelled) {
+            const QString pendingUrl = pending.request.url().toString();
+            searchFrontier.markFailed(pendingUrl, false);
+            searchPages.erase(pendingUrl);
+        }
+        emit appendLogSignal(QString("💾 爬取进度已保存：剩余%1个房源页待爬").arg(searchFrontier.queuedCount()));
+    } else if (!result.ok) {
+        emit appendLogSignal("❌ 房源页加载失败：" + requestUrl);
+        if (searchFrontier.markFailed(requestUrl) && !riskAborted) {
+            emit appendLogSignal(QString("🔁 重新提交（第%1次尝试）").arg(searchFrontier.attempts(requestUrl) + 1));
+            // 重试的页用同一个URL登记新流程，要等本流程结束后再派发
+            QTimer::singleShot(0, this, &Crawl::dispatchSearchJobs);
+        }
     } else {
-        emit appendLogSignal("⚠️ 无有效Cookie，可能触发风控！");
+        emit appendLogSignal(QString("✅ 房源页加载成功（%1）：%2").arg(city, requestUrl));
+        archivePage(requestUrl, city, result);
+        listings.submit(requestUrl, city, result.html, result.json);
+        currentPageCount++;
+        // 本页交给提取线程的同时，下一页占用另一个池页面开始加载
+        enqueueNextPage(requestUrl);
+        if (searchFrontier.hasQueued()) {
+            dispatchSearchJobs();
+        }
+    }
+
+    // 风控中断时队列里的页留待下次继续；否则要等排队的页（如限速/背压推迟提交的）也处理完。
+    // 本流程自己仍登记在 searchPages 里
+    if (runningSearchPages() <= 1 && (riskAborted || !searchFrontier.hasQueued())) {
+        finishSearchTask();
+    }
+}
+
+void Crawl::setArchive(PageArchive *archive)
+{
+    m_archive = archive;
+    if (m_archive != nullptr) {
+        emit appendLogSignal(QString("📼 录制模式：房源页将写入归档 %1（已有%2页）").arg(m_archive->path()).arg(m_archive->size()));
+    }
+}
+
+void Crawl::archivePage(const QString& requestUrl, const QString& city, const CrawlResult& result)
+{
+    if (m_archive == nullptr) return;
+    ArchivedPage page;
+    page.site = SITE_KEY;
+    page.url = requestUrl;
+    page.finalUrl = result.finalUrl.toString();
+    page.tag = city;
+    page.fetchedAt = QDateTime::currentDateTime();
+    page.headers = PageArchive::headersOf(result.request);
+    page.html = result.html;
+    page.json = result.json;
+    if (!m_archive->append(page)) {
+        emit appendLogSignal("⚠️  房源页写入归档失败：" + requestUrl);
+    }
+}
+
+// 回放归档：与在线爬取走同一套提取、去重、入库和结果展示流程
+int Crawl::replayArchive(PageArchive& archive)
+{
+    if (!archive.isOpen()) {
+        emit appendLogSignal("❌ 归档未打开，无法回放");
+        return -1;
+    }
+
+    listings.resetRun();
+    currentPageCount = 0;
+    QStringList scopes;
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < archive.size(); ++i) {
+        if (archive.entry(i).site != SITE_KEY) continue;
+        ArchivedPage page;
+        if (!archive.read(i, page)) {
+            emit appendLogSignal("⚠️  归档记录损坏，跳过：" + archive.entry(i).url);
+            continue;
+        }
+        if (page.json.isEmpty() || !extractHouseJson(page.json, page.tag)) {
+            extractHouseData(page.html, page.tag);
+        }
+        bytes += page.html.size() + page.json.size();
+        currentPageCount++;
+        if (!page.tag.isEmpty() && !scopes.contains(page.tag)) scopes.append(page.tag);
+    }
+
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    currentCity = scopes.join("、");
+    emit appendLogSignal(QString("📼 回放完成：%1个房源页（%2 KB），耗时%3 ms，%4页/秒，识别房源%5条")
+                             .arg(currentPageCount).arg(bytes * 2 / 1024).arg(elapsed)
+                             .arg(QString::number(currentPageCount * 1000.0 / elapsed, 'f', 1))
+                             .arg(listings.houses().size()));
+    showHouseCompareResult();
+    return currentPageCount;
+}
+
+// 继续上次中断的房源爬取：已完成的房源页不再加载
+void Crawl::resumeHouseCrawl()
+{
+    if (!searchFrontier.hasUnfinished()) {
+        emit appendLogSignal("📂 没有未完成的爬取任务");
+        return;
     }
 
-    webPage->load(request);
+    // 本进程内在途的页面（如风控中断前已提交的）此时已全部结束，只需要处理排队中的
+    listings.resetRun();
+    exhaustedScopes.clear();
+    currentCity = searchFrontier.tags().join("、");
+    currentPageCount = searchFrontier.doneCount();
+    searchPages.clear();
+    riskAborted = false;
+
+    emit appendLogSignal(QString("♻️ 从中断处继续爬取「%1」：已完成%2个房源页，剩余%3个（其中%4个为上次崩溃时在途的页面）")
+                             .arg(currentCity).arg(searchFrontier.doneCount())
+                             .arg(searchFrontier.queuedCount()).arg(searchFrontier.recoveredCount()));
+    searchFlow = runSearchFlow(false);
+}
+
+// 全部目标爬取结束：复位状态并展示结果
+void Crawl::finishSearchTask()
+{
+    // 页面都已抓完，但流水线里还有页面在提取：等最后一页的结果回来再结束
+    if (listings.pendingPages() > 0) {
+        emit appendLogSignal(QString("🧮 房源页已全部抓取，等待%1个页面提取完成...").arg(listings.pendingPages()));
+        listings.whenDrained([this]() { finishSearchTask(); });
+        return;
+    }
+    for (const QString& line : listings.summary()) {
+        emit appendLogSignal(line);
+    }
+    emit appendLogSignal(StringPool::shared().summary());
+    emit appendLogSignal(EntityResolver::shared().summary());
+    const QString patternSummary = PatternRegistry::shared().summary();
+    if (!patternSummary.isEmpty()) {
+        emit appendLogSignal(patternSummary);
+    }
+    const QString arenaSummary = GumboArena::summary();
+    if (!arenaSummary.isEmpty()) {
+        emit appendLogSignal(arenaSummary);
+    }
+    emit appendLogSignal(CrawlRequestInterceptor::instance()->summary(SITE_KEY));
+    emit appendLogSignal(HostRateLimiter::shared().summary(RATE_HOST));
+    CrawlRequestInterceptor::instance()->resetStats(SITE_KEY);
+    QTimer::singleShot(1000, this, &Crawl::showHouseCompareResult);
 }
 
 // 展示房源对比结果（不变）
 void Crawl::showHouseCompareResult()
 {
+    QList<HouseData>& houseDataList = listings.houses();
     emit appendLogSignal("\n" + QString("=").repeated(60));
     emit appendLogSignal("=== " + currentCity + "二手房房源对比结果（共" + QString::number(houseDataList.size()) + "条有效房源）===");
     emit appendLogSignal(QString("=").repeated(60));
+    if (listings.unchangedPages() > 0) {
+        emit appendLogSignal(QString("♻️ 另有%1个房源页与上次抓取时相同，未重新解析，其房源不计入本次对比（已在数据库中）")
+                                 .arg(listings.unchangedPages()));
+    }
 
+    // 按总价升序，总价未知的排在最后
     std::sort(houseDataList.begin(), houseDataList.end(), [](const HouseData& a, const HouseData& b) {
-        QString priceA = a.price;
-        QString priceB = b.price;
-        priceA.remove("万").remove(",").trimmed();
-        priceB.remove("万").remove(",").trimmed();
-        return priceA.toDouble() < priceB.toDouble();
+        const bool hasA = a.record.has(HouseRecord::Price);
+        const bool hasB = b.record.has(HouseRecord::Price);
+        if (hasA != hasB) return hasA;
+        return a.record.priceWan < b.record.priceWan;
     });
 
     for (int i = 0; i < houseDataList.size(); i++) {
@@ -856,49 +933,60 @@ void Crawl::showHouseCompareResult()
         emit appendLogSignal("✅ 总价最低房源：" + cheapest.communityName + " - " + cheapest.houseType);
         emit appendLogSignal("   总价：" + cheapest.price + " | 单价：" + cheapest.unitPrice);
 
+        // 同一套房子（同一实体簇）的多条房源只计一次
         double totalPriceSum = 0;
         int validPriceCount = 0;
-        for (auto& house : houseDataList) {
-            QString priceStr = house.price;
-            priceStr.remove("万").remove(",").trimmed();
-            bool ok;
-            double price = priceStr.toDouble(&ok);
-            if (ok) {
-                totalPriceSum += price;
+        QSet<quint32> countedClusters;
+        for (const auto& house : houseDataList) {
+            const quint32 cluster = house.record.clusterId;
+            if (cluster != 0 && countedClusters.contains(cluster)) continue;
+            countedClusters.insert(cluster);
+            if (house.record.has(HouseRecord::Price)) {
+                totalPriceSum += house.record.priceWan;
                 validPriceCount++;
             }
-            //mysql->insertInfo(house);
         }
 
         if (validPriceCount > 0) {
             double avgPrice = totalPriceSum / validPriceCount;
             emit appendLogSignal("✅ 房源均价：" + QString::number(avgPrice, 'f', 1) + " 万");
         }
+        if (countedClusters.size() < houseDataList.size()) {
+            emit appendLogSignal(QString("✅ 去重后共%1套（%2条为同一房源的重复发布，均价只计一次）")
+                                     .arg(countedClusters.size()).arg(houseDataList.size() - countedClusters.size()));
+        }
 
-        QMap<QString, int> houseTypeCount;
-        for (auto& house : houseDataList) {
-            houseTypeCount[house.houseType]++;
+        // 按户型编号分组（字符串字典里的编号，整数比较）
+        QMap<quint32, int> houseTypeCount;
+        for (const auto& house : houseDataList) {
+            houseTypeCount[house.record.houseTypeId]++;
         }
         emit appendLogSignal("✅ 户型分布：");
         for (auto it = houseTypeCount.begin(); it != houseTypeCount.end(); it++) {
-            emit appendLogSignal("   " + it.key() + "：" + QString::number(it.value()) + "套");
+            const QString houseType = StringPool::shared().text(it.key());
+            emit appendLogSignal("   " + (houseType.isEmpty() ? QString("未知") : houseType) + "：" + QString::number(it.value()) + "套");
         }
     }
 
     emit appendLogSignal("\n=== 房源对比完成（低风控模式）===");
+    emit crawlFinished(houseDataList.size(), !searchFrontier.hasUnfinished());
 }
 
 // 启动安居客爬取（核心修改：URL适配安居客）
 void Crawl::startHouseCrawl(const QString& cityWithDistrict, int targetPages)
 {
-    // ========== 1. 拆分城市/区县 ==========
-    QStringList cityDistrictParts = cityWithDistrict.split("-", Qt::SkipEmptyParts);
-    QString pureCityName = cityDistrictParts.size() >= 1 ? cityDistrictParts[0].trimmed() : "";
-    QString districtName = cityDistrictParts.size() >= 2 ? cityDistrictParts[1].trimmed() : "";
+    // ========== 1. 拆分多个目标，再逐个拆分城市/区县 ==========
+    static const QRegularExpression targetSeparator("[,，、;；]");
+    QStringList targets = cityWithDistrict.split(targetSeparator, Qt::SkipEmptyParts);
+    for (QString& target : targets) {
+        target = target.trimmed();
+    }
+    targets.removeAll("");
 
     // 基础校验
-    if (pureCityName.isEmpty()) {
-        emit appendLogSignal("❌ 输入格式错误！请输入：城市名 或 城市名-区县名（示例：北京 或 北京-朝阳区）");
+    if (targets.isEmpty()) {
+        emit appendLogSignal("❌ 输入格式错误！请输入：城市名 或 城市名-区县名（示例：北京 或 北京-朝阳区，多个目标用逗号分隔）");
+        emit crawlFinished(0, false);
         return;
     }
 
@@ -908,72 +996,72 @@ void Crawl::startHouseCrawl(const QString& cityWithDistrict, int targetPages)
         emit appendLogSignal(QString("⚠️  风控调整：页码%1超出范围（1-5），自动修正为%2").arg(targetPages).arg(targetPageCount));
     }
 
-    // ========== 3. 清空历史数据 ==========
-    searchUrlQueue.clear();
-    houseDataList.clear();
-    houseIdSet.clear();
-    currentPageCount = 0;
-    isProcessingSearchTask = true;
-
-    // ========== 4. 获取城市/区域拼音 ==========
-    QString cityPinyin = regionToCode(pureCityName, "");
-    QString districtPinyin = regionToCode(pureCityName, districtName);
-    if (cityPinyin.isEmpty()) {
-        emit appendLogSignal("❌ 无法获取「" + pureCityName + "」的城市拼音，终止爬取！");
-        isProcessingSearchTask = false;
+    // 与上次中断的任务相同（目标和页码一致）时从中断处继续，不重新生成URL
+    const QString jobKey = QString("%1|%2|p%3").arg(SITE_KEY, targets.join(",")).arg(targetPageCount);
+    if (searchFrontier.jobKey() == jobKey && searchFrontier.hasUnfinished()) {
+        resumeHouseCrawl();
         return;
     }
 
-    // ========== 5. 生成安居客URL（核心修改：https://bj.anjuke.com/sale/pg1/） ==========
-    QString houseUrl;
-    if (!districtName.isEmpty() && !districtPinyin.isEmpty()) {
-        // 区级URL：https://bj.anjuke.com/sale/chaoyang/pg1/
-        houseUrl = QString("https://%1.anjuke.com/sale/%2/p%3/")
-                       .arg(cityPinyin)
-                       .arg(districtPinyin)
-                       .arg(targetPageCount);
-    } else {
-        // 城市级URL：https://bj.anjuke.com/sale/pg1/
-        houseUrl = QString("https://%1.anjuke.com/sale/p%2/")
-                       .arg(cityPinyin)
-                       .arg(targetPageCount);
-    }
-
-    // ========== 6. 日志输出 + 入队URL ==========
-    QString crawlScope = districtName.isEmpty() ? pureCityName : QString("%1-%2").arg(pureCityName, districtName);
-    emit appendLogSignal("=== 低风控模式：爬取「" + crawlScope + "」二手房房源（第" + QString::number(targetPageCount) + "页）===");
-    emit appendLogSignal("⚠️  风控提醒：单次只爬1页，目标页码范围1-5！");
-    emit appendLogSignal("⚠️  请确保ke_cookies.txt中的Cookie是安居客登录后最新抓取的！");
-    emit appendLogSignal("————————————————");
-    emit appendLogSignal("🏙️  拼音映射：" + crawlScope + " → 城市拼音：" + cityPinyin + (districtPinyin.isEmpty() ? "" : " | 区域拼音：" + districtPinyin));
-    emit appendLogSignal("📌 待爬取房源页：" + houseUrl);
+    // ========== 3. 清空历史数据 ==========
+    searchFrontier.reset(jobKey);
+    listings.resetRun();
+    exhaustedScopes.clear();
+    currentPageCount = 0;
+    searchPages.clear();
+    riskAborted = false;
+
+    QStringList crawlScopes;
+    for (const QString& target : targets) {
+        QStringList cityDistrictParts = target.split("-", Qt::SkipEmptyParts);
+        QString pureCityName = cityDistrictParts.size() >= 1 ? cityDistrictParts[0].trimmed() : "";
+        QString districtName = cityDistrictParts.size() >= 2 ? cityDistrictParts[1].trimmed() : "";
+
+        // ========== 4. 获取城市/区域拼音 ==========
+        QString cityPinyin = regionToCode(pureCityName, "");
+        QString districtPinyin = regionToCode(pureCityName, districtName);
+        if (cityPinyin.isEmpty()) {
+            emit appendLogSignal("❌ 无法获取「" + pureCityName + "」的城市拼音，跳过该目标！");
+            continue;
+        }
 
-    searchUrlQueue.enqueue(houseUrl);
+        // ========== 5. 生成安居客第1页URL（https://bj.anjuke.com/sale/p1/），后续页抓到上一页后再排队 ==========
+        QString houseUrl;
+        if (!districtName.isEmpty() && !districtPinyin.isEmpty()) {
+            // 区级URL：https://bj.anjuke.com/sale/chaoyang/p1/
+            houseUrl = QString("https://%1.anjuke.com/sale/%2/p1/")
+                           .arg(cityPinyin)
+                           .arg(districtPinyin);
+        } else {
+            // 城市级URL：https://bj.anjuke.com/sale/p1/
+            houseUrl = QString("https://%1.anjuke.com/sale/p1/")
+                           .arg(cityPinyin);
+        }
 
-    // ========== 7. 访问安居客首页建立会话 ==========
-    emit appendLogSignal("🏠 第一步：先访问安居客首页建立会话...");
-    QString homeUrl = "https://www.anjuke.com/"; // 安居客首页
-    QWebEngineHttpRequest homeRequest(homeUrl);
-    QString homeUA = getRandomUA();
+        QString crawlScope = districtName.isEmpty() ? pureCityName : QString("%1-%2").arg(pureCityName, districtName);
+        emit appendLogSignal("🏙️  拼音映射：" + crawlScope + " → 城市拼音：" + cityPinyin + (districtPinyin.isEmpty() ? "" : " | 区域拼音：" + districtPinyin));
+        emit appendLogSignal("📌 待爬取房源页：" + houseUrl);
 
-    // 设置请求头
-    homeRequest.setHeader(QByteArray("User-Agent"), homeUA.toUtf8());
-    homeRequest.setHeader(QByteArray("Referer"), QByteArray(""));
-    homeRequest.setHeader(QByteArray("Accept"), QByteArray("text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7"));
-    homeRequest.setHeader(QByteArray("Accept-Encoding"), QByteArray("gzip, deflate, br"));
-    homeRequest.setHeader(QByteArray("Accept-Language"), QByteArray("zh-CN,zh;q=0.9,en;q=0.8,en-GB;q=0.7,en-US;q=0.6"));
-
-    // 携带Cookie
-    if (!cookieStr.isEmpty()) {
-        homeRequest.setHeader(QByteArray("Cookie"), cookieStr.toUtf8());
+        searchFrontier.enqueue(houseUrl, 0, crawlScope);
+        crawlScopes.append(crawlScope);
     }
 
-    // 启动首页加载
-    webPage->load(homeRequest);
-    isHomeLoadedForSearch = true;
-    pendingSearchKeyword = crawlScope;
-    currentCity = crawlScope;
-}
-
+    if (!searchFrontier.hasQueued()) {
+        emit appendLogSignal("❌ 没有可爬取的目标，终止爬取！");
+        emit crawlFinished(0, false);
+        return;
+    }
 
+    // ========== 6. 日志输出 ==========
+    const QString scopeText = crawlScopes.join("、");
+    emit appendLogSignal("=== 低风控模式：爬取「" + scopeText + "」二手房房源（每个目标最多" + QString::number(targetPageCount) + "页）===");
+    emit appendLogSignal(m_scheduler != nullptr
+                             ? QString("🧵 并发模式：%1个目标将由页面池并行加载").arg(searchFrontier.queuedCount())
+                             : QString("⚠️  风控提醒：单页串行模式，%1个目标依次加载").arg(searchFrontier.queuedCount()));
+    emit appendLogSignal("⚠️  请确保ke_cookies.txt中的Cookie是安居客登录后最新抓取的！");
+    emit appendLogSignal("————————————————");
 
+    // ========== 7. 访问安居客首页建立会话，之后开始爬取房源页 ==========
+    currentCity = scopeText;
+    searchFlow = runSearchFlow(true);
+}
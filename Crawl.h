@@ -8,13 +8,20 @@
 #include <QMap>
 #include <QList>
 #include <QStringList>
+#include <QWebEngineHttpRequest>
+#include <QElapsedTimer>
+#include <map>
 #include "MYSQL.h"
-
-// 关键修正1：避免循环包含 + 正确前向声明
-class MainWindow; // 前向声明 MainWindow（仅用指针，不包含头文件）
-namespace Ui { class MainWindow; } // 前向声明 UI 命名空间（替代 #include "ui_mainwindow.h"）
-
-#include "HouseData.h" // 包含房源数据结构体（必须在前面声明之后）
+#include "CrawlScheduler.h"
+#include "HouseExtractor.h"
+#include "CrawlFrontier.h"
+#include "UrlDedupStore.h"
+#include "PageArchive.h"
+#include "ListingPipeline.h"
+#include "HostRateLimiter.h"
+#include "CrawlTask.h"
+
+#include "HouseData.h" // 包含房源数据结构体
 #include "LLMClient.h"
 
 class Crawl : public QObject
@@ -23,33 +30,23 @@ class Crawl : public QObject
 private:
     // ===================== 核心成员变量（与实现匹配）=====================
     QWebEnginePage *webPage;
-    Ui::MainWindow* m_ui;          // 存储 UI 指针（仅用于信号传递，不直接操作）
-    MainWindow* m_mainWindow;      // 存储窗口实例（稳定接收者）
 
     // ===================== 爬取控制相关 =====================
-    QQueue<QString> urlQueue;
-    QQueue<QString> searchUrlQueue;
-    QSet<QString> crawledUrls;
-    QMap<QString, int> urlDepth;
+    CrawlFrontier urlFrontier;     // 普通页面队列（含深度），持久化在 frontier/anjuke_pages.*
+    CrawlFrontier searchFrontier;  // 房源页队列（标签为所属城市/区县），持久化在 frontier/anjuke_search.*
+    QString currentPageUrl;        // 正在加载的普通页面
     int currentPageCount = 0;      // 直接初始化（避免未初始化风险）
     int targetPageCount = 1;       // 直接初始化（默认爬1页）
 
     // ===================== 数据存储相关（关键修正4：删除全局变量，用类内成员）=====================
     QString cookieStr;
-    QList<HouseData> houseDataList; // 类内成员（替代全局变量，避免冲突）
-    QSet<QString> houseIdSet;       // 类内成员（替代全局变量，避免冲突）
     QString currentCity;
-    bool isHomeLoadedForSearch = false; // 直接初始化
-    QString pendingSearchKeyword;
 
     // ===================== 工具函数（私有）=====================
     QString generateRandomPvid();
     QString generateLogId();
     QString getRandomUA();
-    int getRandomInterval();
-
-    // 搜索任务标志位（直接初始化）
-    bool isProcessingSearchTask = false;
+    int getRandomInterval(const QString& url);
 
     //添加 LLMClient 成员变量（大模型客户端）
     LLMClient *m_llmClient;
@@ -62,31 +59,76 @@ private:
      QMap<QString, QMap<QString, QString>> getRegionCodeMap(); // 区域映射表
      QString regionToCode(const QString& cityName, const QString& regionName); // 区域转编码
 
-     // 分步加载状态枚举
-     enum LoadStep {
-         Step_LoadHome,    // 第一步：加载贝壳首页
-         Step_LoadCity,    // 第二步：加载城市房源页（仅区级需要）
-         Step_LoadTarget   // 第三步：加载目标房源页
-     };
-
-     QString cityHouseUrl;           // 城市级房源页URL（区级爬取时用）
-     bool isCityPageLoading; // 标记当前是否在加载城市页（新增）
-     bool isDistrictPageLoading; // 标记当前是否在加载区级页（新增）
-     int loadStep = 0;
+     // ===================== 爬取流程（协程）=====================
+     // 走到哪一步、正在加载哪个URL都是协程内的局部状态，不再需要首页/搜索/分步加载等标志位
+     CrawlTask searchFlow;   // 房源爬取：首页会话 → 逐页加载/等渲染/提取（调度器模式下只负责首页和派发）
+     CrawlTask pageFlow;     // 普通页面爬取（城市链接）
+     std::map<QString, CrawlTask> searchPages;   // 调度器模式：每个房源页一个流程，按页URL登记（含已结束待清理的）
+     CrawlTask runSearchFlow(bool visitHome);
+     CrawlTask runPageFlow();
+     CrawlTask runSearchPage(QString requestUrl);
+     void reportRiskPage(const QString& url);
+
+     // ===================== 并发调度相关 =====================
+     CrawlScheduler *m_scheduler = nullptr;   // 共享页面池调度器（为空时退回单页串行模式）
+     bool riskAborted = false;                // 本轮已触发风控：不再提交/重试房源页，直到重新开始或继续爬取
+
+     bool isRiskUrl(const QString& url) const;
+     QWebEngineHttpRequest buildHomeRequest();
+     QWebEngineHttpRequest buildSearchRequest(const QUrl& url);
+     void dispatchSearchJobs();
+     int runningSearchPages();
+     void finishSearchTask();
+
+     ExtractMode extractMode = ExtractMode::InPageJson;  // 房源页默认页面内提取，失败时回退整页HTML
+     PageArchive *m_archive = nullptr;    // 录制模式：抓到的房源页追加到归档（不归爬虫所有）
+     void archivePage(const QString& requestUrl, const QString& city, const CrawlResult& result);
+
+     // ===================== 分页 =====================
+     // 房源页在 searchFrontier 中的 depth 即页码-1；第N页抓到后立即排入第N+1页（调度器模式下与第N页的提取并行加载）
+     QSet<QString> exhaustedScopes;           // 已到末页或只剩往期已收录房源的目标，不再翻页
+     static QString pageUrl(const QString& url, int page);
+     void enqueueNextPage(const QString& url);
+     void onPageStored(const QString& url, int houseCount, int newCount);
+
+     // ===================== 提取流水线 =====================
+     // 提取/规范化在线程池、去重汇总在本线程、入库在专用写线程；本轮结果列表也在其中（listings.houses()）
+     // 增量重爬与近重复的指纹与 searchFrontier 放在一起：frontier/anjuke_search.pagefp、.housefp、.simhash
+     using Listings = ListingPipeline<HouseData>;
+     Listings listings{this};
+     static Listings::Extracted extractPage(const Listings::Page& page);  // 工作线程
 
 public:
-    // 构造函数（参数不变，保持与实现一致）
-    explicit Crawl(MainWindow *mainWindow, QWebEnginePage *webPage, Ui::MainWindow* ui);
+    // 构造函数：不依赖任何界面对象，桌面程序和无界面的 CrawlDaemon 共用（webPage为空时自建页面）
+    explicit Crawl(QWebEnginePage *webPage = nullptr, QObject *parent = nullptr);
     ~Crawl() override; // 关键修正2：删除 =default，手动实现析构函数（清理资源）
 
     // ===================== 核心函数声明（与实现一致）=====================
     QString cityToPinyin(const QString& cityName);
     QString getFirstLetter(int index);
-    void extractHouseData(const QString& html);
+    void extractHouseData(const QString& html, const QString& city = QString());
+    bool extractHouseJson(const QString& json, const QString& city = QString());
     void showHouseCompareResult();
 
     // 新增：启动房源爬取的接口（供 MainWindow 调用）
+    // city 支持用逗号/顿号分隔多个目标（如：北京-朝阳区,北京-海淀区,上海），配合调度器并行爬取
     void startHouseCrawl(const QString& city, int targetPages);
+
+    // 设置共享调度器：房源页交给页面池并发加载
+    void setScheduler(CrawlScheduler *scheduler);
+    void setExtractMode(ExtractMode mode);
+    // 录制：之后抓到的房源页都写入archive（nullptr 关闭录制）
+    void setArchive(PageArchive *archive);
+    // 回放：把归档中本站点的页面按原样送入提取与入库流程（无网络、无渲染等待），返回回放页数，失败返回-1
+    int replayArchive(PageArchive& archive);
+
+    // 继续上次中断（崩溃/风控/重启）的房源爬取任务，只加载尚未完成的房源页
+    bool hasUnfinishedCrawl() const { return searchFrontier.hasUnfinished(); }
+    void resumeHouseCrawl();
+    static const QString SITE_KEY;
+    static const QString RATE_HOST;         // 限速键（安居客各城市子域名共用）
+    static const QString LISTING_SELECTOR;  // 房源节点选择器（渲染就绪探测用）
+    static const int RENDER_TIMEOUT_MS;     // 房源页渲染探测超时上限
     // ===================== 静态常量声明（类内共享）=====================
     static const int REQUEST_INTERVAL;
     static const int MAX_DEPTH;
@@ -99,7 +141,9 @@ public:
     static const int MAX_PAGE_STAY_TIME;    // 每页最大停留25秒
 
     QQueue<QString> getSearchUrl(){
-        return searchUrlQueue;
+        QQueue<QString> queue;
+        for (const QString& url : searchFrontier.queuedUrls()) queue.enqueue(url);
+        return queue;
     }
 
     int getCurrentPage(){
@@ -109,14 +153,16 @@ signals:
     // 日志信号（用于主线程更新 UI）
     void appendLogSignal(const QString& log);
     void startCrawlSignal(const QString& city, int targetPages);
+    // 一次房源爬取结束（结果已展示/入库）；completed=false 表示有房源页未完成（风控/失败/无有效目标）
+    void crawlFinished(int houseCount, bool completed);
+    // 往期已收录的房源内容有变化（已提交更新入库）
+    void listingUpdated(const QString& houseUrl);
 
 private slots:
     void onInitFinishedLog();
 
     // ===================== 核心业务槽函数（与实现一致）=====================
-    void onPageLoadFinished(bool ok);
     void processNextUrl();
-    void processSearchUrl();
     void simulateHumanBehavior();
 
     // ===================== Cookie管理函数（与实现一致）=====================
@@ -0,0 +1,348 @@
+#include "CrawlFrontier.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QUrl>
+#include <QSet>
+
+const int CrawlFrontier::DEFAULT_MAX_ATTEMPTS = 3;
+const int CrawlFrontier::COMPACT_THRESHOLD = 512;
+
+// 日志记录（每行一条，字段以\t分隔，文本字段做百分号编码）：
+//   K <jobKey>                  新任务
+//   Q <depth> <tag> <url>       入队
+//   F <url>                     取出（在途，尝试次数+1）
+//   D <url>                     完成
+//   R <url>                     失败后重新入队
+//   U <url>                     中断后重新入队（退还本次尝试次数）
+//   X <url>                     超过最大尝试次数，放弃
+// 快照：K行 + 每个URL一行  S <state> <depth> <attempts> <tag> <url>
+
+CrawlFrontier::CrawlFrontier(int maxAttempts)
+    : maxAttempts(qMax(1, maxAttempts))
+{
+}
+
+CrawlFrontier::~CrawlFrontier()
+{
+    close();
+}
+
+QByteArray CrawlFrontier::encodeField(const QString& text)
+{
+    return QUrl::toPercentEncoding(text, ":/?&=#[]@!$'()*+,;~");
+}
+
+QString CrawlFrontier::decodeField(const QByteArray& field)
+{
+    return QUrl::fromPercentEncoding(field);
+}
+
+bool CrawlFrontier::open(const QString& filePrefix)
+{
+    close();
+    prefix = filePrefix;
+    entries.clear();
+    queue.clear();
+    currentJobKey.clear();
+    queuedTotal = inFlightTotal = doneTotal = failedTotal = recoveredTotal = 0;
+
+    QDir().mkpath(QFileInfo(prefix).absolutePath());
+
+    // 1. 快照 + 2. 追加日志重放
+    const QStringList sources = { prefix + ".snap", prefix + ".log" };
+    for (int i = 0; i < sources.size(); ++i) {
+        QFile file(sources[i]);
+        if (!file.exists() || !file.open(QIODevice::ReadOnly)) continue;
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            if (!line.endsWith('\n')) break;   // 崩溃时写了一半的最后一行，丢弃
+            line.chop(1);
+            if (!line.isEmpty()) applyRecord(line, i == 0);
+        }
+    }
+
+    // 3. 重建排队顺序：上次在途的URL排在最前面，其余按原顺序去重
+    QQueue<QString> rebuilt;
+    QSet<QString> seen;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->state == State::InFlight) {
+            setState(*it, State::Queued);
+            rebuilt.enqueue(it->url);
+            seen.insert(it->url);
+            recoveredTotal++;
+        }
+    }
+    for (const QString& url : queue) {
+        auto it = entries.constFind(url);
+        if (it != entries.constEnd() && it->state == State::Queued && !seen.contains(url)) {
+            rebuilt.enqueue(url);
+            seen.insert(url);
+        }
+    }
+    queue = rebuilt;
+
+    logFile.setFileName(prefix + ".log");
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    compact();
+    return true;
+}
+
+void CrawlFrontier::close()
+{
+    if (logFile.isOpen()) {
+        logFile.flush();
+        logFile.close();
+    }
+}
+
+void CrawlFrontier::reset(const QString& jobKey)
+{
+    entries.clear();
+    queue.clear();
+    queuedTotal = inFlightTotal = doneTotal = failedTotal = recoveredTotal = 0;
+    currentJobKey = jobKey;
+    if (logFile.isOpen()) {
+        compact();
+    }
+}
+
+void CrawlFrontier::applyRecord(const QByteArray& line, bool fromSnapshot)
+{
+    const QList<QByteArray> fields = line.split('\t');
+    const char type = fields[0].isEmpty() ? '\0' : fields[0].at(0);
+
+    if (type == 'K' && fields.size() == 2) {
+        if (!fromSnapshot) {
+            entries.clear();
+            queue.clear();
+            queuedTotal = inFlightTotal = doneTotal = failedTotal = 0;
+        }
+        currentJobKey = decodeField(fields[1]);
+        return;
+    }
+
+    if (type == 'S' && fromSnapshot && fields.size() == 6) {
+        Entry entry;
+        entry.state = static_cast<State>(fields[1].isEmpty() ? 'Q' : fields[1].at(0));
+        entry.depth = fields[2].toInt();
+        entry.attempts = fields[3].toInt();
+        entry.tag = decodeField(fields[4]);
+        entry.url = decodeField(fields[5]);
+        if (entries.contains(entry.url)) return;
+        entries.insert(entry.url, entry);
+        counterFor(entry.state)++;
+        if (entry.state == State::Queued) queue.enqueue(entry.url);
+        return;
+    }
+
+    if (type == 'Q' && fields.size() == 4) {
+        enqueue(decodeField(fields[3]), fields[1].toInt(), decodeField(fields[2]));
+        return;
+    }
+
+    if (fields.size() != 2) return;
+    auto it = entries.find(decodeField(fields[1]));
+    if (it == entries.end()) return;
+
+    switch (type) {
+    case 'F':
+        it->attempts++;
+        setState(*it, State::InFlight);
+        break;
+    case 'D':
+        setState(*it, State::Done);
+        break;
+    case 'U':
+        it->attempts = qMax(0, it->attempts - 1);
+        setState(*it, State::Queued);
+        queue.enqueue(it->url);
+        break;
+    case 'R':
+        setState(*it, State::Queued);
+        queue.enqueue(it->url);
+        break;
+    case 'X':
+        setState(*it, State::Failed);
+        break;
+    default:
+        break;
+    }
+}
+
+int& CrawlFrontier::counterFor(State state)
+{
+    switch (state) {
+    case State::Queued: return queuedTotal;
+    case State::InFlight: return inFlightTotal;
+    case State::Done: return doneTotal;
+    default: return failedTotal;
+    }
+}
+
+void CrawlFrontier::setState(Entry& entry, State state)
+{
+    counterFor(entry.state)--;
+    entry.state = state;
+    counterFor(entry.state)++;
+}
+
+void CrawlFrontier::appendLog(const QByteArray& record)
+{
+    if (!logFile.isOpen()) return;
+    logFile.write(record + '\n');
+    logFile.flush();
+    if (++logRecords >= COMPACT_THRESHOLD) {
+        compact();
+    }
+}
+
+// 重写快照并清空日志；快照先写临时文件再原子替换，任何时刻崩溃都能恢复到一致状态
+void CrawlFrontier::compact()
+{
+    QSaveFile snap(prefix + ".snap");
+    if (!snap.open(QIODevice::WriteOnly)) return;
+
+    snap.write("K\t" + encodeField(currentJobKey) + '\n');
+    auto writeEntry = [&snap](const Entry& entry) {
+        snap.write("S\t" + QByteArray(1, static_cast<char>(entry.state)) + '\t'
+                   + QByteArray::number(entry.depth) + '\t'
+                   + QByteArray::number(entry.attempts) + '\t'
+                   + encodeField(entry.tag) + '\t'
+                   + encodeField(entry.url) + '\n');
+    };
+    // 在途的排最前，其次按排队顺序，最后是已完成/已放弃的
+    for (const Entry& entry : entries) {
+        if (entry.state == State::InFlight) writeEntry(entry);
+    }
+    QSet<QString> written;
+    for (const QString& url : queue) {
+        auto it = entries.constFind(url);
+        if (it != entries.constEnd() && it->state == State::Queued && !written.contains(url)) {
+            writeEntry(*it);
+            written.insert(url);
+        }
+    }
+    for (const Entry& entry : entries) {
+        if (entry.state == State::Done || entry.state == State::Failed) writeEntry(entry);
+    }
+    if (!snap.commit()) return;
+
+    logFile.resize(0);
+    logRecords = 0;
+}
+
+bool CrawlFrontier::enqueue(const QString& url, int depth, const QString& tag)
+{
+    if (url.isEmpty() || entries.contains(url)) return false;
+
+    Entry entry;
+    entry.url = url;
+    entry.depth = depth;
+    entry.tag = tag;
+    entries.insert(url, entry);
+    queuedTotal++;
+    queue.enqueue(url);
+    appendLog("Q\t" + QByteArray::number(depth) + '\t' + encodeField(tag) + '\t' + encodeField(url));
+    return true;
+}
+
+QString CrawlFrontier::takeNext()
+{
+    while (!queue.isEmpty()) {
+        const QString url = queue.dequeue();
+        auto it = entries.find(url);
+        if (it == entries.end() || it->state != State::Queued) continue;
+        it->attempts++;
+        setState(*it, State::InFlight);
+        appendLog("F\t" + encodeField(url));
+        return url;
+    }
+    return QString();
+}
+
+void CrawlFrontier::markDone(const QString& url)
+{
+    auto it = entries.find(url);
+    if (it == entries.end() || it->state == State::Done) return;
+    setState(*it, State::Done);
+    appendLog("D\t" + encodeField(url));
+}
+
+bool CrawlFrontier::markFailed(const QString& url, bool countAttempt)
+{
+    auto it = entries.find(url);
+    if (it == entries.end() || it->state != State::InFlight) return false;
+
+    if (!countAttempt) {
+        it->attempts = qMax(0, it->attempts - 1);
+        setState(*it, State::Queued);
+        queue.enqueue(url);
+        appendLog("U\t" + encodeField(url));
+        return true;
+    }
+    if (it->attempts >= maxAttempts) {
+        setState(*it, State::Failed);
+        appendLog("X\t" + encodeField(url));
+        return false;
+    }
+    setState(*it, State::Queued);
+    queue.enqueue(url);
+    appendLog("R\t" + encodeField(url));
+    return true;
+}
+
+bool CrawlFrontier::isDone(const QString& url) const
+{
+    auto it = entries.constFind(url);
+    return it != entries.constEnd() && it->state == State::Done;
+}
+
+bool CrawlFrontier::isQueued(const QString& url) const
+{
+    auto it = entries.constFind(url);
+    return it != entries.constEnd() && it->state == State::Queued;
+}
+
+int CrawlFrontier::depth(const QString& url) const
+{
+    auto it = entries.constFind(url);
+    return it == entries.constEnd() ? 0 : it->depth;
+}
+
+int CrawlFrontier::attempts(const QString& url) const
+{
+    auto it = entries.constFind(url);
+    return it == entries.constEnd() ? 0 : it->attempts;
+}
+
+QString CrawlFrontier::tag(const QString& url) const
+{
+    auto it = entries.constFind(url);
+    return it == entries.constEnd() ? QString() : it->tag;
+}
+
+QStringList CrawlFrontier::queuedUrls() const
+{
+    QStringList urls;
+    QSet<QString> seen;
+    for (const QString& url : queue) {
+        auto it = entries.constFind(url);
+        if (it != entries.constEnd() && it->state == State::Queued && !seen.contains(url)) {
+            urls.append(url);
+            seen.insert(url);
+        }
+    }
+    return urls;
+}
+
+QStringList CrawlFrontier::tags() const
+{
+    QStringList result;
+    for (const Entry& entry : entries) {
+        if (!entry.tag.isEmpty() && !result.contains(entry.tag)) result.append(entry.tag);
+    }
+    return result;
+}
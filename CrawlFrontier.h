@@ -0,0 +1,101 @@
+#ifndef CRAWLFRONTIER_H
+#define CRAWLFRONTIER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QQueue>
+#include <QFile>
+
+/**
+ * @brief 可持久化、崩溃可恢复的爬取队列（frontier）
+ *
+ * 替代内存里的 urlQueue / searchUrlQueue / urlDepth：每个URL记录状态（排队/在途/完成/放弃）、
+ * 深度、尝试次数和一个标签（如房源页所属城市）。
+ *
+ * 磁盘格式：<prefix>.snap 为压缩快照，<prefix>.log 为追加日志，每次状态变化写一行并立即flush。
+ * 打开时先读快照再重放日志，上次崩溃时的在途URL重新排到队首，因此重启后从中断处继续。
+ * 日志超过 COMPACT_THRESHOLD 行时重写快照（QSaveFile原子替换）并清空日志。
+ */
+class CrawlFrontier
+{
+public:
+    enum class State : char {
+        Queued = 'Q',
+        InFlight = 'F',
+        Done = 'D',
+        Failed = 'X'    // 超过最大尝试次数，不再重试
+    };
+
+    struct Entry {
+        QString url;
+        int depth = 0;
+        int attempts = 0;
+        State state = State::Queued;
+        QString tag;
+    };
+
+    explicit CrawlFrontier(int maxAttempts = DEFAULT_MAX_ATTEMPTS);
+    ~CrawlFrontier();
+
+    // 打开（不存在则新建）磁盘文件并恢复状态；filePrefix 如 "frontier/anjuke_search"
+    bool open(const QString& filePrefix);
+    void close();
+    bool isOpen() const { return logFile.isOpen(); }
+
+    // 开始新任务：清空内存与磁盘记录，jobKey用于下次启动时判断是否为同一任务
+    void reset(const QString& jobKey = QString());
+    QString jobKey() const { return currentJobKey; }
+
+    // 入队（已知URL返回false，不会重复入队）
+    bool enqueue(const QString& url, int depth = 0, const QString& tag = QString());
+    // 取出下一个排队URL并标记为在途（尝试次数+1）；队列为空时返回空串
+    QString takeNext();
+    void markDone(const QString& url);
+    // 失败：未超过最大尝试次数时重新入队并返回true；countAttempt=false 时不消耗尝试次数（如风控中断）
+    bool markFailed(const QString& url, bool countAttempt = true);
+
+    bool contains(const QString& url) const { return entries.contains(url); }
+    bool isDone(const QString& url) const;
+    bool isQueued(const QString& url) const;
+    int depth(const QString& url) const;
+    int attempts(const QString& url) const;
+    QString tag(const QString& url) const;
+
+    bool hasQueued() const { return queuedTotal > 0; }
+    bool hasUnfinished() const { return queuedTotal > 0 || inFlightTotal > 0; }
+    int queuedCount() const { return queuedTotal; }
+    int inFlightCount() const { return inFlightTotal; }
+    int doneCount() const { return doneTotal; }
+    int failedCount() const { return failedTotal; }
+    int recoveredCount() const { return recoveredTotal; }  // open()时从在途恢复为排队的URL数
+    QStringList queuedUrls() const;
+    QStringList tags() const;
+
+    static const int DEFAULT_MAX_ATTEMPTS;
+    static const int COMPACT_THRESHOLD;
+
+private:
+    int& counterFor(State state);
+    void setState(Entry& entry, State state);
+    void appendLog(const QByteArray& record);
+    void applyRecord(const QByteArray& line, bool fromSnapshot);
+    void compact();
+    static QByteArray encodeField(const QString& text);
+    static QString decodeField(const QByteArray& field);
+
+    QHash<QString, Entry> entries;
+    QQueue<QString> queue;          // 排队顺序（惰性删除：出队时跳过非Queued状态的URL）
+    QString currentJobKey;
+    QString prefix;
+    QFile logFile;
+    int maxAttempts;
+    int logRecords = 0;
+    int queuedTotal = 0;
+    int inFlightTotal = 0;
+    int doneTotal = 0;
+    int failedTotal = 0;
+    int recoveredTotal = 0;
+};
+
+#endif // CRAWLFRONTIER_H
@@ -0,0 +1,354 @@
+#ifndef CRAWLPIPELINE_H
+#define CRAWLPIPELINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QQueue>
+#include <QSemaphore>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "BoundedQueue.h"
+
+/**
+ * @brief 分阶段爬取流水线：抓取 → 提取/规范化 → 结果汇总 → 入库
+ *
+ * - 抓取：仍在 WebEngine 所在的界面线程，拿到HTML/JSON后 submit()；
+ * - 提取/规范化：工作线程池（extract 回调必须是纯函数，不能访问爬虫成员）；
+ * - 汇总：提取结果投递回 owner 所在线程（去重、加入结果列表、写日志）；
+ * - 入库：专用写线程，写线程在自己的线程里建立数据库连接（QSqlDatabase 连接不能跨线程使用）；
+ *   写入成功的记录再投递回 owner 线程（persisted 回调），调用方在这里记录去重/内容指纹。
+ *
+ * 阶段之间用 BoundedQueue 相连，每个队列配一个信号量计数已入队的条目，空闲的工作线程/写线程阻塞在
+ * 信号量上，不轮询。队列满时界面线程不阻塞，放入本地积压队列并定时重试，
+ * saturated() 为真时调用方应暂停提交新的抓取任务。
+ * 每个阶段统计队列深度、处理量以及从入队到处理完成的平均/最大延迟。
+ */
+template <typename Record>
+class CrawlPipeline
+{
+public:
+    struct Page {
+        QString url;
+        QString city;
+        QString html;
+        QString json;
+        quint64 previousHash = 0;       // 上次记录的页面内容指纹（owner线程查好传入），0 表示没有记录
+        qint64 enqueuedNs = 0;
+    };
+
+    struct Extracted {
+        QString url;
+        QString city;
+        QList<Record> records;
+        bool fromJson = false;          // true：由页面内提取的JSON得到
+        bool jsonRejected = false;      // JSON无效或没有房源（且没有HTML可回退）
+        int inputChars = 0;
+        qint64 parseMs = 0;
+        QStringList notes;              // 需要写到日志里的提示（如回退到正则提取）
+        quint64 contentHash = 0;        // 房源页内容指纹（房源列表区域源码或页面内提取JSON，由extractFn计算），0 表示未计算
+        bool unchanged = false;         // 指纹与 previousHash 相同：未解析，records 为空
+    };
+
+    enum class PersistOp {
+        Insert,                         // 新房源：插入新记录
+        Update                          // 内容有变化的已收录房源：更新原记录
+    };
+
+    struct StageMetrics {
+        QString name;
+        int depth = 0;                  // 当前排队数（含界面线程积压）
+        int capacity = 0;
+        quint64 processed = 0;
+        double avgLatencyMs = 0;
+        double maxLatencyMs = 0;
+    };
+
+    using ExtractFn = std::function<Extracted(const Page&)>;        // 工作线程
+    using NormalizeFn = std::function<void(Record&)>;               // 工作线程
+    using DeliverFn = std::function<void(const Extracted&)>;        // owner线程
+    using PersistFn = std::function<bool(const Record&, PersistOp)>; // 写线程，返回是否写入成功
+    using PersistedFn = std::function<void(const Record&, PersistOp)>; // owner线程，仅写入成功的记录
+    using WriterHook = std::function<void()>;                       // 写线程启动/退出时调用
+
+    CrawlPipeline(QObject *owner, int workerCount, int queueCapacity)
+        : owner(owner)
+        , workerCount(qMax(1, workerCount))
+        , extractQueue(static_cast<size_t>(queueCapacity))
+        , persistQueue(static_cast<size_t>(queueCapacity) * 16)
+    {
+    }
+
+    ~CrawlPipeline()
+    {
+        stop();
+    }
+
+    CrawlPipeline(const CrawlPipeline&) = delete;
+    CrawlPipeline& operator=(const CrawlPipeline&) = delete;
+
+    void start(ExtractFn extract, NormalizeFn normalize, DeliverFn deliver, PersistFn persist,
+               PersistedFn persisted = PersistedFn(),
+               WriterHook writerSetup = WriterHook(), WriterHook writerTeardown = WriterHook())
+    {
+        if (running) return;
+        extractFn = extract;
+        normalizeFn = normalize;
+        deliverFn = deliver;
+        persistFn = persist;
+        persistedFn = persisted;
+        stopping.store(false);
+        running = true;
+
+        for (int i = 0; i < workerCount; ++i) {
+            QThread *thread = QThread::create([this]() { workerLoop(); });
+            thread->setObjectName(QString("CrawlExtract-%1").arg(i));
+            thread->start();
+            workers.push_back(thread);
+        }
+        writer = QThread::create([this, writerSetup, writerTeardown]() {
+            if (writerSetup) writerSetup();
+            writerLoop();
+            if (writerTeardown) writerTeardown();
+        });
+        writer->setObjectName("CrawlWriter");
+        writer->start();
+
+        retryTimer = new QTimer(owner);
+        retryTimer->setInterval(RETRY_INTERVAL_MS);
+        QObject::connect(retryTimer, &QTimer::timeout, owner, [this]() { flushBacklog(); });
+    }
+
+    // 排空所有队列后停止工作线程与写线程（owner线程调用）
+    void stop()
+    {
+        if (!running) return;
+        flushBacklog();
+        while (!pageBacklog.isEmpty() || !recordBacklog.isEmpty()) {
+            QThread::msleep(5);
+            flushBacklog();
+        }
+        // 每个线程多发一个许可：取到许可却发现队列已空且正在停止的线程就此退出
+        stopping.store(true);
+        pagesReady.release(static_cast<int>(workers.size()));
+        for (QThread *thread : workers) {
+            thread->wait();
+            delete thread;
+        }
+        workers.clear();
+        recordsReady.release();
+        writer->wait();
+        delete writer;
+        writer = nullptr;
+        delete retryTimer;
+        retryTimer = nullptr;
+        running = false;
+    }
+
+    bool isRunning() const { return running; }
+
+    // 提交抓到的页面（owner线程）；提取队列满时先积压在本地，返回false
+    bool submit(Page page)
+    {
+        page.enqueuedNs = nowNs();
+        inFlightPages++;
+        if (pageBacklog.isEmpty() && extractQueue.tryPush(std::move(page))) {
+            pagesReady.release();
+            return true;
+        }
+        pageBacklog.enqueue(page);
+        retryTimer->start();
+        return false;
+    }
+
+    // 交给写线程入库（owner线程）
+    bool persist(Record record, PersistOp op = PersistOp::Insert)
+    {
+        PersistItem item{std::move(record), op, nowNs()};
+        if (recordBacklog.isEmpty() && persistQueue.tryPush(std::move(item))) {
+            recordsReady.release();
+            return true;
+        }
+        recordBacklog.enqueue(item);
+        retryTimer->start();
+        return false;
+    }
+
+    // 提取阶段（含积压）已满：调用方应暂停提交新的抓取任务
+    bool saturated() const
+    {
+        return !pageBacklog.isEmpty() || extractQueue.depth() >= extractQueue.capacity();
+    }
+
+    // 已提交但结果尚未投递回owner线程的页面数
+    int pendingPages() const { return inFlightPages; }
+
+    QList<StageMetrics> metrics() const
+    {
+        StageMetrics extract = extractCounters.snapshot("提取");
+        extract.depth = static_cast<int>(extractQueue.depth()) + pageBacklog.size();
+        extract.capacity = static_cast<int>(extractQueue.capacity());
+        StageMetrics store = persistCounters.snapshot("入库");
+        store.depth = static_cast<int>(persistQueue.depth()) + recordBacklog.size();
+        store.capacity = static_cast<int>(persistQueue.capacity());
+        return {extract, store};
+    }
+
+    // 写线程写入失败的记录数
+    quint64 persistFailures() const { return persistFailed.load(std::memory_order_relaxed); }
+
+    QString metricsSummary() const
+    {
+        QStringList parts;
+        for (const StageMetrics& m : metrics()) {
+            parts.append(QString("%1：排队%2/%3，已处理%4，平均%5ms，最大%6ms")
+                             .arg(m.name).arg(m.depth).arg(m.capacity).arg(m.processed)
+                             .arg(QString::number(m.avgLatencyMs, 'f', 1))
+                             .arg(QString::number(m.maxLatencyMs, 'f', 1)));
+        }
+        QString summary = QString("📈 流水线（%1个提取线程）| %2").arg(workerCount).arg(parts.join(" | "));
+        if (persistFailures() > 0) {
+            summary += QString(" | ⚠️ 入库失败%1条（未记录指纹，下次运行重试）").arg(persistFailures());
+        }
+        return summary;
+    }
+
+    static const int RETRY_INTERVAL_MS = 20;
+
+private:
+    struct PersistItem {
+        Record record;
+        PersistOp op = PersistOp::Insert;
+        qint64 enqueuedNs = 0;
+    };
+
+    struct Counters {
+        std::atomic<quint64> processed{0};
+        std::atomic<qint64> totalNs{0};
+        std::atomic<qint64> maxNs{0};
+
+        void record(qint64 latencyNs)
+        {
+            processed.fetch_add(1, std::memory_order_relaxed);
+            totalNs.fetch_add(latencyNs, std::memory_order_relaxed);
+            qint64 prev = maxNs.load(std::memory_order_relaxed);
+            while (latencyNs > prev && !maxNs.compare_exchange_weak(prev, latencyNs, std::memory_order_relaxed)) {
+            }
+        }
+
+        StageMetrics snapshot(const QString& name) const
+        {
+            StageMetrics m;
+            m.name = name;
+            m.processed = processed.load(std::memory_order_relaxed);
+            m.avgLatencyMs = m.processed == 0 ? 0 : totalNs.load(std::memory_order_relaxed) / 1e6 / m.processed;
+            m.maxLatencyMs = maxNs.load(std::memory_order_relaxed) / 1e6;
+            return m;
+        }
+    };
+
+    static qint64 nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 取到许可后出队：许可对应的条目已经写入，但排在它前面、已占位还没写完的条目会让 tryPop 暂时失败，
+    // 让出时间片重试即可。返回false表示正在停止且队列已空
+    template <typename T>
+    bool take(BoundedQueue<T>& queue, QSemaphore& ready, T& out)
+    {
+        ready.acquire();
+        while (!queue.tryPop(out)) {
+            if (stopping.load() && queue.depth() == 0) return false;
+            QThread::yieldCurrentThread();
+        }
+        return true;
+    }
+
+    void flushBacklog()
+    {
+        while (!pageBacklog.isEmpty()) {
+            Page page = pageBacklog.head();
+            if (!extractQueue.tryPush(std::move(page))) break;
+            pagesReady.release();
+            pageBacklog.dequeue();
+        }
+        while (!recordBacklog.isEmpty()) {
+            PersistItem item = recordBacklog.head();
+            if (!persistQueue.tryPush(std::move(item))) break;
+            recordsReady.release();
+            recordBacklog.dequeue();
+        }
+        if (pageBacklog.isEmpty() && recordBacklog.isEmpty() && retryTimer != nullptr) {
+            retryTimer->stop();
+        }
+    }
+
+    void workerLoop()
+    {
+        Page page;
+        while (take(extractQueue, pagesReady, page)) {
+            Extracted result = extractFn(page);
+            if (normalizeFn) {
+                for (Record& record : result.records) normalizeFn(record);
+            }
+            extractCounters.record(nowNs() - page.enqueuedNs);
+
+            // 结果回到owner线程汇总；owner已销毁时事件随之丢弃
+            QMetaObject::invokeMethod(owner, [this, result]() {
+                inFlightPages--;
+                if (deliverFn) deliverFn(result);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    void writerLoop()
+    {
+        // 写线程的停止许可在提取线程全部退出后才发出，此时队列不会再增长，排空即可结束
+        PersistItem item;
+        while (take(persistQueue, recordsReady, item)) {
+            const bool ok = !persistFn || persistFn(item.record, item.op);
+            persistCounters.record(nowNs() - item.enqueuedNs);
+            if (!ok) {
+                persistFailed.fetch_add(1, std::memory_order_relaxed);
+            } else if (persistedFn) {
+                // owner已销毁时事件随之丢弃
+                QMetaObject::invokeMethod(owner, [this, record = item.record, op = item.op]() {
+                    persistedFn(record, op);
+                }, Qt::QueuedConnection);
+            }
+        }
+    }
+
+    QObject *owner;                     // 汇总阶段所在对象（通常是爬虫本身，流水线是它的成员）
+    int workerCount;
+    BoundedQueue<Page> extractQueue;
+    BoundedQueue<PersistItem> persistQueue;
+    QSemaphore pagesReady;              // 已入队的页面数（另加停止时发给各提取线程的许可）
+    QSemaphore recordsReady;            // 已入队的记录数（另加停止时发给写线程的许可）
+    QQueue<Page> pageBacklog;           // 仅owner线程访问
+    QQueue<PersistItem> recordBacklog;  // 仅owner线程访问
+    QTimer *retryTimer = nullptr;
+    std::vector<QThread*> workers;
+    QThread *writer = nullptr;
+    std::atomic<bool> stopping{false};
+    bool running = false;
+    int inFlightPages = 0;              // 仅owner线程访问
+
+    ExtractFn extractFn;
+    NormalizeFn normalizeFn;
+    DeliverFn deliverFn;
+    PersistFn persistFn;
+    PersistedFn persistedFn;
+    Counters extractCounters;
+    Counters persistCounters;
+    std::atomic<quint64> persistFailed{0};
+};
+
+#endif // CRAWLPIPELINE_H
@@ -0,0 +1,187 @@
+#include "CrawlRequestInterceptor.h"
+#include <QUrl>
+
+using ResourceType = QWebEngineUrlRequestInfo::ResourceType;
+
+ResourcePolicy& ResourcePolicy::block(ResourceType type)
+{
+    if (static_cast<int>(type) < 64) {
+        blockedTypes |= (1ULL << static_cast<int>(type));
+    }
+    return *this;
+}
+
+bool ResourcePolicy::blocks(ResourceType type) const
+{
+    const int bit = static_cast<int>(type);
+    return bit < 64 && (blockedTypes & (1ULL << bit)) != 0;
+}
+
+ResourcePolicy ResourcePolicy::listingDefaults()
+{
+    ResourcePolicy policy;
+    policy.block(QWebEngineUrlRequestInfo::ResourceTypeImage)
+          .block(QWebEngineUrlRequestInfo::ResourceTypeFontResource)
+          .block(QWebEngineUrlRequestInfo::ResourceTypeMedia)
+          .block(QWebEngineUrlRequestInfo::ResourceTypeObject)
+          .block(QWebEngineUrlRequestInfo::ResourceTypeFavicon)
+          .block(QWebEngineUrlRequestInfo::ResourceTypePrefetch)
+          .block(QWebEngineUrlRequestInfo::ResourceTypePing)
+          .block(QWebEngineUrlRequestInfo::ResourceTypeCspReport)
+          .block(QWebEngineUrlRequestInfo::ResourceTypePluginResource);
+    policy.denyHosts = {
+        "google-analytics.com", "googletagmanager.com", "doubleclick.net", "hm.baidu.com",
+        "cnzz.com", "growingio.com", "sensorsdata.cn", "mmstat.com", "tanx.com", "umeng.com"
+    };
+    policy.estimatedPageBudget = 3 * 1024 * 1024;
+    return policy;
+}
+
+CrawlRequestInterceptor* CrawlRequestInterceptor::instance()
+{
+    static CrawlRequestInterceptor *interceptor = nullptr;
+    if (interceptor == nullptr) {
+        // 爬虫页面与调度器池内页面都用默认Profile
+        QWebEngineProfile *profile = QWebEngineProfile::defaultProfile();
+        interceptor = new CrawlRequestInterceptor(profile);
+        profile->setUrlRequestInterceptor(interceptor);
+    }
+    return interceptor;
+}
+
+CrawlRequestInterceptor::CrawlRequestInterceptor(QObject *parent)
+    : QWebEngineUrlRequestInterceptor(parent)
+{
+}
+
+void CrawlRequestInterceptor::setSitePolicy(const QString& site, const QStringList& pageHosts, const ResourcePolicy& policy)
+{
+    SiteEntry entry;
+    entry.pageHosts = pageHosts;
+    entry.policy = policy;
+    sites.insert(site, entry);
+}
+
+bool CrawlRequestInterceptor::hostMatches(const QString& host, const QStringList& suffixes)
+{
+    for (const QString& suffix : suffixes) {
+        if (host == suffix || host.endsWith('.' + suffix)) return true;
+    }
+    return false;
+}
+
+const CrawlRequestInterceptor::SiteEntry* CrawlRequestInterceptor::siteFor(const QUrl& firstPartyUrl, QString& site) const
+{
+    const QString host = firstPartyUrl.host().toLower();
+    if (host.isEmpty()) return nullptr;
+    for (auto it = sites.constBegin(); it != sites.constEnd(); ++it) {
+        if (hostMatches(host, it->pageHosts)) {
+            site = it.key();
+            return &it.value();
+        }
+    }
+    return nullptr;
+}
+
+// 各类资源的典型传输大小（字节，经验值而非实测），用于估算节省量和页面预算
+qint64 CrawlRequestInterceptor::estimatedSize(ResourceType type)
+{
+    switch (type) {
+    case QWebEngineUrlRequestInfo::ResourceTypeImage:        return 60 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeFontResource: return 45 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeMedia:        return 800 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeScript:       return 40 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:   return 25 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:     return 80 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypePrefetch:     return 30 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeXhr:          return 5 * 1024;
+    case QWebEngineUrlRequestInfo::ResourceTypeFavicon:
+    case QWebEngineUrlRequestInfo::ResourceTypePing:
+    case QWebEngineUrlRequestInfo::ResourceTypeCspReport:    return 1024;
+    default:                                                 return 10 * 1024;
+    }
+}
+
+QString CrawlRequestInterceptor::typeName(int type)
+{
+    switch (type) {
+    case QWebEngineUrlRequestInfo::ResourceTypeImage:        return "图片";
+    case QWebEngineUrlRequestInfo::ResourceTypeFontResource: return "字体";
+    case QWebEngineUrlRequestInfo::ResourceTypeMedia:        return "音视频";
+    case QWebEngineUrlRequestInfo::ResourceTypeScript:       return "脚本";
+    case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:   return "样式";
+    case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:     return "子框架";
+    case QWebEngineUrlRequestInfo::ResourceTypeXhr:          return "接口";
+    case QWebEngineUrlRequestInfo::ResourceTypePing:         return "上报";
+    case QWebEngineUrlRequestInfo::ResourceTypeFavicon:      return "图标";
+    case QWebEngineUrlRequestInfo::ResourceTypePrefetch:     return "预取";
+    default:                                                 return "其他";
+    }
+}
+
+void CrawlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo &info)
+{
+    const ResourceType type = info.resourceType();
+    const bool isMainFrame = type == QWebEngineUrlRequestInfo::ResourceTypeMainFrame;
+    const QUrl pageUrl = isMainFrame ? info.requestUrl() : info.firstPartyUrl();
+
+    QString site;
+    const SiteEntry *entry = siteFor(pageUrl, site);
+    if (entry == nullptr) return;
+
+    Stats& stats = siteStats[site];
+    const QString pageKey = pageUrl.toString(QUrl::RemoveFragment);
+    if (isMainFrame) {
+        // 新的顶层加载：重新计算该页预算（记录过多时整体清空，避免长时间运行后膨胀）
+        if (pageEstimatedBytes.size() > 1024) pageEstimatedBytes.clear();
+        pageEstimatedBytes.insert(pageKey, 0);
+        stats.allowed++;
+        return;
+    }
+
+    const ResourcePolicy& policy = entry->policy;
+    const QString host = info.requestUrl().host().toLower();
+    const qint64 size = estimatedSize(type);
+    bool block = policy.blocks(type)
+                 || hostMatches(host, policy.denyHosts)
+                 || (!policy.allowHosts.isEmpty() && !hostMatches(host, policy.allowHosts));
+
+    if (!block && policy.estimatedPageBudget > 0) {
+        // 预算用完后仍放行脚本和接口，房源列表依赖它们渲染
+        qint64& used = pageEstimatedBytes[pageKey];
+        const bool essential = type == QWebEngineUrlRequestInfo::ResourceTypeScript
+                               || type == QWebEngineUrlRequestInfo::ResourceTypeXhr;
+        if (!essential && used + size > policy.estimatedPageBudget) {
+            block = true;
+        } else {
+            used += size;
+        }
+    }
+
+    if (block) {
+        info.block(true);
+        stats.blocked++;
+        stats.estimatedBytesSaved += size;
+        stats.blockedByType[static_cast<int>(type)]++;
+    } else {
+        stats.allowed++;
+    }
+}
+
+void CrawlRequestInterceptor::resetStats(const QString& site)
+{
+    siteStats.remove(site);
+}
+
+QString CrawlRequestInterceptor::summary(const QString& site) const
+{
+    const Stats stats = siteStats.value(site);
+    QStringList parts;
+    for (auto it = stats.blockedByType.constBegin(); it != stats.blockedByType.constEnd(); ++it) {
+        parts.append(QString("%1×%2").arg(typeName(it.key())).arg(it.value()));
+    }
+    return QString("🛡️ 资源拦截[%1]：放行%2个请求，拦截%3个（%4），按典型大小估算约节省%5 MB（非实测）")
+        .arg(site).arg(stats.allowed).arg(stats.blocked)
+        .arg(parts.isEmpty() ? QString("无") : parts.join("、"))
+        .arg(QString::number(stats.estimatedBytesSaved / (1024.0 * 1024.0), 'f', 1));
+}
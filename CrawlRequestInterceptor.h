@@ -0,0 +1,76 @@
+#ifndef CRAWLREQUESTINTERCEPTOR_H
+#define CRAWLREQUESTINTERCEPTOR_H
+
+#include <QWebEngineUrlRequestInterceptor>
+#include <QWebEngineUrlRequestInfo>
+#include <QWebEngineProfile>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+
+// 站点资源策略：爬取时只需要HTML和渲染房源列表的脚本/接口，其余子资源按策略拦截
+struct ResourcePolicy {
+    quint64 blockedTypes = 0;           // 按资源类型拦截（位掩码，见 block()）
+    QStringList allowHosts;             // 非空时，子资源只放行这些域名（后缀匹配）
+    QStringList denyHosts;              // 始终拦截的域名（统计、广告等，后缀匹配）
+    // 单页子资源预算（估算字节，非实测）：每放行一个子资源按其类型的典型大小计入，
+    // 超出后只放行脚本/接口请求；实际相当于按类型加权的请求数上限。0=不限
+    qint64 estimatedPageBudget = 0;
+
+    ResourcePolicy& block(QWebEngineUrlRequestInfo::ResourceType type);
+    bool blocks(QWebEngineUrlRequestInfo::ResourceType type) const;
+
+    // 列表页默认策略：拦截图片、字体、音视频、图标、预取、上报，以及常见统计/广告域名
+    static ResourcePolicy listingDefaults();
+};
+
+/**
+ * @brief 爬虫页面的请求拦截器（安装在页面所属Profile上，所有爬虫页面共用）
+ *
+ * 按顶层页面（firstPartyUrl）的域名找到对应站点的策略；不属于任何站点的页面不受影响。
+ * 拦截器只能看到请求、看不到响应，被拦截请求的真实体积无从得知：页面预算与节省量都按
+ * 资源类型的典型大小估算（estimatedSize），字段名与日志中都标明为估算，不能当作实测流量。
+ * Qt6 中 interceptRequest 在UI线程调用，统计数据无需加锁。
+ */
+class CrawlRequestInterceptor : public QWebEngineUrlRequestInterceptor
+{
+    Q_OBJECT
+public:
+    struct Stats {
+        int allowed = 0;
+        int blocked = 0;
+        qint64 estimatedBytesSaved = 0; // 被拦截请求按类型典型大小累加的估算值，不是实测流量
+        QMap<int, int> blockedByType;   // ResourceType → 拦截次数
+    };
+
+    // 取得（必要时创建并安装）默认Profile上的拦截器
+    static CrawlRequestInterceptor* instance();
+
+    explicit CrawlRequestInterceptor(QObject *parent = nullptr);
+
+    // pageHosts：该站点顶层页面的域名后缀（如 "anjuke.com"）
+    void setSitePolicy(const QString& site, const QStringList& pageHosts, const ResourcePolicy& policy);
+
+    void interceptRequest(QWebEngineUrlRequestInfo &info) override;
+
+    Stats stats(const QString& site) const { return siteStats.value(site); }
+    void resetStats(const QString& site);
+    QString summary(const QString& site) const;
+
+private:
+    struct SiteEntry {
+        QStringList pageHosts;
+        ResourcePolicy policy;
+    };
+
+    const SiteEntry* siteFor(const QUrl& firstPartyUrl, QString& site) const;
+    static bool hostMatches(const QString& host, const QStringList& suffixes);
+    static qint64 estimatedSize(QWebEngineUrlRequestInfo::ResourceType type);   // 典型大小，非实测
+    static QString typeName(int type);
+
+    QMap<QString, SiteEntry> sites;
+    QHash<QString, Stats> siteStats;
+    QHash<QString, qint64> pageEstimatedBytes;   // 顶层页面URL → 已放行子资源的估算字节数
+};
+
+#endif // CRAWLREQUESTINTERCEPTOR_H
@@ -0,0 +1,298 @@
+#include "CrawlScheduler.h"
+#include <QPointer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "PageReadyProbe.h"
+#include "HostRateLimiter.h"
+
+const int CrawlScheduler::DEFAULT_POOL_SIZE = 2;
+const int CrawlScheduler::LOAD_TIMEOUT_MS = 60000;
+
+CrawlScheduler::CrawlScheduler(QObject *parent)
+    : QObject(parent)
+{
+    rateTimer = new QTimer(this);
+    rateTimer->setSingleShot(true);
+    connect(rateTimer, &QTimer::timeout, this, &CrawlScheduler::scheduleDispatch);
+}
+
+CrawlScheduler::~CrawlScheduler()
+{
+    // 页面和定时器都以调度器为父对象，这里只释放槽位结构体
+    for (SiteState& state : sites) {
+        qDeleteAll(state.pages);
+        state.pages.clear();
+    }
+}
+
+CrawlScheduler::SiteState& CrawlScheduler::siteState(const QString& site)
+{
+    SiteState& state = sites[site];
+    if (state.poolSize <= 0) {
+        state.poolSize = DEFAULT_POOL_SIZE;
+        state.maxConcurrent = DEFAULT_POOL_SIZE;
+    }
+    return state;
+}
+
+void CrawlScheduler::configureSite(const QString& site, int poolSize, int maxConcurrent, PageSetup setup)
+{
+    SiteState& state = sites[site];
+    state.poolSize = qMax(1, poolSize);
+    state.maxConcurrent = qBound(1, maxConcurrent, state.poolSize);
+    state.setup = setup;
+    emit appendLogSignal(QString("🧵 调度器：站点「%1」页面池=%2，并发上限=%3")
+                             .arg(site).arg(state.poolSize).arg(state.maxConcurrent));
+}
+
+void CrawlScheduler::submit(const CrawlJob& job)
+{
+    siteState(job.site);
+    jobQueue.enqueue(job);
+    scheduleDispatch();
+}
+
+QList<CrawlJob> CrawlScheduler::cancelPending(const QString& site)
+{
+    QList<CrawlJob> removed;
+    for (int i = 0; i < jobQueue.size(); ) {
+        if (jobQueue.at(i).site == site) {
+            removed.append(jobQueue.takeAt(i));
+        } else {
+            ++i;
+        }
+    }
+    if (!removed.isEmpty()) {
+        emit appendLogSignal(QString("🧹 调度器：已丢弃站点「%1」排队任务%2个").arg(site).arg(removed.size()));
+    }
+    if (runningCount(site) == 0) {
+        emit siteIdle(site);
+    }
+    return removed;
+}
+
+int CrawlScheduler::pendingCount(const QString& site) const
+{
+    int count = 0;
+    for (const CrawlJob& job : jobQueue) {
+        if (job.site == site) count++;
+    }
+    return count;
+}
+
+int CrawlScheduler::runningCount(const QString& site) const
+{
+    auto it = sites.constFind(site);
+    return it == sites.constEnd() ? 0 : it->running;
+}
+
+// 合并同一轮事件循环内的多次调度请求
+void CrawlScheduler::scheduleDispatch()
+{
+    if (dispatchScheduled) return;
+    dispatchScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        dispatchScheduled = false;
+        dispatch();
+    });
+}
+
+void CrawlScheduler::dispatch()
+{
+    // 按入队顺序扫描，跳过所属站点已满或目标主机限速中的任务，保证各站点互不阻塞
+    qint64 nextRetryMs = -1;
+    QString throttledHost;
+    for (int i = 0; i < jobQueue.size(); ) {
+        const CrawlJob& job = jobQueue.at(i);
+        SiteState& state = siteState(job.site);
+        if (state.running >= state.maxConcurrent) {
+            ++i;
+            continue;
+        }
+        PooledPage *slot = acquirePage(job.site);
+        if (slot == nullptr) {
+            ++i;
+            continue;
+        }
+        const QString host = HostRateLimiter::hostKey(job.request.url());
+        qint64 waitMs = 0;
+        if (!HostRateLimiter::shared().tryAcquire(host, &waitMs)) {
+            // 并发已满（waitMs<0）时等在途任务结束触发派发，否则到令牌补足/冷却结束时再试
+            if (waitMs > 0 && (nextRetryMs < 0 || waitMs < nextRetryMs)) {
+                nextRetryMs = waitMs;
+                throttledHost = host;
+            }
+            ++i;
+            continue;
+        }
+        CrawlJob next = jobQueue.takeAt(i);
+        slot->host = host;
+        startJob(slot, next);
+    }
+
+    if (nextRetryMs > 0 && (!rateTimer->isActive() || rateTimer->remainingTime() > nextRetryMs)) {
+        if (nextRetryMs >= 1000) {
+            emit appendLogSignal(QString("🚦 调度器：主机「%1」限速中，%2秒后继续派发")
+                                     .arg(throttledHost).arg(QString::number(nextRetryMs / 1000.0, 'f', 1)));
+        }
+        rateTimer->start(static_cast<int>(nextRetryMs));
+    }
+}
+
+CrawlScheduler::PooledPage* CrawlScheduler::acquirePage(const QString& site)
+{
+    SiteState& state = siteState(site);
+    for (PooledPage *slot : state.pages) {
+        if (!slot->busy) return slot;
+    }
+    if (state.pages.size() >= state.poolSize) {
+        return nullptr;
+    }
+
+    // 池未满时按需新建页面（共用默认Profile，首页建立的会话Cookie对池内页面同样有效）
+    PooledPage *slot = new PooledPage;
+    slot->page = new QWebEnginePage(this);
+    if (state.setup) {
+        state.setup(slot->page);
+    }
+    slot->watchdog = new QTimer(this);
+    slot->watchdog->setSingleShot(true);
+    connect(slot->page, &QWebEnginePage::loadFinished, this, [this, slot](bool ok) {
+        onSlotLoadFinished(slot, ok);
+    });
+    connect(slot->watchdog, &QTimer::timeout, this, [this, slot]() {
+        if (!slot->busy) return;
+        emit appendLogSignal("⏰ 调度器：页面加载超时，放弃任务：" + slot->job.request.url().toString());
+        // 先结束任务再停止加载，Stop触发的loadFinished(false)会因槽位已空闲被忽略
+        finishJob(slot, CrawlResult());
+        slot->page->triggerAction(QWebEnginePage::Stop);
+    });
+    state.pages.append(slot);
+    emit appendLogSignal(QString("🆕 调度器：站点「%1」新建池页面（%2/%3）").arg(site).arg(state.pages.size()).arg(state.poolSize));
+    return slot;
+}
+
+void CrawlScheduler::startJob(PooledPage *slot, const CrawlJob& job)
+{
+    SiteState& state = siteState(job.site);
+    state.running++;
+    slot->busy = true;
+    slot->awaitingLoad = true;
+    slot->ticket++;
+    slot->job = job;
+    slot->loadMs = -1;
+    slot->loadTimer.start();
+    slot->watchdog->start(LOAD_TIMEOUT_MS + job.renderDelayMs);
+
+    emit appendLogSignal(QString("🚀 调度器：[%1] 在途%2/%3 排队%4 → %5")
+                             .arg(job.site).arg(state.running).arg(state.maxConcurrent)
+                             .arg(pendingCount(job.site)).arg(job.request.url().toString()));
+    slot->page->load(job.request);
+}
+
+void CrawlScheduler::onSlotLoadFinished(PooledPage *slot, bool ok)
+{
+    // 非当前任务触发的loadFinished（如页面内跳转）直接忽略
+    if (!slot->busy || !slot->awaitingLoad) return;
+    slot->awaitingLoad = false;
+    slot->loadMs = slot->loadTimer.elapsed();
+
+    if (!ok) {
+        finishJob(slot, CrawlResult());
+        return;
+    }
+
+    const quint64 ticket = slot->ticket;
+    QPointer<QWebEnginePage> page = slot->page;
+    auto fetchHtml = [this, slot, ticket, page]() {
+        if (page.isNull() || slot->ticket != ticket || !slot->busy) return;
+        auto toHtml = [this, slot, ticket, page](const QString& json) {
+            page->toHtml([this, slot, ticket, page, json](const QString& html) {
+                if (page.isNull() || slot->ticket != ticket || !slot->busy) return;
+                CrawlResult result;
+                result.ok = true;
+                result.html = html;
+                result.json = json;
+                finishJob(slot, result);
+            });
+        };
+        if (slot->job.extractScript.isEmpty()) {
+            toHtml(QString());
+            return;
+        }
+        // 页面内提取：只回传房源字段JSON；脚本没找到房源节点时再取整页HTML
+        page->runJavaScript(slot->job.extractScript, [this, slot, ticket, page, toHtml](const QVariant& value) {
+            if (page.isNull() || slot->ticket != ticket || !slot->busy) return;
+            const QString json = value.toString();
+            if (!hasInPageRows(json)) {
+                toHtml(QString());
+                return;
+            }
+            if (slot->job.keepHtml) {
+                toHtml(json);
+                return;
+            }
+            CrawlResult result;
+            result.ok = true;
+            result.json = json;
+            finishJob(slot, result);
+        });
+    };
+
+    if (slot->job.readySelector.isEmpty()) {
+        QTimer::singleShot(slot->job.renderDelayMs, this, fetchHtml);
+        return;
+    }
+
+    // 房源节点数稳定即取HTML，renderDelayMs只作为超时上限
+    const QString url = slot->job.request.url().toString();
+    PageReadyProbe::waitForListings(page, slot->job.readySelector, slot->job.renderDelayMs, this,
+                                    [this, url, fetchHtml](bool ready, int count, qint64 elapsedMs) {
+        if (ready) {
+            emit appendLogSignal(QString("⚡ 调度器：渲染就绪（%1个房源节点，等待%2ms）：%3").arg(count).arg(elapsedMs).arg(url));
+        } else {
+            emit appendLogSignal(QString("⏳ 调度器：渲染探测超时（%1个房源节点），按当前页面提取：%2").arg(count).arg(url));
+        }
+        fetchHtml();
+    });
+}
+
+bool CrawlScheduler::hasInPageRows(const QString& json)
+{
+    if (json.isEmpty()) return false;
+    const QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+    return doc.isObject() && doc.object().value("count").toInt() > 0;
+}
+
+void CrawlScheduler::finishJob(PooledPage *slot, CrawlResult result)
+{
+    slot->watchdog->stop();
+    CrawlJob job = slot->job;
+    result.finalUrl = slot->page->url();
+    result.request = job.request;
+
+    // 反馈给限速器：验证页直接冷却，失败乘性降速，加载快则逐步提速
+    HostRateLimiter::Outcome outcome = HostRateLimiter::Outcome::Ok;
+    if (!result.ok) {
+        outcome = HostRateLimiter::Outcome::Failed;
+    } else if (job.isChallenge && job.isChallenge(result.finalUrl)) {
+        outcome = HostRateLimiter::Outcome::Challenged;
+    }
+    HostRateLimiter::shared().onFinished(slot->host, outcome,
+                                         slot->loadMs >= 0 ? slot->loadMs : slot->loadTimer.elapsed());
+    slot->busy = false;
+    slot->awaitingLoad = false;
+    slot->job = CrawlJob();
+
+    SiteState& state = siteState(job.site);
+    state.running = qMax(0, state.running - 1);
+
+    if (job.onFinished) {
+        job.onFinished(result);
+    }
+
+    if (state.running == 0 && pendingCount(job.site) == 0) {
+        emit siteIdle(job.site);
+    }
+    scheduleDispatch();
+}
@@ -0,0 +1,113 @@
+#ifndef CRAWLSCHEDULER_H
+#define CRAWLSCHEDULER_H
+
+#include <QObject>
+#include <QWebEnginePage>
+#include <QWebEngineHttpRequest>
+#include <QQueue>
+#include <QMap>
+#include <QList>
+#include <QTimer>
+#include <QUrl>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <functional>
+
+// 任务结果：json非空表示页面内脚本提取成功，否则html为整页内容（extractScript为空或脚本回退时）；
+// 设置了keepHtml时二者可能同时非空
+struct CrawlResult {
+    bool ok = false;                    // false 表示加载失败或超时
+    QUrl finalUrl;                      // 跳转后的实际地址（用于风控检测）
+    QWebEngineHttpRequest request;      // 实际发出的请求（录制归档用）
+    QString html;
+    QString json;
+};
+
+// 调度任务：一次页面加载 → 等待渲染就绪 → 页面内提取JSON或取回HTML
+struct CrawlJob {
+    QString site;                       // 站点标识（如 "anjuke" / "ali"），用于套用站点并发上限
+    QWebEngineHttpRequest request;      // 完整请求（UA、Cookie等请求头由爬虫自己设置）
+    int renderDelayMs = 0;              // 加载完成后的渲染等待时间（设置了readySelector时为最长等待时间）
+    QString readySelector;              // 房源节点选择器：非空时用PageReadyProbe探测渲染完成，不再固定等待
+    QString extractScript;              // 页面内提取脚本：非空时先取脚本返回的JSON，页面上没有房源节点时回退toHtml
+    bool keepHtml = false;              // 脚本提取成功时也取回整页HTML（录制归档用，回放时可重跑HTML解析）
+    std::function<bool(const QUrl& finalUrl)> isChallenge;  // 是否跳转到了验证页（限速器据此降速冷却）
+    std::function<void(const CrawlResult& result)> onFinished;
+};
+
+/**
+ * @brief 基于 QWebEnginePage 页面池的并发爬取调度器
+ *
+ * 每个站点维护一个最多 poolSize 个页面的池，所有站点共用一个任务队列，
+ * 调度时按入队顺序取出“所属站点还有空闲名额”的任务分配给空闲页面。
+ * 多个城市/区县的房源页因此可以在同一进程内并行加载，吞吐量随池大小线性增长。
+ * 派发前还要经过 HostRateLimiter：目标主机没有令牌或冷却中时任务留在队列，到点再派发，
+ * 加载耗时、失败与验证页命中都会反馈给限速器调整该主机的速率。
+ */
+class CrawlScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    using PageSetup = std::function<void(QWebEnginePage*)>;
+
+    explicit CrawlScheduler(QObject *parent = nullptr);
+    ~CrawlScheduler() override;
+
+    // 配置站点：页面池大小、同时在途页面上限、新建页面时的初始化回调（设置WebEngine属性等）
+    void configureSite(const QString& site, int poolSize, int maxConcurrent, PageSetup setup = nullptr);
+
+    // 提交任务（未配置过的站点使用默认池大小）
+    void submit(const CrawlJob& job);
+
+    // 丢弃某站点所有排队中的任务（触发风控时使用），在途任务不受影响；返回被丢弃的任务以便调用方记回队列
+    QList<CrawlJob> cancelPending(const QString& site);
+
+    int pendingCount(const QString& site) const;
+    int runningCount(const QString& site) const;
+
+    // 页面内提取脚本的返回值里是否有房源（串行模式据此决定要不要回退toHtml）
+    static bool hasInPageRows(const QString& json);
+
+    static const int DEFAULT_POOL_SIZE;
+    static const int LOAD_TIMEOUT_MS;   // 单页加载超时
+
+signals:
+    void appendLogSignal(const QString& log);
+    void siteIdle(const QString& site); // 该站点排队与在途任务全部完成
+
+private:
+    struct PooledPage {
+        QWebEnginePage *page = nullptr;
+        QTimer *watchdog = nullptr;
+        bool busy = false;
+        bool awaitingLoad = false;
+        quint64 ticket = 0;             // 每个任务递增，用于丢弃过期的异步回调
+        CrawlJob job;
+        QString host;                   // 限速键（HostRateLimiter::hostKey）
+        QElapsedTimer loadTimer;
+        qint64 loadMs = -1;             // 本次加载耗时（loadFinished 之前为-1）
+    };
+
+    struct SiteState {
+        int poolSize = 0;
+        int maxConcurrent = 0;
+        int running = 0;
+        PageSetup setup;
+        QList<PooledPage*> pages;
+    };
+
+    void scheduleDispatch();
+    void dispatch();
+    PooledPage* acquirePage(const QString& site);
+    void startJob(PooledPage *slot, const CrawlJob& job);
+    void onSlotLoadFinished(PooledPage *slot, bool ok);
+    void finishJob(PooledPage *slot, CrawlResult result);
+    SiteState& siteState(const QString& site);
+
+    QQueue<CrawlJob> jobQueue;
+    QMap<QString, SiteState> sites;
+    bool dispatchScheduled = false;
+    QTimer *rateTimer = nullptr;        // 有任务因主机限速被推迟时，到点重新派发
+};
+
+#endif // CRAWLSCHEDULER_H
@@ -0,0 +1,294 @@
+#ifndef CRAWLTASK_H
+#define CRAWLTASK_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <QWebEnginePage>
+#include <QWebEngineHttpRequest>
+#include <QtDebug>
+#include <coroutine>
+#include <memory>
+#include "PageReadyProbe.h"
+#include "CrawlScheduler.h"
+
+/**
+ * @brief 爬取流程协程（C++20），替代层层嵌套的 QTimer::singleShot 回调和各种“当前处于哪一步”的标志位
+ *
+ * 一个爬取流程写成一个返回 CrawlTask 的协程，按顺序 co_await 下面 CrawlAwait 里的等待对象：
+ *   加载页面 → 等房源渲染 → 执行脚本/取HTML → 随机等待 → 下一页……
+ * 交给调度器页面池的房源页同样是一页一个流程（co_await CrawlAwait::scheduled）。
+ * 流程走到哪一步、当前是哪个URL都是协程里的局部变量，同一线程上可以同时挂起任意多个流程，
+ * 互不干扰（每个流程各用各的页面即可）。
+ *
+ * 协程创建后立即执行到第一个 co_await；每个等待对象都在 Qt 事件循环里恢复协程（定时器、信号、
+ * WebEngine 回调），不会在 load()/runJavaScript() 调用栈内同步恢复。流程结束后协程帧自行释放。
+ *
+ * CrawlTask 是流程的句柄：析构或 cancel() 时销毁仍挂起的协程帧（局部变量随之析构），
+ * 此后到达的信号/回调不会再恢复它。爬虫对象在析构时先取消自己的流程，再释放页面。
+ */
+class CrawlTask
+{
+public:
+    struct promise_type {
+        std::shared_ptr<bool> finished = std::make_shared<bool>(false);
+
+        ~promise_type() { *finished = true; }
+
+        CrawlTask get_return_object()
+        {
+            return CrawlTask(std::coroutine_handle<promise_type>::from_promise(*this), finished);
+        }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept
+        {
+            qCritical() << "CrawlTask: 爬取流程抛出未捕获的异常，流程已终止";
+        }
+    };
+
+    CrawlTask() = default;
+    CrawlTask(const CrawlTask&) = delete;
+    CrawlTask& operator=(const CrawlTask&) = delete;
+    CrawlTask(CrawlTask&& other) noexcept
+        : handle(other.handle), finished(std::move(other.finished))
+    {
+        other.handle = nullptr;
+    }
+    CrawlTask& operator=(CrawlTask&& other) noexcept
+    {
+        if (this != &other) {
+            cancel();
+            handle = other.handle;
+            finished = std::move(other.finished);
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+    ~CrawlTask() { cancel(); }
+
+    bool isRunning() const { return finished != nullptr && !*finished; }
+
+    // 只能在流程挂起时调用（不能在流程自身内部取消自己）
+    void cancel()
+    {
+        if (isRunning()) {
+            handle.destroy();
+        }
+        handle = nullptr;
+        finished.reset();
+    }
+
+private:
+    CrawlTask(std::coroutine_handle<promise_type> h, std::shared_ptr<bool> done)
+        : handle(h), finished(std::move(done)) {}
+
+    std::coroutine_handle<promise_type> handle;
+    std::shared_ptr<bool> finished;
+};
+
+// 爬取流程里可以 co_await 的等待对象
+namespace CrawlAwait {
+
+// 等待对象的公共部分：token 随协程帧一起销毁，异步回调只持有它的弱引用，
+// 流程被取消（帧已销毁）后到达的回调直接丢弃，不会恢复一个已经不存在的协程
+class Awaiter
+{
+protected:
+    std::shared_ptr<int> token = std::make_shared<int>(0);
+
+    std::weak_ptr<int> guard() const { return token; }
+};
+
+// 等待 ms 毫秒；context 销毁时定时器随之失效（流程也应已被取消）
+class Sleep : public Awaiter
+{
+public:
+    Sleep(QObject *context, int ms) : context(context), ms(ms) {}
+
+    bool await_ready() const noexcept { return ms <= 0; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        QTimer::singleShot(ms, context, [h, alive = guard()]() {
+            if (!alive.expired()) h.resume();
+        });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    QObject *context;
+    int ms;
+};
+
+inline Sleep sleep(QObject *context, int ms)
+{
+    return Sleep(context, ms);
+}
+
+// 加载页面，恢复时返回 loadFinished 的 ok；结果以排队方式送回，协程不会在 WebEngine 的信号发射里继续执行
+class Load : public Awaiter
+{
+public:
+    Load(QWebEnginePage *page, const QWebEngineHttpRequest& request) : page(page), request(request) {}
+    Load(const Load&) = delete;
+    Load& operator=(const Load&) = delete;
+    ~Load() { QObject::disconnect(*connection); }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        *connection = QObject::connect(page, &QWebEnginePage::loadFinished, page,
+                                       [this, h, alive = guard(), connection = connection](bool loaded) {
+            QObject::disconnect(*connection);
+            if (alive.expired()) return;
+            ok = loaded;
+            h.resume();
+        }, Qt::QueuedConnection);
+        page->load(request);
+    }
+    bool await_resume() const noexcept { return ok; }
+
+private:
+    QWebEnginePage *page;
+    QWebEngineHttpRequest request;
+    std::shared_ptr<QMetaObject::Connection> connection = std::make_shared<QMetaObject::Connection>();
+    bool ok = false;
+};
+
+inline Load load(QWebEnginePage *page, const QWebEngineHttpRequest& request)
+{
+    return Load(page, request);
+}
+
+// 在页面里执行脚本，恢复时返回脚本结果
+class RunJavaScript : public Awaiter
+{
+public:
+    RunJavaScript(QWebEnginePage *page, const QString& script) : page(page), script(script) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        page->runJavaScript(script, [this, h, alive = guard()](const QVariant& value) {
+            if (alive.expired()) return;
+            result = value;
+            h.resume();
+        });
+    }
+    QVariant await_resume() { return std::move(result); }
+
+private:
+    QWebEnginePage *page;
+    QString script;
+    QVariant result;
+};
+
+inline RunJavaScript runJavaScript(QWebEnginePage *page, const QString& script)
+{
+    return RunJavaScript(page, script);
+}
+
+// 取当前页面的整页HTML
+class ToHtml : public Awaiter
+{
+public:
+    explicit ToHtml(QWebEnginePage *page) : page(page) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        page->toHtml([this, h, alive = guard()](const QString& html) {
+            if (alive.expired()) return;
+            result = html;
+            h.resume();
+        });
+    }
+    QString await_resume() { return std::move(result); }
+
+private:
+    QWebEnginePage *page;
+    QString result;
+};
+
+inline ToHtml toHtml(QWebEnginePage *page)
+{
+    return ToHtml(page);
+}
+
+// 房源列表渲染就绪（PageReadyProbe）：ready=false 表示超时
+struct ListingsState {
+    bool ready = false;
+    int count = 0;
+    qint64 elapsedMs = 0;
+};
+
+class ListingsReady : public Awaiter
+{
+public:
+    ListingsReady(QWebEnginePage *page, const QString& selector, int timeoutMs, QObject *context)
+        : page(page), selector(selector), timeoutMs(timeoutMs), context(context) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        PageReadyProbe::waitForListings(page, selector, timeoutMs, context,
+                                        [this, h, alive = guard()](bool ready, int count, qint64 elapsedMs) {
+            if (alive.expired()) return;
+            state = {ready, count, elapsedMs};
+            h.resume();
+        });
+    }
+    ListingsState await_resume() const noexcept { return state; }
+
+private:
+    QWebEnginePage *page;
+    QString selector;
+    int timeoutMs;
+    QObject *context;
+    ListingsState state;
+};
+
+inline ListingsReady listingsReady(QWebEnginePage *page, const QString& selector, int timeoutMs, QObject *context)
+{
+    return ListingsReady(page, selector, timeoutMs, context);
+}
+
+// 把任务交给调度器的页面池，恢复时返回任务结果（job.onFinished 由等待对象接管）；
+// 调度器在 finishJob 里同步调用回调，这里排队一次再恢复，协程不会在调度器的调用栈内继续执行。
+// 任务被 cancelPending 丢弃时不会恢复，调用方应同时取消对应的流程
+class Scheduled : public Awaiter
+{
+public:
+    Scheduled(CrawlScheduler *scheduler, const CrawlJob& job) : scheduler(scheduler), job(job) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        job.onFinished = [this, h, alive = guard(), context = scheduler](const CrawlResult& finished) {
+            QTimer::singleShot(0, context, [this, h, alive, finished]() {
+                if (alive.expired()) return;
+                result = finished;
+                h.resume();
+            });
+        };
+        scheduler->submit(job);
+    }
+    CrawlResult await_resume() { return std::move(result); }
+
+private:
+    CrawlScheduler *scheduler;
+    CrawlJob job;
+    CrawlResult result;
+};
+
+inline Scheduled scheduled(CrawlScheduler *scheduler, const CrawlJob& job)
+{
+    return Scheduled(scheduler, job);
+}
+
+} // namespace CrawlAwait
+
+#endif // CRAWLTASK_H
@@ -0,0 +1,361 @@
+#include "EntityResolver.h"
+#include "StringPool.h"
+#include "UrlDedupStore.h"
+#include <QStringList>
+#include <QUrl>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+const double EntityResolver::AREA_BUCKET_SQM = 5.0;
+const double EntityResolver::AREA_TOLERANCE = 0.03;
+const double EntityResolver::PRICE_TOLERANCE = 0.15;
+const double EntityResolver::MIN_TITLE_SIMILARITY = 0.2;
+const double EntityResolver::MATCH_THRESHOLD = 0.65;
+const int EntityResolver::MAX_BLOCK_CANDIDATES = 64;
+const int EntityResolver::MAX_LISTINGS = 200000;
+
+namespace {
+
+quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+const quint32 kEmptySlot = std::numeric_limits<quint32>::max();
+
+// 两个站点对城市、小区的写法不同（“北京”/“北京市”，“XX小区”/“XX”），去掉后缀后再取字典编号
+quint32 placeId(QString text, const QStringList& suffixes)
+{
+    text.remove(QChar(' '));
+    for (const QString& suffix : suffixes) {
+        if (text.size() > suffix.size() && text.endsWith(suffix)) {
+            text.chop(suffix.size());
+            break;
+        }
+    }
+    return StringPool::shared().intern(text);
+}
+
+quint32 cityId(const QString& city)
+{
+    static const QStringList suffixes = {"市"};
+    return placeId(city, suffixes);
+}
+
+quint32 communityId(const QString& community)
+{
+    static const QStringList suffixes = {"小区", "社区", "公寓"};
+    return placeId(community, suffixes);
+}
+
+double relativeDiff(double a, double b)
+{
+    return qAbs(a - b) / qMax(a, b);
+}
+
+qint64 areaBucket(double areaSqm)
+{
+    return areaSqm > 0 ? static_cast<qint64>(areaSqm / EntityResolver::AREA_BUCKET_SQM) : -1;
+}
+
+} // namespace
+
+EntityResolver& EntityResolver::shared()
+{
+    static EntityResolver resolver;
+    return resolver;
+}
+
+EntityResolver::Listing EntityResolver::listing(const HouseData& data)
+{
+    Listing l;
+    l.key = UrlDedupStore::fingerprint(data.houseUrl);
+    l.source = Source::Anjuke;
+    l.cityId = cityId(data.city);
+    l.communityId = communityId(data.communityName);
+    l.areaSqm = data.record.has(HouseRecord::Area) ? data.record.areaSqm : 0;
+    l.priceWan = data.record.has(HouseRecord::Price) ? data.record.priceWan : 0;
+    if (data.record.has(HouseRecord::Layout)) {
+        l.rooms = data.record.rooms;
+        l.halls = data.record.halls;
+    }
+    l.title = data.houseTitle;
+    return l;
+}
+
+EntityResolver::Listing EntityResolver::listing(const HouseInfo& data)
+{
+    Listing l;
+    l.key = UrlDedupStore::fingerprint(data.houseUrl);
+    l.source = Source::Ali;
+    l.cityId = cityId(data.city);
+    l.communityId = communityId(data.communityName);
+    l.areaSqm = data.record.has(HouseRecord::Area) ? data.record.areaSqm : 0;
+    if (data.record.has(HouseRecord::EvalPrice)) {
+        l.priceWan = data.record.evalPriceWan;
+    } else if (data.record.has(HouseRecord::Price)) {
+        l.priceWan = data.record.priceWan;
+    }
+    if (data.record.has(HouseRecord::Layout)) {
+        l.rooms = data.record.rooms;
+        l.halls = data.record.halls;
+    }
+    l.title = data.houseTitle;
+    return l;
+}
+
+// 标题的 MinHash 签名：只保留字母数字（统一小写），按相邻字符二元组取 SIGNATURE_SIZE 个独立哈希的最小值
+EntityResolver::Signature EntityResolver::signature(const QString& title)
+{
+    Signature sig;
+    sig.fill(kEmptySlot);
+
+    QVector<char16_t> chars;
+    chars.reserve(title.size());
+    for (const QChar c : title) {
+        if (c.isLetterOrNumber()) chars.append(c.toLower().unicode());
+    }
+    if (chars.isEmpty()) return sig;
+
+    const int shingles = chars.size() == 1 ? 1 : chars.size() - 1;
+    for (int i = 0; i < shingles; ++i) {
+        const quint32 gram = (static_cast<quint32>(chars[i]) << 16)
+                             | (i + 1 < chars.size() ? chars[i + 1] : 0);
+        const quint64 base = mix64(gram);
+        for (int k = 0; k < SIGNATURE_SIZE; ++k) {
+            const quint32 h = static_cast<quint32>(mix64(base ^ (0x9e3779b97f4a7c15ULL * (k + 1))));
+            if (h < sig[k]) sig[k] = h;
+        }
+    }
+    return sig;
+}
+
+// 签名相同位置取值相同的比例 ≈ 两个二元组集合的 Jaccard 相似度
+double EntityResolver::similarity(const Signature& a, const Signature& b)
+{
+    if (a[0] == kEmptySlot || b[0] == kEmptySlot) return 0;
+    int same = 0;
+    for (int k = 0; k < SIGNATURE_SIZE; ++k) {
+        if (a[k] == b[k]) same++;
+    }
+    return static_cast<double>(same) / SIGNATURE_SIZE;
+}
+
+quint64 EntityResolver::blockKey(quint32 cityId, quint32 communityId, qint64 areaBucket)
+{
+    return mix64(mix64((static_cast<quint64>(cityId) << 32) | communityId) ^ static_cast<quint64>(areaBucket));
+}
+
+double EntityResolver::score(const Listing& listing, const Signature& sig, const Entry& other) const
+{
+    if (listing.rooms > 0 && other.rooms > 0 && (listing.rooms != other.rooms || listing.halls != other.halls)) {
+        return 0;
+    }
+
+    double areaScore = 0.5;     // 任一方面积未知：中性分
+    if (listing.areaSqm > 0 && other.areaSqm > 0) {
+        const double diff = relativeDiff(listing.areaSqm, other.areaSqm);
+        if (diff > AREA_TOLERANCE) return 0;
+        areaScore = 1.0 - diff / AREA_TOLERANCE;
+    }
+
+    const double titleScore = similarity(sig, other.signature);
+    if (titleScore < MIN_TITLE_SIMILARITY) return 0;
+
+    double priceScore = 0.5;
+    if (listing.priceWan > 0 && other.priceWan > 0) {
+        priceScore = qMax(0.0, 1.0 - relativeDiff(listing.priceWan, other.priceWan) / PRICE_TOLERANCE);
+    }
+    return 0.5 * titleScore + 0.3 * areaScore + 0.2 * priceScore;
+}
+
+EntityResolver::Match EntityResolver::add(const Listing& listing)
+{
+    QMutexLocker locker(&mutex);
+    Match match;
+
+    auto known = indexByKey.constFind(listing.key);
+    if (known != indexByKey.constEnd()) {
+        match.clusterId = entries.at(find(known.value())).cluster;
+        return match;
+    }
+    if (entries.size() >= MAX_LISTINGS) compact();
+
+    const Signature sig = signature(listing.title);
+    const qint64 bucket = areaBucket(listing.areaSqm);
+
+    // 同城同小区、面积档相同或相邻的最近若干条房源里找得分最高的
+    int best = -1;
+    double bestScore = 0;
+    const qint64 firstBucket = bucket < 0 ? bucket : bucket - 1;
+    const qint64 lastBucket = bucket < 0 ? bucket : bucket + 1;
+    for (qint64 b = firstBucket; b <= lastBucket; ++b) {
+        auto block = blocks.constFind(blockKey(listing.cityId, listing.communityId, b));
+        if (block == blocks.constEnd()) continue;
+        const QVector<int>& members = block.value();
+        for (qsizetype i = qMax<qsizetype>(0, members.size() - MAX_BLOCK_CANDIDATES); i < members.size(); ++i) {
+            const double s = score(listing, sig, entries.at(members[i]));
+            if (s > bestScore) {
+                bestScore = s;
+                best = members[i];
+            }
+        }
+    }
+
+    const int index = append(listing, sig, nextCluster++);
+    if (best >= 0 && bestScore >= MATCH_THRESHOLD) {
+        match.merged = true;
+        match.crossSource = (entries.at(find(best)).sources & ~entries.at(index).sources) != 0;
+        match.matchedKey = entries.at(best).key;
+        match.score = bestScore;
+        unite(best, index);
+    }
+    match.clusterId = entries.at(find(index)).cluster;
+    return match;
+}
+
+bool EntityResolver::restore(const Listing& listing, quint32 clusterId)
+{
+    QMutexLocker locker(&mutex);
+    if (clusterId == 0 || indexByKey.contains(listing.key)) return false;
+    if (entries.size() >= MAX_LISTINGS) compact();
+
+    auto existing = indexByCluster.constFind(clusterId);
+    const int member = existing == indexByCluster.constEnd() ? -1 : existing.value();
+    const int index = append(listing, signature(listing.title), clusterId);
+    nextCluster = qMax(nextCluster, clusterId + 1);
+    if (member >= 0) unite(member, index);
+    return true;
+}
+
+int EntityResolver::restore(const QList<HouseData>& houses)
+{
+    int restored = 0;
+    for (const HouseData& house : houses) {
+        Listing l = listing(house);
+        if (!QUrl(house.houseUrl).host().endsWith("anjuke.com")) l.source = Source::Ali;
+        if (restore(l, house.record.clusterId)) restored++;
+    }
+    return restored;
+}
+
+bool EntityResolver::claimSeed()
+{
+    QMutexLocker locker(&mutex);
+    if (seeded) return false;
+    seeded = true;
+    return true;
+}
+
+// 新房源自成一簇，返回它的下标
+int EntityResolver::append(const Listing& listing, const Signature& sig, quint32 cluster)
+{
+    const int index = static_cast<int>(entries.size());
+    const quint8 sourceBit = static_cast<quint8>(1u << static_cast<int>(listing.source));
+    entries.append(Entry{listing.key, listing.source, listing.areaSqm, listing.priceWan,
+                         listing.rooms, listing.halls, sig, index, sourceBit, cluster});
+    indexByKey.insert(listing.key, index);
+    blocks[blockKey(listing.cityId, listing.communityId, areaBucket(listing.areaSqm))].append(index);
+    indexByCluster.insert(cluster, index);
+    clusters++;
+    return index;
+}
+
+// 丢弃最早的一半房源，其余的下标整体前移；簇内留下的第一条成为新根，继承簇编号与来源位
+void EntityResolver::compact()
+{
+    const int first = static_cast<int>(entries.size()) - MAX_LISTINGS / 2;
+    QVector<Entry> kept;
+    kept.reserve(MAX_LISTINGS);
+    QHash<quint32, int> roots;
+    for (int i = first; i < entries.size(); ++i) {
+        const int root = find(i);
+        Entry entry = entries.at(i);
+        const int index = static_cast<int>(kept.size());
+        auto known = roots.constFind(entries.at(root).cluster);
+        if (known == roots.constEnd()) {
+            roots.insert(entries.at(root).cluster, index);
+            entry.parent = index;
+            entry.sources = entries.at(root).sources;
+            entry.cluster = entries.at(root).cluster;
+        } else {
+            entry.parent = known.value();
+        }
+        kept.append(entry);
+    }
+
+    indexByKey.clear();
+    for (int i = 0; i < kept.size(); ++i) indexByKey.insert(kept.at(i).key, i);
+    for (auto it = blocks.begin(); it != blocks.end();) {
+        QVector<int>& members = it.value();
+        members.erase(std::remove_if(members.begin(), members.end(), [first](int m) { return m < first; }),
+                      members.end());
+        for (int& m : members) m -= first;
+        it = members.isEmpty() ? blocks.erase(it) : std::next(it);
+    }
+    entries = std::move(kept);
+    indexByCluster = std::move(roots);
+    clusters = static_cast<int>(indexByCluster.size());
+}
+
+// 路径减半
+int EntityResolver::find(int index)
+{
+    while (entries[index].parent != index) {
+        entries[index].parent = entries[entries[index].parent].parent;
+        index = entries[index].parent;
+    }
+    return index;
+}
+
+int EntityResolver::findConst(int index) const
+{
+    while (entries.at(index).parent != index) index = entries.at(index).parent;
+    return index;
+}
+
+// 簇编号小的根作为新根：簇编号始终是簇内最早那条房源的，已有的编号不变
+void EntityResolver::unite(int a, int b)
+{
+    int ra = find(a);
+    int rb = find(b);
+    if (ra == rb) return;
+    if (entries[rb].cluster < entries[ra].cluster) std::swap(ra, rb);
+    if (entries[rb].cluster != entries[ra].cluster) indexByCluster.remove(entries[rb].cluster);
+    entries[rb].parent = ra;
+    entries[ra].sources |= entries[rb].sources;
+    clusters--;
+}
+
+quint32 EntityResolver::clusterOf(quint64 key) const
+{
+    QMutexLocker locker(&mutex);
+    auto it = indexByKey.constFind(key);
+    return it == indexByKey.constEnd() ? 0 : entries.at(findConst(it.value())).cluster;
+}
+
+int EntityResolver::listingCount() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.size();
+}
+
+int EntityResolver::clusterCount() const
+{
+    QMutexLocker locker(&mutex);
+    return clusters;
+}
+
+QString EntityResolver::summary() const
+{
+    QMutexLocker locker(&mutex);
+    return QString("🔗 实体识别：%1条房源归并为%2套（%3条重复）")
+        .arg(entries.size()).arg(clusters).arg(entries.size() - clusters);
+}
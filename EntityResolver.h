@@ -0,0 +1,123 @@
+#ifndef ENTITYRESOLVER_H
+#define ENTITYRESOLVER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <array>
+#include "HouseData.h"
+#include "HouseInfo.h"
+
+/**
+ * @brief 跨来源的房源实体识别（安居客挂牌 ↔ 阿里拍卖，以及同站重复发布）
+ *
+ * 同一套房子在两个站点、甚至同一站点的不同经纪人那里标题写法、面积/价格取整都不一样。
+ * 每来一条房源增量地判断它是否与已有房源是同一套，并维护所属的簇编号：
+ *   1. 分块：只和“同城市 + 同小区 + 面积档（含相邻档）”的房源比较，不做两两 O(n²) 比较；
+ *      每块只看最近 MAX_BLOCK_CANDIDATES 条，总体近似线性；
+ *   2. 打分：标题字符二元组的 MinHash 估计 Jaccard 相似度，加上面积/价格的相对误差容忍；
+ *      户型都有且不同的直接排除；
+ *   3. 合并：并查集（路径压缩）。簇编号取簇内最早一条房源的编号，后来的房源并入时不会改变已有编号。
+ * 城市、小区用 StringPool 编号比较。
+ *
+ * 簇编号随房源入库（houseinfo.clusterId）。启动时用 restore() 从库里恢复最近的已识别房源，
+ * 新簇从库里最大编号之后继续分配，重爬到的房源沿用原编号。内存里最多保留 MAX_LISTINGS 条，
+ * 超出时丢弃最早的一半：它们的编号已经入库，只是不再参与本进程的匹配。
+ */
+class EntityResolver
+{
+public:
+    enum class Source : quint8 {
+        Anjuke,
+        Ali
+    };
+
+    static const int SIGNATURE_SIZE = 32;
+    using Signature = std::array<quint32, SIGNATURE_SIZE>;
+
+    struct Listing {
+        quint64 key = 0;            // 房源URL指纹（UrlDedupStore::fingerprint）
+        Source source = Source::Anjuke;
+        quint32 cityId = 0;
+        quint32 communityId = 0;
+        double areaSqm = 0;         // 0 表示未知
+        double priceWan = 0;        // 阿里优先用评估价（拍卖起拍价通常明显低于市场价）
+        int rooms = 0;
+        int halls = 0;
+        QString title;
+    };
+
+    struct Match {
+        quint32 clusterId = 0;
+        bool merged = false;        // 并入了已有的簇
+        bool crossSource = false;   // 并入的簇里有另一个来源的房源
+        quint64 matchedKey = 0;
+        double score = 0;
+    };
+
+    static EntityResolver& shared();
+
+    static Listing listing(const HouseData& data);
+    static Listing listing(const HouseInfo& data);
+
+    // 加入一条房源并返回所属簇；同一个 key 重复加入时直接返回已有的簇
+    Match add(const Listing& listing);
+    quint32 clusterOf(quint64 key) const;   // 未收录返回0
+
+    // 恢复一条库里已识别的房源，沿用它的簇编号（同编号的房源归为一簇）；已收录或编号为0时返回false
+    bool restore(const Listing& listing, quint32 clusterId);
+    // 恢复库里读出的房源（按时间从早到晚），来源按链接的域名区分；返回恢复的条数
+    int restore(const QList<HouseData>& houses);
+    // 只有第一次调用返回true：几个爬虫共用一个实例，只需要一个去库里加载
+    bool claimSeed();
+
+    int listingCount() const;
+    int clusterCount() const;
+    QString summary() const;
+
+    static Signature signature(const QString& title);
+    static double similarity(const Signature& a, const Signature& b);
+
+    static const double AREA_BUCKET_SQM;
+    static const double AREA_TOLERANCE;     // 面积相对误差上限
+    static const double PRICE_TOLERANCE;    // 价格相对误差上限（超出只是不加分，不直接排除）
+    static const double MIN_TITLE_SIMILARITY;
+    static const double MATCH_THRESHOLD;
+    static const int MAX_BLOCK_CANDIDATES;
+    static const int MAX_LISTINGS;          // 内存中最多保留的房源数
+
+private:
+    struct Entry {
+        quint64 key;
+        Source source;
+        double areaSqm;
+        double priceWan;
+        int rooms;
+        int halls;
+        Signature signature;
+        int parent;                 // 并查集
+        quint8 sources;             // 仅根节点有效：簇内出现过的来源位
+        quint32 cluster;            // 仅根节点有效：簇编号
+    };
+
+    EntityResolver() = default;
+    int find(int index);
+    int findConst(int index) const;
+    void unite(int a, int b);
+    int append(const Listing& listing, const Signature& sig, quint32 cluster);
+    void compact();
+    double score(const Listing& listing, const Signature& sig, const Entry& other) const;
+    static quint64 blockKey(quint32 cityId, quint32 communityId, qint64 areaBucket);
+
+    mutable QMutex mutex;
+    QVector<Entry> entries;
+    QHash<quint64, int> indexByKey;
+    QHash<quint64, QVector<int>> blocks;
+    QHash<quint32, int> indexByCluster;     // 簇编号 → 簇内任一房源
+    int clusters = 0;
+    quint32 nextCluster = 1;
+    bool seeded = false;
+};
+
+#endif // ENTITYRESOLVER_H
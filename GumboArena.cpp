@@ -0,0 +1,195 @@
+#include "GumboArena.h"
+#include <algorithm>
+#include <atomic>
+
+const size_t GumboArena::CHUNK_SIZE = 256 * 1024;
+const size_t GumboArena::RETAIN_BYTES = 32 * 1024 * 1024;
+
+namespace {
+
+constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+std::atomic<bool> arenaEnabled{true};
+std::atomic<quint64> pageCount{0};
+std::atomic<quint64> fallbackCount{0};
+std::atomic<qint64> totalPageBytes{0};
+std::atomic<qint64> maxPageBytes{0};
+std::atomic<qint64> reservedTotal{0};
+
+size_t alignUp(size_t size)
+{
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+} // namespace
+
+GumboArena::GumboArena()
+    : options(kGumboDefaultOptions)
+{
+    options.allocator = &GumboArena::gumboAllocate;
+    options.deallocator = &GumboArena::gumboDeallocate;
+    options.userdata = this;
+}
+
+GumboArena::~GumboArena()
+{
+    reservedTotal.fetch_sub(static_cast<qint64>(reserved), std::memory_order_relaxed);
+}
+
+GumboArena& GumboArena::local()
+{
+    thread_local GumboArena arena;
+    return arena;
+}
+
+void* GumboArena::gumboAllocate(void* userdata, size_t size)
+{
+    return static_cast<GumboArena*>(userdata)->allocate(size);
+}
+
+void GumboArena::gumboDeallocate(void* userdata, void* ptr)
+{
+    static_cast<GumboArena*>(userdata)->release(ptr);
+}
+
+void* GumboArena::allocate(size_t size)
+{
+    size = alignUp(qMax<size_t>(size, 1));
+
+    // 当前块放不下就换到下一个已有的块（复位后复用），都放不下再申请新块
+    while (current < chunks.size()) {
+        Chunk& chunk = chunks[current];
+        if (chunk.size - offset >= size) {
+            last = chunk.data.get() + offset;
+            offset += size;
+            return last;
+        }
+        if (current + 1 == chunks.size()) break;
+        usedBefore += offset;
+        ++current;
+        offset = 0;
+    }
+
+    Chunk chunk;
+    chunk.size = std::max(CHUNK_SIZE, size);
+    chunk.data.reset(new char[chunk.size]);
+    reserved += chunk.size;
+    reservedTotal.fetch_add(static_cast<qint64>(chunk.size), std::memory_order_relaxed);
+    if (!chunks.empty()) {
+        usedBefore += offset;
+    }
+    chunks.push_back(std::move(chunk));
+    current = chunks.size() - 1;
+    last = chunks.back().data.get();
+    offset = size;
+    return last;
+}
+
+// 只有最近一次分配可以真正收回；扩容时释放的旧缓冲早于新缓冲分配，不在此列，等整页复位
+void GumboArena::release(void* ptr)
+{
+    if (ptr != nullptr && ptr == last) {
+        offset = static_cast<size_t>(last - chunks[current].data.get());
+        last = nullptr;
+    }
+}
+
+void GumboArena::reset()
+{
+    const qint64 used = static_cast<qint64>(usedBefore + offset);
+    pageCount.fetch_add(1, std::memory_order_relaxed);
+    totalPageBytes.fetch_add(used, std::memory_order_relaxed);
+    qint64 peak = maxPageBytes.load(std::memory_order_relaxed);
+    while (used > peak && !maxPageBytes.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    }
+
+    // 偶发的超大页面撑出来的块不长期占着：保留前面的块，超出 RETAIN_BYTES 的部分还给系统
+    if (reserved > RETAIN_BYTES) {
+        size_t kept = 0;
+        size_t keepCount = 0;
+        while (keepCount < chunks.size() && kept + chunks[keepCount].size <= RETAIN_BYTES) {
+            kept += chunks[keepCount].size;
+            ++keepCount;
+        }
+        reservedTotal.fetch_sub(static_cast<qint64>(reserved - kept), std::memory_order_relaxed);
+        chunks.resize(keepCount);
+        reserved = kept;
+    }
+
+    current = 0;
+    offset = 0;
+    usedBefore = 0;
+    last = nullptr;
+}
+
+GumboArena::Document::Document(const char* html, size_t length, const GumboSubtreeFilter* scope)
+{
+    GumboArena& pool = GumboArena::local();
+    if (pool.busy || !arenaEnabled.load(std::memory_order_relaxed)) {
+        fallbackCount.fetch_add(1, std::memory_order_relaxed);
+        GumboOptions options = kGumboDefaultOptions;
+        options.subtree_filter = scope;
+        out = gumbo_parse_with_options(&options, html, length);
+        return;
+    }
+    pool.busy = true;
+    arena = &pool;
+    pool.options.subtree_filter = scope;
+    out = gumbo_parse_with_options(&pool.options, html, length);
+    pool.options.subtree_filter = nullptr;
+}
+
+GumboArena::Document::~Document()
+{
+    if (arena == nullptr) {
+        gumbo_destroy_output(&kGumboDefaultOptions, out);
+        return;
+    }
+    arena->reset();
+    arena->busy = false;
+}
+
+GumboArena::Stats GumboArena::stats()
+{
+    Stats s;
+    s.pages = pageCount.load(std::memory_order_relaxed);
+    s.fallbacks = fallbackCount.load(std::memory_order_relaxed);
+    s.totalBytes = totalPageBytes.load(std::memory_order_relaxed);
+    s.highWaterBytes = maxPageBytes.load(std::memory_order_relaxed);
+    s.reservedBytes = reservedTotal.load(std::memory_order_relaxed);
+    return s;
+}
+
+QString GumboArena::summary()
+{
+    const Stats s = stats();
+    if (s.pages == 0 && s.fallbacks == 0) return QString();
+
+    QString text = QString("🧱 解析内存池：%1页，平均每页%2 KB，单页峰值%3 KB，各线程共保留%4 KB")
+                       .arg(s.pages)
+                       .arg(s.pages > 0 ? s.totalBytes / static_cast<qint64>(s.pages) / 1024 : 0)
+                       .arg(s.highWaterBytes / 1024)
+                       .arg(s.reservedBytes / 1024);
+    if (s.fallbacks > 0) {
+        text += QString("；%1页未用内存池（嵌套解析或已关闭）").arg(s.fallbacks);
+    }
+    return text;
+}
+
+void GumboArena::resetStats()
+{
+    pageCount.store(0, std::memory_order_relaxed);
+    fallbackCount.store(0, std::memory_order_relaxed);
+    totalPageBytes.store(0, std::memory_order_relaxed);
+    maxPageBytes.store(0, std::memory_order_relaxed);
+}
+
+void GumboArena::setEnabled(bool enabled)
+{
+    arenaEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool GumboArena::isEnabled()
+{
+    return arenaEnabled.load(std::memory_order_relaxed);
+}
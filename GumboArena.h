@@ -0,0 +1,101 @@
+#ifndef GUMBOARENA_H
+#define GUMBOARENA_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "gumbo.h"
+
+/**
+ * @brief Gumbo 解析树的线程内内存池（通过 GumboOptions 的 allocator/deallocator 接入）
+ *
+ * Gumbo 每个节点、属性、向量扩容、字符串缓冲都要 malloc 一次，gumbo_destroy_output 又要把整棵树
+ * 逐个 free，几 MB 的列表页上分配器开销比解析本身还大。这里改成按块顺序分配（bump allocator）：
+ *   - 分配只是指针后移（16字节对齐），块用完再接一个 CHUNK_SIZE 的新块，超大请求单独成块；
+ *   - Gumbo 的释放基本都是空操作，只有释放的恰好是最近一次分配时才把指针退回去（如刚建好就被丢弃的token）；
+ *     字符串缓冲和向量扩容是先分配新空间、拷贝、再释放旧空间，旧空间不是最近一次分配，
+ *     留在块里直到整页复位（容量按2倍增长，这部分浪费不超过最终大小）；
+ *   - 一页处理完，Document 析构时整池复位：指针回到第一个块开头，不遍历解析树、不逐个 free；
+ *     块留着给同一线程的下一页复用，只有总量超过 RETAIN_BYTES 时才把多出的块还给系统。
+ *
+ * 每个线程一个内存池（流水线的提取线程各自复用自己的），同一线程上同时只能有一棵树占用；
+ * 嵌套解析（上一页的 Document 还没析构）时退回默认的 malloc/free，保证正确。
+ *
+ * 用法：
+ *   GumboArena::Document doc(utf8.constData(), utf8.size());
+ *   walkElements(doc->root, ...);   // doc 析构即释放整棵树
+ *
+ * 只从固定容器（如 div.property）取数据时可以传 scope：容器外只建元素骨架，文本/注释/大部分属性
+ * 直接丢弃，省掉导航、页脚、内联脚本等部分的建树与内存（见 gumbo.h 的 GumboSubtreeFilter）。
+ */
+class GumboArena
+{
+public:
+    class Document
+    {
+    public:
+        Document(const char* html, size_t length, const GumboSubtreeFilter* scope = nullptr);
+        ~Document();
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        GumboOutput* output() const { return out; }
+        GumboOutput* operator->() const { return out; }
+
+    private:
+        GumboArena* arena = nullptr;    // 为空：走默认分配器，析构时 gumbo_destroy_output
+        GumboOutput* out = nullptr;
+    };
+
+    struct Stats {
+        quint64 pages = 0;              // 用内存池解析的页数
+        quint64 fallbacks = 0;          // 嵌套解析/已关闭内存池时走 malloc 的页数
+        qint64 totalBytes = 0;          // 各页峰值之和（求平均用）
+        qint64 highWaterBytes = 0;      // 单页峰值的最大值
+        qint64 reservedBytes = 0;       // 所有线程当前持有的块总量
+    };
+
+    static Stats stats();
+    static QString summary();           // 未解析过页面时返回空串
+    static void resetStats();
+
+    // 关闭后新解析的页面改用 malloc/free（基准测试对比用）
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static const size_t CHUNK_SIZE;     // 常规块大小
+    static const size_t RETAIN_BYTES;   // 复位后每个线程最多保留的块总量
+
+    ~GumboArena();
+
+private:
+    GumboArena();
+    GumboArena(const GumboArena&) = delete;
+    GumboArena& operator=(const GumboArena&) = delete;
+
+    static GumboArena& local();
+    static void* gumboAllocate(void* userdata, size_t size);
+    static void gumboDeallocate(void* userdata, void* ptr);
+
+    void* allocate(size_t size);
+    void release(void* ptr);
+    void reset();
+
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t current = 0;         // 正在分配的块
+    size_t offset = 0;          // 当前块已用字节
+    size_t usedBefore = 0;      // 前面各块已用字节（本页峰值 = usedBefore + offset）
+    size_t reserved = 0;        // 本线程持有的块总量
+    char* last = nullptr;       // 最近一次分配的起点，释放它时可以回退
+    GumboOptions options;
+    bool busy = false;          // 有 Document 正在占用
+};
+
+#endif // GUMBOARENA_H
@@ -0,0 +1,88 @@
+#ifndef GUMBODOM_H
+#define GUMBODOM_H
+
+#include <QByteArray>
+#include <QVector>
+#include <cctype>
+#include <cstring>
+#include "gumbo.h"
+
+// Gumbo DOM 上的基础查询（HouseExtractor 的手写提取和 SiteRules 的选择器共用）
+namespace GumboDom {
+
+inline const char* attrValue(const GumboNode* node, const char* name)
+{
+    if (node == nullptr || node->type != GUMBO_NODE_ELEMENT) return nullptr;
+    const GumboAttribute* attr = gumbo_get_attribute(&node->v.element.attributes, name);
+    return attr ? attr->value : nullptr;
+}
+
+// class属性值里是否有指定token（按空白切分后精确比较，等价于CSS的 .cls）
+inline bool classListContains(const char* value, const char* cls, size_t len)
+{
+    const char* p = value;
+    while (*p) {
+        while (*p && std::isspace(static_cast<unsigned char>(*p))) ++p;
+        const char* start = p;
+        while (*p && !std::isspace(static_cast<unsigned char>(*p))) ++p;
+        if (static_cast<size_t>(p - start) == len && std::strncmp(start, cls, len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool hasClass(const GumboNode* node, const char* cls)
+{
+    const char* value = attrValue(node, "class");
+    return value != nullptr && classListContains(value, cls, std::strlen(cls));
+}
+
+inline bool isTag(const GumboNode* node, GumboTag tag)
+{
+    return node != nullptr && node->type == GUMBO_NODE_ELEMENT && node->v.element.tag == tag;
+}
+
+// 收集子树内全部文本（等价于旧逻辑“去掉所有标签后的内容”）
+inline void appendText(const GumboNode* node, QByteArray& out)
+{
+    switch (node->type) {
+    case GUMBO_NODE_TEXT:
+    case GUMBO_NODE_WHITESPACE:
+    case GUMBO_NODE_CDATA:
+        out.append(node->v.text.text);
+        break;
+    case GUMBO_NODE_ELEMENT:
+    case GUMBO_NODE_TEMPLATE: {
+        const GumboVector& children = node->v.element.children;
+        for (unsigned int i = 0; i < children.length; ++i) {
+            appendText(static_cast<const GumboNode*>(children.data[i]), out);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// 按文档顺序遍历子树中的元素节点；visitor返回false时不再深入该节点的子节点
+template <typename Visitor>
+void walkElements(const GumboNode* root, Visitor&& visitor)
+{
+    QVector<const GumboNode*> stack;
+    stack.append(root);
+    while (!stack.isEmpty()) {
+        const GumboNode* node = stack.takeLast();
+        if (node->type != GUMBO_NODE_ELEMENT && node->type != GUMBO_NODE_TEMPLATE) continue;
+        if (!visitor(node)) continue;
+        const GumboVector& children = node->v.element.children;
+        // 逆序压栈，保证出栈顺序与文档顺序一致
+        for (int i = static_cast<int>(children.length) - 1; i >= 0; --i) {
+            stack.append(static_cast<const GumboNode*>(children.data[i]));
+        }
+    }
+}
+
+} // namespace GumboDom
+
+#endif // GUMBODOM_H
@@ -0,0 +1,176 @@
+#include "HostRateLimiter.h"
+#include <QStringList>
+#include <cmath>
+
+const double HostRateLimiter::LATENCY_SMOOTHING = 0.3;
+const int HostRateLimiter::FAILURES_BEFORE_COOLDOWN = 3;
+const qint64 HostRateLimiter::MAX_COOLDOWN_MS = 30 * 60 * 1000;
+
+HostPolicy HostPolicy::fromIntervals(int minIntervalMs, int maxIntervalMs)
+{
+    HostPolicy policy;
+    policy.initialRate = 2000.0 / qMax(1, minIntervalMs + maxIntervalMs);
+    policy.maxRate = 4000.0 / qMax(1, minIntervalMs);
+    policy.minRate = 1000.0 / qMax(1, maxIntervalMs * 3);
+    return policy;
+}
+
+HostRateLimiter& HostRateLimiter::shared()
+{
+    static HostRateLimiter limiter;
+    return limiter;
+}
+
+HostRateLimiter::HostRateLimiter()
+{
+    clock.start();
+}
+
+// 取注册域名（最后两段）作为限速键；IP和单段主机名原样返回
+QString HostRateLimiter::hostKey(const QUrl& url)
+{
+    const QString host = url.host().toLower();
+    const QStringList labels = host.split('.', Qt::SkipEmptyParts);
+    bool numeric = false;
+    if (!labels.isEmpty()) labels.last().toInt(&numeric);
+    if (labels.size() <= 2 || numeric) {
+        return host;
+    }
+    return labels.mid(labels.size() - 2).join('.');
+}
+
+void HostRateLimiter::setPolicy(const QString& host, const HostPolicy& policy)
+{
+    HostState& s = hosts[host];
+    s.policy = policy;
+    s.rate = qBound(policy.minRate, policy.initialRate, policy.maxRate);
+    s.tokens = qMin(1.0, policy.burst);
+    s.refilledAtMs = nowMs();
+}
+
+HostRateLimiter::HostState& HostRateLimiter::state(const QString& host)
+{
+    auto it = hosts.find(host);
+    if (it == hosts.end()) {
+        setPolicy(host, HostPolicy());
+        it = hosts.find(host);
+    }
+    return it.value();
+}
+
+void HostRateLimiter::refill(HostState& s)
+{
+    const qint64 now = nowMs();
+    s.tokens = qMin(s.policy.burst, s.tokens + (now - s.refilledAtMs) / 1000.0 * s.rate);
+    s.refilledAtMs = now;
+}
+
+void HostRateLimiter::cooldown(HostState& s, qint64 ms)
+{
+    s.cooldownUntilMs = qMax(s.cooldownUntilMs, nowMs() + qMin(ms, MAX_COOLDOWN_MS));
+    s.tokens = qMin(s.tokens, 0.0);
+}
+
+bool HostRateLimiter::tryAcquire(const QString& host, qint64 *waitMs)
+{
+    HostState& s = state(host);
+    refill(s);
+
+    qint64 wait = 0;
+    if (s.inFlight >= s.policy.maxConcurrent) {
+        wait = -1;
+    } else if (nowMs() < s.cooldownUntilMs) {
+        wait = s.cooldownUntilMs - nowMs();
+    } else if (s.tokens < 1.0) {
+        wait = static_cast<qint64>(std::ceil((1.0 - s.tokens) / s.rate * 1000.0));
+    }
+    if (waitMs != nullptr) *waitMs = wait;
+    if (wait != 0) return false;
+
+    s.tokens -= 1.0;
+    s.inFlight++;
+    return true;
+}
+
+void HostRateLimiter::acquire(const QString& host)
+{
+    HostState& s = state(host);
+    refill(s);
+    s.tokens -= 1.0;
+    s.inFlight++;
+}
+
+qint64 HostRateLimiter::delayBeforeNext(const QString& host)
+{
+    HostState& s = state(host);
+    refill(s);
+    const qint64 now = nowMs();
+    const qint64 cooling = qMax<qint64>(0, s.cooldownUntilMs - now);
+    const qint64 tokenWait = s.tokens >= 1.0 ? 0 : static_cast<qint64>(std::ceil((1.0 - s.tokens) / s.rate * 1000.0));
+    // 单页模式一次只有一个请求，令牌桶的突发额度没有意义，至少间隔当前速率对应的时长
+    const qint64 spacing = static_cast<qint64>(1000.0 / s.rate);
+    return qMax(cooling, qMax(tokenWait, spacing));
+}
+
+void HostRateLimiter::onFinished(const QString& host, Outcome outcome, qint64 latencyMs)
+{
+    HostState& s = state(host);
+    refill(s);
+    s.inFlight = qMax(0, s.inFlight - 1);
+
+    if (outcome == Outcome::Challenged) {
+        // 命中验证页：直接降到下限并冷却，连续命中时冷却时间翻倍
+        s.challenged++;
+        s.rate = s.policy.minRate;
+        cooldown(s, s.policy.challengeCooldownMs << qMin(s.challengeStreak, 4));
+        s.challengeStreak++;
+        return;
+    }
+    if (outcome == Outcome::Failed) {
+        s.failed++;
+        s.consecutiveFailures++;
+        s.rate = qMax(s.policy.minRate, s.rate * s.policy.decreaseFactor);
+        if (s.consecutiveFailures >= FAILURES_BEFORE_COOLDOWN) {
+            // 连续失败：主机可能过载或网络异常，暂停一个冷却周期
+            cooldown(s, s.policy.challengeCooldownMs / 2);
+            s.consecutiveFailures = 0;
+        }
+        return;
+    }
+
+    s.succeeded++;
+    s.consecutiveFailures = 0;
+    s.challengeStreak = 0;
+    s.avgLatencyMs = s.succeeded == 1 ? latencyMs
+                                      : s.avgLatencyMs + LATENCY_SMOOTHING * (latencyMs - s.avgLatencyMs);
+    if (s.avgLatencyMs <= s.policy.targetLatencyMs) {
+        s.rate = qMin(s.policy.maxRate, s.rate + s.policy.increaseStep);
+    } else if (s.avgLatencyMs > 2 * s.policy.targetLatencyMs) {
+        // 明显变慢：小幅降速，避免把正在吃力的主机压垮
+        s.rate = qMax(s.policy.minRate, s.rate * 0.8);
+    }
+}
+
+double HostRateLimiter::currentRate(const QString& host) const
+{
+    auto it = hosts.constFind(host);
+    return it == hosts.constEnd() ? 0 : it->rate;
+}
+
+QString HostRateLimiter::summary(const QString& host) const
+{
+    auto it = hosts.constFind(host);
+    if (it == hosts.constEnd()) {
+        return QString("🚦 限速「%1」：尚无请求").arg(host);
+    }
+    const HostState& s = it.value();
+    const qint64 cooling = qMax<qint64>(0, s.cooldownUntilMs - clock.elapsed());
+    return QString("🚦 限速「%1」：当前%2秒/页（范围%3~%4秒），平均加载%5 ms，成功%6 失败%7 风控%8%9")
+        .arg(host)
+        .arg(QString::number(1.0 / s.rate, 'f', 1))
+        .arg(QString::number(1.0 / s.policy.maxRate, 'f', 1))
+        .arg(QString::number(1.0 / s.policy.minRate, 'f', 1))
+        .arg(static_cast<qint64>(s.avgLatencyMs))
+        .arg(s.succeeded).arg(s.failed).arg(s.challenged)
+        .arg(cooling > 0 ? QString("，冷却剩余%1秒").arg(cooling / 1000) : QString());
+}
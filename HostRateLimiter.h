@@ -0,0 +1,93 @@
+#ifndef HOSTRATELIMITER_H
+#define HOSTRATELIMITER_H
+
+#include <QString>
+#include <QUrl>
+#include <QMap>
+#include <QElapsedTimer>
+
+// 单个主机的限速参数（速率单位：请求/秒）
+struct HostPolicy {
+    double initialRate = 0.1;           // 起始速率
+    double minRate = 1.0 / 60;          // 下限（出错/风控后最低降到这里）
+    double maxRate = 0.5;               // 上限（主机再快也不超过）
+    double burst = 2;                   // 令牌桶容量：空闲一段时间后允许连续发出的请求数
+    int maxConcurrent = 2;              // 同时在途请求上限
+    qint64 targetLatencyMs = 4000;      // 加载耗时低于此值视为主机从容，可以加速
+    double increaseStep = 0.01;         // 加性增：每次从容的成功响应增加的速率
+    double decreaseFactor = 0.5;        // 乘性减：加载失败时速率乘以该系数
+    qint64 challengeCooldownMs = 120000; // 命中验证页后的冷却时间（连续命中时翻倍）
+
+    // 由原先的“最小/最大请求间隔”换算出的默认参数：起始速率取区间中点，上限为最小间隔的4倍速
+    static HostPolicy fromIntervals(int minIntervalMs, int maxIntervalMs);
+};
+
+/**
+ * @brief 按主机的自适应限速器（令牌桶 + AIMD）
+ *
+ * 每个主机一个令牌桶，以当前速率补充令牌，请求前取一个令牌并占用一个并发名额。
+ * 速率按响应情况调整：加载快（低于目标耗时）时加性增，明显变慢时小幅降速，
+ * 加载失败乘性减，命中验证页直接降到下限并冷却一段时间。
+ * 主机按注册域名合并（bj.anjuke.com 与 sh.anjuke.com 共用一个配额），站点风控是整站统计的。
+ * 只在界面线程使用（调度器和爬虫都在界面线程），不加锁。
+ */
+class HostRateLimiter
+{
+public:
+    enum class Outcome {
+        Ok,             // 正常加载
+        Failed,         // 加载失败/超时
+        Challenged      // 跳转到了验证页（风控）
+    };
+
+    static HostRateLimiter& shared();
+
+    static QString hostKey(const QUrl& url);
+
+    void setPolicy(const QString& host, const HostPolicy& policy);
+
+    // 调度器模式：有令牌且并发未满时占用名额并返回true；否则返回false，waitMs给出建议等待时间
+    // （-1 表示并发已满，需等在途请求结束）
+    bool tryAcquire(const QString& host, qint64 *waitMs = nullptr);
+    // 单页模式：直接占用名额（令牌不足时记为欠账，推迟下一次请求）
+    void acquire(const QString& host);
+    // 单页模式：下一次请求前应等待的时间（冷却、令牌补充、当前速率对应的间隔，取最大值）
+    qint64 delayBeforeNext(const QString& host);
+
+    // 一次请求结束（释放并发名额并调整速率）；latencyMs 为页面加载耗时
+    void onFinished(const QString& host, Outcome outcome, qint64 latencyMs);
+
+    double currentRate(const QString& host) const;
+    QString summary(const QString& host) const;
+
+    static const double LATENCY_SMOOTHING;   // 加载耗时的指数平均系数
+    static const int FAILURES_BEFORE_COOLDOWN;
+    static const qint64 MAX_COOLDOWN_MS;
+
+private:
+    struct HostState {
+        HostPolicy policy;
+        double rate = 0;
+        double tokens = 0;
+        qint64 refilledAtMs = 0;
+        qint64 cooldownUntilMs = 0;
+        int inFlight = 0;
+        int consecutiveFailures = 0;
+        int challengeStreak = 0;
+        double avgLatencyMs = 0;
+        quint64 succeeded = 0;
+        quint64 failed = 0;
+        quint64 challenged = 0;
+    };
+
+    HostRateLimiter();
+    HostState& state(const QString& host);
+    void refill(HostState& s);
+    void cooldown(HostState& s, qint64 ms);
+    qint64 nowMs() const { return clock.elapsed(); }
+
+    QMap<QString, HostState> hosts;
+    QElapsedTimer clock;
+};
+
+#endif // HOSTRATELIMITER_H
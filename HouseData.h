@@ -2,6 +2,7 @@
 #define HOUSDATA_H
 
 #include <QString>
+#include "HouseRecord.h"
 
 // 房源数据结构（供MainWindow和Crawl共享）
 struct HouseData {
@@ -17,6 +18,7 @@ struct HouseData {
     QString buildingYear;    // 建造年代
     QString houseUrl;        // 房源链接
     QString city;            // 城市
+    HouseRecord record;      // 数值字段（规范化阶段由上面的显示字段解析）
 };
 
 #endif // HOUSDATA_H
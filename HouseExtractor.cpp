@@ -0,0 +1,983 @@
+#include "HouseExtractor.h"
+#include <QRegularExpression>
+#include <QRegularExpressionMatchIterator>
+#include <QByteArray>
+#include <QSet>
+#include <QVector>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <cstring>
+#include <functional>
+#include "GumboDom.h"
+#include "GumboArena.h"
+#include "PatternRegistry.h"
+#include "ContentFingerprintStore.h"
+
+// ===================== 提取规则（PatternRegistry：进程内只编译一次，各线程共用）=====================
+namespace {
+
+using Pattern = PatternRegistry::Pattern;
+
+const QRegularExpression::PatternOptions kBlockOptions =
+    QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption;
+
+// 去标签、压空白等两个站点共用的清洗规则
+struct CommonRules
+{
+    static const Pattern& add(const char* name, const char* pattern)
+    {
+        return PatternRegistry::shared().add("common", name, pattern);
+    }
+
+    const Pattern& tag = add("tag", "<[^>]*>");
+    const Pattern& space = add("space", R"(\s+)");
+    const Pattern& spanOpen = add("spanOpen", "<span[^>]*>");
+    const Pattern& spanClose = add("spanClose", "</span>");
+
+    static const CommonRules& get()
+    {
+        static const CommonRules rules;
+        return rules;
+    }
+};
+
+struct AnjukeRules
+{
+    static const Pattern& add(const char* name, const char* pattern,
+                              QRegularExpression::PatternOptions options = kBlockOptions)
+    {
+        return PatternRegistry::shared().add("anjuke", name, pattern, options);
+    }
+
+    // 正则路径：房源片段与各字段
+    const Pattern& house = add("house",
+        R"(<div[^>]*?class=["']\s*property\s*["'][^>]*>([\s\S]*?)(?=<div[^>]*?class=["']\s*property\s*["']|$))");
+    const Pattern& title = add("title",
+        R"(<h3[^>]*?(?:title=["']([^"']+)["'][^>]*?class|class=["'][^"']*property-content-title-name[^"']*["'][^>]*?title=["']([^"']+)["'])[^>]*>.*?</h3>)");
+    const Pattern& titleFallback = add("titleFallback",
+        R"(<h3[^>]*class=["'][^"']*property-content-title-name[^"']*["'][^>]*>(.*?)</h3>)");
+    const Pattern& community = add("community",
+        R"(<p\s+[^>]*class=["'][^"']*?property-content-info-comm-name[^"']*?["'][^>]*>([\s\S]*?)</p>)");
+    const Pattern& totalPriceNum = add("totalPriceNum",
+        R"(<span\s+[^>]*class=["'][^"']*?property-price-total-num[^"']*?["'][^>]*>([\d.]+)</span>)");
+    const Pattern& totalPriceText = add("totalPriceText",
+        R"(<span\s+[^>]*class=["'][^"']*?property-price-total-text[^"']*?["'][^>]*>(万)</span>)");
+    const Pattern& unitPrice = add("unitPrice",
+        R"(<p\s+[^>]*class=["'][^"']*?property-price-average[^"']*?["'][^>]*>([\s\S]*?)</p>)");
+    const Pattern& houseType = add("houseType",
+        R"(<p\s+[^>]*class=["'][^"']*property-content-info-text[^"']*property-content-info-attribute[^"']*["'][^>]*>([\s\S]*?)</p>)");
+    const Pattern& baseInfo = add("baseInfo",
+        R"(<p\s+[^>]*class=["'][^"']*property-content-info-text[^"']*["'][^>]*>([\s\S]*?)</p>)");
+    const Pattern& url = add("url", R"(<a\s+[^>]*?href=["']([^"']+)["'][^>]*>)");
+
+    // 字段后处理（DOM/JSON/正则三条路径共用）
+    const Pattern& priceNum = add("priceNum", R"(^[\d.]+$)", QRegularExpression::NoPatternOption);
+    const Pattern& areaFormat = add("areaFormat", R"(^\d+(\.\d+)?\s*㎡$)", QRegularExpression::NoPatternOption);
+    const Pattern& year = add("year", R"(^\d{4}\s*年建造$)", QRegularExpression::NoPatternOption);
+
+    static const AnjukeRules& get()
+    {
+        static const AnjukeRules rules;
+        return rules;
+    }
+};
+
+struct AliRules
+{
+    static const Pattern& add(const char* name, const char* pattern,
+                              QRegularExpression::PatternOptions options = kBlockOptions)
+    {
+        return PatternRegistry::shared().add("ali", name, pattern, options);
+    }
+
+    const Pattern& house = add("house",
+        R"(<div\s+[^>]*?>[\s\S]*?)"
+        R"(<span\s+class=["']text["']\s+numberoflines=["']2["'])"
+        R"([\s\S]{0,2000}?)"
+        R"(<span\s+class=["']text["'].*?font-size:\s*24px)"
+        R"([\s\S]*?</div>)",
+        kBlockOptions | QRegularExpression::MultilineOption);
+    const Pattern& endFlag = add("endFlag",
+        R"(<div[^>]*?>[\s\S]*?已结束[\s\S]*?<span\s+class=["']text["'][\s\S]*?</span>)",
+        kBlockOptions | QRegularExpression::MultilineOption);
+    const Pattern& title = add("title",
+        R"(<span\s+class=["']text["']\s+numberoflines=["']2["']\s+title=["']([^"']+)["'])");
+    const Pattern& titleText = add("titleText",
+        R"(<span\s+class=["']text["']\s+numberoflines=["']2["'].*?>([\s\S]*?)</span>)");
+    const Pattern& baseInfo = add("baseInfo",
+        R"(<span\s+class=["']text["']\s+numberoflines=["']1["'].*?>([\s\S]*?)</span>)");
+    const Pattern& totalPrice = add("totalPrice",
+        R"((?:当前价|起拍价|一口价)[\s\S]*?)"
+        R"(<span\s+class=["']text["'].*?font-size:\s*24px.*?>(\s*[\d.]+)\s*</span>)");
+    const Pattern& evalPrice = add("evalPrice",
+        R"((?:评估价|市场价))"
+        R"([\s\S]{0,300}?)"
+        R"(<span\s+class=["']text["'].*?>(\d+(?:\.\d+)?)万</span>)");
+    const Pattern& url = add("url", R"(<a\s+[^>]*?href=["']([^"']+)["'].*?>)");
+
+    // 字段后处理
+    const Pattern& fontSize = add("fontSize", R"(font-size:\s*24px)", QRegularExpression::CaseInsensitiveOption);
+    const Pattern& evalText = add("evalText", R"(^(\d+(?:\.\d+)?)万$)", QRegularExpression::NoPatternOption);
+    const Pattern& number = add("number", R"(\d+(\.\d+)?)", QRegularExpression::NoPatternOption);
+    const Pattern& houseType = add("houseType", "^(?:(\\d+|多)室)?(?:(\\d+|多)厅)(?:(\\d+|多)卫)?$",
+                                   QRegularExpression::CaseInsensitiveOption);
+    const Pattern& hasChinese = add("hasChinese", "\\p{Script=Han}+", QRegularExpression::NoPatternOption);
+    const Pattern& pureChinese = add("pureChinese", "^\\p{Script=Han}+$", QRegularExpression::NoPatternOption);
+    const Pattern& floor = add("floor", R"((\d+层))", QRegularExpression::NoPatternOption);
+
+    static const AliRules& get()
+    {
+        static const AliRules rules;
+        return rules;
+    }
+};
+
+} // namespace
+
+// ===================== Gumbo DOM 辅助函数 =====================
+namespace {
+
+using GumboDom::attrValue;
+using GumboDom::hasClass;
+using GumboDom::isTag;
+using GumboDom::appendText;
+using GumboDom::walkElements;
+
+// 子树文本，连续空白压缩为 replacement（" " 或 ""）
+QString nodeText(const GumboNode* node, const QString& replacement = " ")
+{
+    QByteArray raw;
+    appendText(node, raw);
+    QString text = QString::fromUtf8(raw);
+    CommonRules::get().space.replace(text, replacement);
+    return text.trimmed();
+}
+
+// 子树内第一个带href的<a>，找不到时向上找包裹它的<a>
+QString findLink(const GumboNode* root)
+{
+    QString href;
+    walkElements(root, [&](const GumboNode* node) {
+        if (!href.isEmpty()) return false;
+        if (isTag(node, GUMBO_TAG_A)) {
+            const char* value = attrValue(node, "href");
+            if (value && *value) {
+                href = QString::fromUtf8(value).trimmed();
+                return false;
+            }
+        }
+        return true;
+    });
+    for (const GumboNode* p = root->parent; href.isEmpty() && p != nullptr; p = p->parent) {
+        if (isTag(p, GUMBO_TAG_A)) {
+            const char* value = attrValue(p, "href");
+            if (value && *value) href = QString::fromUtf8(value).trimmed();
+        }
+    }
+    return href;
+}
+
+// 阿里：标题span（class="text" numberoflines="2"）
+bool isAliTitleSpan(const GumboNode* node)
+{
+    if (!isTag(node, GUMBO_TAG_SPAN) || !hasClass(node, "text")) return false;
+    const char* lines = attrValue(node, "numberoflines");
+    return lines && std::strcmp(lines, "2") == 0;
+}
+
+// 阿里：基础信息span（class="text" numberoflines="1"）
+bool isAliBaseSpan(const GumboNode* node)
+{
+    if (!isTag(node, GUMBO_TAG_SPAN) || !hasClass(node, "text")) return false;
+    const char* lines = attrValue(node, "numberoflines");
+    return lines && std::strcmp(lines, "1") == 0;
+}
+
+// 阿里：24px价格span（class="text" style含 font-size:24px）
+bool isAliPriceSpan(const GumboNode* node)
+{
+    if (!isTag(node, GUMBO_TAG_SPAN) || !hasClass(node, "text")) return false;
+    const char* style = attrValue(node, "style");
+    if (style == nullptr) return false;
+    return AliRules::get().fontSize.contains(QString::fromUtf8(style));
+}
+
+bool containsAliPriceSpan(const GumboNode* root)
+{
+    bool found = false;
+    walkElements(root, [&](const GumboNode* node) {
+        if (found) return false;
+        if (isAliPriceSpan(node)) {
+            found = true;
+            return false;
+        }
+        return true;
+    });
+    return found;
+}
+
+// 元素在原始缓冲里的源码（开始标签到结束标签）追加到 out，元素之间用单元分隔符隔开；
+// 房源页内容指纹只看房源节点本身，页头、广告、统计脚本的变化不影响
+void appendSource(QByteArray& out, const GumboNode* node, const QByteArray& utf8)
+{
+    const GumboElement& element = node->v.element;
+    const size_t begin = element.start_pos.offset;
+    const size_t end = qMin<size_t>(element.end_pos.offset + element.original_end_tag.length,
+                                    static_cast<size_t>(utf8.size()));
+    if (end > begin) out.append(utf8.constData() + begin, static_cast<qsizetype>(end - begin));
+    out.append('\x1f');
+}
+
+// 与旧正则路径相同的链接补全规则
+QString normalizeAnjukeUrl(QString url)
+{
+    if (!url.startsWith("http")) {
+        url = "https://beijing.anjuke.com" + url;
+    }
+    return url;
+}
+
+QString normalizeAliUrl(QString url)
+{
+    if (url.startsWith("//")) {
+        url = "https:" + url;
+    } else if (!url.startsWith("http") && !url.isEmpty()) {
+        url = "https://huodong.taobao.com" + url;
+    }
+    return url;
+}
+
+} // namespace
+
+// ===================== 安居客：DOM路径 =====================
+QList<HouseData> HouseExtractor::extractAnjuke(const QString& html, const QString& city, quint64* listingHash)
+{
+    QList<HouseData> result;
+    QByteArray listingSource;
+    const QByteArray utf8 = html.toUtf8();
+    // 只用到 div.property 子树：容器外的文本、注释和属性在解析时就丢掉
+    static const GumboSubtreeFilter listingScope = {GUMBO_TAG_DIV, "property", nullptr, false};
+    GumboArena::Document doc(utf8.constData(), utf8.size(), &listingScope);
+    GumboOutput* output = doc.output();
+
+    walkElements(output->root, [&](const GumboNode* node) {
+        if (!isTag(node, GUMBO_TAG_DIV) || !hasClass(node, "property")) {
+            return true;
+        }
+        if (listingHash != nullptr) appendSource(listingSource, node, utf8);
+
+        HouseData data;
+        data.city = city;
+        data.houseTitle = "未知";
+        data.communityName = "未知";
+        data.price = "未知";
+        data.unitPrice = "未知";
+        data.houseType = "未知";
+        QString priceNum;
+        QString priceUnit;
+        QStringList baseInfoList;
+        bool hasTitleNode = false;
+
+        // 单次遍历房源子树，按class分派到各字段
+        walkElements(node, [&](const GumboNode* child) {
+            if (isTag(child, GUMBO_TAG_H3) && hasClass(child, "property-content-title-name")) {
+                hasTitleNode = true;
+                const char* title = attrValue(child, "title");
+                QString titleText = title ? QString::fromUtf8(title).simplified() : nodeText(child);
+                if (!titleText.isEmpty()) data.houseTitle = titleText;
+                return false;
+            }
+            if (isTag(child, GUMBO_TAG_SPAN) && hasClass(child, "property-price-total-num")) {
+                priceNum = nodeText(child, "");
+                return false;
+            }
+            if (isTag(child, GUMBO_TAG_SPAN) && hasClass(child, "property-price-total-text")) {
+                priceUnit = nodeText(child, "");
+                return false;
+            }
+            if (!isTag(child, GUMBO_TAG_P)) {
+                return true;
+            }
+            if (hasClass(child, "property-content-info-comm-name")) {
+                QString community = nodeText(child);
+                if (!community.isEmpty()) data.communityName = community;
+            } else if (hasClass(child, "property-price-average")) {
+                QString unit = nodeText(child);
+                if (!unit.isEmpty()) data.unitPrice = unit;
+            }
+            if (hasClass(child, "property-content-info-text")) {
+                if (hasClass(child, "property-content-info-attribute")) {
+                    QString type = nodeText(child, "");
+                    if (!type.isEmpty()) data.houseType = type;
+                }
+                QString info = nodeText(child);
+                if (!info.isEmpty()) baseInfoList.append(info);
+            }
+            return false;
+        });
+
+        if (!hasTitleNode) {
+            return false;
+        }
+
+        if (AnjukeRules::get().priceNum.contains(priceNum)) {
+            data.price = priceNum + (priceUnit == "万" ? priceUnit : QString());
+        }
+        classifyAnjukeBaseInfo(baseInfoList, data);
+
+        QString link = findLink(node);
+        data.houseUrl = link.isEmpty() ? "未知" : normalizeAnjukeUrl(link);
+
+        if (!data.houseTitle.isEmpty() && data.houseTitle != "未知") {
+            result.append(data);
+        }
+        return false; // 房源节点不会嵌套，跳过其子树
+    });
+
+    if (listingHash != nullptr) *listingHash = ContentFingerprintStore::hashBytes(listingSource);
+    return result;
+}
+
+// ===================== 阿里：DOM路径 =====================
+QList<HouseInfo> HouseExtractor::extractAli(const QString& html, const QString& city, quint64* listingHash)
+{
+    QList<HouseInfo> result;
+    QByteArray listingSource;
+    const QByteArray utf8 = html.toUtf8();
+    GumboArena::Document doc(utf8.constData(), utf8.size());
+    GumboOutput* output = doc.output();
+
+    // 先收集标题span，再为每个标题向上找到包含24px价格的最小容器作为房源卡片
+    QList<const GumboNode*> titleSpans;
+    walkElements(output->root, [&](const GumboNode* node) {
+        if (isAliTitleSpan(node)) {
+            titleSpans.append(node);
+            return false;
+        }
+        return true;
+    });
+
+    QSet<const GumboNode*> visitedCards;
+    for (const GumboNode* titleSpan : titleSpans) {
+        const GumboNode* card = nullptr;
+        int depth = 0;
+        for (const GumboNode* p = titleSpan->parent; p != nullptr && depth < 16; p = p->parent, ++depth) {
+            if (containsAliPriceSpan(p)) {
+                card = p;
+                break;
+            }
+        }
+        if (card == nullptr || visitedCards.contains(card)) continue;
+        visitedCards.insert(card);
+        if (listingHash != nullptr) appendSource(listingSource, card, utf8);
+
+        QString cardText = nodeText(card);
+        if (cardText.contains("已结束")) continue;
+
+        const char* titleAttr = attrValue(titleSpan, "title");
+        QString title = titleAttr ? QString::fromUtf8(titleAttr).trimmed() : nodeText(titleSpan);
+        if (title.isEmpty()) title = "未知";
+        if (isNonHouseTitle(title)) continue;
+
+        // 单次遍历卡片：价格标签之后的第一个24px span为总价，评估价标签之后的“xx万”为评估价
+        QString baseText;
+        QString priceNum;
+        QString evalNum;
+        bool afterPriceLabel = false;
+        bool afterEvalLabel = false;
+        const Pattern& evalRegex = AliRules::get().evalText;
+        std::function<void(const GumboNode*)> visit = [&](const GumboNode* node) {
+            if (node->type == GUMBO_NODE_TEXT) {
+                QString text = QString::fromUtf8(node->v.text.text);
+                if (text.contains("当前价") || text.contains("起拍价") || text.contains("一口价")) {
+                    afterPriceLabel = true;
+                }
+                if (text.contains("评估价") || text.contains("市场价")) {
+                    afterEvalLabel = true;
+                }
+                return;
+            }
+            if (node->type != GUMBO_NODE_ELEMENT) return;
+
+            if (baseText.isEmpty() && isAliBaseSpan(node)) {
+                baseText = nodeText(node);
+                return;
+            }
+            if (priceNum.isEmpty() && afterPriceLabel && isAliPriceSpan(node)) {
+                priceNum = nodeText(node, "");
+                return;
+            }
+            if (evalNum.isEmpty() && afterEvalLabel && isTag(node, GUMBO_TAG_SPAN) && hasClass(node, "text")) {
+                QRegularExpressionMatch m = evalRegex.match(nodeText(node, ""));
+                if (m.hasMatch()) {
+                    evalNum = m.captured(1);
+                    return;
+                }
+            }
+            const GumboVector& children = node->v.element.children;
+            for (unsigned int i = 0; i < children.length; ++i) {
+                visit(static_cast<const GumboNode*>(children.data[i]));
+            }
+        };
+        visit(card);
+
+        HouseInfo data;
+        data.city = city;
+        data.houseTitle = title;
+        QString link = findLink(card);
+        data.houseUrl = link.isEmpty() ? "未知" : normalizeAliUrl(link);
+
+        if (fillAliFields(data, baseText, priceNum, evalNum) && !data.houseUrl.isEmpty()) {
+            result.append(data);
+        }
+    }
+
+    if (listingHash != nullptr) *listingHash = ContentFingerprintStore::hashBytes(listingSource);
+    return result;
+}
+
+// ===================== 页面内提取（InPageJson） =====================
+// 脚本规则与上面的DOM路径一一对应：定位房源节点、收集原始文本，数值清洗仍在C++侧完成
+QString HouseExtractor::anjukeInPageScript()
+{
+    return QStringLiteral(R"JS(
+(function () {
+    var clean = function (el, sep) { return el ? el.textContent.replace(/\s+/g, sep).trim() : ''; };
+    var findLink = function (card) {
+        var links = card.querySelectorAll('a[href]');
+        for (var i = 0; i < links.length; i++) {
+            var href = links[i].getAttribute('href').trim();
+            if (href) return href;
+        }
+        for (var p = card.parentElement; p; p = p.parentElement) {
+            if (p.tagName === 'A' && p.getAttribute('href')) return p.getAttribute('href').trim();
+        }
+        return '';
+    };
+    var cards = document.querySelectorAll('div.property');
+    var rows = [];
+    for (var i = 0; i < cards.length; i++) {
+        var card = cards[i];
+        var titleEl = card.querySelector('h3.property-content-title-name');
+        if (!titleEl) continue;
+        var row = {
+            title: (titleEl.getAttribute('title') || titleEl.textContent).replace(/\s+/g, ' ').trim(),
+            community: '', priceNum: '', priceUnit: '', unitPrice: '', houseType: '', baseInfo: [],
+            url: findLink(card)
+        };
+        var comm = card.querySelectorAll('p.property-content-info-comm-name');
+        if (comm.length) row.community = clean(comm[comm.length - 1], ' ');
+        var avg = card.querySelectorAll('p.property-price-average');
+        if (avg.length) row.unitPrice = clean(avg[avg.length - 1], ' ');
+        row.priceNum = clean(card.querySelector('span.property-price-total-num'), '');
+        row.priceUnit = clean(card.querySelector('span.property-price-total-text'), '');
+        var infos = card.querySelectorAll('p.property-content-info-text');
+        for (var j = 0; j < infos.length; j++) {
+            if (infos[j].classList.contains('property-content-info-attribute')) {
+                var type = clean(infos[j], '');
+                if (type) row.houseType = type;
+            }
+            var info = clean(infos[j], ' ');
+            if (info) row.baseInfo.push(info);
+        }
+        rows.push(row);
+    }
+    return JSON.stringify({ count: cards.length, rows: rows });
+})();
+)JS");
+}
+
+QString HouseExtractor::aliInPageScript()
+{
+    return QStringLiteral(R"JS(
+(function () {
+    var clean = function (el, sep) { return el ? el.textContent.replace(/\s+/g, sep).trim() : ''; };
+    var isTextSpan = function (el) { return el.tagName === 'SPAN' && el.classList.contains('text'); };
+    var isBaseSpan = function (el) { return isTextSpan(el) && el.getAttribute('numberoflines') === '1'; };
+    var isPriceSpan = function (el) { return isTextSpan(el) && /font-size:\s*24px/i.test(el.getAttribute('style') || ''); };
+    var containsPrice = function (root) {
+        var spans = root.querySelectorAll('span.text[style]');
+        for (var i = 0; i < spans.length; i++) if (isPriceSpan(spans[i])) return true;
+        return false;
+    };
+    var findLink = function (card) {
+        var links = card.querySelectorAll('a[href]');
+        for (var i = 0; i < links.length; i++) {
+            var href = links[i].getAttribute('href').trim();
+            if (href) return href;
+        }
+        for (var p = card.parentElement; p; p = p.parentElement) {
+            if (p.tagName === 'A' && p.getAttribute('href')) return p.getAttribute('href').trim();
+        }
+        return '';
+    };
+
+    var titles = document.querySelectorAll('span.text[numberoflines="2"]');
+    var seen = new Set();
+    var rows = [];
+    for (var i = 0; i < titles.length; i++) {
+        var card = null;
+        for (var p = titles[i].parentElement, depth = 0; p && depth < 16; p = p.parentElement, depth++) {
+            if (containsPrice(p)) { card = p; break; }
+        }
+        if (!card || seen.has(card)) continue;
+        seen.add(card);
+        if (card.textContent.indexOf('已结束') >= 0) continue;
+
+        // 与DOM路径相同：价格标签之后的第一个24px span为总价，评估价标签之后的“xx万”为评估价
+        var base = '', price = '', evalNum = '', afterPrice = false, afterEval = false;
+        var visit = function (node) {
+            if (node.nodeType === 3) {
+                if (/当前价|起拍价|一口价/.test(node.nodeValue)) afterPrice = true;
+                if (/评估价|市场价/.test(node.nodeValue)) afterEval = true;
+                return;
+            }
+            if (node.nodeType !== 1) return;
+            if (!base && isBaseSpan(node)) { base = clean(node, ' '); return; }
+            if (!price && afterPrice && isPriceSpan(node)) { price = clean(node, ''); return; }
+            if (!evalNum && afterEval && isTextSpan(node)) {
+                var m = /^(\d+(?:\.\d+)?)万$/.exec(clean(node, ''));
+                if (m) { evalNum = m[1]; return; }
+            }
+            for (var c = node.firstChild; c; c = c.nextSibling) visit(c);
+        };
+        visit(card);
+
+        rows.push({
+            title: (titles[i].getAttribute('title') || clean(titles[i], ' ')).trim(),
+            base: base, price: price, eval: evalNum, url: findLink(card)
+        });
+    }
+    return JSON.stringify({ count: titles.length, rows: rows });
+})();
+)JS");
+}
+
+namespace {
+
+// 解析页面脚本结果；页面上没有房源节点（count<=0）视为无效，交给调用方回退
+bool parseInPageRows(const QString& json, QJsonArray& rows)
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) return false;
+    const QJsonObject root = doc.object();
+    if (root.value("count").toInt() <= 0) return false;
+    rows = root.value("rows").toArray();
+    return true;
+}
+
+QString jsonText(const QJsonObject& row, const char* key)
+{
+    return row.value(QLatin1String(key)).toString();
+}
+
+} // namespace
+
+bool HouseExtractor::fromAnjukeJson(const QString& json, const QString& city, QList<HouseData>& out)
+{
+    QJsonArray rows;
+    if (!parseInPageRows(json, rows)) return false;
+
+    const Pattern& priceNumRegex = AnjukeRules::get().priceNum;
+    for (const QJsonValue& value : rows) {
+        const QJsonObject row = value.toObject();
+        HouseData data;
+        data.city = city;
+        data.houseTitle = jsonText(row, "title");
+        if (data.houseTitle.isEmpty()) continue;
+
+        const QString community = jsonText(row, "community");
+        const QString unitPrice = jsonText(row, "unitPrice");
+        const QString houseType = jsonText(row, "houseType");
+        data.communityName = community.isEmpty() ? "未知" : community;
+        data.unitPrice = unitPrice.isEmpty() ? "未知" : unitPrice;
+        data.houseType = houseType.isEmpty() ? "未知" : houseType;
+
+        const QString priceNum = jsonText(row, "priceNum");
+        const QString priceUnit = jsonText(row, "priceUnit");
+        data.price = priceNumRegex.match(priceNum).hasMatch()
+                         ? priceNum + (priceUnit == "万" ? priceUnit : QString())
+                         : "未知";
+
+        QStringList baseInfoList;
+        for (const QJsonValue& info : row.value("baseInfo").toArray()) {
+            baseInfoList.append(info.toString());
+        }
+        classifyAnjukeBaseInfo(baseInfoList, data);
+
+        const QString link = jsonText(row, "url");
+        data.houseUrl = link.isEmpty() ? "未知" : normalizeAnjukeUrl(link);
+        out.append(data);
+    }
+    return true;
+}
+
+bool HouseExtractor::fromAliJson(const QString& json, const QString& city, QList<HouseInfo>& out)
+{
+    QJsonArray rows;
+    if (!parseInPageRows(json, rows)) return false;
+
+    for (const QJsonValue& value : rows) {
+        const QJsonObject row = value.toObject();
+        QString title = jsonText(row, "title");
+        if (title.isEmpty()) title = "未知";
+        if (isNonHouseTitle(title)) continue;
+
+        HouseInfo data;
+        data.city = city;
+        data.houseTitle = title;
+        const QString link = jsonText(row, "url");
+        data.houseUrl = link.isEmpty() ? "未知" : normalizeAliUrl(link);
+
+        if (fillAliFields(data, jsonText(row, "base"), jsonText(row, "price"), jsonText(row, "eval"))) {
+            out.append(data);
+        }
+    }
+    return true;
+}
+
+// ===================== 共用字段解析 =====================
+void HouseExtractor::classifyAnjukeBaseInfo(const QStringList& baseInfoList, HouseData& data)
+{
+    const Pattern& areaFormatRegex = AnjukeRules::get().areaFormat;
+    const Pattern& yearRegex = AnjukeRules::get().year;
+    static const QStringList dirWords = {"东南", "西南", "东北", "西北", "南", "北", "东", "西"};
+
+    QString area, orientation, floor, buildingYear;
+    for (const QString& info : baseInfoList) {
+        if (area.isEmpty() && areaFormatRegex.match(info).hasMatch()) {
+            area = info;
+            continue;
+        }
+        if (orientation.isEmpty()) {
+            bool isDirection = false;
+            for (const QString& dir : dirWords) {
+                if (info.contains(dir)) {
+                    isDirection = true;
+                    break;
+                }
+            }
+            if (isDirection) {
+                orientation = info;
+                continue;
+            }
+        }
+        if (buildingYear.isEmpty() && yearRegex.match(info).hasMatch()) {
+            buildingYear = info;
+            continue;
+        }
+        if (floor.isEmpty() && info.contains("层")) {
+            floor = info;
+            continue;
+        }
+    }
+
+    data.area = area.isEmpty() ? "未知" : area;
+    data.orientation = orientation.isEmpty() ? "未知" : orientation;
+    data.floor = floor.isEmpty() ? "未知" : floor;
+    data.buildingYear = buildingYear.isEmpty() ? "未知" : buildingYear;
+}
+
+bool HouseExtractor::isNonHouseTitle(const QString& title)
+{
+    static const QStringList nonHouseKeywords = {
+        "车位", "车库", "商用", "店面", "门市",
+        "写字楼", "办公", "厂房", "仓库", "工业",
+        "公寓式办公", "商办", "商住两用", "摊位", "柜台", "储藏间",
+        "广场", "商场"
+    };
+    for (const QString& keyword : nonHouseKeywords) {
+        if (title.contains(keyword, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HouseExtractor::fillAliFields(HouseInfo& data, const QString& baseText,
+                                   const QString& priceNum, const QString& evalNum)
+{
+    QString communityName = "未知";
+    QString area = "未知";
+    QString houseType = "未知";
+    QString city = "未知";
+    QString region = "未知";
+    QString location = "未知";
+
+    if (!baseText.isEmpty()) {
+        QStringList baseList = baseText.split("|", Qt::SkipEmptyParts);
+        for (int i = 0; i < baseList.size(); ++i) {
+            baseList[i] = baseList[i].trimmed();
+        }
+        QList<bool> isItemMatched(baseList.size(), false);
+        const int listSize = baseList.size();
+        const int middleEnd = listSize >= 3 ? listSize - 3 : listSize - 1;
+
+        // 第一个元素为小区名
+        if (!baseList.isEmpty() && !baseList[0].isEmpty()) {
+            communityName = baseList[0];
+            isItemMatched[0] = true;
+        }
+
+        // 中间元素：面积
+        const Pattern& numRegex = AliRules::get().number;
+        for (int i = 1; i <= middleEnd; ++i) {
+            QString item = baseList[i];
+            if (isItemMatched[i] || item.isEmpty()) continue;
+            if (!item.contains("㎡") && !item.contains("m²")) continue;
+            QRegularExpressionMatch areaNumMatch = numRegex.match(item);
+            if (areaNumMatch.hasMatch()) {
+                area = areaNumMatch.captured(0) + " ㎡";
+                isItemMatched[i] = true;
+                break;
+            }
+        }
+
+        // 中间元素：户型
+        const Pattern& houseTypeRegex = AliRules::get().houseType;
+        for (int i = 1; i <= middleEnd; ++i) {
+            const QString& item = baseList[i];
+            if (isItemMatched[i] || item.isEmpty()) continue;
+            if (houseTypeRegex.match(item).hasMatch()) {
+                houseType = item;
+                isItemMatched[i] = true;
+                break;
+            }
+        }
+
+        // 倒数第二个为城市，倒数第一个为区域
+        if (listSize >= 2) {
+            if (!baseList[listSize - 2].isEmpty()) {
+                city = baseList[listSize - 2];
+                isItemMatched[listSize - 2] = true;
+            }
+            if (!baseList[listSize - 1].isEmpty()) {
+                region = baseList[listSize - 1];
+                isItemMatched[listSize - 1] = true;
+            }
+        }
+
+        // 小区名兜底：取未匹配的最长中文项
+        if (communityName == "未知" || communityName.isEmpty()) {
+            const Pattern& hasChineseRegex = AliRules::get().hasChinese;
+            QString longestCommunity;
+            for (int i = 0; i < baseList.size(); ++i) {
+                const QString& item = baseList[i];
+                if (!isItemMatched[i] && !item.isEmpty() && hasChineseRegex.match(item).hasMatch()
+                    && !item.contains("室") && !item.contains("厅") && !item.contains("卫")
+                    && item.length() > longestCommunity.length()) {
+                    longestCommunity = item;
+                }
+            }
+            communityName = longestCommunity.isEmpty() ? "未知" : longestCommunity;
+        }
+
+        // 城市/区域兜底
+        if (city == "未知" || region == "未知") {
+            const Pattern& pureChineseRegex = AliRules::get().pureChinese;
+            for (int i = 0; i < baseList.size(); ++i) {
+                const QString& item = baseList[i];
+                if (isItemMatched[i] || item.isEmpty()) continue;
+                if (pureChineseRegex.match(item).hasMatch()) {
+                    if (city == "未知" && item.length() <= 4) {
+                        city = item;
+                        isItemMatched[i] = true;
+                    } else if (region == "未知") {
+                        region = item;
+                        isItemMatched[i] = true;
+                    }
+                }
+            }
+        }
+
+        location = city != "未知" && region != "未知" ? QString("%1市%2区").arg(city, region) :
+                       city != "未知" ? QString("%1市").arg(city) : "未知";
+    }
+
+    // 楼层来自标题
+    const Pattern& floorRegex = AliRules::get().floor;
+    QRegularExpressionMatch floorMatch = floorRegex.match(data.houseTitle);
+    QString floor = floorMatch.hasMatch() ? floorMatch.captured(1).trimmed() : "未知";
+
+    // 朝向：标题或基础信息中出现的方位词
+    static const QStringList dirWords = {"东南", "西南", "东北", "西北", "南", "北", "东", "西"};
+    QString dirResult;
+    for (const QString& dir : dirWords) {
+        if (data.houseTitle.contains(dir) || baseText.contains(dir)) {
+            dirResult += dir + " ";
+        }
+    }
+
+    QString totalPrice = priceNum.isEmpty() ? "未知" : QString("%1 万").arg(priceNum);
+    QString unitPrice = "计算失败";
+    if (!priceNum.isEmpty() && area != "未知") {
+        bool priceOk = false, areaOk = false;
+        double price = priceNum.toDouble(&priceOk);
+        double areaVal = QString(area).remove(" ㎡").trimmed().toDouble(&areaOk);
+        if (priceOk && areaOk && areaVal > 0) {
+            unitPrice = QString("%1 元/㎡").arg(QString::number((price * 10000) / areaVal, 'f', 0));
+        }
+    }
+
+    data.communityName = communityName;
+    data.price = totalPrice;
+    data.evalPrice = evalNum.isEmpty() ? "未知" : QString("%1 万").arg(evalNum);
+    data.unitPrice = unitPrice;
+    data.houseType = houseType;
+    data.area = area;
+    data.orientation = dirResult.trimmed().isEmpty() ? "未知" : dirResult.trimmed();
+    data.floor = floor;
+    data.buildingYear = "未知";
+    data.region = region;
+    data.decoration = "未知";
+    data.location = location;
+    data.rent = "未知";
+
+    return unitPrice != "计算失败";
+}
+
+// ===================== 旧正则路径（回退 + 基准对比）=====================
+QList<HouseData> HouseExtractor::extractAnjukeRegex(const QString& html, const QString& city)
+{
+    const CommonRules& common = CommonRules::get();
+    const AnjukeRules& rules = AnjukeRules::get();
+    QList<HouseData> result;
+
+    for (const QRegularExpressionMatch& houseMatch : rules.house.matchAll(html)) {
+        QString houseHtml = houseMatch.captured(0).trimmed();
+        if (houseHtml.isEmpty() || !houseHtml.contains("property-content-title-name")) {
+            continue;
+        }
+
+        HouseData data;
+        data.city = city;
+        data.houseTitle = "未知";
+        data.communityName = "未知";
+        data.price = "未知";
+        data.unitPrice = "未知";
+        data.houseType = "未知";
+        data.houseUrl = "未知";
+
+        QRegularExpressionMatch titleMatch = rules.title.match(houseHtml);
+        if (titleMatch.hasMatch()) {
+            QString title1 = titleMatch.captured(1).trimmed();
+            QString title2 = titleMatch.captured(2).trimmed();
+            data.houseTitle = !title1.isEmpty() ? title1 : title2;
+            common.space.replace(data.houseTitle, " ");
+        } else {
+            QRegularExpressionMatch fallbackMatch = rules.titleFallback.match(houseHtml);
+            if (fallbackMatch.hasMatch()) {
+                data.houseTitle = fallbackMatch.captured(1).trimmed();
+                common.tag.remove(data.houseTitle);
+                common.space.replace(data.houseTitle, " ");
+            }
+        }
+
+        QRegularExpressionMatch communityMatch = rules.community.match(houseHtml);
+        if (communityMatch.hasMatch()) {
+            QString community = communityMatch.captured(1).trimmed();
+            common.tag.remove(community);
+            common.space.replace(community, " ");
+            data.communityName = community.trimmed();
+        }
+
+        QRegularExpressionMatch totalPriceNumMatch = rules.totalPriceNum.match(houseHtml);
+        if (totalPriceNumMatch.hasMatch()) {
+            QRegularExpressionMatch unitMatch = rules.totalPriceText.match(houseHtml);
+            data.price = totalPriceNumMatch.captured(1).trimmed() + (unitMatch.hasMatch() ? unitMatch.captured(1).trimmed() : "");
+        }
+
+        QRegularExpressionMatch unitPriceMatch = rules.unitPrice.match(houseHtml);
+        if (unitPriceMatch.hasMatch()) {
+            QString priceText = unitPriceMatch.captured(1).trimmed();
+            common.space.replace(priceText, " ");
+            if (!priceText.trimmed().isEmpty()) data.unitPrice = priceText.trimmed();
+        }
+
+        QRegularExpressionMatch houseTypeMatch = rules.houseType.match(houseHtml);
+        if (houseTypeMatch.hasMatch()) {
+            QString typeHtml = houseTypeMatch.captured(1).trimmed();
+            common.spanOpen.remove(typeHtml);
+            common.spanClose.remove(typeHtml);
+            common.space.replace(typeHtml, "");
+            if (!typeHtml.trimmed().isEmpty()) data.houseType = typeHtml.trimmed();
+        }
+
+        QStringList baseInfoList;
+        for (const QRegularExpressionMatch& infoMatch : rules.baseInfo.matchAll(houseHtml)) {
+            QString infoHtml = infoMatch.captured(1).trimmed();
+            common.tag.remove(infoHtml);
+            common.space.replace(infoHtml, " ");
+            infoHtml = infoHtml.trimmed();
+            if (!infoHtml.isEmpty()) baseInfoList.append(infoHtml);
+        }
+        classifyAnjukeBaseInfo(baseInfoList, data);
+
+        QRegularExpressionMatch urlMatch = rules.url.match(houseHtml);
+        if (urlMatch.hasMatch()) {
+            data.houseUrl = normalizeAnjukeUrl(urlMatch.captured(1).trimmed());
+        }
+
+        if (!data.houseTitle.isEmpty() && data.houseTitle != "未知") {
+            result.append(data);
+        }
+    }
+    return result;
+}
+
+QList<HouseInfo> HouseExtractor::extractAliRegex(const QString& html, const QString& city)
+{
+    const CommonRules& common = CommonRules::get();
+    const AliRules& rules = AliRules::get();
+    QList<HouseInfo> result;
+
+    for (const QRegularExpressionMatch& houseMatch : rules.house.matchAll(html)) {
+        QString houseHtml = houseMatch.captured(0).trimmed();
+
+        if (rules.endFlag.contains(houseHtml)) continue;
+
+        HouseInfo data;
+        data.city = city;
+        data.houseTitle = "未知";
+        data.houseUrl = "未知";
+
+        QRegularExpressionMatch titleMatch = rules.title.match(houseHtml);
+        if (titleMatch.hasMatch()) {
+            data.houseTitle = titleMatch.captured(1).trimmed();
+        } else {
+            QRegularExpressionMatch titleTextMatch = rules.titleText.match(houseHtml);
+            if (titleTextMatch.hasMatch()) {
+                data.houseTitle = titleTextMatch.captured(1).trimmed();
+                common.tag.remove(data.houseTitle);
+                common.space.replace(data.houseTitle, " ");
+            }
+        }
+        if (isNonHouseTitle(data.houseTitle)) continue;
+
+        QString baseText;
+        QRegularExpressionMatch baseInfoMatch = rules.baseInfo.match(houseHtml);
+        if (baseInfoMatch.hasMatch()) {
+            baseText = baseInfoMatch.captured(1).trimmed();
+            common.tag.remove(baseText);
+            common.space.replace(baseText, " ");
+        }
+
+        QString priceNum;
+        QRegularExpressionMatch priceMatch = rules.totalPrice.match(houseHtml);
+        if (priceMatch.hasMatch()) priceNum = priceMatch.captured(1).trimmed();
+
+        QString evalNum;
+        QRegularExpressionMatch evalMatch = rules.evalPrice.match(houseHtml);
+        if (evalMatch.hasMatch()) evalNum = evalMatch.captured(1).trimmed();
+
+        QRegularExpressionMatch urlMatch = rules.url.match(houseHtml);
+        if (urlMatch.hasMatch()) data.houseUrl = normalizeAliUrl(urlMatch.captured(1).trimmed());
+
+        if (fillAliFields(data, baseText, priceNum, evalNum) && !data.houseUrl.isEmpty()) {
+            result.append(data);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,63 @@
+#ifndef HOUSEEXTRACTOR_H
+#define HOUSEEXTRACTOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "HouseData.h"
+#include "HouseInfo.h"
+
+// 房源页提取方式：Html=toHtml取整页后用Gumbo解析；InPageJson=页面内脚本只回传房源字段JSON
+enum class ExtractMode {
+    Html,
+    InPageJson
+};
+
+/**
+ * @brief 基于Gumbo的房源DOM提取器
+ *
+ * 整页HTML只用gumbo_parse解析一次，然后在DOM树上按标签/class定位房源节点，
+ * 在一次子树遍历中读出标题、小区、总价、单价、面积、楼层、年代等字段。
+ * 替代原先对整页HTML和每个房源片段反复执行的大量DotMatchesEverything正则。
+ *
+ * 旧的正则提取路径保留为 *Regex 版本，仅用于DOM路径失效时的回退和基准测试对比。
+ * 两条路径用到的正则都在 PatternRegistry 里按站点声明（"anjuke"/"ali"/"common"），只编译一次。
+ */
+class HouseExtractor
+{
+public:
+    // 安居客二手房列表页：房源节点为 div.property
+    // listingHash 非空时写入全部房源节点源码的指纹（房源页内容指纹，页面上没有房源节点时为0）
+    static QList<HouseData> extractAnjuke(const QString& html, const QString& city, quint64* listingHash = nullptr);
+
+    // 阿里拍卖房源页：房源卡片为包含标题span(numberoflines=2)和24px价格span的最小容器
+    // listingHash 同上，按全部房源卡片的源码计算
+    static QList<HouseInfo> extractAli(const QString& html, const QString& city, quint64* listingHash = nullptr);
+
+    // 旧正则路径（与原Crawl/AliCrawl::extractHouseData逻辑一致，去掉了逐字段日志）
+    static QList<HouseData> extractAnjukeRegex(const QString& html, const QString& city);
+    static QList<HouseInfo> extractAliRegex(const QString& html, const QString& city);
+
+    // 页面内提取脚本：在渲染进程里按与DOM路径相同的规则定位房源并收集原始字段，
+    // 返回 {"count":房源节点数,"rows":[...]} 形式的紧凑JSON字符串，避免toHtml搬运整页DOM
+    static QString anjukeInPageScript();
+    static QString aliInPageScript();
+
+    // 页面脚本返回的JSON → 房源列表（字段后处理与DOM路径共用）
+    // JSON无效或页面上没有房源节点时返回false，调用方应回退到toHtml路径
+    static bool fromAnjukeJson(const QString& json, const QString& city, QList<HouseData>& out);
+    static bool fromAliJson(const QString& json, const QString& city, QList<HouseInfo>& out);
+
+private:
+    // 安居客基础信息列表 → 面积/朝向/楼层/年代（两条路径共用，保证结果一致）
+    static void classifyAnjukeBaseInfo(const QStringList& baseInfoList, HouseData& data);
+
+    // 阿里字段后处理（基础信息拆分、楼层、朝向、单价计算），两条路径共用
+    static bool fillAliFields(HouseInfo& data, const QString& baseText,
+                              const QString& priceNum, const QString& evalNum);
+
+    // 阿里非住宅关键词过滤（车位、商铺等）
+    static bool isNonHouseTitle(const QString& title);
+};
+
+#endif // HOUSEEXTRACTOR_H
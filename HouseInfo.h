@@ -2,6 +2,7 @@
 #define HOUSEINFO_H
 
 #include <QString>
+#include "HouseRecord.h"
 
 // 房源数据结构体
 struct HouseInfo {
@@ -21,6 +22,7 @@ struct HouseInfo {
     QString decoration;     // 装修情况（如：精装修）
     QString location;  // 具体位置（如：张郭庄地铁站附近）
     QString rent;        // 年租
+    HouseRecord record;  // 数值字段（规范化阶段由上面的显示字段解析）
 };
 
 #endif // HOUSEINFO_H
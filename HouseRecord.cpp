@@ -0,0 +1,217 @@
+#include "HouseRecord.h"
+#include "HouseData.h"
+#include "HouseInfo.h"
+#include "StringPool.h"
+
+const int HouseRecord::MIN_YEAR = 1900;
+const int HouseRecord::MAX_YEAR = 2100;
+
+namespace {
+
+bool isDigit(QChar c)
+{
+    return c >= QLatin1Char('0') && c <= QLatin1Char('9');
+}
+
+// 数字之后（跳过空白）是否紧跟某个单位
+bool unitFollows(QStringView text, qsizetype pos, QStringView unit)
+{
+    while (pos < text.size() && text.at(pos).isSpace()) pos++;
+    return text.mid(pos).startsWith(unit);
+}
+
+// 标记字符之前紧挨着的整数（"3室" → 3），没有数字返回-1
+int numberBefore(QStringView text, qsizetype markPos)
+{
+    qsizetype begin = markPos;
+    while (begin > 0 && text.at(begin - 1).isSpace()) begin--;
+    qsizetype end = begin;
+    while (begin > 0 && isDigit(text.at(begin - 1))) begin--;
+    if (begin == end) return -1;
+    int value = 0;
+    for (qsizetype i = begin; i < end; ++i) {
+        value = value * 10 + (text.at(i).unicode() - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+bool HouseRecord::firstNumber(QStringView text, double& value, qsizetype *endPos)
+{
+    qsizetype i = 0;
+    while (i < text.size() && !isDigit(text.at(i))) i++;
+    if (i == text.size()) return false;
+
+    double integer = 0;
+    for (; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+        if (isDigit(c)) {
+            integer = integer * 10 + (c.unicode() - '0');
+        } else if (c == QLatin1Char(',') && i + 1 < text.size() && isDigit(text.at(i + 1))) {
+            continue;   // 千分位
+        } else {
+            break;
+        }
+    }
+    double fraction = 0;
+    if (i + 1 < text.size() && text.at(i) == QLatin1Char('.') && isDigit(text.at(i + 1))) {
+        double scale = 0.1;
+        for (++i; i < text.size() && isDigit(text.at(i)); ++i) {
+            fraction += (text.at(i).unicode() - '0') * scale;
+            scale /= 10;
+        }
+    }
+    value = integer + fraction;
+    if (endPos != nullptr) *endPos = i;
+    return true;
+}
+
+bool HouseRecord::parsePriceWan(QStringView text, double& wan)
+{
+    qsizetype end = 0;
+    double value = 0;
+    if (!firstNumber(text, value, &end)) return false;
+    if (unitFollows(text, end, u"亿")) {
+        value *= 10000;
+    } else if (!unitFollows(text, end, u"万") && unitFollows(text, end, u"元")) {
+        value /= 10000;
+    }
+    if (value <= 0) return false;
+    wan = value;
+    return true;
+}
+
+bool HouseRecord::parseUnitPrice(QStringView text, double& yuan)
+{
+    qsizetype end = 0;
+    double value = 0;
+    if (!firstNumber(text, value, &end)) return false;
+    if (unitFollows(text, end, u"万")) value *= 10000;
+    if (value <= 0) return false;
+    yuan = value;
+    return true;
+}
+
+bool HouseRecord::parseArea(QStringView text, double& sqm)
+{
+    double value = 0;
+    if (!firstNumber(text, value) || value <= 0) return false;
+    sqm = value;
+    return true;
+}
+
+bool HouseRecord::parseYear(QStringView text, int& year)
+{
+    double value = 0;
+    if (!firstNumber(text, value)) return false;
+    const int y = static_cast<int>(value);
+    if (y < MIN_YEAR || y > MAX_YEAR) return false;
+    year = y;
+    return true;
+}
+
+bool HouseRecord::parseLayout(QStringView text, int& rooms, int& halls)
+{
+    const qsizetype roomPos = text.indexOf(u'室');
+    if (roomPos < 0) return false;
+    const int r = numberBefore(text, roomPos);
+    if (r <= 0) return false;
+    const qsizetype hallPos = text.indexOf(u'厅', roomPos);
+    const int h = hallPos < 0 ? 0 : numberBefore(text, hallPos);
+    rooms = r;
+    halls = qMax(0, h);
+    return true;
+}
+
+bool HouseRecord::parseFloor(QStringView text, Level& level, int& totalFloors)
+{
+    Level l = Level::Unknown;
+    if (text.contains(u'低')) l = Level::Low;
+    else if (text.contains(u'中')) l = Level::Middle;
+    else if (text.contains(u'高')) l = Level::High;
+
+    int total = 0;
+    const qsizetype gong = text.indexOf(u'共');
+    double value = 0;
+    if (gong >= 0 && firstNumber(text.mid(gong), value)) {
+        total = static_cast<int>(value);
+    } else if (l == Level::Unknown) {
+        // 没有档位时形如“6层”的是整栋层数
+        const qsizetype layer = text.indexOf(u'层');
+        if (layer > 0) total = qMax(0, numberBefore(text, layer));
+    }
+    if (l == Level::Unknown && total <= 0) return false;
+    level = l;
+    totalFloors = total;
+    return true;
+}
+
+void HouseRecord::setFloor(QStringView floorText)
+{
+    if (!parseFloor(floorText, floorLevel, totalFloors)) return;
+    if (floorLevel != Level::Unknown) valid |= FloorLevel;
+    if (totalFloors > 0) valid |= TotalFloors;
+}
+
+namespace {
+
+void parseCommon(HouseRecord& r, const QString& price, const QString& unitPrice, const QString& area,
+                 const QString& buildingYear, const QString& houseType, const QString& floor)
+{
+    if (HouseRecord::parsePriceWan(price, r.priceWan)) r.valid |= HouseRecord::Price;
+    if (HouseRecord::parseUnitPrice(unitPrice, r.unitPriceYuan)) r.valid |= HouseRecord::UnitPrice;
+    if (HouseRecord::parseArea(area, r.areaSqm)) r.valid |= HouseRecord::Area;
+    if (HouseRecord::parseYear(buildingYear, r.buildingYear)) r.valid |= HouseRecord::BuildingYear;
+    if (HouseRecord::parseLayout(houseType, r.rooms, r.halls)) r.valid |= HouseRecord::Layout;
+    r.setFloor(floor);
+    r.parsed = true;
+}
+
+} // namespace
+
+HouseRecord HouseRecord::fromHouse(const HouseData& data)
+{
+    HouseRecord r;
+    parseCommon(r, data.price, data.unitPrice, data.area, data.buildingYear, data.houseType, data.floor);
+    return r;
+}
+
+HouseRecord HouseRecord::fromHouse(const HouseInfo& data)
+{
+    HouseRecord r;
+    parseCommon(r, data.price, data.unitPrice, data.area, data.buildingYear, data.houseType, data.floor);
+    if (parsePriceWan(data.evalPrice, r.evalPriceWan)) r.valid |= EvalPrice;
+    return r;
+}
+
+namespace {
+
+void internField(StringPool& pool, QString& field, quint32& id)
+{
+    id = pool.intern(field);
+    field = pool.text(id);
+}
+
+} // namespace
+
+void HouseRecord::internFields(HouseData& data)
+{
+    StringPool& pool = StringPool::shared();
+    internField(pool, data.city, data.record.cityId);
+    internField(pool, data.communityName, data.record.communityId);
+    internField(pool, data.houseType, data.record.houseTypeId);
+    internField(pool, data.orientation, data.record.orientationId);
+    internField(pool, data.decoration, data.record.decorationId);
+}
+
+void HouseRecord::internFields(HouseInfo& data)
+{
+    StringPool& pool = StringPool::shared();
+    internField(pool, data.city, data.record.cityId);
+    internField(pool, data.communityName, data.record.communityId);
+    internField(pool, data.houseType, data.record.houseTypeId);
+    internField(pool, data.orientation, data.record.orientationId);
+    internField(pool, data.decoration, data.record.decorationId);
+    internField(pool, data.region, data.record.regionId);
+}
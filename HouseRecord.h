@@ -0,0 +1,91 @@
+#ifndef HOUSERECORD_H
+#define HOUSERECORD_H
+
+#include <QString>
+#include <QStringView>
+
+struct HouseData;
+struct HouseInfo;
+
+/**
+ * @brief 房源的数值字段（两个站点共用的类型化记录）
+ *
+ * HouseData/HouseInfo 里的总价、单价、面积、年代是给界面看的字符串（"500万"、"120㎡"），
+ * 数值在流水线规范化阶段（工作线程）解析一次存到这里，入库、排序、筛选、特征工程直接用数字。
+ * 每个字段有对应的有效位：页面上缺失或写着“未知”“计算失败”的字段无效，数值保持0。
+ */
+struct HouseRecord {
+    enum Field : quint16 {
+        Price        = 0x0001,  // 总价（万）
+        EvalPrice    = 0x0002,  // 评估价（万，仅阿里）
+        UnitPrice    = 0x0004,  // 单价（元/㎡）
+        Area         = 0x0008,  // 面积（㎡）
+        BuildingYear = 0x0010,  // 建造年份
+        Layout       = 0x0020,  // 几室几厅
+        FloorLevel   = 0x0040,  // 低/中/高楼层
+        TotalFloors  = 0x0080   // 总层数
+    };
+
+    enum class Level : quint8 {
+        Unknown,
+        Low,
+        Middle,
+        High
+    };
+
+    double priceWan = 0;
+    double evalPriceWan = 0;
+    double unitPriceYuan = 0;
+    double areaSqm = 0;
+    int buildingYear = 0;
+    int rooms = 0;
+    int halls = 0;
+    int totalFloors = 0;
+    Level floorLevel = Level::Unknown;
+    quint16 valid = 0;          // Field 位组合
+
+    // 重复率高的文本字段在 StringPool 里的编号（0 为空串）：相等判断、分组、筛选直接比编号
+    quint32 cityId = 0;
+    quint32 communityId = 0;
+    quint32 houseTypeId = 0;
+    quint32 orientationId = 0;
+    quint32 decorationId = 0;
+    quint32 regionId = 0;       // 仅阿里
+
+    quint32 clusterId = 0;      // EntityResolver 的簇编号（同一套房子在各来源的房源相同），0 表示未识别
+    bool parsed = false;        // false：尚未从显示字段解析（如不经过流水线直接构造的 HouseData）
+
+    bool has(Field field) const { return (valid & field) != 0; }
+
+    // 入库约定：无效的数值字段写 -1
+    double priceForDb() const { return has(Price) ? priceWan : -1; }
+    double unitPriceForDb() const { return has(UnitPrice) ? unitPriceYuan : -1; }
+    double areaForDb() const { return has(Area) ? areaSqm : -1; }
+    int buildingYearForDb() const { return has(BuildingYear) ? buildingYear : -1; }
+
+    // 解析楼层文本，设置 floorLevel/totalFloors 及其有效位
+    void setFloor(QStringView floorText);
+
+    // 由显示字段解析（安居客/阿里的单位写法不同，统一在这里处理）
+    static HouseRecord fromHouse(const HouseData& data);
+    static HouseRecord fromHouse(const HouseInfo& data);
+
+    // 上述文本字段换成 StringPool 里的共享实例，并把编号写入 data.record（规范化阶段在 fromHouse 之后调用）
+    static void internFields(HouseData& data);
+    static void internFields(HouseInfo& data);
+
+    // 单字段解析，失败返回false（界面筛选、特征工程等只有字符串的地方共用）
+    static bool parsePriceWan(QStringView text, double& wan);        // "500万" "500 万" "1.2亿"
+    static bool parseUnitPrice(QStringView text, double& yuan);      // "45000元/㎡" "4.5万/㎡"
+    static bool parseArea(QStringView text, double& sqm);            // "89.5㎡" "89.5 m²"
+    static bool parseYear(QStringView text, int& year);              // "2010年建造" "2010年"
+    static bool parseLayout(QStringView text, int& rooms, int& halls); // "3室2厅"
+    static bool parseFloor(QStringView text, Level& level, int& totalFloors); // "中楼层(共18层)"
+    // 第一个数字（允许千分位逗号），不拼接后面的数字
+    static bool firstNumber(QStringView text, double& value, qsizetype *endPos = nullptr);
+
+    static const int MIN_YEAR;
+    static const int MAX_YEAR;
+};
+
+#endif // HOUSERECORD_H
@@ -1,36 +1,111 @@
-// KeCrawler.h
-#ifndef KECRAWLER_H
-#define KECRAWLER_H
-
-#include "BaseCrawler.h"
-
-class KeCrawler : public BaseCrawler {
-    Q_OBJECT
-public:
-    explicit KeCrawler(QObject *parent = nullptr, QWebEnginePage *page = nullptr)
-        : BaseCrawler(parent, page) {
-        // 贝壳特定初始化（如Cookie加载）
-        loadCookiesFromFile("ke_cookies.txt");
+// KeCrawler.cpp
+#include "KeCrawler.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QUrl>
+
+const QString KeCrawler::RULES_PATH = "rules/ke.json";
+
+QString KeCrawler::resolveRulesPath(const QString& path)
+{
+    if (QDir::isAbsolutePath(path)) return path;
+    return QDir(QCoreApplication::applicationDirPath()).filePath(path);
+}
+
+KeCrawler::KeCrawler(QObject *parent, QWebEnginePage *page, const QString& rulesPath)
+    : BaseCrawler(parent, page), rules(std::make_shared<SiteRules>())
+{
+    const QString path = resolveRulesPath(rulesPath);
+    if (!rules->load(path, &rulesError)) {
+        rulesError = QString("❌ 贝壳规则文件加载失败（%1）：%2").arg(path, rulesError);
     }
+    openFrontier("ke");
+    connect(webPage, &QWebEnginePage::loadFinished, this, &KeCrawler::onPageLoadFinished);
+
+    // 提取在工作线程执行，只用规则对象（只读）和页面参数；去重、增量重爬、入库与安居客/阿里共用。
+    // 页面在汇总、交给写线程之后才标记完成，中途崩溃重启后会重新抓取
+    std::shared_ptr<const SiteRules> program = rules;
+    listings.start(rules->name(),
+                   [program](const Listings::Page& page) { return extractPage(*program, page); },
+                   {[this](const QString& line) { emit appendLogSignal(line); },
+                    [this](const QString& url, int, int) { frontier.markDone(url); },
+                    {}});
+}
 
-    void startCrawl(const QString& city, int targetPages) override {
-        currentCity = city;
-        targetPageCount = targetPages;
-        // 贝壳URL生成逻辑（复用原startHouseCrawl核心代码）
-        QString cityPinyin = cityToPinyin(city);
-        QString url = QString("https://%1.ke.com/ershoufang/pg%2/")
-                          .arg(cityPinyin).arg(targetPages);
-        urlQueue.enqueue(url);
-        emit appendLogSignal("贝壳爬取任务启动：" + url);
-        processNextUrl(); // 开始处理队列
+KeCrawler::Listings::Extracted KeCrawler::extractPage(const SiteRules& program, const Listings::Page& page)
+{
+    Listings::Extracted result;
+    result.url = page.url;
+    result.city = page.city;
+    result.inputChars = page.html.size();
+    QElapsedTimer timer;
+    timer.start();
+    result.records = program.extract(page.html, page.city, page.url);
+    result.parseMs = timer.elapsed();
+    return result;
+}
+
+void KeCrawler::startCrawl(const QString& city, int targetPages) {
+    if (!rules->isLoaded()) {
+        emit appendLogSignal(rulesError);
+        return;
     }
+    currentCity = city;
+    targetPageCount = targetPages;
 
-private:
-    // 复用原贝壳特有的方法（城市转拼音、数据提取等）
-    QString cityToPinyin(const QString& cityName) { /* 原实现 */ }
-    void extractHouseData(const QString& html) { /* 原实现，适配贝壳HTML */ }
-    void processNextUrl() { /* 原实现，处理贝壳URL */ }
-    void loadCookiesFromFile(const QString& path) { /* 原实现 */ }
-};
+    // 同一任务上次没爬完时从中断处继续，否则清空队列重新开始
+    const QString jobKey = QString("%1|%2").arg(city).arg(targetPages);
+    if (frontier.jobKey() != jobKey || !frontier.hasUnfinished()) {
+        frontier.reset(jobKey);
+    }
+    for (int page = 1; page <= targetPages; ++page) {
+        const QString url = rules->listUrl(city, page);
+        if (url.isEmpty()) {
+            emit appendLogSignal(QString("⚠️ %1 规则文件里没有城市「%2」的子域名").arg(rules->name(), city));
+            return;
+        }
+        frontier.enqueue(url, page - 1, city);
+    }
+    emit appendLogSignal(QString("🚀 %1爬取任务启动：%2，共%3页").arg(rules->name(), city).arg(targetPages));
+    processNextUrl();
+}
+
+void KeCrawler::processNextUrl() {
+    // 提取跟不上时先暂停抓取
+    if (listings.saturated()) {
+        QTimer::singleShot(200, this, &KeCrawler::processNextUrl);
+        return;
+    }
+    currentUrl = frontier.takeNext();
+    if (currentUrl.isEmpty()) {
+        // 最后几页可能还在提取：汇总完再报结果
+        listings.whenDrained([this]() {
+            emit appendLogSignal(QString("✅ %1爬取完成：共%2条房源").arg(rules->name()).arg(listings.houses().size()));
+            for (const QString& line : listings.summary()) {
+                emit appendLogSignal(line);
+            }
+        });
+        return;
+    }
+
+    emit appendLogSignal("🌐 加载页面：" + currentUrl);
+    webPage->load(QUrl(currentUrl));
+}
+
+void KeCrawler::onPageLoadFinished(bool ok) {
+    const QString url = currentUrl;
+    const int delayMs = 1500 + QRandomGenerator::global()->bounded(2000);
+    if (!ok) {
+        const bool retry = frontier.markFailed(url);
+        emit appendLogSignal(QString("❌ 页面加载失败%1：%2").arg(retry ? "，稍后重试" : "，已放弃", url));
+        QTimer::singleShot(delayMs, this, &KeCrawler::processNextUrl);
+        return;
+    }
 
-#endif // KECRAWLER_H
+    webPage->toHtml([this, url, delayMs](const QString& html) {
+        listings.submit(url, frontier.tag(url).isEmpty() ? currentCity : frontier.tag(url), html, QString());
+        QTimer::singleShot(delayMs, this, &KeCrawler::processNextUrl);
+    });
+}
@@ -3,34 +3,37 @@
 #define KECRAWLER_H
 
 #include "BaseCrawler.h"
+#include "SiteRules.h"
+#include <memory>
 
+/**
+ * @brief 贝壳二手房爬虫：选择器、字段、单位、城市子域名全部在规则文件 rules/ke.json 里，
+ * 这里只负责按页加载列表页、把HTML交给流水线按规则提取、汇总入库。
+ * 页面改版时改规则文件即可，不需要重新编译。
+ */
 class KeCrawler : public BaseCrawler {
     Q_OBJECT
 public:
-    explicit KeCrawler(QObject *parent = nullptr, QWebEnginePage *page = nullptr)
-        : BaseCrawler(parent, page) {
-        // 贝壳特定初始化（如Cookie加载）
-        loadCookiesFromFile("ke_cookies.txt");
-    }
-
-    void startCrawl(const QString& city, int targetPages) override {
-        currentCity = city;
-        targetPageCount = targetPages;
-        // 贝壳URL生成逻辑（复用原startHouseCrawl核心代码）
-        QString cityPinyin = cityToPinyin(city);
-        QString url = QString("https://%1.ke.com/ershoufang/pg%2/")
-                          .arg(cityPinyin).arg(targetPages);
-        urlQueue.enqueue(url);
-        emit appendLogSignal("贝壳爬取任务启动：" + url);
-        processNextUrl(); // 开始处理队列
-    }
+    // rulesPath 为相对路径时按可执行文件所在目录解析
+    explicit KeCrawler(QObject *parent = nullptr, QWebEnginePage *page = nullptr,
+                       const QString& rulesPath = RULES_PATH);
+
+    void startCrawl(const QString& city, int targetPages) override;
+
+    static const QString RULES_PATH;
+    // 规则文件随程序部署（CMake 复制到可执行文件旁边），CrawlDaemon --workdir 切换工作目录后也能找到
+    static QString resolveRulesPath(const QString& path);
+
+private slots:
+    void onPageLoadFinished(bool ok);
 
 private:
-    // 复用原贝壳特有的方法（城市转拼音、数据提取等）
-    QString cityToPinyin(const QString& cityName) { /* 原实现 */ }
-    void extractHouseData(const QString& html) { /* 原实现，适配贝壳HTML */ }
-    void processNextUrl() { /* 原实现，处理贝壳URL */ }
-    void loadCookiesFromFile(const QString& path) { /* 原实现 */ }
+    void processNextUrl();
+    static Listings::Extracted extractPage(const SiteRules& program, const Listings::Page& page);  // 工作线程
+
+    std::shared_ptr<SiteRules> rules;   // 加载后只读，提取线程共用
+    QString rulesError;
+    QString currentUrl;
 };
 
 #endif // KECRAWLER_H
@@ -0,0 +1,61 @@
+#include "ListingPipeline.h"
+#include <QChar>
+
+// 字段哈希：字段间用单元分隔符隔开，避免相邻字段拼接产生歧义
+
+void ListingTraits<HouseData>::simplifyFields(HouseData& data)
+{
+    for (QString *field : {&data.houseTitle, &data.communityName, &data.price, &data.unitPrice, &data.area,
+                           &data.houseType, &data.orientation, &data.floor, &data.decoration, &data.buildingYear}) {
+        *field = field->simplified();
+    }
+}
+
+quint64 ListingTraits<HouseData>::contentHash(const HouseData& data)
+{
+    const QString joined = QStringList{data.houseTitle, data.communityName, data.price, data.unitPrice, data.area,
+                                       data.houseType, data.orientation, data.floor, data.decoration,
+                                       data.buildingYear}.join(QChar(0x1f));
+    return ContentFingerprintStore::hashText(joined);
+}
+
+bool ListingTraits<HouseData>::persist(Mysql& db, const HouseData& data, bool update)
+{
+    return update ? db.updateInfo(data) : db.insertInfo(data);
+}
+
+QString ListingTraits<HouseData>::describe(const HouseData& data)
+{
+    return QString("%1 | 小区=%2 | 总价=%3 | 户型=%4 | 面积=%5 | 朝向=%6 | 楼层=%7 | 年代=%8")
+        .arg(data.houseTitle, data.communityName, data.price, data.houseType,
+             data.area, data.orientation, data.floor, data.buildingYear);
+}
+
+void ListingTraits<HouseInfo>::simplifyFields(HouseInfo& data)
+{
+    for (QString *field : {&data.houseTitle, &data.communityName, &data.price, &data.evalPrice, &data.unitPrice,
+                           &data.houseType, &data.area, &data.orientation, &data.floor, &data.buildingYear,
+                           &data.region, &data.decoration, &data.location, &data.rent}) {
+        *field = field->simplified();
+    }
+}
+
+quint64 ListingTraits<HouseInfo>::contentHash(const HouseInfo& data)
+{
+    const QString joined = QStringList{data.houseTitle, data.communityName, data.price, data.evalPrice,
+                                       data.unitPrice, data.houseType, data.area, data.orientation, data.floor,
+                                       data.buildingYear, data.region, data.decoration, data.location,
+                                       data.rent}.join(QChar(0x1f));
+    return ContentFingerprintStore::hashText(joined);
+}
+
+bool ListingTraits<HouseInfo>::persist(Mysql& db, const HouseInfo& data, bool update)
+{
+    return update ? db.updateAlInfo(data) : db.insertAlInfo(data);
+}
+
+QString ListingTraits<HouseInfo>::describe(const HouseInfo& data)
+{
+    return QString("%1 | 小区=%2 | 总价=%3 | 单价=%4 | 面积=%5 | 位置=%6")
+        .arg(data.houseTitle, data.communityName, data.price, data.unitPrice, data.area, data.location);
+}
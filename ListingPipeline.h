@@ -0,0 +1,414 @@
+#ifndef LISTINGPIPELINE_H
+#define LISTINGPIPELINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include "CrawlPipeline.h"
+#include "ContentFingerprintStore.h"
+#include "SimHashIndex.h"
+#include "EntityResolver.h"
+#include "UrlDedupStore.h"
+#include "HouseRecord.h"
+#include "HouseData.h"
+#include "HouseInfo.h"
+#include "MYSQL.h"
+
+/**
+ * @brief 各房源类型各自的部分：参与规范化/内容哈希的字段、入库用的表、日志里展示的字段。
+ * 特化在 ListingPipeline.cpp
+ */
+template <typename Record>
+struct ListingTraits;
+
+template <>
+struct ListingTraits<HouseData> {
+    static void simplifyFields(HouseData& data);
+    static quint64 contentHash(const HouseData& data);      // 规范化后字段的哈希（增量重爬判断房源是否有变化）
+    static bool persist(Mysql& db, const HouseData& data, bool update);     // 写入成功返回true
+    static QString describe(const HouseData& data);
+};
+
+template <>
+struct ListingTraits<HouseInfo> {
+    static void simplifyFields(HouseInfo& data);
+    static quint64 contentHash(const HouseInfo& data);
+    static bool persist(Mysql& db, const HouseInfo& data, bool update);
+    static QString describe(const HouseInfo& data);
+};
+
+/**
+ * @brief 房源汇总流程：提取 → 规范化 → 去重 → 入库，各站点爬虫共用
+ *
+ * 在 CrawlPipeline 之上补齐各爬虫原先各写一份的部分：
+ * - 页指纹（<prefix>.pagefp）：提交时查出上次的指纹，提取线程解析前先对页面内JSON或房源列表区域取哈希，
+ *   与上次相同就不再解析和入库（这些页的房源不进本轮结果，unchangedPages() 计数）；页指纹在该页的房源全部写入成功后才记录；
+ * - 本轮URL去重、近重复（<prefix>.simhash）、跨来源实体归并；
+ * - 房源指纹（<prefix>.housefp）：往期已收录的房源只在内容有变化时更新入库；
+ *   URL指纹（UrlDedupStore）和房源指纹都在写线程写入成功之后才记录，写入失败的房源下次运行照常重试；
+ * - 写线程自建数据库连接，按 ListingTraits 写入对应的表。
+ * 爬虫只提供本站点的提取函数和几个回调（日志、翻页判断、房源更新通知），均在 owner 线程调用。
+ */
+template <typename Record>
+class ListingPipeline
+{
+public:
+    using Pipeline = CrawlPipeline<Record>;
+    using Page = typename Pipeline::Page;
+    using Extracted = typename Pipeline::Extracted;
+    using ExtractFn = typename Pipeline::ExtractFn;
+    using PersistOp = typename Pipeline::PersistOp;
+    using Traits = ListingTraits<Record>;
+
+    // 站点的HTML/JSON解析函数（HouseExtractor 里的静态函数），由 extractWith 组合成提取函数
+    struct Parsers {
+        bool (*fromJson)(const QString& json, const QString& city, QList<Record>& out) = nullptr;
+        QList<Record> (*fromHtml)(const QString& html, const QString& city, quint64* listingHash) = nullptr;
+        QList<Record> (*fromRegex)(const QString& html, const QString& city) = nullptr;
+        const char *regexMarker = nullptr;   // DOM提取为空但HTML含此标记：页面结构有变化，回退正则
+        const char *cardMarker = nullptr;    // 房源卡片的开始标签，解析前据此截取列表区域取哈希
+    };
+
+    struct Hooks {
+        std::function<void(const QString&)> log;
+        // 一页汇总完成（houseCount<0：页面内容与上次一致，未提取）；newCount 为新增与有变化的房源数
+        std::function<void(const QString& url, int houseCount, int newCount)> pageStored;
+        std::function<void(const QString& houseUrl)> listingUpdated;
+    };
+
+    explicit ListingPipeline(QObject *owner)
+        : pipeline(owner, qBound(1, QThread::idealThreadCount() - 1, 4), 64)
+    {
+    }
+
+    ~ListingPipeline()
+    {
+        stop();
+        close();
+    }
+
+    ListingPipeline(const ListingPipeline&) = delete;
+    ListingPipeline& operator=(const ListingPipeline&) = delete;
+
+    // 打开增量重爬与近重复的持久化文件：<prefix>.pagefp、.housefp、.simhash
+    void open(const QString& prefix)
+    {
+        pageFingerprints.open(prefix + ".pagefp");
+        listingFingerprints.open(prefix + ".housefp");
+        nearDuplicates.open(prefix + ".simhash");
+    }
+
+    void close()
+    {
+        pageFingerprints.close();
+        listingFingerprints.close();
+        nearDuplicates.close();
+    }
+
+    // siteName 只用于日志；extract 在工作线程执行，只能用参数
+    void start(const QString& siteName, ExtractFn extract, Hooks callbacks)
+    {
+        site = siteName;
+        hooks = std::move(callbacks);
+        // 写线程自建数据库连接（QSqlDatabase 连接只能在创建它的线程使用）
+        auto writerDb = std::make_shared<Mysql*>(nullptr);
+        pipeline.start(extract, &ListingPipeline::normalize,
+                       [this](const Extracted& result) { handleExtracted(result); },
+                       [writerDb](const Record& data, PersistOp op) {
+                           return Traits::persist(**writerDb, data, op == PersistOp::Update);
+                       },
+                       [this](const Record& data, PersistOp) { onPersisted(data); },
+                       [writerDb]() { *writerDb = new Mysql(); (*writerDb)->connectDatabase(); },
+                       [writerDb]() { (*writerDb)->close(); delete *writerDb; *writerDb = nullptr; });
+    }
+
+    // 排空队列，已交给写线程的房源全部入库后返回
+    void stop() { pipeline.stop(); }
+
+    // 新一轮爬取：清空结果列表、本轮去重集合和计数（写线程上还没确认的页指纹照常等待）
+    void resetRun()
+    {
+        results.clear();
+        seen.clear();
+        skippedPages = 0;
+        nearDuplicateCount = 0;
+    }
+
+    // 抓到的房源页交给提取线程池；队列已满时暂存在本地，由流水线定时补交
+    bool submit(const QString& url, const QString& city, const QString& html, const QString& json)
+    {
+        Page page;
+        page.url = url;
+        page.city = city;
+        page.html = html;
+        page.json = json;
+        page.previousHash = url.isEmpty() ? 0 : pageFingerprints.lookup(UrlDedupStore::fingerprint(url));
+        if (pipeline.submit(page)) return true;
+        log("🚦 提取队列已满，房源页暂存等待：" + url);
+        return false;
+    }
+
+    // 同步汇总（回放用）：在本线程规范化后走与流水线结果相同的去重入库流程
+    void process(Extracted result)
+    {
+        for (Record& data : result.records) normalize(data);
+        handleExtracted(result);
+    }
+
+    // 流水线中的页面全部汇总完成后调用 done（当前没有在途页面时立即调用）
+    void whenDrained(std::function<void()> done)
+    {
+        if (pipeline.pendingPages() == 0) {
+            done();
+            return;
+        }
+        drained = std::move(done);
+    }
+
+    bool saturated() const { return pipeline.saturated(); }
+    int pendingPages() const { return pipeline.pendingPages(); }
+    QList<Record>& houses() { return results; }
+    const QList<Record>& houses() const { return results; }
+    int unchangedPages() const { return skippedPages; }   // 本轮与上次相同、未解析的房源页（房源不在 houses() 里）
+
+    // 一轮结束时的统计：增量重爬、近重复、各阶段指标
+    QStringList summary() const
+    {
+        QStringList lines;
+        if (skippedPages > 0) {
+            lines.append(QString("♻️ 增量重爬：%1个房源页内容未变化，已跳过解析和入库").arg(skippedPages));
+        }
+        if (nearDuplicateCount > 0) {
+            lines.append(QString("🪞 近重复检测：跳过%1条重复发布的房源（指纹库共%2条）")
+                             .arg(nearDuplicateCount).arg(nearDuplicates.size()));
+        }
+        lines.append(pipeline.metricsSummary());
+        const quint64 unrecorded = UrlDedupStore::shared().unrecordedCount();
+        if (unrecorded > 0) {
+            lines.append(QString("⚠️ 去重库未打开或已满：%1条房源未记录，下次运行会当作新房源重新入库").arg(unrecorded));
+        }
+        return lines;
+    }
+
+    // 单页提取（工作线程）：优先页面内提取的JSON，无效时回退整页HTML（DOM提取，整页只解析一次；DOM未命中再回退正则）。
+    // 解析前先取内容指纹，与上次相同直接返回 unchanged
+    static Extracted extractWith(const Page& page, const Parsers& parsers)
+    {
+        Extracted result;
+        result.url = page.url;
+        result.city = page.city;
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!page.json.isEmpty()) {
+            result.contentHash = ContentFingerprintStore::hashText(page.json);
+            result.inputChars = page.json.length();
+            if (page.previousHash != 0 && result.contentHash == page.previousHash) {
+                result.fromJson = true;
+                result.unchanged = true;
+                return result;
+            }
+            if (parsers.fromJson(page.json, page.city, result.records)) {
+                result.fromJson = true;
+                result.parseMs = timer.elapsed();
+                return result;
+            }
+            result.records.clear();
+            result.contentHash = 0;
+            if (page.html.isEmpty()) {
+                result.jsonRejected = true;
+                return result;
+            }
+        }
+
+        result.inputChars = page.html.length();
+        if (parsers.cardMarker != nullptr) {
+            result.contentHash = ContentFingerprintStore::hashSlice(page.html, QLatin1String(parsers.cardMarker),
+                                                                   QLatin1String("<script"));
+            if (page.previousHash != 0 && result.contentHash == page.previousHash) {
+                result.unchanged = true;
+                return result;
+            }
+        }
+        result.records = parsers.fromHtml(page.html, page.city, nullptr);
+        if (result.records.isEmpty() && parsers.fromRegex != nullptr && parsers.regexMarker != nullptr
+            && page.html.contains(QLatin1String(parsers.regexMarker))) {
+            result.notes.append("⚠️  DOM提取未命中房源节点，回退到正则提取");
+            result.records = parsers.fromRegex(page.html, page.city);
+        }
+        result.parseMs = timer.elapsed();
+        return result;
+    }
+
+    // 规范化（工作线程）：压缩字段空白，房源链接统一成去重用的规范形式，数值字段解析一次存入 record，
+    // 小区名等重复字段换成字符串字典里的共享实例
+    static void normalize(Record& data)
+    {
+        Traits::simplifyFields(data);
+        data.houseUrl = UrlDedupStore::normalizeUrl(data.houseUrl.trimmed());
+        data.record = HouseRecord::fromHouse(data);
+        HouseRecord::internFields(data);
+    }
+
+private:
+    void log(const QString& line) const
+    {
+        if (hooks.log) hooks.log(line);
+    }
+
+    // 提取结果回到本线程：写日志、比较页指纹、去重入库，再交给爬虫判断翻页
+    void handleExtracted(const Extracted& result)
+    {
+        if (result.unchanged) {
+            // 页面内JSON/房源列表区域与上次抓取时完全相同：没有解析，也不去重入库
+            skippedPages++;
+            log("♻️ 房源页内容与上次一致，跳过解析和入库：" + result.url);
+            if (hooks.pageStored) hooks.pageStored(result.url, -1, 0);
+            finishIfDrained();
+            return;
+        }
+
+        if (result.jsonRejected) {
+            log("⚠️  页面内提取结果无效，且没有整页HTML可回退：" + result.url);
+        } else if (result.fromJson) {
+            log(QString("⚡ 页面内提取：JSON %1字符，解析耗时%2 ms，识别房源%3条")
+                    .arg(result.inputChars).arg(result.parseMs).arg(result.records.size()));
+        } else {
+            log(QString("🔍 开始提取%1房源数据...").arg(site));
+            for (const QString& note : result.notes) {
+                log(note);
+            }
+            log(QString("⏱️ 解析耗时：%1 ms（HTML长度=%2字符，识别房源%3条）")
+                    .arg(result.parseMs).arg(result.inputChars).arg(result.records.size()));
+        }
+        // 提取出房源才记录页指纹：空页/提取失败的页下次照常重新提取
+        const quint64 pageKey = result.url.isEmpty() || result.records.isEmpty() ? 0 : UrlDedupStore::fingerprint(result.url);
+        const int newCount = storeHouses(result.records, pageKey, result.contentHash);
+        if (!result.url.isEmpty() && hooks.pageStored) {
+            hooks.pageStored(result.url, result.records.size(), newCount);
+        }
+        finishIfDrained();
+    }
+
+    void finishIfDrained()
+    {
+        if (drained && pipeline.pendingPages() == 0) {
+            std::function<void()> done = std::move(drained);
+            drained = nullptr;
+            done();
+        }
+    }
+
+    // 去重后加入结果列表；历次运行都没见过的房源写入数据库，往期已收录但内容有变化的更新原记录。
+    // 页指纹（pageKey 为0时不记录）等本页交给写线程的房源全部写入成功后再记录，有写入失败的页下次照常解析。
+    // 返回新增与有变化的房源数（用于判断是否继续翻页）
+    int storeHouses(const QList<Record>& pageHouses, quint64 pageKey, quint64 pageHash)
+    {
+        int storedCount = 0;
+        int newCount = 0;
+        int changedCount = 0;
+        int unchangedCount = 0;
+        for (const Record& data : pageHouses) {
+            const quint64 fp = UrlDedupStore::fingerprint(data.houseUrl);
+            if (seen.contains(fp)) {
+                log("🚫 房源重复，已过滤：" + data.houseUrl);
+                continue;
+            }
+            seen.insert(fp);
+            // URL不同但标题/小区/户型/面积/总价几乎相同：同一套房子重复发布，不进结果也不入库
+            const quint64 simhash = SimHashIndex::fingerprint(data);
+            SimHashIndex::Hit nearHit;
+            if (nearDuplicates.findNear(simhash, fp, &nearHit)) {
+                nearDuplicateCount++;
+                log(QString("🪞 疑似重复发布（海明距离%1），已跳过：%2").arg(nearHit.distance).arg(data.houseUrl));
+                continue;
+            }
+            nearDuplicates.insert(fp, simhash);
+            const EntityResolver::Match entity = EntityResolver::shared().add(EntityResolver::listing(data));
+            if (entity.crossSource) {
+                log(QString("🔗 与另一来源的房源为同一套（相似度%1）：%2")
+                        .arg(QString::number(entity.score, 'f', 2)).arg(data.houseUrl));
+            }
+            Record house = data;
+            house.record.clusterId = entity.clusterId;
+            results.append(house);
+            storedCount++;
+            // 这里只查询；指纹在写入成功后由 onPersisted 记录
+            if (!UrlDedupStore::shared().containsFingerprint(fp)) {
+                pipeline.persist(house);
+                pageOfListing.insert(fp, pageKey);
+                newCount++;
+            } else if (listingFingerprints.compare(fp, Traits::contentHash(data)) == ContentFingerprintStore::Change::Unchanged) {
+                unchangedCount++;
+            } else {
+                // 内容有变化（或是启用内容指纹之前收录的房源）：更新已有记录
+                pipeline.persist(house, PersistOp::Update);
+                pageOfListing.insert(fp, pageKey);
+                changedCount++;
+                log("🔄 房源信息有变化，更新入库：" + data.houseUrl);
+                if (hooks.listingUpdated) hooks.listingUpdated(data.houseUrl);
+            }
+
+            log("🎉 提取成功：" + Traits::describe(data));
+        }
+
+        log(QString("\n📊 提取完成：共识别%1个房源，%2条有效房源（新入库%3条，有变化%4条，未变化%5条）")
+                .arg(pageHouses.size()).arg(storedCount).arg(newCount).arg(changedCount).arg(unchangedCount));
+
+        if (pageKey != 0 && pageHash != 0) {
+            const int writes = newCount + changedCount;
+            if (writes == 0) {
+                pageFingerprints.record(pageKey, pageHash);
+            } else {
+                unconfirmedPages.insert(pageKey, PendingPage{pageHash, writes});
+            }
+        }
+        return newCount + changedCount;
+    }
+
+    // 写线程写入成功（owner线程）：记录URL指纹和内容指纹，之后的运行才会把它当作已收录、未变化；
+    // 所在页的房源都写入成功后再记录页指纹
+    void onPersisted(const Record& data)
+    {
+        const quint64 fp = UrlDedupStore::fingerprint(data.houseUrl);
+        UrlDedupStore::shared().insertFingerprint(fp);
+        listingFingerprints.record(fp, Traits::contentHash(data));
+
+        const quint64 pageKey = pageOfListing.take(fp);
+        auto page = unconfirmedPages.find(pageKey);
+        if (pageKey == 0 || page == unconfirmedPages.end()) return;
+        if (--page->writes == 0) {
+            pageFingerprints.record(pageKey, page->hash);
+            unconfirmedPages.erase(page);
+        }
+    }
+
+    struct PendingPage {
+        quint64 hash = 0;
+        int writes = 0;                          // 还没确认写入成功的房源数
+    };
+
+    Pipeline pipeline;
+    QString site;
+    Hooks hooks;
+    std::function<void()> drained;               // whenDrained 登记的回调，最后一页汇总后调用一次
+
+    ContentFingerprintStore pageFingerprints;    // 房源页URL → 列表区域/页面内JSON的哈希
+    ContentFingerprintStore listingFingerprints; // 房源URL → 规范化字段的哈希
+    SimHashIndex nearDuplicates;                 // 换标题重新发布的同一套房源只保留最早的一条
+    QHash<quint64, PendingPage> unconfirmedPages; // 页URL指纹 → 等写入确认的页指纹
+    QHash<quint64, quint64> pageOfListing;       // 已交给写线程的房源URL指纹 → 所在页URL指纹（0：不记页指纹）
+    QSet<quint64> seen;                          // 本轮已汇总房源的URL指纹（跨运行去重由 UrlDedupStore 负责）
+    QList<Record> results;
+    int skippedPages = 0;                        // 本轮内容未变化、跳过入库的房源页
+    int nearDuplicateCount = 0;                  // 本轮跳过的近重复房源
+};
+
+#endif // LISTINGPIPELINE_H
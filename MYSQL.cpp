@@ -1,4 +1,6 @@
 #include"MYSQL.h"
+#include "StringPool.h"
+#include "UrlDedupStore.h"
 #include<QSqlQuery>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -29,6 +31,7 @@ qDebug() << "Qt可用数据库驱动：" << QSqlDatabase::drivers();
     // 3. 打开连接并检查结果
     if (db.open()) {
         qDebug() << "MySQL连接成功！";
+        ensureSchema();
     } else {
         qDebug() << "MySQL连接失败：" << db.lastError().text();
     }
@@ -38,145 +41,140 @@ void Mysql::close(){
     db.close();
 }
 
-void Mysql::insertInfo(const HouseData &data){
-    QString sql = R"(
+namespace {
+
+// houseUrl 有唯一键：别的进程（各自的去重库）已收录同一房源时改为更新那一行
+const QString kInsertHouseSql = R"(
         INSERT INTO houseinfo (houseTitle,communityName, price, unitPrice,
-                            houseType, area, floor, orientation, buildingYear, houseUrl)
+                            houseType, area, floor, orientation, buildingYear, houseUrl, city, clusterId)
         VALUES (:houseTitle,:communityName, :price, :unitPrice,
-                :houseType, :area, :floor, :orientation, :buildingYear, :houseUrl)
+                :houseType, :area, :floor, :orientation, :buildingYear, :houseUrl, :city, :clusterId)
+        ON DUPLICATE KEY UPDATE houseTitle = VALUES(houseTitle), communityName = VALUES(communityName),
+                                price = VALUES(price), unitPrice = VALUES(unitPrice), houseType = VALUES(houseType),
+                                area = VALUES(area), floor = VALUES(floor), orientation = VALUES(orientation),
+                                buildingYear = VALUES(buildingYear), city = VALUES(city), clusterId = VALUES(clusterId)
     )";
 
-    //准备SQL查询
-    QSqlQuery query(db);  //显示绑定数据库
-    if (!query.prepare(sql)) {
-        qWarning() << "SQL准备失败：" << query.lastError().text();
-    }
-
-    QString price = data.price;
-    if(price=="未知"){
-        price="-1";
-        price.toDouble();
-    }else{
-      price.remove("万").remove(",").trimmed().toDouble();
-    }
+const QString kUpdateHouseSql = R"(
+        UPDATE houseinfo SET houseTitle = :houseTitle, communityName = :communityName,
+                             price = :price, unitPrice = :unitPrice, houseType = :houseType,
+                             area = :area, floor = :floor, orientation = :orientation,
+                             buildingYear = :buildingYear, city = :city, clusterId = :clusterId
+        WHERE houseUrl = :houseUrl
+    )";
 
+// 后加的列：旧库里没有时在连接后补上
+const QList<QPair<QString, QString>> kAddedColumns = {
+    {"city", "VARCHAR(64) NOT NULL DEFAULT ''"},
+    {"clusterId", "INT UNSIGNED NOT NULL DEFAULT 0"},     // EntityResolver 的簇编号，0 表示未识别
+};
 
-    QString unitPrice=data.unitPrice;
-    if(unitPrice=="未知"){
-        unitPrice="-1";
-        unitPrice.toDouble();
-    }else{
-       unitPrice.remove("元/㎡").remove(",").trimmed().toDouble();
-    }
+// 同一套房子（同一簇）在库里可能有多行：安居客挂牌、阿里拍卖、不同经纪人重复发布。
+// 统计和查询每簇只取最近收录的一行，未识别（clusterId = 0）的每行各算一套
+const QString kOneRowPerCluster =
+    "(clusterId = 0 OR ID IN (SELECT MAX(ID) FROM houseinfo WHERE clusterId > 0 GROUP BY clusterId))";
 
+} // namespace
 
-    QString year=data.buildingYear;
-    if(year=="未知"){
-        year="-1";
-        year.toDouble();
-    }else{
-        year.remove("年建造").remove(",").trimmed().toInt();
+void Mysql::ensureSchema(){
+    QSqlQuery query(db);
+    for (const auto &column : kAddedColumns) {
+        query.prepare("SELECT COUNT(*) FROM information_schema.COLUMNS "
+                      "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'houseinfo' AND COLUMN_NAME = :name");
+        query.bindValue(":name", column.first);
+        if (!query.exec() || !query.next()) {
+            qWarning() << "检查表结构失败：" << query.lastError().text();
+            return;
+        }
+        if (query.value(0).toInt() > 0) continue;
+        if (!query.exec(QString("ALTER TABLE houseinfo ADD COLUMN %1 %2").arg(column.first, column.second))) {
+            qWarning() << "添加列" << column.first << "失败：" << query.lastError().text();
+        }
     }
 
-
-    QString area=data.area;
-    if(area=="未知"){
-        area="-1";
-        area.toDouble();
-    }else{
-        area.remove("㎡").remove(",").trimmed().toDouble();
+    // houseUrl 唯一键：建键前先删掉同一链接的重复行（保留最新的一条）
+    if (!query.exec("SELECT COUNT(*) FROM information_schema.STATISTICS "
+                    "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'houseinfo' AND INDEX_NAME = 'uk_houseUrl'")
+        || !query.next()) {
+        qWarning() << "检查表结构失败：" << query.lastError().text();
+        return;
     }
-    qDebug()<<"小区标题"<<data.houseTitle;
-    qDebug()<<"小区名"<<data.communityName;
-    //绑定数据（参数名对应SQL中的:xxx）
-    query.bindValue(":houseTitle", data.houseTitle);
-    query.bindValue(":communityName", data.communityName);
-    query.bindValue(":price",price);
-    query.bindValue(":unitPrice",unitPrice);
-    query.bindValue(":houseType", data.houseType);
-    query.bindValue(":area",area);
-    query.bindValue(":floor", data.floor);
-    query.bindValue(":orientation", data.orientation);
-    query.bindValue(":buildingYear", year);
-    query.bindValue(":houseUrl", data.houseUrl);
-
-    //执行插入
-    if (!query.exec()) {
-        qWarning() << "数据插入失败：" << query.lastError().text();
-    }else{
-       qDebug() << "数据插入成功！";
+    if (query.value(0).toInt() > 0) return;
+    if (!query.exec("DELETE older FROM houseinfo older JOIN houseinfo newer "
+                    "ON older.houseUrl = newer.houseUrl AND older.ID < newer.ID")) {
+        qWarning() << "清理重复房源失败：" << query.lastError().text();
+        return;
+    }
+    if (query.numRowsAffected() > 0) {
+        qDebug() << "已删除" << query.numRowsAffected() << "条重复房源";
+    }
+    if (!query.exec("ALTER TABLE houseinfo ADD UNIQUE KEY uk_houseUrl (houseUrl)")) {
+        qWarning() << "添加houseUrl唯一键失败：" << query.lastError().text();
     }
 }
 
+bool Mysql::insertInfo(const HouseData &data){
+    return saveInfo(data, false);
+}
 
-void Mysql::insertAlInfo(const HouseInfo &data){
-    QString sql = R"(
-        INSERT INTO houseinfo (houseTitle,communityName, price, unitPrice,
-                            houseType, area, floor, orientation, buildingYear, houseUrl)
-        VALUES (:houseTitle,:communityName, :price, :unitPrice,
-                :houseType, :area, :floor, :orientation, :buildingYear, :houseUrl)
-    )";
+bool Mysql::updateInfo(const HouseData &data){
+    return saveInfo(data, true);
+}
 
-    //准备SQL查询
-    QSqlQuery query(db);  //显示绑定数据库
-    if (!query.prepare(sql)) {
-        qWarning() << "SQL准备失败：" << query.lastError().text();
-    }
+bool Mysql::insertAlInfo(const HouseInfo &data){
+    return saveAlInfo(data, false);
+}
 
-    QString price = data.price;
-    if(price=="未知"){
-        price="-1";
-        price.toDouble();
-    }else{
-        price.remove("万").remove(",").trimmed().toDouble();
-    }
+bool Mysql::updateAlInfo(const HouseInfo &data){
+    return saveAlInfo(data, true);
+}
 
+// 数值字段直接用流水线解析好的 record（不经流水线构造的 HouseData 在这里补解析一次），无效的写 -1
+bool Mysql::saveInfo(const HouseData &data, bool update){
+    const HouseRecord record = data.record.parsed ? data.record : HouseRecord::fromHouse(data);
+    return saveHouse(data.houseTitle, data.communityName, data.houseType, data.floor, data.orientation, data.houseUrl,
+              data.city, record, update);
+}
 
-    QString unitPrice=data.unitPrice;
-    if(unitPrice=="计算失败"){
-        unitPrice="-1";
-        unitPrice.toDouble();
-    }else{
-        unitPrice.remove("元/㎡").remove(",").trimmed().toDouble();
-    }
+bool Mysql::saveAlInfo(const HouseInfo &data, bool update){
+    const HouseRecord record = data.record.parsed ? data.record : HouseRecord::fromHouse(data);
+    return saveHouse(data.houseTitle, data.communityName, data.houseType, data.floor, data.orientation, data.houseUrl,
+              data.city, record, update);
+}
 
+bool Mysql::saveHouse(const QString &houseTitle, const QString &communityName, const QString &houseType,
+                      const QString &floor, const QString &orientation, const QString &houseUrl,
+                      const QString &city, const HouseRecord &record, bool update){
+    QString sql = update ? kUpdateHouseSql : kInsertHouseSql;
 
-    QString year=data.buildingYear;
-    if(year=="未知"){
-        year="-1";
-        year.toDouble();
-    }else{
-        year.remove("年").remove(",").trimmed().toInt();
+    //准备SQL查询
+    QSqlQuery query(db);  //显示绑定数据库
+    if (!query.prepare(sql)) {
+        qWarning() << "SQL准备失败：" << query.lastError().text();
+        return false;
     }
 
-
-    QString area=data.area;
-    if(area=="未知"){
-        area="-1";
-        area.toDouble();
-    }else{
-        area.remove("㎡").remove(",").trimmed().toDouble();
-    }
-    qDebug()<<"小区标题"<<data.houseTitle;
-    qDebug()<<"小区名"<<data.communityName;
     //绑定数据（参数名对应SQL中的:xxx）
-    query.bindValue(":houseTitle", data.houseTitle);
-    query.bindValue(":communityName", data.communityName);
-    query.bindValue(":price",price);
-    query.bindValue(":unitPrice",unitPrice);
-    query.bindValue(":houseType", data.houseType);
-    query.bindValue(":area",area);
-    query.bindValue(":floor", data.floor);
-    query.bindValue(":orientation", data.orientation);
-    query.bindValue(":buildingYear", year);
-    query.bindValue(":houseUrl", data.houseUrl);
+    query.bindValue(":houseTitle", houseTitle);
+    query.bindValue(":communityName", communityName);
+    query.bindValue(":price", record.priceForDb());
+    query.bindValue(":unitPrice", record.unitPriceForDb());
+    query.bindValue(":houseType", houseType);
+    query.bindValue(":area", record.areaForDb());
+    query.bindValue(":floor", floor);
+    query.bindValue(":orientation", orientation);
+    query.bindValue(":buildingYear", record.buildingYearForDb());
+    query.bindValue(":houseUrl", houseUrl);
+    query.bindValue(":city", city);
+    query.bindValue(":clusterId", record.clusterId);
 
     //执行插入
     if (!query.exec()) {
-        qWarning() << "数据插入失败：" << query.lastError().text();
-    }else{
-        qDebug() << "数据插入成功！";
+        qWarning() << (update ? "数据更新失败：" : "数据插入失败：") << query.lastError().text();
+        return false;
     }
+    qDebug() << (update ? "数据更新成功！" : "数据插入成功！");
+    return true;
 }
 
 QVector<QVector<QString>> Mysql::getInfo(){
@@ -244,7 +242,7 @@ void  Mysql::getPriceCout(double& two, double & four, double & ufour)
     QString sql = R"(
         SELECT price
         FROM houseinfo
-    )";
+        WHERE )" + kOneRowPerCluster;
 
     // 执行SQL查询
     if (!query.exec(sql)) {
@@ -295,7 +293,7 @@ void Mysql::getAreaCout(double& One,double & Two,double & Three, double & total)
     QString sql = R"(
         SELECT area
         FROM houseinfo
-    )";
+        WHERE )" + kOneRowPerCluster;
 
     // 执行SQL查询
     if (!query.exec(sql)) {
@@ -375,12 +373,14 @@ void Mysql::generateTable(QTableWidget* tableWidget,QList<QStringList> &tableOri
 
          // 步骤3：按列顺序，填充QStringList（与表格填充顺序完全一致）
          QString col0 = query.value(0).toString().trimmed(); // houseTitle
-         QString col1 = query.value(1).toString().trimmed(); // communityName
+         // 小区名/户型/楼层大量重复：换成字符串字典里的共享实例，整表只存一份字符数据
+         StringPool& pool = StringPool::shared();
+         QString col1 = pool.canonical(query.value(1).toString().trimmed()); // communityName
          QString col2 = query.value(2).toString().trimmed()+"万"; // price
          QString col3 = query.value(3).toString().trimmed()+"元"; // unitPrice
          QString col4 = query.value(4).toString().trimmed()+"平米"; // area
-         QString col5 = query.value(5).toString().trimmed(); // houseType
-         QString col6 = query.value(6).toString().trimmed(); // floor
+         QString col5 = pool.canonical(query.value(5).toString().trimmed()); // houseType
+         QString col6 = pool.canonical(query.value(6).toString().trimmed()); // floor
          QString col7 = query.value(7).toString().trimmed(); // houseUrl
 
          // 向rowData中添加8列数据（顺序与表格一致，后续可通过索引精准获取）
@@ -388,12 +388,12 @@ void Mysql::generateTable(QTableWidget* tableWidget,QList<QStringList> &tableOri
 
         // 填充其他列（索引1~6）
         tableWidget->setItem(currentRow, 0, new QTableWidgetItem(query.value(0).toString()));
-        tableWidget->setItem(currentRow, 1, new QTableWidgetItem(query.value(1).toString()));
+        tableWidget->setItem(currentRow, 1, new QTableWidgetItem(col1));
         tableWidget->setItem(currentRow, 2, new QTableWidgetItem(query.value(2).toString()+"万"));
         tableWidget->setItem(currentRow, 3, new QTableWidgetItem(query.value(3).toString()+"元"));
         tableWidget->setItem(currentRow, 4, new QTableWidgetItem(query.value(4).toString()+"平米"));
-        tableWidget->setItem(currentRow, 5, new QTableWidgetItem(query.value(5).toString()));
-        tableWidget->setItem(currentRow, 6, new QTableWidgetItem(query.value(6).toString()));
+        tableWidget->setItem(currentRow, 5, new QTableWidgetItem(col5));
+        tableWidget->setItem(currentRow, 6, new QTableWidgetItem(col6));
         tableWidget->setItem(currentRow,7, new QTableWidgetItem(query.value(7).toString()));
 
         currentRow++;
@@ -411,7 +411,7 @@ QList<HouseData> Mysql::getAllHouseData()
     QList<HouseData> houseDataList;
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
-                  "area, floor, orientation, buildingYear, houseUrl FROM houseinfo";
+                  "area, floor, orientation, buildingYear, houseUrl FROM houseinfo WHERE " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     if (!query.exec(sql)) {
@@ -453,6 +453,71 @@ QList<HouseData> Mysql::getAllHouseData()
     return houseDataList;
 }
 
+QList<HouseData> Mysql::getClusteredHouses(int limit)
+{
+    QList<HouseData> houseDataList;
+
+    QSqlQuery query(db);
+    query.prepare("SELECT houseTitle, communityName, price, houseType, area, houseUrl, city, clusterId "
+                  "FROM houseinfo WHERE clusterId > 0 ORDER BY ID DESC LIMIT :limit");
+    query.bindValue(":limit", limit);
+    if (!query.exec()) {
+        qWarning() << "查询实体簇失败：" << query.lastError().text();
+        return houseDataList;
+    }
+
+    while (query.next()) {
+        HouseData data;
+        data.houseTitle = query.value(0).toString();
+        data.communityName = query.value(1).toString();
+        const double price = query.value(2).toDouble();
+        data.price = (price > 0) ? QString::number(price) + "万" : "未知";
+        data.houseType = query.value(3).toString();
+        const double area = query.value(4).toDouble();
+        data.area = (area > 0) ? QString::number(area) + "㎡" : "未知";
+        data.houseUrl = query.value(5).toString();
+        data.city = query.value(6).toString();
+        data.record = HouseRecord::fromHouse(data);
+        data.record.clusterId = query.value(7).toUInt();
+        houseDataList.prepend(data);
+    }
+    return houseDataList;
+}
+
+QStringList Mysql::normalizeHouseUrls()
+{
+    QStringList urls;
+    QSqlQuery query(db);
+    if (!query.exec("SELECT ID, houseUrl FROM houseinfo")) {
+        qWarning() << "查询房源链接失败：" << query.lastError().text();
+        return urls;
+    }
+
+    QList<QPair<QVariant, QString>> renamed;
+    while (query.next()) {
+        const QString url = query.value(1).toString();
+        const QString normalized = UrlDedupStore::normalizeUrl(url);
+        if (normalized != url) renamed.append({query.value(0), normalized});
+        urls.append(normalized);
+    }
+
+    db.transaction();
+    QSqlQuery update(db);
+    update.prepare("UPDATE houseinfo SET houseUrl = :houseUrl WHERE ID = :id");
+    for (const auto &row : renamed) {
+        update.bindValue(":houseUrl", row.second);
+        update.bindValue(":id", row.first);
+        if (!update.exec()) {
+            qWarning() << "规范化房源链接失败：" << update.lastError().text();
+        }
+    }
+    db.commit();
+    if (!renamed.isEmpty()) {
+        qDebug() << "已规范化" << renamed.size() << "条房源链接";
+    }
+    return urls;
+}
+
 // 按价格范围查询房源
 QList<HouseData> Mysql::findHousesByPrice(double minPrice, double maxPrice)
 {
@@ -460,7 +525,7 @@ QList<HouseData> Mysql::findHousesByPrice(double minPrice, double maxPrice)
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
                   "area, floor, orientation, buildingYear, houseUrl FROM houseinfo "
-                  "WHERE price >= ? AND price <= ?";
+                  "WHERE price >= ? AND price <= ? AND " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     query.prepare(sql);
@@ -488,7 +553,7 @@ QList<HouseData> Mysql::findHousesByType(const QString& houseType)
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
                   "area, floor, orientation, buildingYear, houseUrl FROM houseinfo "
-                  "WHERE houseType LIKE ?";
+                  "WHERE houseType LIKE ? AND " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     query.prepare(sql);
@@ -515,7 +580,7 @@ QList<HouseData> Mysql::findHousesByArea(double minArea, double maxArea)
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
                   "area, floor, orientation, buildingYear, houseUrl FROM houseinfo "
-                  "WHERE area >= ? AND area <= ?";
+                  "WHERE area >= ? AND area <= ? AND " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     query.prepare(sql);
@@ -543,7 +608,7 @@ QList<HouseData> Mysql::findHousesByPriceAndType(double minPrice, double maxPric
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
                   "area, floor, orientation, buildingYear, houseUrl FROM houseinfo "
-                  "WHERE price >= ? AND price <= ? AND houseType LIKE ?";
+                  "WHERE price >= ? AND price <= ? AND houseType LIKE ? AND " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     query.prepare(sql);
@@ -592,6 +657,22 @@ HouseData Mysql::createHouseDataFromQuery(QSqlQuery& query)
 
     data.houseUrl = query.value(9).toString();
 
+    // 库里已经是数值，直接填入 record（不再从显示字符串反解析）
+    data.record.priceWan = qMax(0.0, price);
+    data.record.unitPriceYuan = qMax(0.0, unitPrice);
+    data.record.areaSqm = qMax(0.0, area);
+    data.record.buildingYear = qMax(0, year);
+    if (price > 0) data.record.valid |= HouseRecord::Price;
+    if (unitPrice > 0) data.record.valid |= HouseRecord::UnitPrice;
+    if (area > 0) data.record.valid |= HouseRecord::Area;
+    if (year > 0) data.record.valid |= HouseRecord::BuildingYear;
+    if (HouseRecord::parseLayout(data.houseType, data.record.rooms, data.record.halls)) {
+        data.record.valid |= HouseRecord::Layout;
+    }
+    data.record.setFloor(data.floor);
+    data.record.parsed = true;
+    HouseRecord::internFields(data);
+
     return data;
 }
 
@@ -600,7 +681,7 @@ HouseData Mysql::createHouseDataFromQuery(QSqlQuery& query)
 void Mysql::getToJas(QJsonArray& houseDataArray){
 
     QString sql = "SELECT houseTitle, communityName, price, unitPrice, houseType, "
-                  "area, floor, orientation, buildingYear, houseUrl FROM houseinfo";
+                  "area, floor, orientation, buildingYear, houseUrl FROM houseinfo WHERE " + kOneRowPerCluster;
 
     QSqlQuery query(db);
     if (!query.exec(sql)) {
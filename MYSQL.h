@@ -15,14 +15,23 @@ public:
     ~Mysql();
      void connectDatabase();
      void close();
-     void insertInfo(const HouseData &data);
-     void insertAlInfo(const HouseInfo &data);
+     // 写入成功返回true（爬虫只在写入成功后记录去重/内容指纹，失败的房源下次运行会重试）
+     bool insertInfo(const HouseData &data);
+     bool insertAlInfo(const HouseInfo &data);
+     // 增量重爬：内容有变化的已收录房源按 houseUrl 更新原记录
+     bool updateInfo(const HouseData &data);
+     bool updateAlInfo(const HouseInfo &data);
      QVector<QVector<QString>> getInfo();
+     // 价格/面积统计、getAllHouseData、findHousesBy*、getToJas 按 clusterId 归并：同一套房子只取最近收录的一行
      void getPriceCout(double&,double &,double &);
      void getAreaCout(double&,double &,double &,double &);
      void generateTable(QTableWidget*, QList<QStringList> &);
 
      QList<HouseData> getAllHouseData();  // 新增：获取所有房源数据
+     // 最近收录的已识别房源（带 city 与 record.clusterId，按收录时间从早到晚），启动时恢复 EntityResolver
+     QList<HouseData> getClusteredHouses(int limit);
+     // 已收录房源的链接；早期未规范化的链接就地改成规范形式（否则按规范链接的UPDATE匹配不到）
+     QStringList normalizeHouseUrls();
      // AI对话查询方法
      QList<HouseData> findHousesByPrice(double minPrice, double maxPrice);  // 按价格范围查询
      QList<HouseData> findHousesByType(const QString& houseType);          // 按户型查询
@@ -32,6 +41,12 @@ public:
 private:
      // 辅助函数
     HouseData createHouseDataFromQuery(QSqlQuery& query);
+    void ensureSchema();
+    bool saveInfo(const HouseData &data, bool update);
+    bool saveAlInfo(const HouseInfo &data, bool update);
+    bool saveHouse(const QString &houseTitle, const QString &communityName, const QString &houseType,
+                   const QString &floor, const QString &orientation, const QString &houseUrl,
+                   const QString &city, const HouseRecord &record, bool update);
     QSqlDatabase db;
 
 
@@ -0,0 +1,197 @@
+#include "PageArchive.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+const QByteArray kFileMagic("PGARCH01");
+const quint32 kRecordMagic = 0x50475231;   // "PGR1"
+const int kRecordHeaderBytes = 12;
+const quint32 kMaxMetaBytes = 1 << 20;
+const QList<QByteArray> kCredentialHeaders = { "cookie", "authorization", "proxy-authorization" };
+
+} // namespace
+
+PageArchive::~PageArchive()
+{
+    close();
+}
+
+QMap<QString, QString> PageArchive::headersOf(const QWebEngineHttpRequest& request)
+{
+    QMap<QString, QString> headers;
+    for (const QByteArray& name : request.headers()) {
+        if (kCredentialHeaders.contains(name.toLower())) continue;
+        headers.insert(QString::fromLatin1(name), QString::fromUtf8(request.header(name)));
+    }
+    return headers;
+}
+
+bool PageArchive::open(const QString& filePath, Mode mode)
+{
+    close();
+    openMode = mode;
+    file.setFileName(filePath);
+
+    if (mode == Mode::Read) {
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        if (file.read(kFileMagic.size()) != kFileMagic) {
+            file.close();
+            return false;
+        }
+        return scan();
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    if (!file.open(QIODevice::ReadWrite)) return false;
+    if (file.size() == 0) {
+        file.write(kFileMagic);
+        file.flush();
+        return true;
+    }
+    if (file.read(kFileMagic.size()) != kFileMagic) {
+        file.close();
+        return false;
+    }
+    if (!scan()) return false;
+    file.seek(file.size());
+    return true;
+}
+
+void PageArchive::close()
+{
+    if (file.isOpen()) {
+        file.flush();
+        file.close();
+    }
+    entries.clear();
+}
+
+// 顺序读取记录头建立索引；遇到不完整的记录即停止（追加模式下截掉它）
+bool PageArchive::scan()
+{
+    entries.clear();
+    qint64 offset = kFileMagic.size();
+    const qint64 total = file.size();
+
+    while (offset + kRecordHeaderBytes <= total) {
+        file.seek(offset);
+        QDataStream header(file.read(kRecordHeaderBytes));
+        quint32 magic = 0, metaBytes = 0, bodyBytes = 0;
+        header >> magic >> metaBytes >> bodyBytes;
+        if (magic != kRecordMagic || metaBytes > kMaxMetaBytes
+            || offset + kRecordHeaderBytes + metaBytes + bodyBytes > total) {
+            break;
+        }
+
+        const QJsonObject meta = QJsonDocument::fromJson(file.read(metaBytes)).object();
+        IndexEntry entry;
+        entry.offset = offset;
+        entry.site = meta.value("site").toString();
+        entry.url = meta.value("url").toString();
+        entry.tag = meta.value("tag").toString();
+        entry.timestampMs = static_cast<qint64>(meta.value("ts").toDouble());
+        entry.bodyBytes = bodyBytes;
+        entries.append(entry);
+        offset += kRecordHeaderBytes + metaBytes + bodyBytes;
+    }
+
+    if (offset < total && openMode == Mode::Append) {
+        file.resize(offset);
+    }
+    return true;
+}
+
+bool PageArchive::append(const ArchivedPage& page)
+{
+    if (!file.isOpen() || openMode != Mode::Append) return false;
+
+    QJsonObject headers;
+    for (auto it = page.headers.constBegin(); it != page.headers.constEnd(); ++it) {
+        headers.insert(it.key(), it.value());
+    }
+    const bool hasJson = !page.json.isEmpty();
+    const bool hasHtml = !page.html.isEmpty();
+    const qint64 timestampMs = (page.fetchedAt.isValid() ? page.fetchedAt : QDateTime::currentDateTime()).toMSecsSinceEpoch();
+    QJsonObject meta;
+    meta.insert("site", page.site);
+    meta.insert("url", page.url);
+    meta.insert("finalUrl", page.finalUrl);
+    meta.insert("tag", page.tag);
+    meta.insert("ts", static_cast<double>(timestampMs));
+    meta.insert("headers", headers);
+    QByteArray body;
+    if (hasJson && hasHtml) {
+        body = qCompress(page.json.toUtf8(), 6);
+        meta.insert("kind", "json+html");
+        meta.insert("jsonBytes", static_cast<double>(body.size()));
+        body.append(qCompress(page.html.toUtf8(), 6));
+    } else {
+        meta.insert("kind", hasJson ? "json" : "html");
+        body = qCompress((hasJson ? page.json : page.html).toUtf8(), 6);
+    }
+
+    const QByteArray metaBytes = QJsonDocument(meta).toJson(QJsonDocument::Compact);
+
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out << kRecordMagic << static_cast<quint32>(metaBytes.size()) << static_cast<quint32>(body.size());
+    record.append(metaBytes);
+    record.append(body);
+
+    const qint64 offset = file.size();
+    file.seek(offset);
+    if (file.write(record) != record.size()) return false;
+    file.flush();
+
+    IndexEntry entry;
+    entry.offset = offset;
+    entry.site = page.site;
+    entry.url = page.url;
+    entry.tag = page.tag;
+    entry.timestampMs = timestampMs;
+    entry.bodyBytes = static_cast<quint32>(body.size());
+    entries.append(entry);
+    return true;
+}
+
+bool PageArchive::read(int i, ArchivedPage& page)
+{
+    if (!file.isOpen() || i < 0 || i >= entries.size()) return false;
+
+    file.seek(entries.at(i).offset);
+    QDataStream header(file.read(kRecordHeaderBytes));
+    quint32 magic = 0, metaBytes = 0, bodyBytes = 0;
+    header >> magic >> metaBytes >> bodyBytes;
+    if (magic != kRecordMagic) return false;
+
+    const QJsonObject meta = QJsonDocument::fromJson(file.read(metaBytes)).object();
+    const QByteArray body = file.read(bodyBytes);
+    if (body.size() != static_cast<qsizetype>(bodyBytes)) return false;
+
+    page = ArchivedPage();
+    page.site = meta.value("site").toString();
+    page.url = meta.value("url").toString();
+    page.finalUrl = meta.value("finalUrl").toString();
+    page.tag = meta.value("tag").toString();
+    page.fetchedAt = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(meta.value("ts").toDouble()));
+    const QJsonObject headers = meta.value("headers").toObject();
+    for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        page.headers.insert(it.key(), it.value().toString());
+    }
+    const QString kind = meta.value("kind").toString();
+    if (kind == "json+html") {
+        const qsizetype jsonBytes = static_cast<qsizetype>(meta.value("jsonBytes").toDouble());
+        if (jsonBytes < 0 || jsonBytes > body.size()) return false;
+        page.json = QString::fromUtf8(qUncompress(body.left(jsonBytes)));
+        page.html = QString::fromUtf8(qUncompress(body.mid(jsonBytes)));
+    } else if (kind == "json") {
+        page.json = QString::fromUtf8(qUncompress(body));
+    } else {
+        page.html = QString::fromUtf8(qUncompress(body));
+    }
+    return true;
+}
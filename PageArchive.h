@@ -0,0 +1,83 @@
+#ifndef PAGEARCHIVE_H
+#define PAGEARCHIVE_H
+
+#include <QString>
+#include <QMap>
+#include <QList>
+#include <QFile>
+#include <QDateTime>
+#include <QWebEngineHttpRequest>
+
+// 一个归档页面：抓取时的请求信息 + 页面内容（整页HTML和/或页面内提取的JSON）
+struct ArchivedPage {
+    QString site;                       // 站点标识（Crawl::SITE_KEY / AliCrawl::SITE_KEY）
+    QString url;                        // 请求地址
+    QString finalUrl;                   // 跳转后的实际地址
+    QString tag;                        // 所属城市/区县（提取时用作city）
+    QDateTime fetchedAt;
+    QMap<QString, QString> headers;     // 实际发出的请求头（不含Cookie等凭据）
+    QString html;
+    QString json;
+};
+
+/**
+ * @brief 页面录制/回放归档
+ *
+ * 录制模式下爬虫把每个抓到的房源页追加到归档文件；回放时按索引逐页读出，
+ * 走与在线爬取完全相同的提取和入库流程，不需要网络，也没有渲染等待，可用于
+ * 解析器修复后重新提取历史数据，以及在本机稳定地测量提取吞吐量。
+ *
+ * 文件格式：文件头 "PGARCH01"，之后是连续的记录
+ *   quint32 'PGR1' | quint32 元数据长度 | quint32 正文长度 | 元数据(JSON) | 正文(qCompress压缩的UTF-8)
+ * 元数据含 site/url/finalUrl/tag/ts/headers/kind。kind 为 "html"/"json" 时正文是单份内容；
+ * 为 "json+html" 时正文是压缩的JSON后接压缩的HTML，前者长度记在元数据 jsonBytes 里。
+ * 录制页面内提取的页面时爬虫会同时取回整页HTML，回放时JSON提取失败还能重跑HTML解析。
+ * 打开时只读记录头并跳过正文，在内存中建立索引；
+ * 崩溃时写了一半的末尾记录会被丢弃（追加模式下截断）。
+ */
+class PageArchive
+{
+public:
+    enum class Mode {
+        Read,
+        Append
+    };
+
+    struct IndexEntry {
+        qint64 offset = 0;              // 记录在文件中的起始位置
+        QString site;
+        QString url;
+        QString tag;
+        qint64 timestampMs = 0;
+        quint32 bodyBytes = 0;          // 压缩后的正文大小
+    };
+
+    PageArchive() = default;
+    ~PageArchive();
+    PageArchive(const PageArchive&) = delete;
+    PageArchive& operator=(const PageArchive&) = delete;
+
+    bool open(const QString& filePath, Mode mode);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    Mode mode() const { return openMode; }
+    QString path() const { return file.fileName(); }
+
+    bool append(const ArchivedPage& page);
+
+    int size() const { return entries.size(); }
+    const IndexEntry& entry(int i) const { return entries.at(i); }
+    bool read(int i, ArchivedPage& page);
+
+    // 请求头转成归档用的键值表；Cookie、Authorization、Proxy-Authorization 不落盘
+    static QMap<QString, QString> headersOf(const QWebEngineHttpRequest& request);
+
+private:
+    bool scan();
+
+    QFile file;
+    Mode openMode = Mode::Read;
+    QList<IndexEntry> entries;
+};
+
+#endif // PAGEARCHIVE_H
@@ -0,0 +1,104 @@
+#include "PageReadyProbe.h"
+#include <QVariantMap>
+
+const int PageReadyProbe::POLL_INTERVAL_MS = 300;
+const int PageReadyProbe::STABLE_MS = 1500;
+
+void PageReadyProbe::waitForListings(QWebEnginePage *page, const QString& selector, int timeoutMs,
+                                     QObject *context, Callback callback)
+{
+    if (page == nullptr) return;
+    // 构造即开始轮询，结束后deleteLater
+    new PageReadyProbe(page, selector, timeoutMs, context, callback);
+}
+
+PageReadyProbe::PageReadyProbe(QWebEnginePage *page, const QString& selector, int timeoutMs,
+                               QObject *context, Callback callback)
+    : QObject(context)
+    , page(page)
+    , script(buildScript(selector))
+    , timeoutMs(timeoutMs)
+    , callback(callback)
+{
+    elapsed.start();
+    pollTimer.setInterval(POLL_INTERVAL_MS);
+    connect(&pollTimer, &QTimer::timeout, this, &PageReadyProbe::poll);
+    pollTimer.start();
+    poll();
+}
+
+// 注入脚本：首次执行时安装MutationObserver，之后每次执行只返回当前状态
+// 观察回调里只做标记，计数合并到下一帧，避免大页面上每次DOM变动都querySelectorAll
+QString PageReadyProbe::buildScript(const QString& selector)
+{
+    QString quoted = selector;
+    quoted.replace("\\", "\\\\").replace("\"", "\\\"");
+
+    return QString(R"JS(
+(function (sel) {
+    var st = window.__crawlReadyProbe;
+    var recount = function () {
+        st.pending = false;
+        var n = document.querySelectorAll(sel).length;
+        if (n !== st.count) {
+            st.count = n;
+            st.changedAt = performance.now();
+        }
+    };
+    if (!st || st.sel !== sel) {
+        if (st && st.observer) st.observer.disconnect();
+        st = window.__crawlReadyProbe = { sel: sel, count: -1, changedAt: performance.now(), pending: false };
+        st.observer = new MutationObserver(function () {
+            if (st.pending) return;
+            st.pending = true;
+            requestAnimationFrame(recount);
+        });
+        st.observer.observe(document.documentElement, { childList: true, subtree: true });
+    }
+    recount();
+    return { count: st.count, quietMs: Math.round(performance.now() - st.changedAt) };
+})("%1");
+)JS").arg(quoted);
+}
+
+void PageReadyProbe::poll()
+{
+    if (finished) return;
+    if (page.isNull()) {
+        finished = true;
+        pollTimer.stop();
+        deleteLater();
+        return;
+    }
+    if (elapsed.elapsed() >= timeoutMs) {
+        finish(false);
+        return;
+    }
+    if (pollInFlight) return;
+
+    pollInFlight = true;
+    QPointer<PageReadyProbe> self(this);
+    page->runJavaScript(script, [self](const QVariant& result) {
+        if (self.isNull() || self->finished) return;
+        self->pollInFlight = false;
+
+        const QVariantMap state = result.toMap();
+        const int count = state.value("count").toInt();
+        const int quietMs = state.value("quietMs").toInt();
+        self->lastCount = qMax(0, count);
+        if (count > 0 && quietMs >= STABLE_MS) {
+            self->finish(true);
+        }
+    });
+}
+
+void PageReadyProbe::finish(bool ready)
+{
+    if (finished) return;
+    finished = true;
+    pollTimer.stop();
+    if (callback) {
+        callback(ready, lastCount, elapsed.elapsed());
+    }
+    deleteLater();
+}
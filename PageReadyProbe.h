@@ -0,0 +1,52 @@
+#ifndef PAGEREADYPROBE_H
+#define PAGEREADYPROBE_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QWebEnginePage>
+#include <functional>
+
+/**
+ * @brief 房源列表渲染就绪探测（替代固定的15~30秒渲染等待）
+ *
+ * 向页面注入一个MutationObserver，记录房源节点（selector匹配的元素）数量及其最后一次变化的时间，
+ * C++侧通过runJavaScript轮询：节点数>0且连续STABLE_MS毫秒不再变化即视为渲染完成。
+ * 超过timeoutMs仍未稳定时按超时回调，调用方照常取HTML（与原固定等待的行为一致）。
+ *
+ * 探测对象以context为父对象，回调触发后自行释放；页面销毁时静默结束，不再回调。
+ */
+class PageReadyProbe : public QObject
+{
+    Q_OBJECT
+public:
+    // ready=false 表示超时；count 为最后一次观察到的房源节点数；elapsedMs 为实际等待时间
+    using Callback = std::function<void(bool ready, int count, qint64 elapsedMs)>;
+
+    static void waitForListings(QWebEnginePage *page, const QString& selector, int timeoutMs,
+                                QObject *context, Callback callback);
+
+    static const int POLL_INTERVAL_MS;  // 轮询间隔
+    static const int STABLE_MS;         // 节点数保持不变多久视为渲染完成
+
+private:
+    PageReadyProbe(QWebEnginePage *page, const QString& selector, int timeoutMs,
+                   QObject *context, Callback callback);
+
+    void poll();
+    void finish(bool ready);
+    static QString buildScript(const QString& selector);
+
+    QPointer<QWebEnginePage> page;
+    QString script;
+    int timeoutMs;
+    Callback callback;
+    QTimer pollTimer;
+    QElapsedTimer elapsed;
+    int lastCount = 0;
+    bool pollInFlight = false;
+    bool finished = false;
+};
+
+#endif // PAGEREADYPROBE_H
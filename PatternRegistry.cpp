@@ -0,0 +1,151 @@
+#include "PatternRegistry.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QtDebug>
+#include <algorithm>
+
+const int PatternRegistry::SUMMARY_TOP = 5;
+
+PatternRegistry::Pattern::Pattern(const QString& site, const QString& name, const QString& pattern,
+                                  QRegularExpression::PatternOptions options)
+    : siteName(site), ruleName(name), re(pattern, options)
+{
+    if (!re.isValid()) {
+        qWarning() << "PatternRegistry: 规则" << site + "/" + name << "无效：" << re.errorString();
+    }
+    re.optimize();
+}
+
+void PatternRegistry::Pattern::record(bool hit, qint64 nanos) const
+{
+    (hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+    totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+QRegularExpressionMatch PatternRegistry::Pattern::match(const QString& subject) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QRegularExpressionMatch m = re.match(subject);
+    record(m.hasMatch(), timer.nsecsElapsed());
+    return m;
+}
+
+bool PatternRegistry::Pattern::contains(const QString& subject) const
+{
+    return match(subject).hasMatch();
+}
+
+QList<QRegularExpressionMatch> PatternRegistry::Pattern::matchAll(const QString& subject) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QList<QRegularExpressionMatch> matches;
+    QRegularExpressionMatchIterator it = re.globalMatch(subject);
+    while (it.hasNext()) {
+        matches.append(it.next());
+    }
+    record(!matches.isEmpty(), timer.nsecsElapsed());
+    return matches;
+}
+
+void PatternRegistry::Pattern::remove(QString& text) const
+{
+    replace(text, QString());
+}
+
+// 没有匹配时 QString::replace 不会分离数据，比较数据指针即可知道是否发生了替换
+void PatternRegistry::Pattern::replace(QString& text, const QString& after) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QString before = text;
+    text.replace(re, after);
+    record(text.constData() != before.constData(), timer.nsecsElapsed());
+}
+
+PatternRegistry& PatternRegistry::shared()
+{
+    static PatternRegistry registry;
+    return registry;
+}
+
+const PatternRegistry::Pattern& PatternRegistry::add(const QString& site, const QString& name, const QString& pattern,
+                                                     QRegularExpression::PatternOptions options)
+{
+    const QString ruleKey = site + "/" + name;
+    const QString key = ruleKey + "\n" + QString::number(options.toInt()) + "\n" + pattern;
+    QMutexLocker locker(&mutex);
+    auto it = byKey.constFind(key);
+    if (it != byKey.constEnd()) {
+        current.insert(ruleKey, it.value());
+        return *it.value();
+    }
+
+    patterns.emplace_back(new Pattern(site, name, pattern, options));
+    Pattern *p = patterns.back().get();
+    byKey.insert(key, p);
+    current.insert(ruleKey, p);
+    return *p;
+}
+
+QList<PatternRegistry::Stats> PatternRegistry::stats(const QString& site) const
+{
+    QMutexLocker locker(&mutex);
+    QList<Stats> result;
+    for (const auto& p : patterns) {
+        if (!site.isEmpty() && p->siteName != site) continue;
+        if (current.value(p->siteName + "/" + p->ruleName) != p.get()) continue;
+        Stats s;
+        s.site = p->siteName;
+        s.name = p->ruleName;
+        s.pattern = p->re.pattern();
+        s.hits = p->hits.load(std::memory_order_relaxed);
+        s.misses = p->misses.load(std::memory_order_relaxed);
+        s.nanos = p->totalNanos.load(std::memory_order_relaxed);
+        result.append(s);
+    }
+    return result;
+}
+
+QString PatternRegistry::summary(const QString& site) const
+{
+    QList<Stats> all = stats(site);
+    quint64 calls = 0;
+    qint64 nanos = 0;
+    QStringList dead;
+    for (const Stats& s : all) {
+        calls += s.hits + s.misses;
+        nanos += s.nanos;
+        if (s.hits == 0 && s.misses > 0) dead.append(s.site + "/" + s.name);
+    }
+    if (calls == 0) return QString();
+
+    std::sort(all.begin(), all.end(), [](const Stats& a, const Stats& b) { return a.nanos > b.nanos; });
+    QStringList hot;
+    for (int i = 0; i < all.size() && i < SUMMARY_TOP; ++i) {
+        const Stats& s = all.at(i);
+        if (s.hits + s.misses == 0) break;
+        hot.append(QString("%1/%2(命中%3/未命中%4, %5 ms)")
+                       .arg(s.site, s.name).arg(s.hits).arg(s.misses)
+                       .arg(QString::number(s.nanos / 1e6, 'f', 1)));
+    }
+
+    QString text = QString("🧩 提取规则：%1条，共匹配%2次、用时%3 ms；最耗时：%4")
+                       .arg(all.size()).arg(calls).arg(QString::number(nanos / 1e6, 'f', 1))
+                       .arg(hot.join("、"));
+    if (!dead.isEmpty()) {
+        text += "；从未命中：" + dead.join("、");
+    }
+    return text;
+}
+
+void PatternRegistry::resetStats()
+{
+    QMutexLocker locker(&mutex);
+    for (const auto& p : patterns) {
+        p->hits.store(0, std::memory_order_relaxed);
+        p->misses.store(0, std::memory_order_relaxed);
+        p->totalNanos.store(0, std::memory_order_relaxed);
+    }
+}
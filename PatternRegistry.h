@@ -0,0 +1,86 @@
+#ifndef PATTERNREGISTRY_H
+#define PATTERNREGISTRY_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 进程内共享的提取正则注册表
+ *
+ * 各站点适配器（HouseExtractor、Crawl、AliCrawl）在首次使用时按“站点 + 规则名”声明自己的正则，
+ * 注册时立即编译并 JIT 优化（QRegularExpression::optimize），之后所有线程共用同一个实例，
+ * 不再在每条房源的循环里反复构造 QRegularExpression、反复编译同样的 PCRE2 模式。
+ *
+ * 每条规则记录命中/未命中次数和累计匹配耗时，summary() 列出最耗时的规则和从未命中的规则，
+ * 用来发现热点规则和页面改版后已经失效的规则。计数用原子变量，匹配本身不加锁。
+ */
+class PatternRegistry
+{
+public:
+    class Pattern
+    {
+    public:
+        QRegularExpressionMatch match(const QString& subject) const;
+        bool contains(const QString& subject) const;
+        // 取出全部匹配（按一次调用计时：至少一个匹配算命中）
+        QList<QRegularExpressionMatch> matchAll(const QString& subject) const;
+        // 就地删除/替换全部匹配（有替换发生算命中）
+        void remove(QString& text) const;
+        void replace(QString& text, const QString& after) const;
+
+        const QRegularExpression& regex() const { return re; }
+        const QString& site() const { return siteName; }
+        const QString& name() const { return ruleName; }
+
+    private:
+        friend class PatternRegistry;
+        Pattern(const QString& site, const QString& name, const QString& pattern,
+                QRegularExpression::PatternOptions options);
+        void record(bool hit, qint64 nanos) const;
+
+        QString siteName;
+        QString ruleName;
+        QRegularExpression re;
+        mutable std::atomic<quint64> hits{0};
+        mutable std::atomic<quint64> misses{0};
+        mutable std::atomic<qint64> totalNanos{0};
+    };
+
+    struct Stats {
+        QString site;
+        QString name;
+        QString pattern;
+        quint64 hits = 0;
+        quint64 misses = 0;
+        qint64 nanos = 0;           // 累计匹配耗时
+    };
+
+    static PatternRegistry& shared();
+
+    // 同一站点同名同模式的规则只编译一次，重复声明返回已有实例；
+    // 模式或选项不同（如重新加载了规则文件）时编译新实例并取代旧的，旧实例仍然有效（已持有的引用不受影响）
+    const Pattern& add(const QString& site, const QString& name, const QString& pattern,
+                       QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption);
+
+    QList<Stats> stats(const QString& site = QString()) const;   // site 为空时返回全部（不含已被取代的规则）
+    QString summary(const QString& site = QString()) const;      // 没有任何匹配记录时返回空串
+    void resetStats();
+
+    static const int SUMMARY_TOP;   // summary 里列出的最耗时规则数
+
+private:
+    PatternRegistry() = default;
+
+    mutable QMutex mutex;
+    std::vector<std::unique_ptr<Pattern>> patterns;     // 注册后地址不变，调用方可长期持有引用
+    QHash<QString, Pattern*> byKey;                      // "站点/规则名\n选项\n模式"
+    QHash<QString, Pattern*> current;                    // "站点/规则名" → 最近声明的实例
+};
+
+#endif // PATTERNREGISTRY_H
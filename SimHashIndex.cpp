@@ -0,0 +1,280 @@
+#include "SimHashIndex.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtAlgorithms>
+#include <cstring>
+
+namespace {
+
+const QByteArray kMagic("SIMHASH1");
+const int kRecordBytes = 16;
+
+// 各类特征的标签，避免不同字段的相同取值落到同一个特征上
+const quint64 kTitleTag = 0x7469746c65000000ULL;
+const quint64 kCommunityTag = 0x636f6d6d75000000ULL;
+const quint64 kLayoutTag = 0x6c61796f75000000ULL;
+const quint64 kAreaTag = 0x6172656100000000ULL;
+const quint64 kPriceTag = 0x7072696365000000ULL;
+const quint64 kFloorsTag = 0x666c6f6f72000000ULL;
+
+quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+quint64 textHash(const QString& text)
+{
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (const QChar c : text) {
+        h ^= c.unicode();
+        h *= 0x100000001b3ULL;
+    }
+    return mix64(h);
+}
+
+// 每一位按特征哈希该位的取值加/减权重，最后取符号
+class Accumulator
+{
+public:
+    void add(quint64 featureHash, int weight)
+    {
+        for (int bit = 0; bit < 64; ++bit) {
+            counts[bit] += ((featureHash >> bit) & 1) ? weight : -weight;
+        }
+        empty = false;
+    }
+
+    quint64 value() const
+    {
+        if (empty) return 0;
+        quint64 hash = 0;
+        for (int bit = 0; bit < 64; ++bit) {
+            if (counts[bit] > 0) hash |= (1ULL << bit);
+        }
+        return hash;
+    }
+
+private:
+    int counts[64] = {};
+    bool empty = true;
+};
+
+// 标题只保留字母数字（统一小写）后按字符二元组计特征；小区、户型、面积、总价、总层数的权重更高，
+// 只改几个字的标题距离很小，而同小区同户型但标题完全不同的房源距离会超过阈值
+quint64 simhash(const QString& title, const QString& community, const HouseRecord& record)
+{
+    Accumulator acc;
+
+    QString normalized;
+    normalized.reserve(title.size());
+    for (const QChar c : title) {
+        if (c.isLetterOrNumber()) normalized.append(c.toLower());
+    }
+    for (qsizetype i = 0; i + 1 < normalized.size(); ++i) {
+        const quint64 gram = (static_cast<quint64>(normalized.at(i).unicode()) << 16) | normalized.at(i + 1).unicode();
+        acc.add(mix64(kTitleTag ^ gram), 1);
+    }
+
+    if (!community.isEmpty()) acc.add(mix64(kCommunityTag ^ textHash(community)), 4);
+    if (record.has(HouseRecord::Layout)) {
+        acc.add(mix64(kLayoutTag ^ (static_cast<quint64>(record.rooms) << 8) ^ static_cast<quint64>(record.halls)), 3);
+    }
+    if (record.has(HouseRecord::Area)) acc.add(mix64(kAreaTag ^ static_cast<quint64>(qRound64(record.areaSqm))), 3);
+    if (record.has(HouseRecord::Price)) acc.add(mix64(kPriceTag ^ static_cast<quint64>(qRound64(record.priceWan))), 2);
+    if (record.has(HouseRecord::TotalFloors)) acc.add(mix64(kFloorsTag ^ static_cast<quint64>(record.totalFloors)), 2);
+    return acc.value();
+}
+
+} // namespace
+
+const int SimHashIndex::FLUSH_EVERY = 256;
+
+SimHashIndex::~SimHashIndex()
+{
+    close();
+}
+
+bool SimHashIndex::open(const QString& filePath)
+{
+    close();
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+
+    if (file.size() == 0) {
+        file.write(kMagic);
+        file.flush();
+        return true;
+    }
+    if (file.read(kMagic.size()) != kMagic) {
+        file.close();
+        return false;
+    }
+
+    // 先按房源取最新的指纹，再一次性建表
+    const QByteArray data = file.readAll();
+    const int records = data.size() / kRecordBytes;
+    const char *p = data.constData();
+    for (int i = 0; i < records; ++i, p += kRecordBytes) {
+        quint64 key = 0, hash = 0;
+        std::memcpy(&key, p, sizeof(key));
+        std::memcpy(&hash, p + sizeof(key), sizeof(hash));
+        auto it = indexByKey.constFind(key);
+        if (it != indexByKey.constEnd()) {
+            entries[it.value()].hash = hash;
+            staleRecords++;
+        } else {
+            indexByKey.insert(key, entries.size());
+            entries.append(Entry{key, hash});
+        }
+    }
+    for (int i = 0; i < entries.size(); ++i) {
+        index(i);
+    }
+
+    // 崩溃时写了一半的末尾记录
+    const qint64 validEnd = kMagic.size() + static_cast<qint64>(records) * kRecordBytes;
+    if (file.size() > validEnd) {
+        file.resize(validEnd);
+    }
+    if (staleRecords > entries.size() && staleRecords > 1024) {
+        compact();
+    }
+    file.seek(file.size());
+    return true;
+}
+
+void SimHashIndex::close()
+{
+    if (file.isOpen()) {
+        file.flush();
+        file.close();
+    }
+    entries.clear();
+    indexByKey.clear();
+    for (auto& table : tables) table.clear();
+    staleRecords = 0;
+    unflushed = 0;
+}
+
+quint16 SimHashIndex::block(quint64 hash, int table)
+{
+    return static_cast<quint16>(hash >> (16 * table));
+}
+
+int SimHashIndex::distance(quint64 a, quint64 b)
+{
+    return static_cast<int>(qPopulationCount(a ^ b));
+}
+
+void SimHashIndex::index(int i)
+{
+    for (int t = 0; t < TABLE_COUNT; ++t) {
+        tables[t][block(entries.at(i).hash, t)].append(i);
+    }
+}
+
+void SimHashIndex::unindex(int i)
+{
+    for (int t = 0; t < TABLE_COUNT; ++t) {
+        auto it = tables[t].find(block(entries.at(i).hash, t));
+        if (it != tables[t].end()) it->removeOne(i);
+    }
+}
+
+bool SimHashIndex::findNear(quint64 simhash, quint64 key, Hit *hit) const
+{
+    if (simhash == 0) return false;
+    int bestDistance = MAX_DISTANCE + 1;
+    quint64 bestKey = 0;
+    for (int t = 0; t < TABLE_COUNT; ++t) {
+        auto bucket = tables[t].constFind(block(simhash, t));
+        if (bucket == tables[t].constEnd()) continue;
+        for (int i : bucket.value()) {
+            const Entry& e = entries.at(i);
+            if (e.key == key) continue;
+            const int d = distance(simhash, e.hash);
+            if (d < bestDistance) {
+                bestDistance = d;
+                bestKey = e.key;
+            }
+        }
+    }
+    if (bestDistance > MAX_DISTANCE) return false;
+    if (hit != nullptr) {
+        hit->key = bestKey;
+        hit->distance = bestDistance;
+    }
+    return true;
+}
+
+void SimHashIndex::insert(quint64 key, quint64 simhash)
+{
+    if (simhash == 0) return;
+    auto it = indexByKey.constFind(key);
+    if (it != indexByKey.constEnd()) {
+        const int i = it.value();
+        if (entries.at(i).hash == simhash) return;
+        unindex(i);
+        entries[i].hash = simhash;
+        index(i);
+        staleRecords++;
+    } else {
+        const int i = entries.size();
+        indexByKey.insert(key, i);
+        entries.append(Entry{key, simhash});
+        index(i);
+    }
+    append(key, simhash);
+}
+
+void SimHashIndex::append(quint64 key, quint64 hash)
+{
+    if (!file.isOpen()) return;
+    char buffer[kRecordBytes];
+    std::memcpy(buffer, &key, sizeof(key));
+    std::memcpy(buffer + sizeof(key), &hash, sizeof(hash));
+    file.write(buffer, kRecordBytes);
+    if (++unflushed >= FLUSH_EVERY) {
+        file.flush();
+        unflushed = 0;
+    }
+}
+
+// 每个房源只保留最新指纹，原子替换原文件
+void SimHashIndex::compact()
+{
+    const QString path = file.fileName();
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) return;
+    out.write(kMagic);
+    char buffer[kRecordBytes];
+    for (const Entry& e : entries) {
+        std::memcpy(buffer, &e.key, sizeof(e.key));
+        std::memcpy(buffer + sizeof(e.key), &e.hash, sizeof(e.hash));
+        out.write(buffer, kRecordBytes);
+    }
+    file.close();
+    if (out.commit()) {
+        staleRecords = 0;
+    }
+    file.open(QIODevice::ReadWrite);
+}
+
+quint64 SimHashIndex::fingerprint(const HouseData& data)
+{
+    const HouseRecord record = data.record.parsed ? data.record : HouseRecord::fromHouse(data);
+    return simhash(data.houseTitle, data.communityName, record);
+}
+
+quint64 SimHashIndex::fingerprint(const HouseInfo& data)
+{
+    const HouseRecord record = data.record.parsed ? data.record : HouseRecord::fromHouse(data);
+    return simhash(data.houseTitle, data.communityName, record);
+}
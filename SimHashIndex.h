@@ -0,0 +1,77 @@
+#ifndef SIMHASHINDEX_H
+#define SIMHASHINDEX_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+#include "HouseData.h"
+#include "HouseInfo.h"
+
+/**
+ * @brief 同一站点内“换个标题重新发布”的近重复房源检测（SimHash + 分块查找表）
+ *
+ * 经纪人重复发布同一套房子时URL不同、标题只改几个字，houseIdSet/UrlDedupStore 只能拦住URL完全相同的。
+ * 每条房源由规范化标题的字符二元组、小区名、户型、面积、总价、总层数加权算出64位 SimHash，
+ * 海明距离 ≤ MAX_DISTANCE 视为同一套。
+ *
+ * 查找：64位切成 TABLE_COUNT(=MAX_DISTANCE+1) 段，每段一张表（段值 → 房源下标）。
+ * 距离不超过3的两个指纹至少有一段完全相同（抽屉原理），所以只需在4张表里各查一个桶再逐个比对，
+ * 不用扫描全部指纹。
+ *
+ * 持久化格式与 ContentFingerprintStore 相同：文件头 "SIMHASH1" + 16字节记录（房源URL指纹 | SimHash），
+ * 同一房源后写的记录覆盖先写的。只在爬虫所在线程使用，不加锁。
+ */
+class SimHashIndex
+{
+public:
+    static const int MAX_DISTANCE = 3;
+    static const int TABLE_COUNT = MAX_DISTANCE + 1;
+
+    struct Hit {
+        quint64 key = 0;        // 命中的已有房源（URL指纹）
+        int distance = 0;
+    };
+
+    SimHashIndex() = default;
+    ~SimHashIndex();
+    SimHashIndex(const SimHashIndex&) = delete;
+    SimHashIndex& operator=(const SimHashIndex&) = delete;
+
+    bool open(const QString& filePath);
+    void close();
+
+    // 找与 simhash 距离 ≤ MAX_DISTANCE 的其他房源（忽略 key 自身），取距离最小的一条
+    bool findNear(quint64 simhash, quint64 key, Hit *hit = nullptr) const;
+    // 记录/更新房源的指纹
+    void insert(quint64 key, quint64 simhash);
+
+    int size() const { return entries.size(); }
+
+    static quint64 fingerprint(const HouseData& data);
+    static quint64 fingerprint(const HouseInfo& data);
+    static int distance(quint64 a, quint64 b);
+
+    static const int FLUSH_EVERY;
+
+private:
+    struct Entry {
+        quint64 key;
+        quint64 hash;
+    };
+
+    static quint16 block(quint64 hash, int table);
+    void index(int i);
+    void unindex(int i);
+    void append(quint64 key, quint64 hash);
+    void compact();
+
+    QFile file;
+    QVector<Entry> entries;
+    QHash<quint64, int> indexByKey;
+    QHash<quint16, QVector<int>> tables[TABLE_COUNT];
+    int staleRecords = 0;
+    int unflushed = 0;
+};
+
+#endif // SIMHASHINDEX_H
@@ -0,0 +1,675 @@
+#include "SiteRules.h"
+#include "GumboArena.h"
+#include "HouseRecord.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QUrl>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+// 规则文件里可以写的字段名 → HouseData 成员
+const QHash<QString, QString HouseData::*>& fieldMembers()
+{
+    static const QHash<QString, QString HouseData::*> members = {
+        {"houseTitle", &HouseData::houseTitle},
+        {"communityName", &HouseData::communityName},
+        {"price", &HouseData::price},
+        {"unitPrice", &HouseData::unitPrice},
+        {"area", &HouseData::area},
+        {"houseType", &HouseData::houseType},
+        {"orientation", &HouseData::orientation},
+        {"floor", &HouseData::floor},
+        {"decoration", &HouseData::decoration},
+        {"buildingYear", &HouseData::buildingYear},
+        {"houseUrl", &HouseData::houseUrl},
+    };
+    return members;
+}
+
+bool isIdentChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('-') || c == QLatin1Char('_');
+}
+
+QString readIdent(const QString& text, int& i)
+{
+    const int start = i;
+    while (i < text.size() && isIdentChar(text.at(i))) ++i;
+    return text.mid(start, i - start);
+}
+
+void skipSpace(const QString& text, int& i)
+{
+    while (i < text.size() && text.at(i).isSpace()) ++i;
+}
+
+// 整数去掉小数部分，其余最多保留两位小数
+QString formatNumber(double value)
+{
+    QString text = QString::number(value, 'f', 2);
+    while (text.endsWith(QLatin1Char('0'))) text.chop(1);
+    if (text.endsWith(QLatin1Char('.'))) text.chop(1);
+    return text;
+}
+
+const PatternRegistry::Pattern& tagPattern()
+{
+    static const PatternRegistry::Pattern& pattern = PatternRegistry::shared().add("common", "tag", "<[^>]*>");
+    return pattern;
+}
+
+// 子树文本，连续空白压成一个空格
+QString nodeText(const CompactDom& dom, CompactDom::Index node)
+{
+    return QString::fromUtf8(dom.text(node)).simplified();
+}
+
+// 空白分隔的列表里是否有指定token（[attr~=v]）；list 来自 CompactDom，不以 \0 结尾
+bool listContains(const QByteArray& list, const QByteArray& token)
+{
+    const char* p = list.constData();
+    const char* end = p + list.size();
+    while (p < end) {
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+        const char* start = p;
+        while (p < end && !std::isspace(static_cast<unsigned char>(*p))) ++p;
+        if (p - start == token.size() && std::memcmp(start, token.constData(), static_cast<size_t>(token.size())) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool SiteRules::load(const QString& path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法读取规则文件：%1").arg(path);
+        return false;
+    }
+    return loadJson(file.readAll(), error);
+}
+
+bool SiteRules::loadJson(const QByteArray& json, QString *error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = QString("规则文件不是有效的JSON对象：%1").arg(parseError.errorString());
+        return false;
+    }
+
+    *this = SiteRules();
+    QString message;
+    if (!compile(doc.object(), message)) {
+        *this = SiteRules();
+        if (error) *error = message;
+        return false;
+    }
+    loaded = true;
+    return true;
+}
+
+bool SiteRules::compile(const QJsonObject& root, QString& error)
+{
+    siteKey = root.value("site").toString();
+    if (siteKey.isEmpty()) {
+        error = "缺少 site";
+        return false;
+    }
+    siteName = root.value("name").toString(siteKey);
+    listUrlTemplate = root.value("listUrl").toString();
+    missingValue = root.value("missing").toString("未知");
+    const QJsonObject cityObject = root.value("cities").toObject();
+    for (auto it = cityObject.constBegin(); it != cityObject.constEnd(); ++it) {
+        cities.insert(it.key(), it.value().toString());
+    }
+
+    const QJsonObject listingObject = root.value("listing").toObject();
+    const QString listingSelector = listingObject.value("selector").toString();
+    const QString listingRegex = listingObject.value("pattern").toString();
+    if (listingSelector.isEmpty() && listingRegex.isEmpty()) {
+        error = "listing 需要 selector 或 pattern";
+        return false;
+    }
+    if (!listingSelector.isEmpty() && !parseSelectorGroup(listingSelector, listing, error)) {
+        error = "listing.selector：" + error;
+        return false;
+    }
+    assignSlots(listing);
+    // 容器选择器只有一个复合选择器、且带 id 或 class 时，解析时只完整构建容器子树；
+    // 有后代/子代关系的选择器要看容器外祖先的属性，仍然整页解析
+    if (listing.alternatives.size() == 1 && listing.alternatives.first().size() == 1) {
+        const Compound& container = listing.alternatives.first().first();
+        scopedParse = !container.id.isEmpty() || !container.classes.isEmpty();
+    }
+    if (!listingRegex.isEmpty()) {
+        listingPattern = &PatternRegistry::shared().add(
+            siteKey, "listing", listingRegex,
+            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption);
+    }
+
+    const QJsonArray fieldArray = root.value("fields").toArray();
+    if (fieldArray.isEmpty()) {
+        error = "缺少 fields";
+        return false;
+    }
+    for (const QJsonValue& value : fieldArray) {
+        FieldRule field;
+        if (!compileField(value.toObject(), field, error)) {
+            error = QString("字段 %1：%2").arg(field.name, error);
+            return false;
+        }
+        fields.append(field);
+    }
+    return true;
+}
+
+bool SiteRules::compileField(const QJsonObject& object, FieldRule& field, QString& error)
+{
+    field.name = object.value("name").toString();
+    field.member = fieldMembers().value(field.name, nullptr);
+    if (field.member == nullptr) {
+        error = "不是 HouseData 的字段";
+        return false;
+    }
+
+    const QString selector = object.value("selector").toString();
+    const QString regex = object.value("pattern").toString();
+    if (selector.isEmpty() && regex.isEmpty()) {
+        error = "需要 selector 或 pattern";
+        return false;
+    }
+    field.attr = object.value("attr").toString().toUtf8();
+    field.orText = object.value("orText").toBool(false);
+    field.split = object.value("split").toString();
+    field.required = object.value("required").toBool(false);
+
+    const QString matchRegex = object.value("match").toString();
+    if (!matchRegex.isEmpty()) {
+        field.match = &PatternRegistry::shared().add(siteKey, field.name + ".match", matchRegex);
+        if (!field.match->regex().isValid()) {
+            error = "match 正则无效：" + field.match->regex().errorString();
+            return false;
+        }
+    }
+    if (!regex.isEmpty()) {
+        field.pattern = &PatternRegistry::shared().add(
+            siteKey, field.name + ".pattern", regex,
+            QRegularExpression::DotMatchesEverythingOption | QRegularExpression::CaseInsensitiveOption);
+        if (!field.pattern->regex().isValid()) {
+            error = "pattern 正则无效：" + field.pattern->regex().errorString();
+            return false;
+        }
+    }
+    if (!selector.isEmpty()) {
+        field.selector = selectorIndex(selector, error);
+        if (field.selector < 0) return false;
+        // 需要拆分或挑选时要看全部匹配节点
+        if (!field.split.isEmpty() || field.match != nullptr) selectors[field.selector].collectAll = true;
+    }
+
+    for (const QJsonValue& t : object.value("transforms").toArray()) {
+        const QString name = t.toString();
+        if (name == "collapseSpace") field.transforms.append(Transform::CollapseSpace);
+        else if (name == "stripSpace") field.transforms.append(Transform::StripSpace);
+        else if (name == "stripTags") field.transforms.append(Transform::StripTags);
+        else if (name == "absoluteUrl") field.transforms.append(Transform::AbsoluteUrl);
+        else {
+            error = "未知的 transform：" + name;
+            return false;
+        }
+    }
+
+    const QString unit = object.value("unit").toString();
+    if (unit.isEmpty()) field.unit = Unit::None;
+    else if (unit == "priceWan") field.unit = Unit::PriceWan;
+    else if (unit == "unitPrice") field.unit = Unit::UnitPrice;
+    else if (unit == "area") field.unit = Unit::Area;
+    else if (unit == "year") field.unit = Unit::Year;
+    else {
+        error = "未知的 unit：" + unit;
+        return false;
+    }
+    return true;
+}
+
+// 同一个选择器只编译、匹配一次
+int SiteRules::selectorIndex(const QString& text, QString& error)
+{
+    const QString normalized = text.simplified();
+    for (int i = 0; i < selectors.size(); ++i) {
+        if (selectors.at(i).text == normalized) return i;
+    }
+    SelectorGroup group;
+    if (!parseSelectorGroup(normalized, group, error)) {
+        error = QString("选择器“%1”：%2").arg(text, error);
+        return -1;
+    }
+    assignSlots(group);
+    selectors.append(group);
+    return selectors.size() - 1;
+}
+
+void SiteRules::assignSlots(SelectorGroup& group)
+{
+    for (Selector& selector : group.alternatives) {
+        for (Compound& compound : selector) {
+            compound.slot = compoundCount++;
+        }
+    }
+}
+
+// 每页一次：把选择器和字段用到的名称查成本页的编号，匹配时只比较整数
+SiteRules::Binding SiteRules::bind(const CompactDom& dom) const
+{
+    Binding binding;
+    binding.compounds.resize(compoundCount);
+    const int idAttr = dom.attrId("id");
+    auto bindGroup = [&](const SelectorGroup& group) {
+        for (const Selector& selector : group.alternatives) {
+            for (const Compound& compound : selector) {
+                BoundCompound& bound = binding.compounds[compound.slot];
+                if (!compound.id.isEmpty()) {
+                    bound.idAttr = idAttr;
+                    if (idAttr < 0) bound.possible = false;
+                }
+                for (const QByteArray& c : compound.classes) {
+                    const int id = dom.classId(c);
+                    if (id < 0) bound.possible = false;
+                    bound.classes.append(id);
+                }
+                for (const AttrTest& test : compound.attrs) {
+                    const int id = dom.attrId(test.name);
+                    if (id < 0) bound.possible = false;
+                    bound.attrs.append(id);
+                }
+            }
+        }
+    };
+    bindGroup(listing);
+    for (const SelectorGroup& group : selectors) {
+        bindGroup(group);
+    }
+    for (const FieldRule& field : fields) {
+        binding.fieldAttrs.append(field.attr.isEmpty() ? -1 : dom.attrId(field.attr));
+    }
+    return binding;
+}
+
+bool SiteRules::parseSelectorGroup(const QString& text, SelectorGroup& group, QString& error)
+{
+    group.text = text.simplified();
+    const QString& s = group.text;
+    int i = 0;
+    Selector current;
+    bool childCombinator = false;
+
+    while (true) {
+        skipSpace(s, i);
+        if (i >= s.size() || s.at(i) == QLatin1Char(',')) {
+            if (current.isEmpty() || childCombinator) {
+                error = "选择器为空或以组合符结尾";
+                return false;
+            }
+            group.alternatives.append(current);
+            current.clear();
+            if (i >= s.size()) break;
+            ++i;
+            continue;
+        }
+        if (s.at(i) == QLatin1Char('>')) {
+            if (current.isEmpty() || childCombinator) {
+                error = "“>”前缺少选择器";
+                return false;
+            }
+            childCombinator = true;
+            ++i;
+            continue;
+        }
+
+        Compound compound;
+        compound.childOfPrevious = childCombinator;
+        childCombinator = false;
+        bool empty = true;
+
+        if (s.at(i) == QLatin1Char('*')) {
+            ++i;
+            empty = false;
+        } else if (isIdentChar(s.at(i))) {
+            const QByteArray tagName = readIdent(s, i).toLower().toUtf8();
+            const GumboTag tag = gumbo_tag_enum(tagName.constData());
+            if (tag == GUMBO_TAG_UNKNOWN) {
+                error = "未知标签 " + QString::fromUtf8(tagName);
+                return false;
+            }
+            compound.tag = tag;
+            empty = false;
+        }
+
+        while (i < s.size()) {
+            const QChar c = s.at(i);
+            if (c == QLatin1Char('.') || c == QLatin1Char('#')) {
+                ++i;
+                const QString ident = readIdent(s, i);
+                if (ident.isEmpty()) {
+                    error = QString("“%1”后缺少名称").arg(c);
+                    return false;
+                }
+                if (c == QLatin1Char('.')) compound.classes.append(ident.toUtf8());
+                else compound.id = ident.toUtf8();
+                empty = false;
+            } else if (c == QLatin1Char('[')) {
+                ++i;
+                skipSpace(s, i);
+                AttrTest test;
+                test.name = readIdent(s, i).toLower().toUtf8();
+                skipSpace(s, i);
+                if (test.name.isEmpty() || i >= s.size()) {
+                    error = "属性选择器不完整";
+                    return false;
+                }
+                if (s.at(i) != QLatin1Char(']')) {
+                    const QChar opChar = s.at(i);
+                    if (opChar == QLatin1Char('=')) {
+                        test.op = AttrTest::Equals;
+                        ++i;
+                    } else if (i + 1 < s.size() && s.at(i + 1) == QLatin1Char('=')) {
+                        if (opChar == QLatin1Char('~')) test.op = AttrTest::Includes;
+                        else if (opChar == QLatin1Char('^')) test.op = AttrTest::Prefix;
+                        else if (opChar == QLatin1Char('$')) test.op = AttrTest::Suffix;
+                        else if (opChar == QLatin1Char('*')) test.op = AttrTest::Contains;
+                        else {
+                            error = QString("不支持的属性运算符 %1=").arg(opChar);
+                            return false;
+                        }
+                        i += 2;
+                    } else {
+                        error = "属性选择器不完整";
+                        return false;
+                    }
+                    skipSpace(s, i);
+                    QString value;
+                    if (i < s.size() && (s.at(i) == QLatin1Char('"') || s.at(i) == QLatin1Char('\''))) {
+                        const QChar quote = s.at(i++);
+                        const int end = s.indexOf(quote, i);
+                        if (end < 0) {
+                            error = "属性值缺少结束引号";
+                            return false;
+                        }
+                        value = s.mid(i, end - i);
+                        i = end + 1;
+                    } else {
+                        value = readIdent(s, i);
+                    }
+                    test.value = value.toUtf8();
+                    skipSpace(s, i);
+                }
+                if (i >= s.size() || s.at(i) != QLatin1Char(']')) {
+                    error = "属性选择器缺少“]”";
+                    return false;
+                }
+                ++i;
+                compound.attrs.append(test);
+                empty = false;
+            } else {
+                break;
+            }
+        }
+
+        if (empty) {
+            error = QString("无法识别的字符“%1”").arg(s.at(i));
+            return false;
+        }
+        current.append(compound);
+    }
+    return !group.alternatives.isEmpty();
+}
+
+bool SiteRules::matchesCompound(const CompactDom& dom, Index node, const Compound& compound,
+                                const BoundCompound& bound)
+{
+    if (dom.type(node) != CompactDom::Element) return false;
+    // 先比较标签枚举，绝大多数节点在这里就被排除
+    if (compound.tag >= 0 && dom.tag(node) != compound.tag) return false;
+    if (!bound.possible) return false;
+    if (!compound.id.isEmpty()) {
+        QByteArray id;
+        if (!dom.attribute(node, bound.idAttr, &id) || id != compound.id) return false;
+    }
+    for (int c : bound.classes) {
+        if (!dom.hasClass(node, c)) return false;
+    }
+    for (int k = 0; k < compound.attrs.size(); ++k) {
+        const AttrTest& test = compound.attrs.at(k);
+        QByteArray actual;
+        if (!dom.attribute(node, bound.attrs.at(k), &actual)) return false;
+        if (test.op == AttrTest::Exists) continue;
+        bool ok = false;
+        switch (test.op) {
+        case AttrTest::Equals: ok = actual == test.value; break;
+        case AttrTest::Includes: ok = listContains(actual, test.value); break;
+        case AttrTest::Prefix: ok = actual.startsWith(test.value); break;
+        case AttrTest::Suffix: ok = actual.endsWith(test.value); break;
+        case AttrTest::Contains: ok = actual.contains(test.value); break;
+        case AttrTest::Exists: ok = true; break;
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// 从右向左匹配：index 位置的复合选择器匹配 node 后，沿父节点下标在 scope（含）以内找左侧的部分
+bool SiteRules::matchesFrom(const CompactDom& dom, const Binding& binding, Index node,
+                            const Selector& selector, int index, Index scope)
+{
+    const Compound& compound = selector.at(index);
+    if (!matchesCompound(dom, node, compound, binding.compounds.at(compound.slot))) return false;
+    if (index == 0) return true;
+    for (Index p = dom.parent(node); p != CompactDom::NONE; p = dom.parent(p)) {
+        if (matchesFrom(dom, binding, p, selector, index - 1, scope)) return true;
+        if (compound.childOfPrevious || p == scope) break;
+    }
+    return false;
+}
+
+bool SiteRules::matches(const CompactDom& dom, const Binding& binding, Index node,
+                        const SelectorGroup& group, Index scope)
+{
+    for (const Selector& selector : group.alternatives) {
+        if (matchesFrom(dom, binding, node, selector, selector.size() - 1, scope)) return true;
+    }
+    return false;
+}
+
+QString SiteRules::listUrl(const QString& city, int page) const
+{
+    const QString code = cities.value(city);
+    if (code.isEmpty() || listUrlTemplate.isEmpty()) return QString();
+    QString url = listUrlTemplate;
+    url.replace("{city}", code);
+    url.replace("{page}", QString::number(page));
+    return url;
+}
+
+QList<HouseData> SiteRules::extract(const QString& html, const QString& city, const QString& pageUrl) const
+{
+    QList<HouseData> result;
+    if (!loaded) return result;
+
+    if (!listing.alternatives.isEmpty()) {
+        const QByteArray utf8 = html.toUtf8();
+        // 过滤条件只取标签、id 和第一个 class，其余条件仍由 matches() 在容器节点上检查
+        GumboSubtreeFilter scope = {GUMBO_TAG_LAST, nullptr, nullptr, false};
+        if (scopedParse) {
+            const Compound& container = listing.alternatives.first().first();
+            if (container.tag >= 0) scope.tag = static_cast<GumboTag>(container.tag);
+            if (!container.id.isEmpty()) scope.id = container.id.constData();
+            if (!container.classes.isEmpty()) scope.class_name = container.classes.first().constData();
+        }
+        CompactDom dom;
+        {
+            GumboArena::Document doc(utf8.constData(), utf8.size(), scopedParse ? &scope : nullptr);
+            dom.build(doc.output(), utf8.constData(), static_cast<size_t>(utf8.size()));
+        } // Gumbo 的树到这里就释放，后面只用紧凑表示
+        const Binding binding = bind(dom);
+        bool foundContainer = false;
+        const Index root = dom.root();
+        const Index end = root == CompactDom::NONE ? root : dom.subtreeEnd(root);
+        for (Index node = root; node < end;) {
+            if (!matches(dom, binding, node, listing, 0)) {
+                ++node;
+                continue;
+            }
+            foundContainer = true;
+            HouseData data;
+            if (extractListing(dom, binding, node, utf8.constData(), city, pageUrl, data)) {
+                result.append(data);
+            }
+            node = dom.subtreeEnd(node); // 房源容器不嵌套，跳过其子树
+        }
+        if (foundContainer || listingPattern == nullptr) return result;
+    }
+
+    // 整页都没有匹配选择器的容器（页面改版）：按正则切出房源片段，只用字段的 pattern
+    for (const QRegularExpressionMatch& m : listingPattern->matchAll(html)) {
+        const QString fragment = m.captured(0);
+        HouseData data;
+        data.city = city;
+        bool complete = true;
+        for (const FieldRule& field : fields) {
+            QString value;
+            if (field.pattern != nullptr) {
+                const QRegularExpressionMatch fm = field.pattern->match(fragment);
+                if (fm.hasMatch()) value = fm.captured(fm.lastCapturedIndex() > 0 ? 1 : 0);
+            }
+            if (!finishField(field, value, pageUrl, data)) {
+                complete = false;
+                break;
+            }
+        }
+        if (complete) result.append(data);
+    }
+    return result;
+}
+
+bool SiteRules::extractListing(const CompactDom& dom, const Binding& binding, Index listingNode,
+                               const char* utf8, const QString& city, const QString& pageUrl,
+                               HouseData& data) const
+{
+    // 顺序扫描容器子树的下标区间，同时为所有选择器收集节点；只取第一个的选择器取到后不再测试
+    QVector<QVector<Index>> hits(selectors.size());
+    int pending = selectors.size();
+    QVector<bool> satisfied(selectors.size(), false);
+    const Index end = dom.subtreeEnd(listingNode);
+    for (Index node = listingNode + 1; node < end && pending > 0; ++node) {
+        if (dom.type(node) != CompactDom::Element) continue;
+        for (int s = 0; s < selectors.size(); ++s) {
+            if (satisfied.at(s) || !matches(dom, binding, node, selectors.at(s), listingNode)) continue;
+            hits[s].append(node);
+            if (!selectors.at(s).collectAll) {
+                satisfied[s] = true;
+                pending--;
+            }
+        }
+    }
+
+    data.city = city;
+    QString fragment;   // 容器的原始HTML，只在需要正则回退时切出来
+    for (int f = 0; f < fields.size(); ++f) {
+        const FieldRule& field = fields.at(f);
+        QString value;
+        if (field.selector >= 0) {
+            for (Index node : hits.at(field.selector)) {
+                QString text;
+                QByteArray attr;
+                if (!field.attr.isEmpty() && dom.attribute(node, binding.fieldAttrs.at(f), &attr)) {
+                    text = QString::fromUtf8(attr).trimmed();
+                }
+                if (text.isEmpty() && (field.attr.isEmpty() || field.orText)) text = nodeText(dom, node);
+
+                const QStringList candidates = field.split.isEmpty() ? QStringList{text} : text.split(field.split);
+                for (const QString& candidate : candidates) {
+                    const QString trimmed = candidate.trimmed();
+                    if (trimmed.isEmpty()) continue;
+                    if (field.match == nullptr || field.match->contains(trimmed)) {
+                        value = trimmed;
+                        break;
+                    }
+                }
+                if (!value.isEmpty()) break;
+            }
+        }
+        if (value.isEmpty() && field.pattern != nullptr) {
+            if (fragment.isEmpty()) {
+                fragment = QString::fromUtf8(utf8 + dom.sourceOffset(listingNode),
+                                             static_cast<int>(dom.sourceLength(listingNode)));
+            }
+            const QRegularExpressionMatch m = field.pattern->match(fragment);
+            if (m.hasMatch()) value = m.captured(m.lastCapturedIndex() > 0 ? 1 : 0);
+        }
+        if (!finishField(field, value, pageUrl, data)) return false;
+    }
+    return true;
+}
+
+// 后处理 + 单位规范化后写入字段；必填字段为空时返回false
+bool SiteRules::finishField(const FieldRule& field, QString value, const QString& pageUrl, HouseData& data) const
+{
+    if (field.pattern != nullptr && value.contains(QLatin1Char('<'))) {
+        tagPattern().remove(value);   // 正则捕获的是HTML片段
+    }
+    for (Transform t : field.transforms) {
+        switch (t) {
+        case Transform::CollapseSpace:
+            value = value.simplified();
+            break;
+        case Transform::StripSpace:
+            value = value.simplified().remove(QLatin1Char(' '));
+            break;
+        case Transform::StripTags:
+            tagPattern().remove(value);
+            break;
+        case Transform::AbsoluteUrl:
+            if (!value.isEmpty() && !pageUrl.isEmpty()) {
+                value = QUrl(pageUrl).resolved(QUrl(value)).toString();
+            } else if (value.startsWith("//")) {
+                value.prepend("https:");
+            }
+            break;
+        }
+    }
+    value = value.trimmed();
+
+    double number = 0;
+    int year = 0;
+    switch (field.unit) {
+    case Unit::None:
+        break;
+    case Unit::PriceWan:
+        if (HouseRecord::parsePriceWan(value, number)) value = formatNumber(number) + "万";
+        break;
+    case Unit::UnitPrice:
+        if (HouseRecord::parseUnitPrice(value, number)) value = QString::number(qRound64(number)) + "元/㎡";
+        break;
+    case Unit::Area:
+        if (HouseRecord::parseArea(value, number)) value = formatNumber(number) + "㎡";
+        break;
+    case Unit::Year:
+        if (HouseRecord::parseYear(value, year)) value = QString::number(year) + "年建造";
+        break;
+    }
+
+    if (value.isEmpty()) {
+        if (field.required) return false;
+        value = missingValue;
+    }
+    data.*field.member = value;
+    return true;
+}
@@ -0,0 +1,153 @@
+#ifndef SITERULES_H
+#define SITERULES_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QJsonObject>
+#include "HouseData.h"
+#include "PatternRegistry.h"
+#include "CompactDom.h"
+
+/**
+ * @brief 声明式站点提取规则（rules/<site>.json），加载时编译成提取程序
+ *
+ * 新增站点或修一个选择器只需要改规则文件，不用改C++、不用重新编译。规则文件描述：
+ *   - listUrl / cities：列表页URL模板（{city} {page}）与城市名 → 子域名；
+ *   - listing：房源容器的CSS选择器，以及整页找不到容器时回退用的正则；
+ *   - fields：每个 HouseData 字段的选择器（取文本或属性）、可选的按分隔符拆分 + 正则挑选、
+ *     选择器取不到值时对房源HTML片段回退的正则、后处理（压空白/去空白/去标签/补全URL）
+ *     和单位规范化（总价→“xx万”、单价→“xx元/㎡”、面积→“xx㎡”、年代→“xxxx年建造”，
+ *     与 HouseRecord 的解析格式一致）。
+ *
+ * 编译：选择器（标签、.class、#id、[attr]/[attr=v]/[attr^=v]/[attr$=v]/[attr*=v]/[attr~=v]、
+ * 后代/子代组合、逗号分组）解析成结构化的匹配步骤，标签名转成 GumboTag 枚举；
+ * 多个字段写同一个选择器时只匹配一次；正则在 PatternRegistry 里注册（站点名即规则文件的 site）。
+ * 执行：整页只解析一次，转成 CompactDom 后释放 Gumbo 的树；选择器里的 class/属性名先换成本页的
+ * 编号（bind），找容器、遍历容器子树都是按下标顺序扫描；每个房源容器的子树只扫一遍，
+ * 同时为所有选择器收集节点，再按字段取值。
+ *
+ * load() 之后只读，可在流水线的多个提取线程里同时调用 extract()。
+ */
+class SiteRules
+{
+public:
+    bool load(const QString& path, QString *error = nullptr);
+    bool loadJson(const QByteArray& json, QString *error = nullptr);
+    bool isLoaded() const { return loaded; }
+
+    const QString& site() const { return siteKey; }
+    const QString& name() const { return siteName; }
+
+    // 第 page 页列表页URL；城市不在规则的 cities 表里时返回空串
+    QString listUrl(const QString& city, int page) const;
+
+    // 从整页HTML提取房源；pageUrl 用于补全相对链接
+    QList<HouseData> extract(const QString& html, const QString& city, const QString& pageUrl = QString()) const;
+
+private:
+    using Index = CompactDom::Index;
+
+    struct AttrTest {
+        enum Op : quint8 { Exists, Equals, Includes, Prefix, Suffix, Contains };
+        QByteArray name;
+        QByteArray value;
+        Op op = Exists;
+    };
+
+    // 复合选择器（如 div.title[data-id]）以及它与左侧复合选择器的关系
+    struct Compound {
+        int tag = -1;                   // GumboTag，-1 表示任意标签
+        QByteArray id;
+        QVector<QByteArray> classes;
+        QVector<AttrTest> attrs;
+        bool childOfPrevious = false;   // true：“>”子代；false：后代
+        int slot = -1;                  // 在 Binding::compounds 里的下标
+    };
+
+    using Selector = QVector<Compound>;
+
+    struct SelectorGroup {
+        QString text;
+        QVector<Selector> alternatives; // 逗号分隔的任一匹配即可
+        bool collectAll = false;        // 有字段需要遍历全部匹配节点（拆分/挑选），否则只取第一个
+    };
+
+    enum class Transform : quint8 {
+        CollapseSpace,
+        StripSpace,
+        StripTags,
+        AbsoluteUrl
+    };
+
+    enum class Unit : quint8 {
+        None,
+        PriceWan,
+        UnitPrice,
+        Area,
+        Year
+    };
+
+    struct FieldRule {
+        QString name;
+        QString HouseData::*member = nullptr;
+        int selector = -1;              // selectors 下标
+        QByteArray attr;                // 为空时取节点文本
+        bool orText = false;            // 属性为空时改取节点文本
+        QString split;
+        const PatternRegistry::Pattern *match = nullptr;    // 从候选值里挑第一个匹配的
+        const PatternRegistry::Pattern *pattern = nullptr;  // 回退：对房源HTML片段取第1个捕获组
+        QVector<Transform> transforms;
+        Unit unit = Unit::None;
+        bool required = false;          // 取不到值时丢弃整条房源
+    };
+
+    // 复合选择器绑定到某一页：class 名、属性名换成该页 CompactDom 里的编号
+    struct BoundCompound {
+        bool possible = true;           // 用到的名称本页都出现过，否则不可能匹配
+        int idAttr = -1;
+        QVector<int> classes;
+        QVector<int> attrs;             // 与 Compound::attrs 一一对应
+    };
+
+    struct Binding {
+        QVector<BoundCompound> compounds;   // 按 Compound::slot
+        QVector<int> fieldAttrs;            // 按 fields 下标，字段不取属性时为 -1
+    };
+
+    bool compile(const QJsonObject& root, QString& error);
+    bool compileField(const QJsonObject& object, FieldRule& field, QString& error);
+    int selectorIndex(const QString& text, QString& error);
+    static bool parseSelectorGroup(const QString& text, SelectorGroup& group, QString& error);
+    void assignSlots(SelectorGroup& group);
+    Binding bind(const CompactDom& dom) const;
+
+    static bool matchesCompound(const CompactDom& dom, Index node, const Compound& compound,
+                                const BoundCompound& bound);
+    static bool matchesFrom(const CompactDom& dom, const Binding& binding, Index node,
+                            const Selector& selector, int index, Index scope);
+    static bool matches(const CompactDom& dom, const Binding& binding, Index node,
+                        const SelectorGroup& group, Index scope);
+
+    bool extractListing(const CompactDom& dom, const Binding& binding, Index listing, const char* utf8,
+                        const QString& city, const QString& pageUrl, HouseData& data) const;
+    bool finishField(const FieldRule& field, QString value, const QString& pageUrl, HouseData& data) const;
+
+    bool loaded = false;
+    QString siteKey;
+    QString siteName;
+    QString listUrlTemplate;
+    QHash<QString, QString> cities;
+    QString missingValue;
+    SelectorGroup listing;
+    bool scopedParse = false;           // 容器选择器可以直接作为解析过滤条件（GumboSubtreeFilter）
+    const PatternRegistry::Pattern *listingPattern = nullptr;
+    QVector<SelectorGroup> selectors;
+    QVector<FieldRule> fields;
+    int compoundCount = 0;
+};
+
+#endif // SITERULES_H
@@ -0,0 +1,71 @@
+#include "StringPool.h"
+
+StringPool& StringPool::shared()
+{
+    static StringPool pool;
+    return pool;
+}
+
+StringPool::StringPool()
+{
+    strings.append(QString());
+    ids.insert(QString(), EMPTY_ID);
+}
+
+quint32 StringPool::intern(const QString& text)
+{
+    if (text.isEmpty()) return EMPTY_ID;
+    {
+        QReadLocker locker(&lock);
+        auto it = ids.constFind(text);
+        if (it != ids.constEnd()) return it.value();
+    }
+
+    QWriteLocker locker(&lock);
+    auto it = ids.constFind(text);      // 两次加锁之间可能已被其他线程插入
+    if (it != ids.constEnd()) return it.value();
+    const quint32 id = static_cast<quint32>(strings.size());
+    strings.append(text);
+    ids.insert(text, id);
+    totalBytes += text.size() * static_cast<qint64>(sizeof(QChar));
+    return id;
+}
+
+bool StringPool::find(const QString& text, quint32& id) const
+{
+    QReadLocker locker(&lock);
+    auto it = ids.constFind(text);
+    if (it == ids.constEnd()) return false;
+    id = it.value();
+    return true;
+}
+
+QString StringPool::text(quint32 id) const
+{
+    QReadLocker locker(&lock);
+    return id < static_cast<quint32>(strings.size()) ? strings.at(id) : QString();
+}
+
+QString StringPool::canonical(const QString& text)
+{
+    return this->text(intern(text));
+}
+
+int StringPool::size() const
+{
+    QReadLocker locker(&lock);
+    return strings.size() - 1;
+}
+
+qint64 StringPool::bytes() const
+{
+    QReadLocker locker(&lock);
+    return totalBytes;
+}
+
+QString StringPool::summary() const
+{
+    QReadLocker locker(&lock);
+    return QString("🔤 字符串字典：%1个不同取值，共%2 KB")
+        .arg(strings.size() - 1).arg(totalBytes / 1024);
+}
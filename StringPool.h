@@ -0,0 +1,46 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+/**
+ * @brief 进程内共享的字符串字典（重复率高的房源字段用）
+ *
+ * 小区名、户型、朝向、装修、城市、区域这几列在成千上万条房源里反复出现。
+ * intern() 给每个不同的字符串分配一个32位编号，text() 返回字典里那一份 QString：
+ * 记录里的字段换成字典里的实例后，所有副本（结果列表、界面表格、导出）共享同一块字符数据，
+ * 比较/分组/筛选可以直接比编号。编号只在本进程内有效，不落盘。
+ *
+ * 流水线的多个提取线程会同时写入，内部用读写锁；查已有字符串只拿读锁。
+ */
+class StringPool
+{
+public:
+    static StringPool& shared();
+
+    static const quint32 EMPTY_ID = 0;  // 空串固定为0
+
+    quint32 intern(const QString& text);
+    // 只查不插入，未收录返回false
+    bool find(const QString& text, quint32& id) const;
+    QString text(quint32 id) const;
+    // intern 后返回字典里的实例（调用方用它替换自己的副本）
+    QString canonical(const QString& text);
+
+    int size() const;
+    qint64 bytes() const;               // 字典中字符串的字符数据总字节数
+    QString summary() const;
+
+private:
+    StringPool();
+
+    mutable QReadWriteLock lock;
+    QHash<QString, quint32> ids;
+    QVector<QString> strings;           // 下标即编号
+    qint64 totalBytes = 0;
+};
+
+#endif // STRINGPOOL_H
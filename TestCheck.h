@@ -0,0 +1,24 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <QDebug>
+
+// 各测试程序共用的断言：条件不成立时计数并打印条件和行号，不中断后续用例
+inline int testFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            testFailures++; \
+            qDebug() << "  失败：" << #cond << "（第" << __LINE__ << "行）"; \
+        } \
+    } while (0)
+
+// 打印汇总并返回进程退出码
+inline int testResult()
+{
+    qDebug() << "=== 测试完成，失败" << testFailures << "项 ===";
+    return testFailures == 0 ? 0 : 1;
+}
+
+#endif // TESTCHECK_H
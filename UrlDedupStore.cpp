@@ -0,0 +1,332 @@
+#include "UrlDedupStore.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtDebug>
+#include <cstring>
+
+const quint64 UrlDedupStore::DEFAULT_CAPACITY = 1 << 16;
+
+namespace {
+
+const char kMagic[8] = { 'U', 'R', 'L', 'D', 'E', 'D', 'U', 'P' };
+const int kBloomHashes = 7;
+const int kBloomBitsPerSlot = 8;   // 按槽位数分配，装载率0.7时约每元素11位
+
+// splitmix64 终结器：打散FNV结果的低位，开放寻址和Bloom都直接取低位
+quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+quint64 nextPowerOfTwo(quint64 v)
+{
+    quint64 p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+UrlDedupStore& UrlDedupStore::shared()
+{
+    static UrlDedupStore store;
+    static bool opened = store.open("dedup/seen.fps");
+    Q_UNUSED(opened);
+    return store;
+}
+
+UrlDedupStore::~UrlDedupStore()
+{
+    close();
+}
+
+QString UrlDedupStore::normalizeUrl(const QString& url)
+{
+    QUrl parsed(url.trimmed());
+    if (!parsed.isValid() || parsed.host().isEmpty()) {
+        return url.trimmed();
+    }
+
+    static const QStringList trackingKeys = {
+        "spm", "scm", "pvid", "logid", "from", "trace_id", "traceid", "utm_source", "utm_medium",
+        "utm_campaign", "utm_term", "utm_content", "now_time", "position", "kwtype", "entry"
+    };
+    QUrlQuery query(parsed);
+    const auto items = query.queryItems(QUrl::FullyEncoded);
+    for (const auto& item : items) {
+        if (trackingKeys.contains(item.first, Qt::CaseInsensitive)) {
+            query.removeAllQueryItems(item.first);
+        }
+    }
+    parsed.setQuery(query);
+    parsed.setFragment(QString());
+    parsed.setScheme(parsed.scheme().toLower());
+    parsed.setHost(parsed.host().toLower());
+
+    QString normalized = parsed.toString(QUrl::FullyEncoded);
+    while (normalized.endsWith('/')) normalized.chop(1);
+    return normalized;
+}
+
+quint64 UrlDedupStore::fingerprint(const QString& key)
+{
+    // FNV-1a 64 + splitmix64，跨进程/跨平台稳定（qHash带随机种子，不能持久化）
+    const QByteArray bytes = normalizeUrl(key).toUtf8();
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (char c : bytes) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    h = mix64(h);
+    return h == 0 ? 1 : h;   // 0 表示空槽
+}
+
+bool UrlDedupStore::open(const QString& filePath, quint64 initialCapacity)
+{
+    QMutexLocker locker(&mutex);
+    if (mapped != nullptr) {
+        file.unmap(mapped);
+        file.close();
+        mapped = nullptr;
+        header = nullptr;
+        slots = nullptr;
+    }
+
+    path = filePath;
+    created = false;
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    file.setFileName(path);
+    const bool exists = file.exists() && file.size() >= static_cast<qint64>(sizeof(Header));
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    if (exists) {
+        Header existing;
+        file.read(reinterpret_cast<char*>(&existing), sizeof(Header));
+        const qint64 expectedSize = sizeof(Header) + static_cast<qint64>(existing.capacity * sizeof(quint64));
+        if (std::memcmp(existing.magic, kMagic, sizeof(kMagic)) == 0 && existing.version == 1
+            && existing.capacity > 0 && (existing.capacity & (existing.capacity - 1)) == 0
+            && file.size() == expectedSize) {
+            if (!mapFile(file, existing.capacity, false)) return false;
+            rebuildBloom();
+            return true;
+        }
+        // 文件损坏或版本不符：重建（去重库只是加速用，丢失后最多重复爬一次）
+        file.resize(0);
+    }
+
+    if (!mapFile(file, nextPowerOfTwo(qMax<quint64>(initialCapacity, 1024)), true)) return false;
+    rebuildBloom();
+    created = true;
+    return true;
+}
+
+bool UrlDedupStore::claimSeed()
+{
+    QMutexLocker locker(&mutex);
+    const bool seed = created && slots != nullptr;
+    created = false;
+    return seed;
+}
+
+bool UrlDedupStore::mapFile(QFile& target, quint64 capacity, bool initialize)
+{
+    const qint64 bytes = sizeof(Header) + static_cast<qint64>(capacity * sizeof(quint64));
+    if (initialize && !target.resize(bytes)) return false;
+
+    uchar *memory = target.map(0, bytes);
+    if (memory == nullptr) return false;
+
+    if (initialize) {
+        std::memset(memory, 0, static_cast<size_t>(bytes));
+        Header *h = reinterpret_cast<Header*>(memory);
+        std::memcpy(h->magic, kMagic, sizeof(kMagic));
+        h->version = 1;
+        h->capacity = capacity;
+        h->count = 0;
+    }
+    mapped = memory;
+    header = reinterpret_cast<Header*>(memory);
+    slots = reinterpret_cast<quint64*>(memory + sizeof(Header));
+    return true;
+}
+
+void UrlDedupStore::close()
+{
+    QMutexLocker locker(&mutex);
+    if (mapped != nullptr) {
+        file.unmap(mapped);
+        mapped = nullptr;
+        header = nullptr;
+        slots = nullptr;
+    }
+    if (file.isOpen()) file.close();
+    bloom.clear();
+}
+
+bool UrlDedupStore::probe(quint64 fp, quint64& slot) const
+{
+    const quint64 mask = header->capacity - 1;
+    slot = fp & mask;
+    while (slots[slot] != 0) {
+        if (slots[slot] == fp) return true;
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+void UrlDedupStore::rebuildBloom()
+{
+    const quint64 bits = nextPowerOfTwo(header->capacity * kBloomBitsPerSlot);
+    bloom.fill(0, static_cast<int>(bits / 64));
+    bloomMask = bits - 1;
+    for (quint64 i = 0; i < header->capacity; ++i) {
+        if (slots[i] != 0) bloomAdd(slots[i]);
+    }
+}
+
+void UrlDedupStore::bloomAdd(quint64 fp)
+{
+    // 双重哈希：h1 + i*h2
+    const quint64 h1 = fp;
+    const quint64 h2 = mix64(fp) | 1;
+    for (int i = 0; i < kBloomHashes; ++i) {
+        const quint64 bit = (h1 + i * h2) & bloomMask;
+        bloom[static_cast<int>(bit >> 6)] |= (1ULL << (bit & 63));
+    }
+}
+
+bool UrlDedupStore::bloomMayContain(quint64 fp) const
+{
+    const quint64 h1 = fp;
+    const quint64 h2 = mix64(fp) | 1;
+    for (int i = 0; i < kBloomHashes; ++i) {
+        const quint64 bit = (h1 + i * h2) & bloomMask;
+        if ((bloom[static_cast<int>(bit >> 6)] & (1ULL << (bit & 63))) == 0) return false;
+    }
+    return true;
+}
+
+bool UrlDedupStore::containsFingerprint(quint64 fp) const
+{
+    QMutexLocker locker(&mutex);
+    if (slots == nullptr) return false;
+    if (!bloomMayContain(fp)) {
+        bloomRejectCount++;
+        return false;
+    }
+    quint64 slot = 0;
+    return probe(fp, slot);
+}
+
+bool UrlDedupStore::insertFingerprint(quint64 fp)
+{
+    QMutexLocker locker(&mutex);
+    if (slots == nullptr) {
+        noteUnrecorded("去重库未打开");
+        return true;
+    }
+
+    const bool maybeSeen = bloomMayContain(fp);
+    if (!maybeSeen) bloomRejectCount++;
+    quint64 slot = 0;
+    if (maybeSeen && probe(fp, slot)) return false;
+
+    // 装载率超过0.7时扩容（扩容后重新找空槽）；扩容失败时原表仍在，还有空槽就照常插入
+    if ((header->count + 1) * 10 > header->capacity * 7 && !grow()) {
+        if (slots == nullptr || header->count + 1 >= header->capacity) {
+            noteUnrecorded("去重库扩容失败且已满");
+            return true;
+        }
+    }
+    probe(fp, slot);
+    slots[slot] = fp;
+    header->count++;
+    bloomAdd(fp);
+    return true;
+}
+
+// 容量翻倍：新表在内存里建好后用QSaveFile整体替换原文件（映射状态下不能改大小）。
+// 替换是原子的：失败时原文件不变，重新映射原文件继续使用，返回false
+bool UrlDedupStore::grow()
+{
+    const quint64 oldCapacity = header->capacity;
+    const quint64 newCapacity = oldCapacity * 2;
+    QByteArray table(static_cast<qsizetype>(sizeof(Header) + newCapacity * sizeof(quint64)), '\0');
+    Header *h = reinterpret_cast<Header*>(table.data());
+    std::memcpy(h->magic, kMagic, sizeof(kMagic));
+    h->version = 1;
+    h->capacity = newCapacity;
+    h->count = header->count;
+    quint64 *newSlots = reinterpret_cast<quint64*>(table.data() + sizeof(Header));
+    const quint64 mask = newCapacity - 1;
+    for (quint64 i = 0; i < oldCapacity; ++i) {
+        const quint64 fp = slots[i];
+        if (fp == 0) continue;
+        quint64 s = fp & mask;
+        while (newSlots[s] != 0) s = (s + 1) & mask;
+        newSlots[s] = fp;
+    }
+
+    QSaveFile next(path);
+    if (!next.open(QIODevice::WriteOnly) || next.write(table) != table.size()) return false;
+
+    // 有的平台不能替换仍被映射的文件：先解除映射再提交
+    file.unmap(mapped);
+    file.close();
+    mapped = nullptr;
+    header = nullptr;
+    slots = nullptr;
+    const bool swapped = next.commit();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite) || !mapFile(file, swapped ? newCapacity : oldCapacity, false)) return false;
+    if (swapped) rebuildBloom();
+    return swapped;
+}
+
+bool UrlDedupStore::contains(const QString& key) const
+{
+    return containsFingerprint(fingerprint(key));
+}
+
+// 调用方持有 mutex
+void UrlDedupStore::noteUnrecorded(const char *reason)
+{
+    if (unrecorded++ == 0) {
+        qWarning() << "UrlDedupStore:" << reason << path << "，之后插入的键不会被记录，下次运行会当作新键";
+    }
+}
+
+quint64 UrlDedupStore::unrecordedCount() const
+{
+    QMutexLocker locker(&mutex);
+    return unrecorded;
+}
+
+bool UrlDedupStore::insert(const QString& key)
+{
+    return insertFingerprint(fingerprint(key));
+}
+
+quint64 UrlDedupStore::size() const
+{
+    QMutexLocker locker(&mutex);
+    return header ? header->count : 0;
+}
+
+quint64 UrlDedupStore::capacity() const
+{
+    QMutexLocker locker(&mutex);
+    return header ? header->capacity : 0;
+}
@@ -0,0 +1,84 @@
+#ifndef URLDEDUPSTORE_H
+#define URLDEDUPSTORE_H
+
+#include <QString>
+#include <QFile>
+#include <QVector>
+#include <QMutex>
+
+/**
+ * @brief 持久化的URL/房源去重库（各站点爬虫共用一个实例）
+ *
+ * 每个键（规范化后的URL）只保存64位指纹，存放在内存映射文件里的开放寻址哈希表中（装载率≤0.7），
+ * 前面挡一层内存Bloom过滤器（每个元素约10位，k=7，误判率约1%）：绝大多数新URL在Bloom处即可判定，
+ * 不必访问映射页。平均每个URL约13字节，查找/插入O(1)，进程重启后直接映射已有文件，无需重建。
+ *
+ * 替代原先每次运行都从空开始、按完整UTF-16字符串存储的 QSet<QString> crawledUrls / houseIdSet。
+ */
+class UrlDedupStore
+{
+public:
+    // 共享实例：首次使用时打开 dedup/seen.fps
+    static UrlDedupStore& shared();
+
+    UrlDedupStore() = default;
+    ~UrlDedupStore();
+    UrlDedupStore(const UrlDedupStore&) = delete;
+    UrlDedupStore& operator=(const UrlDedupStore&) = delete;
+
+    bool open(const QString& filePath, quint64 initialCapacity = DEFAULT_CAPACITY);
+    void close();
+    bool isOpen() const { return slots != nullptr; }
+    // 文件是本次新建的（首次运行或原文件损坏）时第一次调用返回true：调用方据此用数据库里已有的房源补齐
+    bool claimSeed();
+
+    bool contains(const QString& key) const;
+    // 插入；返回true表示此前从未见过（新URL/新房源）
+    bool insert(const QString& key);
+
+    bool containsFingerprint(quint64 fp) const;
+    // 库未打开、或扩容失败且表已满时记不下：仍返回true（当作新键）并计入 unrecordedCount()，首次发生时打警告
+    bool insertFingerprint(quint64 fp);
+
+    // 规范化（去掉#片段、末尾斜杠、常见跟踪参数，协议/域名小写）后计算64位指纹
+    static quint64 fingerprint(const QString& key);
+    static QString normalizeUrl(const QString& url);
+
+    quint64 size() const;
+    quint64 capacity() const;
+    quint64 bloomRejects() const { return bloomRejectCount; }  // 由Bloom直接判定为新键的次数
+    quint64 unrecordedCount() const;                            // 因未打开/已满没有记下的插入次数
+
+    static const quint64 DEFAULT_CAPACITY;
+
+private:
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 reserved;
+        quint64 capacity;   // 槽位数（2的幂）
+        quint64 count;
+    };
+
+    bool mapFile(QFile& file, quint64 capacity, bool initialize);
+    bool grow();
+    bool probe(quint64 fp, quint64& slot) const;   // 找到返回true；否则slot为可插入的空槽
+    void rebuildBloom();
+    void bloomAdd(quint64 fp);
+    bool bloomMayContain(quint64 fp) const;
+    void noteUnrecorded(const char *reason);
+
+    mutable QMutex mutex;
+    QString path;
+    QFile file;
+    uchar *mapped = nullptr;
+    Header *header = nullptr;
+    quint64 *slots = nullptr;
+    QVector<quint64> bloom;
+    quint64 bloomMask = 0;
+    mutable quint64 bloomRejectCount = 0;
+    quint64 unrecorded = 0;
+    bool created = false;
+};
+
+#endif // URLDEDUPSTORE_H
@@ -3,9 +3,31 @@
 #include <QSqlRecord>
 #include <QDateTime>
 #include <QJsonDocument>
+#include <QSet>
 
 DatabaseManager* DatabaseManager::m_instance = nullptr;
 
+namespace {
+
+// 查询结果的字符串字典：小区名/户型/楼层在一批房源里大量重复，同一取值只保留一份 QString，
+// 各行的 QVariant 共享其字符数据（服务端独立部署，不依赖爬虫侧的 StringPool）
+class ResultDictionary
+{
+public:
+    QVariant intern(const QVariant& value)
+    {
+        const QString text = value.toString();
+        auto it = values.constFind(text);
+        if (it == values.constEnd()) it = values.insert(text);
+        return *it;
+    }
+
+private:
+    QSet<QString> values;
+};
+
+} // namespace
+
 DatabaseManager* DatabaseManager::instance()
 {
     if (!m_instance) {
@@ -310,15 +332,16 @@ QList<QVariantMap> DatabaseManager::getHouses(int limit, int offset)
     query.addBindValue(offset);
     
     if (query.exec()) {
+        ResultDictionary dictionary;
         while (query.next()) {
             QVariantMap house;
             house["ID"] = query.value("ID");
             house["houseTitle"] = query.value("houseTitle");
             house["price"] = query.value("price");
             house["area"] = query.value("area");
-            house["communityName"] = query.value("communityName");
-            house["floor"] = query.value("floor");
-            house["houseType"] = query.value("houseType");
+            house["communityName"] = dictionary.intern(query.value("communityName"));
+            house["floor"] = dictionary.intern(query.value("floor"));
+            house["houseType"] = dictionary.intern(query.value("houseType"));
             house["unitPrice"] = query.value("unitPrice");
             house["houseUrl"] = query.value("houseUrl");
             houses.append(house);
@@ -360,15 +383,16 @@ QList<QVariantMap> DatabaseManager::searchHouses(const QVariantMap& filters)
     
     QSqlQuery query(db);
     if (query.exec(sql)) {
+        ResultDictionary dictionary;
         while (query.next()) {
             QVariantMap house;
             house["ID"] = query.value("ID");
             house["houseTitle"] = query.value("houseTitle");
             house["price"] = query.value("price");
             house["area"] = query.value("area");
-            house["communityName"] = query.value("communityName");
-            house["floor"] = query.value("floor");
-            house["houseType"] = query.value("houseType");
+            house["communityName"] = dictionary.intern(query.value("communityName"));
+            house["floor"] = dictionary.intern(query.value("floor"));
+            house["houseType"] = dictionary.intern(query.value("houseType"));
             house["unitPrice"] = query.value("unitPrice");
             house["houseUrl"] = query.value("houseUrl");
             houses.append(house);
@@ -473,15 +497,16 @@ QList<QVariantMap> DatabaseManager::getUserFavorites(int userId)
     query.addBindValue(userId);
     
     if (query.exec()) {
+        ResultDictionary dictionary;
         while (query.next()) {
             QVariantMap house;
             house["ID"] = query.value("ID");
             house["houseTitle"] = query.value("houseTitle");
             house["price"] = query.value("price");
             house["area"] = query.value("area");
-            house["communityName"] = query.value("communityName");
-            house["floor"] = query.value("floor");
-            house["houseType"] = query.value("houseType");
+            house["communityName"] = dictionary.intern(query.value("communityName"));
+            house["floor"] = dictionary.intern(query.value("floor"));
+            house["houseType"] = dictionary.intern(query.value("houseType"));
             house["unitPrice"] = query.value("unitPrice");
             house["houseUrl"] = query.value("houseUrl");
             favorites.append(house);
@@ -612,12 +637,13 @@ QList<QVariantMap> DatabaseManager::getPopularHouses(int limit)
     qDebug() << "Executing popular houses query with limit:" << limit;
     
     if (query.exec()) {
+        ResultDictionary dictionary;
         while (query.next()) {
             QVariantMap house;
             house["ID"] = query.value("ID");
             house["houseTitle"] = query.value("houseTitle");
-            house["communityName"] = query.value("communityName");
-            house["houseType"] = query.value("houseType");
+            house["communityName"] = dictionary.intern(query.value("communityName"));
+            house["houseType"] = dictionary.intern(query.value("houseType"));
             house["area"] = query.value("area");
             house["price"] = query.value("price");
             house["favorite_count"] = query.value("favorite_count");
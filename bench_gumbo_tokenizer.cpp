@@ -0,0 +1,161 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include "gumbo.h"
+#include "char_scan.h"
+
+// Gumbo 分词器微基准：同一份页面分别在关闭快速路径、标量扫描、SSE2、AVX2 下反复解析，
+// 对比 MB/秒，并核对各模式解析出的节点数与文本完全一致（快速路径不能改变解析结果）；
+// 另外单独测各模式下整页 UTF-8 预校验的速度
+// 用法：TokenizerBench [页面.html ...] [迭代次数]
+// 不传页面时使用 fixtures/ 下的全部样例页面；也可以传入实际爬取时保存的页面
+
+struct TreeDigest {
+    int nodes = 0;
+    qint64 textBytes = 0;
+    size_t textHash = 0;
+
+    bool operator==(const TreeDigest& other) const
+    {
+        return nodes == other.nodes && textBytes == other.textBytes && textHash == other.textHash;
+    }
+};
+
+static void digestNode(const GumboNode* node, TreeDigest& digest)
+{
+    ++digest.nodes;
+    const GumboVector* children = nullptr;
+    if (node->type == GUMBO_NODE_DOCUMENT) {
+        children = &node->v.document.children;
+    } else if (node->type == GUMBO_NODE_ELEMENT || node->type == GUMBO_NODE_TEMPLATE) {
+        children = &node->v.element.children;
+        for (unsigned int i = 0; i < node->v.element.attributes.length; ++i) {
+            const GumboAttribute* attr = static_cast<const GumboAttribute*>(node->v.element.attributes.data[i]);
+            const QByteArray value(attr->value);
+            digest.textBytes += value.size();
+            digest.textHash = qHash(value, digest.textHash);
+        }
+    } else {
+        const QByteArray text(node->v.text.text);
+        digest.textBytes += text.size();
+        digest.textHash = qHash(text, digest.textHash);
+    }
+    if (children == nullptr) return;
+    for (unsigned int i = 0; i < children->length; ++i) {
+        digestNode(static_cast<const GumboNode*>(children->data[i]), digest);
+    }
+}
+
+static TreeDigest parseDigest(const QByteArray& html)
+{
+    GumboOutput* output = gumbo_parse_with_options(&kGumboDefaultOptions, html.constData(), html.size());
+    TreeDigest digest;
+    digestNode(output->document, digest);
+    gumbo_destroy_output(&kGumboDefaultOptions, output);
+    return digest;
+}
+
+static double megabytesPerSecond(const QByteArray& html, int iterations)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        GumboOutput* output = gumbo_parse_with_options(&kGumboDefaultOptions, html.constData(), html.size());
+        gumbo_destroy_output(&kGumboDefaultOptions, output);
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    return ns > 0 ? html.size() * double(iterations) * 1e3 / ns : 0.0;
+}
+
+// 整页 UTF-8 预校验（解析前一次性完成）的吞吐；validBytes 为通过校验的前缀长度
+static double validateMegabytesPerSecond(const QByteArray& html, int iterations, qint64& validBytes)
+{
+    const char* begin = html.constData();
+    const char* end = begin + html.size();
+    validBytes = gumbo_scan_valid_utf8(begin, end) - begin;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        validBytes = gumbo_scan_valid_utf8(begin, end) - begin;
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    return ns > 0 ? html.size() * double(iterations) * 1e3 / ns : 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QStringList pages;
+    int iterations = 20;
+    for (int i = 1; i < argc; ++i) {
+        bool isNumber = false;
+        const int n = QString(argv[i]).toInt(&isNumber);
+        if (isNumber) {
+            iterations = qMax(1, n);
+        } else {
+            pages << QString(argv[i]);
+        }
+    }
+    if (pages.isEmpty()) {
+        const QDir fixtureDir(QFileInfo(QString(__FILE__)).absolutePath() + "/fixtures/");
+        for (const QString& name : fixtureDir.entryList({"*.html"}, QDir::Files, QDir::Name)) {
+            pages << fixtureDir.filePath(name);
+        }
+    }
+
+    const GumboScanMode modes[] = {GUMBO_SCAN_OFF, GUMBO_SCAN_SCALAR, GUMBO_SCAN_SSE2, GUMBO_SCAN_AVX2};
+    gumbo_scan_set_mode(GUMBO_SCAN_AUTO);
+    qDebug().noquote() << QString("=== Gumbo 分词器基准测试（迭代 %1 次，自动选择：%2）===")
+                              .arg(iterations).arg(gumbo_scan_mode_name(gumbo_scan_get_mode()));
+
+    bool allMatch = true;
+    for (const QString& path : pages) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "无法读取页面：" << path;
+            continue;
+        }
+        const QByteArray html = file.readAll();
+        qDebug().noquote() << QString("[%1] 页面大小 %2 KB").arg(QFileInfo(path).fileName()).arg(html.size() / 1024);
+
+        gumbo_scan_set_mode(GUMBO_SCAN_OFF);
+        const TreeDigest reference = parseDigest(html);
+        double baseline = 0;
+        for (GumboScanMode mode : modes) {
+            if (!gumbo_scan_mode_supported(mode)) {
+                qDebug().noquote() << QString("  %1：当前CPU不支持，跳过").arg(gumbo_scan_mode_name(mode));
+                continue;
+            }
+            gumbo_scan_set_mode(mode);
+            const TreeDigest digest = parseDigest(html);  // 预热一次，同时核对解析结果
+            const double mbps = megabytesPerSecond(html, iterations);
+            if (mode == GUMBO_SCAN_OFF) baseline = mbps;
+            qDebug().noquote() << QString("  %1：%2 MB/秒（%3x），节点 %4 个")
+                                      .arg(gumbo_scan_mode_name(mode), -6)
+                                      .arg(mbps, 0, 'f', 1)
+                                      .arg(baseline > 0 ? mbps / baseline : 0.0, 0, 'f', 2)
+                                      .arg(digest.nodes);
+            if (mode != GUMBO_SCAN_OFF) {
+                qint64 validBytes = 0;
+                const double validateMbps = validateMegabytesPerSecond(html, iterations * 10, validBytes);
+                qDebug().noquote() << QString("          UTF-8 预校验 %1 MB/秒%2")
+                                          .arg(validateMbps, 0, 'f', 0)
+                                          .arg(validBytes < html.size()
+                                                   ? QString("（第 %1 字节起不是合法UTF-8，之后逐字符解码）").arg(validBytes)
+                                                   : QString());
+            }
+            if (!(digest == reference)) {
+                allMatch = false;
+                qDebug().noquote() << "  ⚠️ 解析结果与关闭快速路径时不一致";
+            }
+        }
+    }
+    gumbo_scan_set_mode(GUMBO_SCAN_AUTO);
+
+    qDebug() << "=== 基准测试完成 ===";
+    return allMatch ? 0 : 1;
+}
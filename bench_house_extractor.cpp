@@ -0,0 +1,188 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include "HouseExtractor.h"
+#include "PatternRegistry.h"
+#include "SiteRules.h"
+#include "GumboArena.h"
+#include "CompactDom.h"
+
+// 房源提取基准测试：同一份页面分别走旧正则路径和Gumbo DOM路径，对比 页/秒；
+// 安居客页面另外用规则文件 rules/anjuke.json 提取一次，对比规则引擎与手写DOM代码；
+// DOM路径再关掉解析内存池（GumboArena）跑一遍，对比逐节点 malloc/free 的开销；
+// 安居客页面另外只做解析，对比整页建树与只建 div.property 子树（GumboSubtreeFilter）的 页/秒 和每页内存，
+// 并统计规则引擎用的 CompactDom 的建立耗时与占用
+// 用法：ExtractBench [安居客页面.html] [阿里页面.html] [迭代次数]
+// 不传参数时使用 fixtures/ 下的样例页面；也可以传入实际爬取时保存的页面
+
+static QString readFixture(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法读取样例页面：" << path;
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+template <typename Func>
+static double pagesPerSecond(const QString& html, int iterations, Func extract, int& listingCount)
+{
+    listingCount = extract(html).size(); // 预热一次，同时记录房源数
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        extract(html);
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    return ns > 0 ? iterations * 1e9 / ns : 0.0;
+}
+
+static void report(const QString& name, const QString& html, double regexPps, int regexCount,
+                   double domPps, int domCount)
+{
+    qDebug().noquote() << QString("[%1] 页面大小 %2 KB").arg(name).arg(html.toUtf8().size() / 1024);
+    qDebug().noquote() << QString("  正则路径：%1 页/秒，房源 %2 条").arg(regexPps, 0, 'f', 1).arg(regexCount);
+    qDebug().noquote() << QString("  DOM 路径：%1 页/秒，房源 %2 条").arg(domPps, 0, 'f', 1).arg(domCount);
+    if (regexPps > 0) {
+        qDebug().noquote() << QString("  加速比：%1x").arg(domPps / regexPps, 0, 'f', 2);
+    }
+    if (regexCount != domCount) {
+        qDebug().noquote() << "  ⚠️ 两条路径识别的房源数不一致，请检查样例页面结构";
+    }
+}
+
+// 关闭解析内存池重跑DOM路径（Gumbo默认的 malloc/free），与内存池下的结果对比
+template <typename Func>
+static void reportMalloc(const QString& html, int iterations, double arenaPps, Func extract)
+{
+    int count = 0;
+    GumboArena::setEnabled(false);
+    const double mallocPps = pagesPerSecond(html, iterations, extract, count);
+    GumboArena::setEnabled(true);
+    qDebug().noquote() << QString("  DOM 路径（malloc）：%1 页/秒；解析内存池加速 %2x")
+                              .arg(mallocPps, 0, 'f', 1)
+                              .arg(mallocPps > 0 ? arenaPps / mallocPps : 0.0, 0, 'f', 2);
+}
+
+// 只解析不提取：scope 为空时整页建树；每页内存取解析内存池的平均用量
+static void reportScope(const QByteArray& utf8, int iterations)
+{
+    static const GumboSubtreeFilter listingScope = {GUMBO_TAG_DIV, "property", nullptr, false};
+    for (const GumboSubtreeFilter* scope : {static_cast<const GumboSubtreeFilter*>(nullptr), &listingScope}) {
+        const GumboArena::Stats before = GumboArena::stats();
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            GumboArena::Document doc(utf8.constData(), utf8.size(), scope);
+        }
+        const qint64 ns = timer.nsecsElapsed();
+        const GumboArena::Stats after = GumboArena::stats();
+        const qint64 pages = static_cast<qint64>(after.pages - before.pages);
+        qDebug().noquote() << QString("  仅解析（%1）：%2 页/秒，每页 %3 KB")
+                                  .arg(scope ? "只建 div.property 子树" : "整页")
+                                  .arg(ns > 0 ? iterations * 1e9 / ns : 0.0, 0, 'f', 1)
+                                  .arg(pages > 0 ? (after.totalBytes - before.totalBytes) / pages / 1024 : 0);
+    }
+}
+
+// Gumbo 树转 CompactDom：每页建立耗时（不含解析）、节点数和占用，与解析内存池的每页用量对比
+static void reportCompact(const QByteArray& utf8, int iterations)
+{
+    const GumboArena::Stats before = GumboArena::stats();
+    qint64 buildNs = 0;
+    CompactDom dom;
+    for (int i = 0; i < iterations; ++i) {
+        GumboArena::Document doc(utf8.constData(), utf8.size());
+        QElapsedTimer timer;
+        timer.start();
+        dom.build(doc.output(), utf8.constData(), static_cast<size_t>(utf8.size()));
+        buildNs += timer.nsecsElapsed();
+    }
+    const GumboArena::Stats after = GumboArena::stats();
+    const qint64 pages = static_cast<qint64>(after.pages - before.pages);
+    qDebug().noquote() << QString("  CompactDom：建立 %1 ms/页，%2 个节点，%3 KB（Gumbo 树 %4 KB）")
+                              .arg(iterations > 0 ? buildNs / 1e6 / iterations : 0.0, 0, 'f', 3)
+                              .arg(dom.size())
+                              .arg(dom.byteSize() / 1024)
+                              .arg(pages > 0 ? (after.totalBytes - before.totalBytes) / pages / 1024 : 0);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const QString fixtureDir = QFileInfo(QString(__FILE__)).absolutePath() + "/fixtures/";
+    const QString rulesDir = QFileInfo(QString(__FILE__)).absolutePath() + "/rules/";
+    const QString anjukePath = argc > 1 ? QString(argv[1]) : fixtureDir + "anjuke_sale_page.html";
+    const QString aliPath = argc > 2 ? QString(argv[2]) : fixtureDir + "ali_auction_page.html";
+    const int iterations = argc > 3 ? qMax(1, QString(argv[3]).toInt()) : 20;
+
+    qDebug() << "=== 房源提取基准测试（迭代" << iterations << "次）===";
+
+    const QString anjukeHtml = readFixture(anjukePath);
+    if (!anjukeHtml.isEmpty()) {
+        int regexCount = 0, domCount = 0;
+        double regexPps = pagesPerSecond(anjukeHtml, iterations, [](const QString& html) {
+            return HouseExtractor::extractAnjukeRegex(html, "北京");
+        }, regexCount);
+        double domPps = pagesPerSecond(anjukeHtml, iterations, [](const QString& html) {
+            return HouseExtractor::extractAnjuke(html, "北京");
+        }, domCount);
+        report("安居客", anjukeHtml, regexPps, regexCount, domPps, domCount);
+        reportMalloc(anjukeHtml, iterations, domPps, [](const QString& html) {
+            return HouseExtractor::extractAnjuke(html, "北京");
+        });
+        reportScope(anjukeHtml.toUtf8(), iterations);
+        reportCompact(anjukeHtml.toUtf8(), iterations);
+
+        SiteRules rules;
+        QString error;
+        if (rules.load(rulesDir + "anjuke.json", &error)) {
+            int ruleCount = 0;
+            double rulePps = pagesPerSecond(anjukeHtml, iterations, [&rules](const QString& html) {
+                return rules.extract(html, "北京");
+            }, ruleCount);
+            qDebug().noquote() << QString("  规则文件：%1 页/秒，房源 %2 条（相对DOM路径 %3x）")
+                                      .arg(rulePps, 0, 'f', 1).arg(ruleCount)
+                                      .arg(domPps > 0 ? rulePps / domPps : 0.0, 0, 'f', 2);
+            if (ruleCount != domCount) {
+                qDebug().noquote() << "  ⚠️ 规则文件与DOM路径识别的房源数不一致";
+            }
+        } else {
+            qDebug().noquote() << "  规则文件加载失败：" << error;
+        }
+    }
+
+    const QString aliHtml = readFixture(aliPath);
+    if (!aliHtml.isEmpty()) {
+        int regexCount = 0, domCount = 0;
+        double regexPps = pagesPerSecond(aliHtml, iterations, [](const QString& html) {
+            return HouseExtractor::extractAliRegex(html, "北京");
+        }, regexCount);
+        double domPps = pagesPerSecond(aliHtml, iterations, [](const QString& html) {
+            return HouseExtractor::extractAli(html, "北京");
+        }, domCount);
+        report("阿里拍卖", aliHtml, regexPps, regexCount, domPps, domCount);
+        reportMalloc(aliHtml, iterations, domPps, [](const QString& html) {
+            return HouseExtractor::extractAli(html, "北京");
+        });
+    }
+
+    // 各规则的命中/未命中与累计耗时（含预热，正则路径与DOM路径的字段后处理规则都在内）
+    for (const PatternRegistry::Stats& s : PatternRegistry::shared().stats()) {
+        qDebug().noquote() << QString("  %1/%2：命中 %3，未命中 %4，%5 ms")
+                                  .arg(s.site, s.name).arg(s.hits).arg(s.misses)
+                                  .arg(s.nanos / 1e6, 0, 'f', 2);
+    }
+
+    const QString arenaSummary = GumboArena::summary();
+    if (!arenaSummary.isEmpty()) {
+        qDebug().noquote() << " " << arenaSummary;
+    }
+
+    qDebug() << "=== 基准测试完成 ===";
+    return 0;
+}
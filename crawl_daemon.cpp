@@ -0,0 +1,270 @@
+// 无界面爬虫进程：按任务文件依次执行房源爬取，写入与桌面程序相同的数据库/去重库/爬取队列
+//
+// 用法：CrawlDaemon <job.json> [--workdir 目录] [--timeout-min 分钟] [--record 归档文件]
+//       CrawlDaemon --replay 归档文件 [--workdir 目录]
+//   --workdir     工作目录（Cookie文件、frontier/、dedup/ 均相对于此目录），同一台机器跑多个进程时各用一个；
+//                 各进程的去重库互不相通，同一房源被多个进程收录时由 houseinfo.houseUrl 的唯一键合并成一条
+//   --timeout-min 整体超时，覆盖任务文件中的 timeoutMinutes
+//   --record      把抓到的房源页追加到归档文件（PageArchive），供离线回放
+//   --replay      不联网，把归档中的页面送入提取与入库流程，输出吞吐量后退出（不需要任务文件）
+//
+// 任务文件示例见 crawl_job.example.json：
+//   { "timeoutMinutes": 60, "extractMode": "json",
+//     "jobs": [ { "site": "anjuke", "targets": ["北京-朝阳区", "上海"], "pages": 2 },
+//               { "site": "ali",    "targets": "杭州", "pages": 1 } ] }
+//
+// 日志：每行一个JSON对象输出到stdout（ts/level/event/site/job/msg），便于日志系统采集
+// 退出码：0 全部完成；1 参数或任务文件错误；2 有任务未完成（风控/加载失败，进度已保存，重跑即续爬）；3 超时
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include "Crawl.h"
+#include "AliCrawl.h"
+#include "CrawlScheduler.h"
+#include "PageArchive.h"
+
+namespace {
+
+enum ExitCode {
+    ExitOk = 0,
+    ExitBadJob = 1,
+    ExitIncomplete = 2,
+    ExitTimeout = 3
+};
+
+struct DaemonJob {
+    QString site;
+    QStringList targets;
+    int pages = 1;
+};
+
+void logJson(const QString& level, const QString& event, QJsonObject fields = QJsonObject())
+{
+    fields.insert("ts", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs));
+    fields.insert("level", level);
+    fields.insert("event", event);
+    const QByteArray line = QJsonDocument(fields).toJson(QJsonDocument::Compact) + '\n';
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+    std::fflush(stdout);
+}
+
+// 爬虫日志以表情符号标注级别，这里映射成结构化日志的level
+QString levelOf(const QString& message)
+{
+    const QString text = message.trimmed();
+    if (text.startsWith("❌")) return "error";
+    if (text.startsWith("⚠") || text.startsWith("⏰") || text.startsWith("⏳")) return "warn";
+    return "info";
+}
+
+bool loadJobs(const QString& path, QList<DaemonJob>& jobs, int& timeoutMinutes, ExtractMode& mode, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "无法打开任务文件：" + path;
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        error = "任务文件不是合法的JSON对象：" + parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    timeoutMinutes = root.value("timeoutMinutes").toInt(timeoutMinutes);
+    mode = root.value("extractMode").toString("json") == "html" ? ExtractMode::Html : ExtractMode::InPageJson;
+
+    const QJsonArray list = root.value("jobs").toArray();
+    for (int i = 0; i < list.size(); ++i) {
+        const QJsonObject item = list.at(i).toObject();
+        DaemonJob job;
+        job.site = item.value("site").toString();
+        if (job.site != Crawl::SITE_KEY && job.site != AliCrawl::SITE_KEY) {
+            error = QString("第%1个任务的site无效：%2（可选 %3 / %4）").arg(i + 1).arg(job.site, Crawl::SITE_KEY, AliCrawl::SITE_KEY);
+            return false;
+        }
+        const QJsonValue targets = item.value("targets");
+        if (targets.isArray()) {
+            for (const QJsonValue& target : targets.toArray()) {
+                if (!target.toString().trimmed().isEmpty()) job.targets.append(target.toString().trimmed());
+            }
+        } else if (!targets.toString().trimmed().isEmpty()) {
+            job.targets.append(targets.toString().trimmed());
+        }
+        if (job.targets.isEmpty()) {
+            error = QString("第%1个任务没有targets").arg(i + 1);
+            return false;
+        }
+        job.pages = item.value("pages").toInt(1);
+        jobs.append(job);
+    }
+    if (jobs.isEmpty()) {
+        error = "任务文件中没有jobs";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 离屏渲染：没有显示器/窗口系统的服务器上也能运行 QtWebEngine
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CrawlDaemon");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面房源爬虫进程");
+    parser.addHelpOption();
+    parser.addPositionalArgument("job", "任务文件（JSON）");
+    QCommandLineOption workdirOption("workdir", "工作目录（Cookie、frontier/、dedup/ 所在目录）", "dir");
+    QCommandLineOption timeoutOption("timeout-min", "整体超时（分钟）", "minutes");
+    QCommandLineOption recordOption("record", "录制抓到的房源页到归档文件", "file");
+    QCommandLineOption replayOption("replay", "回放归档文件（离线提取/基准测试）", "file");
+    parser.addOption(workdirOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.process(app);
+
+    const bool replayMode = parser.isSet(replayOption);
+    if ((replayMode && !parser.positionalArguments().isEmpty())
+        || (!replayMode && parser.positionalArguments().size() != 1)) {
+        logJson("error", "bad_args", {{"msg", "用法：CrawlDaemon <job.json> [--workdir 目录] [--timeout-min 分钟] [--record 归档] 或 CrawlDaemon --replay 归档"}});
+        return ExitBadJob;
+    }
+    // 归档路径按启动时的目录解析（之后可能切换到 --workdir）
+    const QString recordPath = parser.isSet(recordOption) ? QFileInfo(parser.value(recordOption)).absoluteFilePath() : QString();
+    const QString replayPath = replayMode ? QFileInfo(parser.value(replayOption)).absoluteFilePath() : QString();
+
+    QList<DaemonJob> jobs;
+    int timeoutMinutes = 60;
+    ExtractMode mode = ExtractMode::InPageJson;
+    QString error;
+    const QString jobPath = replayMode ? QString() : QFileInfo(parser.positionalArguments().first()).absoluteFilePath();
+    if (!replayMode && !loadJobs(jobPath, jobs, timeoutMinutes, mode, error)) {
+        logJson("error", "bad_job_file", {{"msg", error}, {"file", jobPath}});
+        return ExitBadJob;
+    }
+    if (parser.isSet(timeoutOption)) {
+        timeoutMinutes = parser.value(timeoutOption).toInt();
+    }
+
+    // 爬虫在构造时打开 frontier/ 与 Cookie 文件，必须先切换工作目录
+    if (parser.isSet(workdirOption)) {
+        const QString workdir = parser.value(workdirOption);
+        if (!QDir().mkpath(workdir) || !QDir::setCurrent(workdir)) {
+            logJson("error", "bad_workdir", {{"msg", "无法进入工作目录：" + workdir}});
+            return ExitBadJob;
+        }
+    }
+
+    CrawlScheduler scheduler;
+    Crawl anjuke;
+    AliCrawl ali;
+    anjuke.setScheduler(&scheduler);
+    ali.setScheduler(&scheduler);
+    anjuke.setExtractMode(mode);
+    ali.setExtractMode(mode);
+
+    int currentJob = -1;
+    auto forward = [&currentJob](const QString& site) {
+        return [&currentJob, site](const QString& message) {
+            logJson(levelOf(message), "log", {{"site", site}, {"job", currentJob}, {"msg", message.trimmed()}});
+        };
+    };
+    QObject::connect(&scheduler, &CrawlScheduler::appendLogSignal, forward("scheduler"));
+    QObject::connect(&anjuke, &Crawl::appendLogSignal, forward(Crawl::SITE_KEY));
+    QObject::connect(&ali, &AliCrawl::appendLogSignal, forward(AliCrawl::SITE_KEY));
+
+    if (replayMode) {
+        PageArchive archive;
+        if (!archive.open(replayPath, PageArchive::Mode::Read)) {
+            logJson("error", "bad_archive", {{"msg", "无法打开归档：" + replayPath}});
+            return ExitBadJob;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        const int anjukePages = anjuke.replayArchive(archive);
+        const int aliPages = ali.replayArchive(archive);
+        logJson("info", "replay_finished", {{"archive", replayPath}, {"records", archive.size()},
+                                            {"anjukePages", anjukePages}, {"aliPages", aliPages},
+                                            {"elapsedMs", static_cast<double>(timer.elapsed())}});
+        return ExitOk;
+    }
+
+    PageArchive recordArchive;
+    if (!recordPath.isEmpty()) {
+        if (!recordArchive.open(recordPath, PageArchive::Mode::Append)) {
+            logJson("error", "bad_archive", {{"msg", "无法打开归档：" + recordPath}});
+            return ExitBadJob;
+        }
+        anjuke.setArchive(&recordArchive);
+        ali.setArchive(&recordArchive);
+    }
+
+    bool allCompleted = true;
+    std::function<void()> runNext = [&]() {
+        currentJob++;
+        if (currentJob >= jobs.size()) {
+            logJson(allCompleted ? "info" : "warn", "daemon_finished", {{"jobs", static_cast<int>(jobs.size())}, {"completed", allCompleted}});
+            app.exit(allCompleted ? ExitOk : ExitIncomplete);
+            return;
+        }
+        const DaemonJob& job = jobs.at(currentJob);
+        logJson("info", "job_started", {{"site", job.site}, {"job", currentJob},
+                                        {"targets", QJsonArray::fromStringList(job.targets)}, {"pages", job.pages}});
+        const QString targets = job.targets.join(",");
+        if (job.site == Crawl::SITE_KEY) {
+            anjuke.startHouseCrawl(targets, job.pages);
+        } else {
+            ali.startHouseCrawl(targets, job.pages);
+        }
+    };
+
+    auto onFinished = [&](const QString& site) {
+        return [&, site](int houseCount, bool completed) {
+            if (currentJob < 0 || currentJob >= jobs.size() || jobs.at(currentJob).site != site) return;
+            allCompleted = allCompleted && completed;
+            logJson(completed ? "info" : "warn", "job_finished",
+                    {{"site", site}, {"job", currentJob}, {"houses", houseCount}, {"completed", completed}});
+            // 下一个任务放到下一轮事件循环，避免在爬虫信号里重入 startHouseCrawl
+            QTimer::singleShot(0, &app, runNext);
+        };
+    };
+    QObject::connect(&anjuke, &Crawl::crawlFinished, onFinished(Crawl::SITE_KEY));
+    QObject::connect(&ali, &AliCrawl::crawlFinished, onFinished(AliCrawl::SITE_KEY));
+
+    if (timeoutMinutes > 0) {
+        // 定时器以int毫秒计时：超过上限（约24.8天）时按上限
+        const qint64 timeoutMs = qMin<qint64>(static_cast<qint64>(timeoutMinutes) * 60 * 1000,
+                                              std::numeric_limits<int>::max());
+        QTimer::singleShot(static_cast<int>(timeoutMs), &app, [&]() {
+            logJson("error", "timeout", {{"job", currentJob}, {"minutes", timeoutMinutes},
+                                         {"msg", "整体超时，已完成的房源页进度已保存，重跑将从中断处继续"}});
+            app.exit(ExitTimeout);
+        });
+    }
+
+    logJson("info", "daemon_started", {{"jobFile", jobPath}, {"jobs", static_cast<int>(jobs.size())},
+                                       {"workdir", QDir::currentPath()}, {"timeoutMinutes", timeoutMinutes}});
+    QTimer::singleShot(0, &app, runNext);
+    return app.exec();
+}
@@ -0,0 +1,711 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "char_scan.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GUMBO_SCAN_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// SSSE3 and AVX2 are compiled with per-function target attributes on
+// GCC/Clang, so the rest of the library does not need -mssse3/-mavx2; MSVC
+// accepts the intrinsics as is.
+#if defined(GUMBO_SCAN_HAVE_SSE2) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define GUMBO_SCAN_HAVE_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GUMBO_SCAN_SSSE3_TARGET
+#define GUMBO_SCAN_AVX2_TARGET
+#else
+#define GUMBO_SCAN_SSSE3_TARGET __attribute__((target("ssse3")))
+#define GUMBO_SCAN_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+typedef size_t (*ScanFunction)(const char*, const char*, char, char);
+typedef const char* (*ValidateFunction)(const char*, const char*);
+typedef void (*LinesFunction)(const char*, const char*, GumboScanLines*);
+
+static bool is_continuation(unsigned char b) { return (b & 0xC0) == 0x80; }
+
+// Plain text: printable ASCII plus tab and newline, minus the stop characters.
+static bool plain_stop(unsigned char b, char stop1, char stop2) {
+  return (b < 0x20 && b != '\t' && b != '\n') || b >= 0x7F ||
+         b == (unsigned char) stop1 || b == (unsigned char) stop2;
+}
+
+// Multi-byte characters that end a text run: U+0080-U+009F (C2 80-9F),
+// U+FDD0-U+FDEF and the rest of the EF B7 block, U+FFFE/U+FFFF (EF BF BE-BF),
+// and any four-byte character whose third byte is BF, which covers the
+// U+xFFFE/U+xFFFF noncharacters of the other planes.
+static bool text_stop(const unsigned char* c, char stop1, char stop2) {
+  unsigned char b = c[0];
+  if (b < 0x80) {
+    return plain_stop(b, stop1, stop2);
+  } else if (b == 0xC2) {
+    return c[1] <= 0x9F;
+  } else if (b == 0xEF) {
+    return c[1] == 0xB7 || (c[1] == 0xBF && c[2] >= 0xBE);
+  } else if (b >= 0xF0) {
+    return c[2] == 0xBF;
+  }
+  return false;
+}
+
+static size_t scan_plain_scalar(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const char* c = begin;
+  while (c < end && !plain_stop((unsigned char) *c, stop1, stop2)) {
+    ++c;
+  }
+  return c - begin;
+}
+
+static size_t scan_text_scalar(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const char* c = begin;
+  while (c < end && !text_stop((const unsigned char*) c, stop1, stop2)) {
+    ++c;
+  }
+  return c - begin;
+}
+
+#ifdef GUMBO_SCAN_HAVE_SSE2
+// Returns the start of the last character that begins before c if it is a
+// multi-byte one (it may run past c), and c otherwise.
+static const char* char_boundary_before(const char* begin, const char* c) {
+  const char* p = c;
+  while (p > begin && c - p < 3 && is_continuation((unsigned char) p[-1])) {
+    --p;
+  }
+  if (p > begin && (unsigned char) p[-1] >= 0xC0) {
+    --p;
+  }
+  return p;
+}
+#endif  // GUMBO_SCAN_HAVE_SSE2
+
+static const char* valid_utf8_scalar(const char* begin, const char* end) {
+  const unsigned char* c = (const unsigned char*) begin;
+  const unsigned char* e = (const unsigned char*) end;
+  while (c < e) {
+    uint64_t word;
+    if (e - c >= 8) {
+      memcpy(&word, c, sizeof(word));
+      if (!(word & 0x8080808080808080ull)) {
+        c += 8;
+        continue;
+      }
+    }
+    unsigned char b = *c;
+    if (b < 0x80) {
+      ++c;
+      continue;
+    }
+    // Second-byte ranges from RFC 3629, section 4.
+    int width;
+    unsigned char low = 0x80, high = 0xBF;
+    if (b >= 0xC2 && b <= 0xDF) {
+      width = 2;
+    } else if (b >= 0xE0 && b <= 0xEF) {
+      width = 3;
+      low = b == 0xE0 ? 0xA0 : 0x80;
+      high = b == 0xED ? 0x9F : 0xBF;
+    } else if (b >= 0xF0 && b <= 0xF4) {
+      width = 4;
+      low = b == 0xF0 ? 0x90 : 0x80;
+      high = b == 0xF4 ? 0x8F : 0xBF;
+    } else {
+      break;
+    }
+    if (e - c < width || c[1] < low || c[1] > high ||
+        (width > 2 && !is_continuation(c[2])) ||
+        (width > 3 && !is_continuation(c[3]))) {
+      break;
+    }
+    c += width;
+  }
+  return (const char*) c;
+}
+
+static void lines_scalar(
+    const char* begin, const char* end, GumboScanLines* output) {
+  for (const char* c = begin; c < end; ++c) {
+    unsigned char b = (unsigned char) *c;
+    if (b == '\n') {
+      ++output->newlines;
+      output->line_start = c + 1;
+      output->line_chars = 0;
+      output->has_tab = false;
+    } else {
+      output->has_tab = output->has_tab || b == '\t';
+      output->line_chars += !is_continuation(b);
+    }
+  }
+}
+
+static void lines_init(const char* begin, GumboScanLines* output) {
+  output->newlines = 0;
+  output->line_start = begin;
+  output->line_chars = 0;
+  output->has_tab = false;
+}
+
+#ifdef GUMBO_SCAN_HAVE_SSE2
+
+static unsigned int lowest_bit(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return (unsigned int) index;
+#else
+  return (unsigned int) __builtin_ctz(mask);
+#endif
+}
+
+static unsigned int highest_bit(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanReverse(&index, mask);
+  return (unsigned int) index;
+#else
+  return 31 - (unsigned int) __builtin_clz(mask);
+#endif
+}
+
+static unsigned int count_bits(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  mask = mask - ((mask >> 1) & 0x55555555u);
+  mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+  return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#else
+  return (unsigned int) __builtin_popcount(mask);
+#endif
+}
+
+// Folds one block's newline, tab and continuation-byte masks into the line
+// counts; width is the block size in bytes.
+static void lines_block(const char* block, unsigned int width,
+    unsigned int newlines, unsigned int tabs, unsigned int continuations,
+    GumboScanLines* output) {
+  if (!newlines) {
+    output->line_chars += width - count_bits(continuations);
+    output->has_tab = output->has_tab || tabs != 0;
+    return;
+  }
+  unsigned int last = highest_bit(newlines);
+  unsigned int after = last + 1 < 32 ? ~0u << (last + 1) : 0;
+  output->newlines += count_bits(newlines);
+  output->line_start = block + last + 1;
+  output->line_chars = (width - 1 - last) - count_bits(continuations & after);
+  output->has_tab = (tabs & after) != 0;
+}
+
+// Bytes <= 0x1F other than tab and newline, DEL and the two stop characters.
+static __m128i plain_stop_sse2(__m128i v, __m128i s1, __m128i s2) {
+  const __m128i allowed = _mm_or_si128(
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+  const __m128i control =
+      _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+  __m128i stop = _mm_andnot_si128(allowed, control);
+  stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+  stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, s1));
+  return _mm_or_si128(stop, _mm_cmpeq_epi8(v, s2));
+}
+
+static size_t scan_plain_sse2(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const __m128i s1 = _mm_set1_epi8(stop1);
+  const __m128i s2 = _mm_set1_epi8(stop2);
+  const char* c = begin;
+  for (; end - c >= 16; c += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) c);
+    // Every byte >= 0x80 ends a plain run as well.
+    __m128i stop = _mm_or_si128(plain_stop_sse2(v, s1, s2),
+        _mm_cmplt_epi8(v, _mm_setzero_si128()));
+    unsigned int mask = (unsigned int) _mm_movemask_epi8(stop);
+    if (mask) {
+      return (c - begin) + lowest_bit(mask);
+    }
+  }
+  return (c - begin) + scan_plain_scalar(c, end, stop1, stop2);
+}
+
+// The block also reads the two bytes after it (the rest of a character that
+// starts in it), so it needs 18 bytes.
+static size_t scan_text_sse2(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const __m128i s1 = _mm_set1_epi8(stop1);
+  const __m128i s2 = _mm_set1_epi8(stop2);
+  const char* c = begin;
+  for (; end - c >= 18; c += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) c);
+    __m128i v1 = _mm_loadu_si128((const __m128i*) (c + 1));
+    __m128i v2 = _mm_loadu_si128((const __m128i*) (c + 2));
+    __m128i stop = plain_stop_sse2(v, s1, s2);
+    __m128i c1 = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char) 0xC2)),
+        _mm_cmpeq_epi8(_mm_min_epu8(v1, _mm_set1_epi8((char) 0x9F)), v1));
+    __m128i noncharacter = _mm_and_si128(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8((char) 0xEF)),
+        _mm_or_si128(_mm_cmpeq_epi8(v1, _mm_set1_epi8((char) 0xB7)),
+            _mm_and_si128(_mm_cmpeq_epi8(v1, _mm_set1_epi8((char) 0xBF)),
+                _mm_cmpeq_epi8(
+                    _mm_max_epu8(v2, _mm_set1_epi8((char) 0xBE)), v2))));
+    __m128i plane = _mm_and_si128(
+        _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8((char) 0xF0)), v),
+        _mm_cmpeq_epi8(v2, _mm_set1_epi8((char) 0xBF)));
+    stop = _mm_or_si128(stop, _mm_or_si128(c1, _mm_or_si128(noncharacter, plane)));
+    unsigned int mask = (unsigned int) _mm_movemask_epi8(stop);
+    if (mask) {
+      return (c - begin) + lowest_bit(mask);
+    }
+  }
+  return (c - begin) + scan_text_scalar(c, end, stop1, stop2);
+}
+
+static void lines_sse2(
+    const char* begin, const char* end, GumboScanLines* output) {
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i tab = _mm_set1_epi8('\t');
+  // Continuation bytes 0x80-0xBF are exactly the signed bytes below -64.
+  const __m128i lead = _mm_set1_epi8(-64);
+  const char* c = begin;
+  for (; end - c >= 16; c += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) c);
+    lines_block(c, 16, (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)),
+        (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(v, tab)),
+        (unsigned int) _mm_movemask_epi8(_mm_cmplt_epi8(v, lead)), output);
+  }
+  lines_scalar(c, end, output);
+}
+
+// UTF-8 validation after Keiser & Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte" (the lookup algorithm).  Each byte is classified by
+// three 16-entry tables, indexed by the high and low nibble of the previous
+// byte and the high nibble of the byte itself; a bit that survives the AND of
+// all three marks an error in that two-byte window.  Third and fourth bytes of
+// a character are checked separately, against the lead two and three bytes
+// back.  All-ASCII blocks skip the tables.
+#define UTF8_TOO_SHORT (1 << 0)
+#define UTF8_TOO_LONG (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3)
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+static const uint8_t kUtf8Byte1High[16] = {
+    // 0_______: ASCII
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    // 10______: continuation
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    // 1100____, 1101____: two-byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT,
+    // 1110____: three-byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    // 1111____: four-byte lead
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4};
+
+static const uint8_t kUtf8Byte1Low[16] = {
+    // ____0000
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    // ____0001
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    // ____001_
+    UTF8_CARRY, UTF8_CARRY,
+    // ____0100
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    // ____0101, ____011_, ____1___ (except ____1101)
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1101
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000};
+
+static const uint8_t kUtf8Byte2High[16] = {
+    // ________ 0_______: ASCII
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    // ________ 1000____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    // ________ 1001____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE,
+    // ________ 101_____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    // ________ 11______: lead
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT};
+
+// A block ends in the middle of a character if one of its last three bytes is
+// a lead that needs more bytes than are left; subtracting these limits with
+// saturation leaves a non-zero byte exactly then.
+static const uint8_t kUtf8IncompleteLimit[16] = {0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+// Finishes validation after the last clean block: the scalar loop restarts at
+// the character that straddles the block boundary, if any, and pins down the
+// exact position of an error the block check found.
+static const char* valid_utf8_tail(
+    const char* begin, const char* c, const char* end) {
+  return valid_utf8_scalar(char_boundary_before(begin, c), end);
+}
+
+#define UTF8_LOOKUP_SSSE3(table, index)                        \
+  _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (table)), \
+      _mm_and_si128((index), _mm_set1_epi8(0x0F)))
+
+GUMBO_SCAN_SSSE3_TARGET
+static __m128i utf8_block_error_ssse3(__m128i input, __m128i prev_input) {
+  __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+  __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+  __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+  __m128i special = _mm_and_si128(
+      _mm_and_si128(UTF8_LOOKUP_SSSE3(kUtf8Byte1High, _mm_srli_epi16(prev1, 4)),
+          UTF8_LOOKUP_SSSE3(kUtf8Byte1Low, prev1)),
+      UTF8_LOOKUP_SSSE3(kUtf8Byte2High, _mm_srli_epi16(input, 4)));
+  // Bytes that must be the third or fourth byte of a character get 0x80.
+  __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xE0 - 0x80)));
+  __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xF0 - 0x80)));
+  __m128i must_continue = _mm_and_si128(
+      _mm_or_si128(third, fourth), _mm_set1_epi8((char) 0x80));
+  return _mm_xor_si128(must_continue, special);
+}
+
+GUMBO_SCAN_SSSE3_TARGET
+static const char* valid_utf8_ssse3(const char* begin, const char* end) {
+  const __m128i limit = _mm_loadu_si128((const __m128i*) kUtf8IncompleteLimit);
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+  const char* c = begin;
+  for (; end - c >= 16; c += 16) {
+    __m128i input = _mm_loadu_si128((const __m128i*) c);
+    __m128i error = _mm_movemask_epi8(input)
+                        ? utf8_block_error_ssse3(input, prev_input)
+                        : prev_incomplete;
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) !=
+        0xFFFF) {
+      break;
+    }
+    prev_incomplete = _mm_subs_epu8(input, limit);
+    prev_input = input;
+  }
+  return valid_utf8_tail(begin, c, end);
+}
+
+#endif  // GUMBO_SCAN_HAVE_SSE2
+
+#ifdef GUMBO_SCAN_HAVE_AVX2
+
+GUMBO_SCAN_AVX2_TARGET
+static __m256i plain_stop_avx2(__m256i v, __m256i s1, __m256i s2) {
+  const __m256i allowed = _mm256_or_si256(
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+  const __m256i control =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+  __m256i stop = _mm256_andnot_si256(allowed, control);
+  stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F)));
+  stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(v, s1));
+  return _mm256_or_si256(stop, _mm256_cmpeq_epi8(v, s2));
+}
+
+GUMBO_SCAN_AVX2_TARGET
+static size_t scan_plain_avx2(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const __m256i s1 = _mm256_set1_epi8(stop1);
+  const __m256i s2 = _mm256_set1_epi8(stop2);
+  const char* c = begin;
+  for (; end - c >= 32; c += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) c);
+    __m256i stop = _mm256_or_si256(plain_stop_avx2(v, s1, s2),
+        _mm256_cmpgt_epi8(_mm256_setzero_si256(), v));
+    unsigned int mask = (unsigned int) _mm256_movemask_epi8(stop);
+    if (mask) {
+      return (c - begin) + lowest_bit(mask);
+    }
+  }
+  // The tail (under 32 bytes) goes through one SSE2 block and the scalar loop.
+  return (c - begin) + scan_plain_sse2(c, end, stop1, stop2);
+}
+
+GUMBO_SCAN_AVX2_TARGET
+static size_t scan_text_avx2(
+    const char* begin, const char* end, char stop1, char stop2) {
+  const __m256i s1 = _mm256_set1_epi8(stop1);
+  const __m256i s2 = _mm256_set1_epi8(stop2);
+  const char* c = begin;
+  for (; end - c >= 34; c += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) c);
+    __m256i v1 = _mm256_loadu_si256((const __m256i*) (c + 1));
+    __m256i v2 = _mm256_loadu_si256((const __m256i*) (c + 2));
+    __m256i stop = plain_stop_avx2(v, s1, s2);
+    __m256i c1 = _mm256_and_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8((char) 0xC2)),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(v1, _mm256_set1_epi8((char) 0x9F)), v1));
+    __m256i noncharacter = _mm256_and_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8((char) 0xEF)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v1, _mm256_set1_epi8((char) 0xB7)),
+            _mm256_and_si256(_mm256_cmpeq_epi8(v1, _mm256_set1_epi8((char) 0xBF)),
+                _mm256_cmpeq_epi8(
+                    _mm256_max_epu8(v2, _mm256_set1_epi8((char) 0xBE)), v2))));
+    __m256i plane = _mm256_and_si256(
+        _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8((char) 0xF0)), v),
+        _mm256_cmpeq_epi8(v2, _mm256_set1_epi8((char) 0xBF)));
+    stop = _mm256_or_si256(
+        stop, _mm256_or_si256(c1, _mm256_or_si256(noncharacter, plane)));
+    unsigned int mask = (unsigned int) _mm256_movemask_epi8(stop);
+    if (mask) {
+      return (c - begin) + lowest_bit(mask);
+    }
+  }
+  return (c - begin) + scan_text_sse2(c, end, stop1, stop2);
+}
+
+GUMBO_SCAN_AVX2_TARGET
+static void lines_avx2(
+    const char* begin, const char* end, GumboScanLines* output) {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i lead = _mm256_set1_epi8(-64);
+  const char* c = begin;
+  for (; end - c >= 32; c += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) c);
+    lines_block(c, 32,
+        (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)),
+        (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, tab)),
+        (unsigned int) _mm256_movemask_epi8(_mm256_cmpgt_epi8(lead, v)),
+        output);
+  }
+  lines_sse2(c, end, output);
+}
+
+#define UTF8_LOOKUP_AVX2(table, index)                                        \
+  _mm256_shuffle_epi8(                                                        \
+      _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (table))), \
+      _mm256_and_si256((index), _mm256_set1_epi8(0x0F)))
+
+// The bytes n positions back, reaching into the previous block.
+#define UTF8_PREV_AVX2(input, prev_input, n)                                   \
+  _mm256_alignr_epi8((input),                                                  \
+      _mm256_permute2x128_si256((prev_input), (input), 0x21), 16 - (n))
+
+GUMBO_SCAN_AVX2_TARGET
+static __m256i utf8_block_error_avx2(__m256i input, __m256i prev_input) {
+  __m256i prev1 = UTF8_PREV_AVX2(input, prev_input, 1);
+  __m256i prev2 = UTF8_PREV_AVX2(input, prev_input, 2);
+  __m256i prev3 = UTF8_PREV_AVX2(input, prev_input, 3);
+  __m256i special = _mm256_and_si256(
+      _mm256_and_si256(
+          UTF8_LOOKUP_AVX2(kUtf8Byte1High, _mm256_srli_epi16(prev1, 4)),
+          UTF8_LOOKUP_AVX2(kUtf8Byte1Low, prev1)),
+      UTF8_LOOKUP_AVX2(kUtf8Byte2High, _mm256_srli_epi16(input, 4)));
+  __m256i third =
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8((char) (0xE0 - 0x80)));
+  __m256i fourth =
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8((char) (0xF0 - 0x80)));
+  __m256i must_continue = _mm256_and_si256(
+      _mm256_or_si256(third, fourth), _mm256_set1_epi8((char) 0x80));
+  return _mm256_xor_si256(must_continue, special);
+}
+
+GUMBO_SCAN_AVX2_TARGET
+static const char* valid_utf8_avx2(const char* begin, const char* end) {
+  const __m256i limit = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, (char) 0xEF, (char) 0xDF, (char) 0xBF);
+  __m256i prev_input = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+  const char* c = begin;
+  for (; end - c >= 32; c += 32) {
+    __m256i input = _mm256_loadu_si256((const __m256i*) c);
+    __m256i error = _mm256_movemask_epi8(input)
+                        ? utf8_block_error_avx2(input, prev_input)
+                        : prev_incomplete;
+    if (!_mm256_testz_si256(error, error)) {
+      break;
+    }
+    prev_incomplete = _mm256_subs_epu8(input, limit);
+    prev_input = input;
+  }
+  return valid_utf8_tail(begin, c, end);
+}
+
+#endif  // GUMBO_SCAN_HAVE_AVX2
+
+#ifdef GUMBO_SCAN_HAVE_SSE2
+
+static bool cpu_supports(GumboScanMode mode) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  int max_leaf = info[0];
+  __cpuid(info, 1);
+  if (mode != GUMBO_SCAN_AVX2) {
+    return (info[2] & (1 << 9)) != 0;  // SSSE3
+  }
+  // OSXSAVE: the OS saves the YMM registers across context switches.
+  if (max_leaf < 7 || !(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return mode == GUMBO_SCAN_AVX2 ? __builtin_cpu_supports("avx2") != 0
+                                 : __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+#endif  // GUMBO_SCAN_HAVE_SSE2
+
+// Resolved lazily on the first scan.  Concurrent first scans from several
+// threads all store the same values, and a thread that still sees the initial
+// scalar functions merely scans more slowly.
+static GumboScanMode scan_mode = GUMBO_SCAN_AUTO;
+static ScanFunction scan_plain_function = scan_plain_scalar;
+static ScanFunction scan_text_function = scan_text_scalar;
+static ValidateFunction validate_function = valid_utf8_scalar;
+static LinesFunction lines_function = lines_scalar;
+
+bool gumbo_scan_mode_supported(GumboScanMode mode) {
+  switch (mode) {
+    case GUMBO_SCAN_AUTO:
+    case GUMBO_SCAN_OFF:
+    case GUMBO_SCAN_SCALAR:
+      return true;
+    case GUMBO_SCAN_SSE2:
+#ifdef GUMBO_SCAN_HAVE_SSE2
+      return true;
+#else
+      return false;
+#endif
+    case GUMBO_SCAN_AVX2:
+#ifdef GUMBO_SCAN_HAVE_AVX2
+      return cpu_supports(GUMBO_SCAN_AVX2);
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+void gumbo_scan_set_mode(GumboScanMode mode) {
+  if (mode == GUMBO_SCAN_AUTO || !gumbo_scan_mode_supported(mode)) {
+    mode = gumbo_scan_mode_supported(GUMBO_SCAN_AVX2)
+               ? GUMBO_SCAN_AVX2
+               : gumbo_scan_mode_supported(GUMBO_SCAN_SSE2)
+                     ? GUMBO_SCAN_SSE2
+                     : GUMBO_SCAN_SCALAR;
+  }
+  scan_plain_function = scan_plain_scalar;
+  scan_text_function = scan_text_scalar;
+  validate_function = valid_utf8_scalar;
+  lines_function = lines_scalar;
+  switch (mode) {
+#ifdef GUMBO_SCAN_HAVE_AVX2
+    case GUMBO_SCAN_AVX2:
+      scan_plain_function = scan_plain_avx2;
+      scan_text_function = scan_text_avx2;
+      validate_function = valid_utf8_avx2;
+      lines_function = lines_avx2;
+      break;
+#endif
+#ifdef GUMBO_SCAN_HAVE_SSE2
+    case GUMBO_SCAN_SSE2:
+      scan_plain_function = scan_plain_sse2;
+      scan_text_function = scan_text_sse2;
+      if (cpu_supports(GUMBO_SCAN_SSE2)) {
+        validate_function = valid_utf8_ssse3;
+      }
+      lines_function = lines_sse2;
+      break;
+#endif
+    default:
+      break;
+  }
+  scan_mode = mode;
+}
+
+GumboScanMode gumbo_scan_get_mode(void) {
+  if (scan_mode == GUMBO_SCAN_AUTO) {
+    gumbo_scan_set_mode(GUMBO_SCAN_AUTO);
+  }
+  return scan_mode;
+}
+
+const char* gumbo_scan_mode_name(GumboScanMode mode) {
+  switch (mode) {
+    case GUMBO_SCAN_AUTO:
+      return "auto";
+    case GUMBO_SCAN_OFF:
+      return "off";
+    case GUMBO_SCAN_SCALAR:
+      return "scalar";
+    case GUMBO_SCAN_SSE2:
+      return "sse2";
+    case GUMBO_SCAN_AVX2:
+      return "avx2";
+  }
+  return "unknown";
+}
+
+bool gumbo_scan_enabled(void) {
+  return gumbo_scan_get_mode() != GUMBO_SCAN_OFF;
+}
+
+size_t gumbo_scan_plain(
+    const char* begin, const char* end, char stop1, char stop2) {
+  gumbo_scan_get_mode();
+  return scan_plain_function(begin, end, stop1, stop2);
+}
+
+const char* gumbo_scan_valid_utf8(const char* begin, const char* end) {
+  if (!gumbo_scan_enabled()) {
+    return begin;
+  }
+  return validate_function(begin, end);
+}
+
+size_t gumbo_scan_text(
+    const char* begin, const char* end, char stop1, char stop2) {
+  gumbo_scan_get_mode();
+  return scan_text_function(begin, end, stop1, stop2);
+}
+
+void gumbo_scan_lines(
+    const char* begin, const char* end, GumboScanLines* output) {
+  gumbo_scan_get_mode();
+  lines_init(begin, output);
+  lines_function(begin, end, output);
+}
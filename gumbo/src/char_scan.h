@@ -0,0 +1,105 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Bulk scanning of "plain" text runs for the tokenizer fast paths.  The
+// tokenizer normally decodes and dispatches one code point at a time; for long
+// runs of text and attribute values where no state transition can happen, it
+// instead asks for the length of the run up to the next interesting byte and
+// consumes it in one step.  The input is also validated as UTF-8 up front, so
+// the iterator can decode the validated prefix without its DFA and runs can
+// include multi-byte characters.  Everything uses SSE2/SSSE3 or AVX2 where the
+// CPU supports it (chosen once at runtime) and a scalar loop everywhere else.
+
+#ifndef GUMBO_CHAR_SCAN_H_
+#define GUMBO_CHAR_SCAN_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Implementation used by the gumbo_scan_* functions.  GUMBO_SCAN_AUTO picks the
+// widest one the CPU supports; GUMBO_SCAN_OFF disables the fast paths and the
+// up-front validation altogether, so every character is decoded and goes
+// through the state machine as in upstream Gumbo.  GUMBO_SCAN_SSE2 validates
+// UTF-8 with SSSE3 when available and with the scalar loop otherwise.
+typedef enum {
+  GUMBO_SCAN_AUTO,
+  GUMBO_SCAN_OFF,
+  GUMBO_SCAN_SCALAR,
+  GUMBO_SCAN_SSE2,
+  GUMBO_SCAN_AVX2
+} GumboScanMode;
+
+// Selects the scan implementation.  A mode the CPU does not support falls back
+// to the best available one.  This is process-wide and meant for benchmarks and
+// tests; it must not be changed while another thread is parsing.
+void gumbo_scan_set_mode(GumboScanMode mode);
+
+// Returns the implementation currently in use (never GUMBO_SCAN_AUTO).
+GumboScanMode gumbo_scan_get_mode(void);
+
+// Returns the name of a mode, for diagnostics ("off", "scalar", "sse2"...).
+const char* gumbo_scan_mode_name(GumboScanMode mode);
+
+// Returns true if the CPU can run the given mode.
+bool gumbo_scan_mode_supported(GumboScanMode mode);
+
+// Returns true unless the fast paths have been switched off.
+bool gumbo_scan_enabled(void);
+
+// Returns the number of leading plain bytes in [begin, end): printable ASCII
+// (0x20-0x7E) plus '\t' and '\n', excluding stop1 and stop2.  Any other byte -
+// '\r', NUL, the remaining control characters, DEL and every non-ASCII byte -
+// ends the run, so newline normalization, UTF-8 decoding and parse error
+// reporting stay with the per-character path.
+size_t gumbo_scan_plain(
+    const char* begin, const char* end, char stop1, char stop2);
+
+// Returns the start of the first character in [begin, end) that is not
+// well-formed UTF-8 in the sense of RFC 3629 (overlong, surrogate, past
+// U+10FFFF, stray continuation byte or truncated), or end if there is none.
+// Returns begin when the fast paths are off.
+const char* gumbo_scan_valid_utf8(const char* begin, const char* end);
+
+// Like gumbo_scan_plain, but non-ASCII characters are part of the run too.
+// [begin, end) must lie inside a prefix returned by gumbo_scan_valid_utf8 and
+// end on a character boundary.  The run still ends before the code points
+// Gumbo reports as invalid (C1 controls and noncharacters), and before a few
+// rare neighbours of them that are cheaper to leave to the per-character path.
+size_t gumbo_scan_text(
+    const char* begin, const char* end, char stop1, char stop2);
+
+// What it takes to advance a source position over a run accepted by
+// gumbo_scan_plain or gumbo_scan_text.
+typedef struct {
+  // Number of '\n' in the run.
+  size_t newlines;
+  // Start of the last line in the run: just past the last '\n', or begin.
+  const char* line_start;
+  // Number of code points from line_start to the end of the run.
+  size_t line_chars;
+  // Whether the last line contains a tab (its column then depends on the
+  // tab stops, which the caller works out).
+  bool has_tab;
+} GumboScanLines;
+
+void gumbo_scan_lines(
+    const char* begin, const char* end, GumboScanLines* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GUMBO_CHAR_SCAN_H_
@@ -413,6 +413,12 @@ typedef enum {
    * should've been foster-parented, if verbatim mode is set).
    */
   GUMBO_INSERTION_FOSTER_PARENTED = 1 << 10,
+
+  /**
+   * A flag for elements that matched GumboOptions::subtree_filter.  Their
+   * subtrees are the only parts of the document built in full.
+   */
+  GUMBO_INSERTION_SUBTREE_MATCH = 1 << 11,
 } GumboParseFlags;
 
 /**
@@ -554,6 +560,43 @@ typedef void* (*GumboAllocatorFunction)(void* userdata, size_t size);
  */
 typedef void (*GumboDeallocatorFunction)(void* userdata, void* ptr);
 
+/**
+ * Restricts a parse to the subtrees rooted at matching elements, for callers
+ * that only extract data from one container (say, every div.listing) of a
+ * large page.  An element matches if it is in the HTML namespace and every
+ * field that is set matches.
+ *
+ * The tree builder still needs the full stack of open elements, so element
+ * nodes outside the matching subtrees are built as usual; what is skipped is
+ * their text and comment nodes and, where the parser never reads them again,
+ * their attributes.  Inside a matching element (including the element itself)
+ * the tree is identical to an unfiltered parse.  Matching elements carry
+ * GUMBO_INSERTION_SUBTREE_MATCH in their parse_flags.  Nodes that the adoption
+ * agency algorithm later moves across a subtree boundary (misnested formatting
+ * tags) keep whatever they were built with.
+ */
+typedef struct GumboInternalSubtreeFilter {
+  /** The tag to match, or GUMBO_TAG_LAST for any tag. */
+  GumboTag tag;
+
+  /**
+   * A token that must appear in the whitespace-separated class attribute, or
+   * NULL.  Compared case-sensitively.
+   */
+  const char* class_name;
+
+  /** The exact value of the id attribute, or NULL. */
+  const char* id;
+
+  /**
+   * Whether to stop parsing once the first matching element is closed.  The
+   * elements still open at that point are closed as if the input had ended
+   * there.  Only use this when the document has a single container of
+   * interest.
+   */
+  bool stop_after_first;
+} GumboSubtreeFilter;
+
 /**
  * Input struct containing configuration options for the parser.
  * These let you specify alternate memory managers, provide different error
@@ -616,6 +659,14 @@ typedef struct GumboInternalOptions {
    * Default: GUMBO_NAMESPACE_HTML
    */
   GumboNamespaceEnum fragment_namespace;
+
+  /**
+   * If set, only the subtrees rooted at elements matching this filter are
+   * built in full; see GumboSubtreeFilter.  The filter must outlive the call
+   * to gumbo_parse_with_options.
+   * Default: NULL
+   */
+  const GumboSubtreeFilter* subtree_filter;
 } GumboOptions;
 
 /** Default options struct; use this with gumbo_parse_with_options. */
@@ -64,7 +64,7 @@ static void* malloc_wrapper(void* unused, size_t size) { return malloc(size); }
 static void free_wrapper(void* unused, void* ptr) { free(ptr); }
 
 const GumboOptions kGumboDefaultOptions = {&malloc_wrapper, &free_wrapper, NULL,
-    8, false, -1, GUMBO_TAG_LAST, GUMBO_NAMESPACE_HTML};
+    8, false, -1, GUMBO_TAG_LAST, GUMBO_NAMESPACE_HTML, NULL};
 
 static const GumboStringPiece kDoctypeHtml = GUMBO_STRING("html");
 static const GumboStringPiece kPublicIdHtml4_0 =
@@ -402,6 +402,10 @@ typedef struct GumboInternalParserState {
   // flag appropriately.
   bool _closed_body_tag;
   bool _closed_html_tag;
+
+  // Set when a subtree filter with stop_after_first has seen its first match
+  // closed; the main loop stops pulling tokens after the current one.
+  bool _stop_parsing;
 } GumboParserState;
 
 static bool token_has_attribute(const GumboToken* token, const char* name) {
@@ -496,6 +500,7 @@ static void parser_state_init(GumboParser* parser) {
   parser_state->_current_token = NULL;
   parser_state->_closed_body_tag = false;
   parser_state->_closed_html_tag = false;
+  parser_state->_stop_parsing = false;
   parser->_parser_state = parser_state;
 }
 
@@ -885,12 +890,110 @@ static void insert_node(
   }
 }
 
+// Whether nodes appended to parent are kept, i.e. no subtree filter is set or
+// parent is (inside) an element that matched it.
+static bool in_filtered_subtree(
+    const GumboParser* parser, const GumboNode* parent) {
+  if (!parser->_options->subtree_filter) {
+    return true;
+  }
+  for (const GumboNode* node = parent; node; node = node->parent) {
+    if (node->parse_flags & GUMBO_INSERTION_SUBTREE_MATCH) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool is_class_separator(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+// Whether the whitespace-separated list in class_attr contains name.
+static bool class_list_contains(const char* class_attr, const char* name) {
+  size_t name_length = strlen(name);
+  const char* c = class_attr;
+  while (*c) {
+    while (*c && is_class_separator(*c)) {
+      ++c;
+    }
+    const char* start = c;
+    while (*c && !is_class_separator(*c)) {
+      ++c;
+    }
+    if ((size_t)(c - start) == name_length &&
+        memcmp(start, name, name_length) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool matches_subtree_filter(
+    const GumboSubtreeFilter* filter, const GumboNode* node) {
+  const GumboElement* element = &node->v.element;
+  if (element->tag_namespace != GUMBO_NAMESPACE_HTML ||
+      (filter->tag != GUMBO_TAG_LAST && element->tag != filter->tag)) {
+    return false;
+  }
+  if (filter->id) {
+    const GumboAttribute* id = gumbo_get_attribute(&element->attributes, "id");
+    if (!id || strcmp(id->value, filter->id) != 0) {
+      return false;
+    }
+  }
+  if (filter->class_name) {
+    const GumboAttribute* class_attr =
+        gumbo_get_attribute(&element->attributes, "class");
+    if (!class_attr || !class_list_contains(class_attr->value,
+                           filter->class_name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Marks node if it matches the subtree filter.  Otherwise, if it is being
+// inserted outside every matching subtree, its attributes are dropped, except
+// where the tree builder reads them again later: formatting elements are
+// compared and cloned by the active formatting elements list, <html> and
+// <body> get attributes merged into them, and foreign elements are checked for
+// integration points.
+static void apply_subtree_filter(
+    GumboParser* parser, GumboNode* node, const GumboNode* parent) {
+  if (matches_subtree_filter(parser->_options->subtree_filter, node)) {
+    node->parse_flags |= GUMBO_INSERTION_SUBTREE_MATCH;
+    return;
+  }
+  GumboVector* attributes = &node->v.element.attributes;
+  if (attributes->length == 0 || in_filtered_subtree(parser, parent) ||
+      node->v.element.tag_namespace != GUMBO_NAMESPACE_HTML ||
+      node_tag_in_set(node,
+          (gumbo_tagset){TAG(HTML), TAG(BODY), TAG(A), TAG(B), TAG(BIG),
+              TAG(CODE), TAG(EM), TAG(FONT), TAG(I), TAG(NOBR), TAG(S),
+              TAG(SMALL), TAG(STRIKE), TAG(STRONG), TAG(TT), TAG(U)})) {
+    return;
+  }
+  for (unsigned int i = 0; i < attributes->length; ++i) {
+    gumbo_destroy_attribute(parser, attributes->data[i]);
+  }
+  gumbo_parser_deallocate(parser, attributes->data);
+  *attributes = kGumboEmptyVector;
+}
+
 static void maybe_flush_text_node_buffer(GumboParser* parser) {
   GumboParserState* state = parser->_parser_state;
   TextNodeBufferState* buffer_state = &state->_text_node;
   if (buffer_state->_buffer.length == 0) {
     return;
   }
+  if (parser->_options->subtree_filter &&
+      !in_filtered_subtree(parser,
+          get_appropriate_insertion_location(parser, NULL).target)) {
+    gumbo_string_buffer_clear(parser, &buffer_state->_buffer);
+    buffer_state->_type = GUMBO_NODE_WHITESPACE;
+    return;
+  }
 
   assert(buffer_state->_type == GUMBO_NODE_WHITESPACE ||
          buffer_state->_type == GUMBO_NODE_TEXT ||
@@ -958,12 +1061,21 @@ static GumboNode* pop_current_node(GumboParser* parser) {
   if (!is_closed_body_or_html_tag) {
     record_end_of_element(state->_current_token, &current_node->v.element);
   }
+  if ((current_node->parse_flags & GUMBO_INSERTION_SUBTREE_MATCH) &&
+      parser->_options->subtree_filter->stop_after_first &&
+      !in_filtered_subtree(parser, current_node->parent)) {
+    state->_stop_parsing = true;
+  }
   return current_node;
 }
 
 static void append_comment_node(
     GumboParser* parser, GumboNode* node, const GumboToken* token) {
   maybe_flush_text_node_buffer(parser);
+  if (!in_filtered_subtree(parser, node)) {
+    gumbo_parser_deallocate(parser, (void*) token->v.text);
+    return;
+  }
   GumboNode* comment = create_node(parser, GUMBO_NODE_COMMENT);
   comment->type = GUMBO_NODE_COMMENT;
   comment->parse_flags = GUMBO_INSERTION_NORMAL;
@@ -1064,6 +1176,9 @@ static void insert_element(GumboParser* parser, GumboNode* node,
     maybe_flush_text_node_buffer(parser);
   }
   InsertionLocation location = get_appropriate_insertion_location(parser, NULL);
+  if (parser->_options->subtree_filter) {
+    apply_subtree_filter(parser, node, location.target);
+  }
   insert_node(parser, node, location);
   gumbo_vector_add(parser, (void*) node, &state->_open_elements);
 }
@@ -3959,6 +4074,49 @@ static bool handle_in_foreign_content(GumboParser* parser, GumboToken* token) {
 }
 
 // http://www.whatwg.org/specs/web-apps/current-work/multipage/tree-construction.html#tree-construction
+// Text-run fast path.  Once a character or whitespace token has been appended
+// to the pending text node in "in body" or "text" mode, every following plain
+// character would take exactly the same route (the active formatting elements
+// have just been reconstructed, so doing it again is a no-op), so the rest of
+// the run is pulled from the tokenizer and appended in one go instead of one
+// token each.  "text" mode covers the bodies of <script>, <style>, <title> and
+// <textarea>, which the tokenizer would otherwise emit one code point at a
+// time.
+static void append_text_run(GumboParser* parser, const GumboToken* token) {
+  GumboParserState* state = parser->_parser_state;
+  TextNodeBufferState* buffer_state = &state->_text_node;
+  bool in_body = state->_insertion_mode == GUMBO_INSERTION_MODE_IN_BODY;
+  if ((token->type != GUMBO_TOKEN_CHARACTER &&
+          token->type != GUMBO_TOKEN_WHITESPACE) ||
+      state->_reprocess_current_token || state->_ignore_next_linefeed ||
+      (!in_body && state->_insertion_mode != GUMBO_INSERTION_MODE_TEXT) ||
+      buffer_state->_buffer.length == 0) {
+    return;
+  }
+  const GumboNode* current_node = get_adjusted_current_node(parser);
+  if (!current_node ||
+      current_node->v.element.tag_namespace != GUMBO_NAMESPACE_HTML) {
+    return;
+  }
+  GumboStringPiece run;
+  if (!gumbo_lex_text_run(parser, &run)) {
+    return;
+  }
+  if (buffer_state->_type == GUMBO_NODE_WHITESPACE) {
+    for (size_t i = 0; i < run.length; ++i) {
+      char c = run.data[i];
+      if (c != ' ' && c != '\t' && c != '\n') {
+        buffer_state->_type = GUMBO_NODE_TEXT;
+        if (in_body) {
+          set_frameset_not_ok(parser);
+        }
+        break;
+      }
+    }
+  }
+  gumbo_string_buffer_append_string(parser, &run, &buffer_state->_buffer);
+}
+
 static bool handle_token(GumboParser* parser, GumboToken* token) {
   if (parser->_parser_state->_ignore_next_linefeed &&
       token->type == GUMBO_TOKEN_WHITESPACE && token->v.character == '\n') {
@@ -4135,6 +4293,7 @@ GumboOutput* gumbo_parse_with_options(
             token.v.start_tag.is_self_closing);
 
     has_error = !handle_token(&parser, &token) || has_error;
+    append_text_run(&parser, &token);
 
     // Check for memory leaks when ownership is transferred from start tag
     // tokens to nodes.
@@ -4153,8 +4312,13 @@ GumboOutput* gumbo_parse_with_options(
     assert(loop_count < 1000000000);
 
   } while ((token.type != GUMBO_TOKEN_EOF || state->_reprocess_current_token) &&
-           !(options->stop_on_first_error && has_error));
+           !(options->stop_on_first_error && has_error) &&
+           !state->_stop_parsing);
 
+  if (state->_stop_parsing && state->_reprocess_current_token) {
+    // The token was handed back for reprocessing and will never be consumed.
+    gumbo_token_destroy(&parser, &token);
+  }
   finish_parsing(&parser);
   // For API uniformity reasons, if the doctype still has nulls, convert them to
   // empty strings.
@@ -50,6 +50,7 @@
 
 #include "attribute.h"
 #include "char_ref.h"
+#include "char_scan.h"
 #include "error.h"
 #include "gumbo.h"
 #include "parser.h"
@@ -668,6 +669,29 @@ static void append_char_to_tag_buffer(
   gumbo_string_buffer_append_codepoint(parser, codepoint, buffer);
 }
 
+// Fast path for quoted attribute values: appends the current character, then
+// the whole run of plain characters after it up to the closing quote or the
+// next '&', straight to the tag buffer.  The iterator is left on the character
+// that ended the run, which is reconsumed in the same state.
+static void append_attr_value_run(
+    GumboParser* parser, GumboTokenizerState* tokenizer, int c, char quote) {
+  append_char_to_tag_buffer(parser, c, false);
+  if (!gumbo_scan_enabled()) {
+    return;
+  }
+  Utf8Iterator* input = &tokenizer->_input;
+  utf8iterator_next(input);
+  tokenizer->_reconsume_current_input = true;
+  GumboStringPiece run;
+  run.data = utf8iterator_get_char_pointer(input);
+  run.length = utf8iterator_scan_run(input, quote, '&');
+  if (run.length > 0) {
+    gumbo_string_buffer_append_string(
+        parser, &run, &tokenizer->_tag_state._buffer);
+    utf8iterator_skip_plain(input, run.length);
+  }
+}
+
 // (Re-)initialize the tag buffer.  This also resets the original_text pointer
 // and _start_pos field to point to the current position.
 static void initialize_tag_buffer(GumboParser* parser) {
@@ -1791,7 +1815,7 @@ static StateResult handle_attr_value_double_quoted_state(GumboParser* parser,
       tokenizer->_reconsume_current_input = true;
       return NEXT_CHAR;
     default:
-      append_char_to_tag_buffer(parser, c, false);
+      append_attr_value_run(parser, tokenizer, c, '"');
       return NEXT_CHAR;
   }
 }
@@ -1819,7 +1843,7 @@ static StateResult handle_attr_value_single_quoted_state(GumboParser* parser,
       tokenizer->_reconsume_current_input = true;
       return NEXT_CHAR;
     default:
-      append_char_to_tag_buffer(parser, c, false);
+      append_attr_value_run(parser, tokenizer, c, '\'');
       return NEXT_CHAR;
   }
 }
@@ -2866,6 +2890,41 @@ bool gumbo_lex(GumboParser* parser, GumboToken* output) {
   }
 }
 
+bool gumbo_lex_text_run(GumboParser* parser, GumboStringPiece* output) {
+  GumboTokenizerState* tokenizer = parser->_tokenizer_state;
+  if (tokenizer->_buffered_emit_char != kGumboNoChar ||
+      tokenizer->_temporary_buffer_emit || !gumbo_scan_enabled()) {
+    return false;
+  }
+  // Script data and rawtext have no character references, so only '<' ends
+  // the run there.
+  char stop = '&';
+  switch (tokenizer->_state) {
+    case GUMBO_LEX_DATA:
+      if (tokenizer->_is_in_cdata) {
+        return false;
+      }
+      break;
+    case GUMBO_LEX_RCDATA:
+      break;
+    case GUMBO_LEX_RAWTEXT:
+    case GUMBO_LEX_SCRIPT:
+      stop = '<';
+      break;
+    default:
+      return false;
+  }
+  Utf8Iterator* input = &tokenizer->_input;
+  output->data = utf8iterator_get_char_pointer(input);
+  output->length = utf8iterator_scan_run(input, '<', stop);
+  if (output->length == 0) {
+    return false;
+  }
+  utf8iterator_skip_plain(input, output->length);
+  reset_token_start_point(tokenizer);
+  return true;
+}
+
 void gumbo_token_destroy(GumboParser* parser, GumboToken* token) {
   if (!token) return;
 
@@ -106,6 +106,18 @@ void gumbo_tokenizer_set_is_current_node_foreign(
 //   gumbo_tokenizer_state_destroy(&parser);
 bool gumbo_lex(struct GumboInternalParser* parser, GumboToken* output);
 
+// Consumes a run of plain text in the data, RCDATA, RAWTEXT or script data
+// state in one step instead of one character token per code point.  The run
+// ends before the next '<', '&' (data and RCDATA only), or character that
+// needs the per-character path (see utf8iterator_scan_run), and
+// is returned as a piece of the original buffer.  Returns false, consuming
+// nothing, if the tokenizer is not in a state where the run would simply be
+// emitted as character tokens, or if the run is empty.  The parser must only
+// use this where each of those character tokens would be appended to the
+// current text node without further effect.
+bool gumbo_lex_text_run(
+    struct GumboInternalParser* parser, GumboStringPiece* output);
+
 // Frees the internally-allocated pointers within an GumboToken.  Note that this
 // doesn't free the token itself, since oftentimes it will be allocated on the
 // stack.  A simple call to free() (or GumboParser->deallocator, if
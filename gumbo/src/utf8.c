@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "char_scan.h"
 #include "error.h"
 #include "gumbo.h"
 #include "parser.h"
@@ -124,6 +125,33 @@ static void add_error(Utf8Iterator* iter, GumboErrorType type) {
   error->v.codepoint = code_point;
 }
 
+// Sets the current character to a successfully decoded code point whose width
+// has already been stored.
+static void accept_char(Utf8Iterator* iter, uint32_t code_point) {
+  // This is the special handling for carriage returns that is mandated by
+  // the HTML5 spec.  Since we're looking for particular 7-bit literal
+  // characters, we operate in terms of chars and only need a check for iter
+  // overrun, instead of having to read in a full next code point.
+  // http://www.whatwg.org/specs/web-apps/current-work/multipage/parsing.html#preprocessing-the-input-stream
+  if (code_point == '\r') {
+    assert(iter->_width == 1);
+    const char* next = iter->_start + 1;
+    if (next < iter->_end && *next == '\n') {
+      // Advance the iter, as if the carriage return didn't exist.
+      ++iter->_start;
+      // Preserve the true offset, since other tools that look at it may be
+      // unaware of HTML5's rules for converting \r into \n.
+      ++iter->_pos.offset;
+    }
+    code_point = '\n';
+  }
+  if (utf8_is_invalid_code_point(code_point)) {
+    add_error(iter, GUMBO_ERR_UTF8_INVALID);
+    code_point = kUtf8ReplacementChar;
+  }
+  iter->_current = code_point;
+}
+
 // Reads the next UTF-8 character in the iter.
 // This assumes that iter->_start points to the beginning of the character.
 // When this method returns, iter->_width and iter->_current will be set
@@ -136,34 +164,37 @@ static void read_char(Utf8Iterator* iter) {
     return;
   }
 
+  if (iter->_start < iter->_valid_end) {
+    // Validated up front, so the character is complete and well-formed and can
+    // be decoded straight from its lead byte.
+    const unsigned char* c = (const unsigned char*) iter->_start;
+    uint32_t code_point;
+    if (c[0] < 0x80) {
+      code_point = c[0];
+      iter->_width = 1;
+    } else if (c[0] < 0xE0) {
+      code_point = ((c[0] & 0x1Fu) << 6) | (c[1] & 0x3Fu);
+      iter->_width = 2;
+    } else if (c[0] < 0xF0) {
+      code_point =
+          ((c[0] & 0x0Fu) << 12) | ((c[1] & 0x3Fu) << 6) | (c[2] & 0x3Fu);
+      iter->_width = 3;
+    } else {
+      code_point = ((c[0] & 0x07u) << 18) | ((c[1] & 0x3Fu) << 12) |
+                   ((c[2] & 0x3Fu) << 6) | (c[3] & 0x3Fu);
+      iter->_width = 4;
+    }
+    accept_char(iter, code_point);
+    return;
+  }
+
   uint32_t code_point = 0;
   uint32_t state = UTF8_ACCEPT;
   for (const char* c = iter->_start; c < iter->_end; ++c) {
     decode(&state, &code_point, (uint32_t)(unsigned char) (*c));
     if (state == UTF8_ACCEPT) {
       iter->_width = c - iter->_start + 1;
-      // This is the special handling for carriage returns that is mandated by
-      // the HTML5 spec.  Since we're looking for particular 7-bit literal
-      // characters, we operate in terms of chars and only need a check for iter
-      // overrun, instead of having to read in a full next code point.
-      // http://www.whatwg.org/specs/web-apps/current-work/multipage/parsing.html#preprocessing-the-input-stream
-      if (code_point == '\r') {
-        assert(iter->_width == 1);
-        const char* next = c + 1;
-        if (next < iter->_end && *next == '\n') {
-          // Advance the iter, as if the carriage return didn't exist.
-          ++iter->_start;
-          // Preserve the true offset, since other tools that look at it may be
-          // unaware of HTML5's rules for converting \r into \n.
-          ++iter->_pos.offset;
-        }
-        code_point = '\n';
-      }
-      if (utf8_is_invalid_code_point(code_point)) {
-        add_error(iter, GUMBO_ERR_UTF8_INVALID);
-        code_point = kUtf8ReplacementChar;
-      }
-      iter->_current = code_point;
+      accept_char(iter, code_point);
       return;
     } else if (state == UTF8_REJECT) {
       // We don't want to consume the invalid continuation byte of a multi-byte
@@ -213,6 +244,7 @@ void utf8iterator_init(GumboParser* parser, const char* source,
   iter->_pos.column = 1;
   iter->_pos.offset = 0;
   iter->_parser = parser;
+  iter->_valid_end = gumbo_scan_valid_utf8(source, iter->_end);
   read_char(iter);
 }
 
@@ -224,6 +256,45 @@ void utf8iterator_next(Utf8Iterator* iter) {
   read_char(iter);
 }
 
+size_t utf8iterator_scan_run(
+    const Utf8Iterator* iter, char stop1, char stop2) {
+  size_t length = 0;
+  if (iter->_start < iter->_valid_end) {
+    length = gumbo_scan_text(iter->_start, iter->_valid_end, stop1, stop2);
+    if (iter->_start + length < iter->_valid_end) {
+      return length;
+    }
+  }
+  return length +
+         gumbo_scan_plain(iter->_start + length, iter->_end, stop1, stop2);
+}
+
+void utf8iterator_skip_plain(Utf8Iterator* iter, size_t length) {
+  const char* end = iter->_start + length;
+  assert(length > 0 && end <= iter->_end);
+  GumboScanLines lines;
+  gumbo_scan_lines(iter->_start, end, &lines);
+  if (lines.newlines > 0) {
+    iter->_pos.line += lines.newlines;
+    iter->_pos.column = 1;
+  }
+  if (!lines.has_tab) {
+    iter->_pos.column += lines.line_chars;
+  } else {
+    int tab_stop = iter->_parser->_options->tab_stop;
+    for (const char* c = lines.line_start; c < end; ++c) {
+      if (*c == '\t') {
+        iter->_pos.column = ((iter->_pos.column / tab_stop) + 1) * tab_stop;
+      } else if ((*c & 0xC0) != 0x80) {
+        ++iter->_pos.column;
+      }
+    }
+  }
+  iter->_pos.offset += length;
+  iter->_start = end;
+  read_char(iter);
+}
+
 int utf8iterator_current(const Utf8Iterator* iter) { return iter->_current; }
 
 void utf8iterator_get_position(
@@ -58,6 +58,11 @@ typedef struct GumboInternalUtf8Iterator {
   // Points past the end of the iter, like a past-the-end iterator in the STL.
   const char* _end;
 
+  // End of the prefix of the input that was validated as UTF-8 up front (see
+  // gumbo_scan_valid_utf8).  Characters starting before it are decoded
+  // without the DFA and may be skipped in runs.
+  const char* _valid_end;
+
   // The code point under the cursor.
   int _current;
 
@@ -87,6 +92,19 @@ void utf8iterator_init(struct GumboInternalParser* parser, const char* source,
 // Advances the current position by one code point.
 void utf8iterator_next(Utf8Iterator* iter);
 
+// Returns the length in bytes of the run of plain text that starts at the
+// current character and ends before the next stop1, stop2, or character that
+// needs the per-character path: '\r', NUL, other control characters, anything
+// outside the validated prefix that is not ASCII, and invalid code points.
+size_t utf8iterator_scan_run(
+    const Utf8Iterator* iter, char stop1, char stop2);
+
+// Advances past a run of length bytes returned by utf8iterator_scan_run, which
+// needs no decoding and cannot raise a parse error.  Positions are updated as
+// if utf8iterator_next had been called once per code point, but computed for
+// the run as a whole.
+void utf8iterator_skip_plain(Utf8Iterator* iter, size_t length);
+
 // Returns the current code point as an integer.
 int utf8iterator_current(const Utf8Iterator* iter);
 
@@ -23,17 +23,15 @@ MainWindow::MainWindow(QWidget *parent)
     QWebEnginePage *crawlWebPage = createWebEnginePage(); // 给 Crawl 用
     QWebEnginePage *aliCrawlWebPage = createWebEnginePage(); // 给 AliCrawl 用
 
-    // 1. 初始化 Crawl 实例（传入 MainWindow 指针、Web 页面、UI 指针）
-    m_crawl = new Crawl(
-        this,                  // MainWindow 作为 Crawl 的父对象（生命周期绑定）
-        crawlWebPage, // 新建 Web 页面，父对象设为 MainWindow
-        ui                     // 传入 UI 指针（Crawl 用于信号传递，不直接操作）
-        );
-    a_crawl = new AliCrawl(
-        this,
-        aliCrawlWebPage,
-        ui
-        );
+    // 1. 初始化爬虫实例（爬虫核心不依赖界面，日志通过 appendLogSignal 回传）
+    m_crawl = new Crawl(crawlWebPage);
+    a_crawl = new AliCrawl(aliCrawlWebPage);
+
+    // 页面池调度器：多目标房源页由池内页面并发加载，两个爬虫共用一个调度器
+    m_scheduler = new CrawlScheduler(this);
+    connect(m_scheduler, &CrawlScheduler::appendLogSignal, this, &MainWindow::updateLog, Qt::QueuedConnection);
+    m_crawl->setScheduler(m_scheduler);
+    a_crawl->setScheduler(m_scheduler);
 
     //初始化数据库类对象
     mysql=new Mysql();
@@ -397,25 +395,12 @@ void MainWindow::displayMap(){
     webView->load(QUrl::fromLocalFile(htmlPath));
 
 }
-// 辅助工具函数：提取字符串中的纯数字（使用 QRegularExpression，兼容 Qt5/Qt6）
+// 辅助工具函数：提取字符串中的第一个数字（与入库时的数值解析共用 HouseRecord，
+// 不再把所有数字片段拼接起来——“3室2厅”“1,200万”之前会被拼成错误的数）
 double extractPureNumber(const QString &text)
 {
-    // 正则表达式：匹配整数或小数（保留正数，满足房价/面积场景）
-    QRegularExpression regExp("(\\d+(\\.\\d+)?)");
-    QRegularExpressionMatchIterator it = regExp.globalMatch(text); // 全局匹配所有数字片段
-    QString numStr;
-
-    // 提取所有数字片段并拼接
-    while (it.hasNext())
-    {
-        QRegularExpressionMatch match = it.next();
-        numStr += match.captured(1); // 获取第一个捕获组的内容（纯数字）
-    }
-
-    // 转换为数字，失败则返回0
-    bool ok;
-    double num = numStr.toDouble(&ok);
-    return ok ? num : 0.0;
+    double num = 0.0;
+    return HouseRecord::firstNumber(text, num) ? num : 0.0;
 }
 
 void MainWindow::filterTableData()
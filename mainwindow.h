@@ -78,6 +78,7 @@ private:
 
     Crawl* m_crawl;
     AliCrawl* a_crawl;
+    CrawlScheduler* m_scheduler;   // 两个爬虫共用的页面池调度器（多城市/区县并发爬取）
     // 辅助函数：创建独立的 QWebEnginePage（每个爬虫单独用，避免冲突）
     QWebEnginePage* createWebEnginePage();
 
@@ -1,5 +1,5 @@
 #include "preprocessor.h"
-#include <QRegularExpression>
+#include <QStringList>
 #include <QtGlobal>
 #include <cmath>
 
@@ -12,32 +12,42 @@ int Preprocessor::featureDim() const {
 }
 
 QVector<float> Preprocessor::transform(const QVector<QString>& fields) const {
-    QVector<float> feat(featureDim(), 0.0f);
-
     if (fields.size() != 6) {
         // 输入不对就返回全零，避免崩
-        return feat;
+        return QVector<float>(featureDim(), 0.0f);
     }
 
+    HouseRecord r;
+    if (HouseRecord::parsePriceWan(fields[0], r.priceWan)) r.valid |= HouseRecord::Price;
+    if (HouseRecord::parseLayout(fields[1], r.rooms, r.halls)) r.valid |= HouseRecord::Layout;
+    if (HouseRecord::parseUnitPrice(fields[2], r.unitPriceYuan)) r.valid |= HouseRecord::UnitPrice;
+    r.setFloor(fields[3]);
+    if (HouseRecord::parseYear(fields[5], r.buildingYear)) r.valid |= HouseRecord::BuildingYear;
+    r.parsed = true;
+    return transform(r, fields[4]);
+}
+
+QVector<float> Preprocessor::transform(const HouseRecord& record, const QString& orientation) const {
+    QVector<float> feat(featureDim(), 0.0f);
     const int R = cfg_.max_room * cfg_.max_room;
 
     // 0 总价
-    feat[0] = parseWanPriceNorm(fields[0]);
+    feat[0] = priceNorm(record);
 
     // 1..R 户型 one-hot
-    encodeLayoutOneHot(fields[1], feat, 1);
+    encodeLayoutOneHot(record, feat, 1);
 
     // 1+R 每平米价格
-    feat[1 + R] = parseMeterPriceNorm(fields[2]);
+    feat[1 + R] = meterPriceNorm(record);
 
     // 2+R..4+R 楼层低中高 one-hot + 5+R 总层数归一化
-    encodeFloor(fields[3], feat, 2 + R);
+    encodeFloor(record, feat, 2 + R);
 
     // 6+R..13+R 朝向 one-hot
-    encodeOrientationOneHot(fields[4], feat, 6 + R);
+    encodeOrientationOneHot(orientation, feat, 6 + R);
 
     // 14+R 年份归一化
-    feat[14 + R] = parseYearNorm(fields[5]);
+    feat[14 + R] = yearNorm(record);
 
     return feat;
 }
@@ -49,70 +59,48 @@ float Preprocessor::clamp01(float v) {
     return v;
 }
 
-float Preprocessor::parseWanPriceNorm(const QString& s) const {
-    // 支持 "123万" "123.5万" "约123万" 等：提取第一个数字
-    QRegularExpression re(R"(([0-9]+(?:\.[0-9]+)?))");
-    auto m = re.match(s);
-    if (!m.hasMatch() || cfg_.max_prices <= 0.0f) return 0.0f;
-
-    float value = m.captured(1).toFloat(); // 单位：万
-    return clamp01(value / cfg_.max_prices);
+float Preprocessor::priceNorm(const HouseRecord& r) const {
+    if (!r.has(HouseRecord::Price) || cfg_.max_prices <= 0.0f) return 0.0f;
+    return clamp01(float(r.priceWan) / cfg_.max_prices); // 单位：万
 }
 
-void Preprocessor::encodeLayoutOneHot(const QString& s, QVector<float>& out, int offset) const {
-    // 解析 "p室q厅"
+void Preprocessor::encodeLayoutOneHot(const HouseRecord& r, QVector<float>& out, int offset) const {
     // one-hot 维度：max_room^2
     // 索引：(p-1)*max_room + (q-1)
-    if (cfg_.max_room <= 0) return;
-
-    QRegularExpression re(R"((\d+)\s*室\s*(\d+)\s*厅)");
-    auto m = re.match(s);
-    if (!m.hasMatch()) return;
+    if (cfg_.max_room <= 0 || !r.has(HouseRecord::Layout)) return;
 
-    int p = m.captured(1).toInt();
-    int q = m.captured(2).toInt();
+    int p = r.rooms;
+    int q = r.halls;
     if (p < 1 || p > cfg_.max_room || q < 1 || q > cfg_.max_room) return;
 
     int idx = (p - 1) * cfg_.max_room + (q - 1);
-    int R = cfg_.max_room * cfg_.max_room;
-    if (offset + idx >= 0 && offset + idx < offset + R && offset + idx < out.size()) {
+    if (offset + idx < out.size()) {
         out[offset + idx] = 1.0f;
     }
 }
 
-float Preprocessor::parseMeterPriceNorm(const QString& s) const {
-    // 提取第一个数字即可，比如 "12000元/㎡" "12000 元/平" "1.2万/㎡"（如果你数据会出现“万”，需要另加规则）
-    QRegularExpression re(R"(([0-9]+(?:\.[0-9]+)?))");
-    auto m = re.match(s);
-    if (!m.hasMatch() || cfg_.max_meter_price <= 0.0f) return 0.0f;
-
-    float value = m.captured(1).toFloat();
-    return clamp01(value / cfg_.max_meter_price);
+float Preprocessor::meterPriceNorm(const HouseRecord& r) const {
+    // "1.2万/㎡" 这类写法在 HouseRecord::parseUnitPrice 里已换算成元
+    if (!r.has(HouseRecord::UnitPrice) || cfg_.max_meter_price <= 0.0f) return 0.0f;
+    return clamp01(float(r.unitPriceYuan) / cfg_.max_meter_price);
 }
 
-void Preprocessor::encodeFloor(const QString& s, QVector<float>& out, int offset) const {
+void Preprocessor::encodeFloor(const HouseRecord& r, QVector<float>& out, int offset) const {
     // 输出 4 维：
     // offset+0..2: 低/中/高 one-hot
     // offset+3: Y/max_floor
-    // 例如 "低楼层（共18层）"
-    // 兼容中英文括号
-    QString t = s;
-    t.remove(' ');
-
-    // 低/中/高
-    if (t.contains("低")) out[offset + 0] = 1.0f;
-    else if (t.contains("中")) out[offset + 1] = 1.0f;
-    else if (t.contains("高")) out[offset + 2] = 1.0f;
+    switch (r.floorLevel) {
+    case HouseRecord::Level::Low:    out[offset + 0] = 1.0f; break;
+    case HouseRecord::Level::Middle: out[offset + 1] = 1.0f; break;
+    case HouseRecord::Level::High:   out[offset + 2] = 1.0f; break;
+    case HouseRecord::Level::Unknown: break;
+    }
 
-    // 提取 Y
-    QRegularExpression re(R"(共\s*(\d+)\s*层)");
-    auto m = re.match(t);
-    if (!m.hasMatch() || cfg_.max_floor <= 0.0f) {
+    if (!r.has(HouseRecord::TotalFloors) || cfg_.max_floor <= 0.0f) {
         out[offset + 3] = 0.0f;
         return;
     }
-    float Y = m.captured(1).toFloat();
-    out[offset + 3] = clamp01(Y / cfg_.max_floor);
+    out[offset + 3] = clamp01(float(r.totalFloors) / cfg_.max_floor);
 }
 
 void Preprocessor::encodeOrientationOneHot(const QString& s, QVector<float>& out, int offset) const {
@@ -131,14 +119,10 @@ void Preprocessor::encodeOrientationOneHot(const QString& s, QVector<float>& out
     // 未匹配则全 0
 }
 
-float Preprocessor::parseYearNorm(const QString& s) const {
-    QRegularExpression re(R"((\d{4}))");
-    auto m = re.match(s);
-    if (!m.hasMatch()) return 0.0f;
-
-    int year = m.captured(1).toInt();
+float Preprocessor::yearNorm(const HouseRecord& r) const {
+    if (!r.has(HouseRecord::BuildingYear)) return 0.0f;
     if (cfg_.max_year <= cfg_.min_year) return 0.0f;
 
-    float v = float(year - cfg_.min_year) / float(cfg_.max_year - cfg_.min_year);
+    float v = float(r.buildingYear - cfg_.min_year) / float(cfg_.max_year - cfg_.min_year);
     return clamp01(v);
 }
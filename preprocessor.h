@@ -1,6 +1,7 @@
 #pragma once
 #include <QString>
 #include <QVector>
+#include "HouseRecord.h"
 
 /**
  * 输入 6 个字段（按 0 索引顺序）：
@@ -35,19 +36,22 @@ public:
 
     int featureDim() const; // 输出维度
 
-    // 输入必须是长度=6的 QVector<QString>（按你定义顺序）
+    // 输入必须是长度=6的 QVector<QString>（按你定义顺序）；先用 HouseRecord 的解析函数转成数值再编码
     QVector<float> transform(const QVector<QString>& fields) const;
 
+    // 已解析好的房源（爬虫流水线产出的 HouseData::record），不再做字符串解析；朝向仍是文本
+    QVector<float> transform(const HouseRecord& record, const QString& orientation) const;
+
 private:
     Config cfg_;
 
     static float clamp01(float v);
 
-    // 解析工具
-    float parseWanPriceNorm(const QString& s) const;          // "XXX万" -> 0..1
-    void  encodeLayoutOneHot(const QString& s, QVector<float>& out, int offset) const; // "p室q厅"
-    float parseMeterPriceNorm(const QString& s) const;        // 提取数字 -> /max_meter_price
-    void  encodeFloor(const QString& s, QVector<float>& out, int offset) const;        // 低/中/高 + Y/max_floor
+    // 编码工具（输入都是 HouseRecord 里的数值，无效字段编码为0）
+    float priceNorm(const HouseRecord& r) const;              // 万 -> 0..1
+    void  encodeLayoutOneHot(const HouseRecord& r, QVector<float>& out, int offset) const; // p室q厅
+    float meterPriceNorm(const HouseRecord& r) const;         // 元/㎡ -> /max_meter_price
+    void  encodeFloor(const HouseRecord& r, QVector<float>& out, int offset) const;        // 低/中/高 + Y/max_floor
     void  encodeOrientationOneHot(const QString& s, QVector<float>& out, int offset) const; // 8 类
-    float parseYearNorm(const QString& s) const;              // "XXXX年" -> 0..1
+    float yearNorm(const HouseRecord& r) const;               // 年份 -> 0..1
 };
@@ -0,0 +1,103 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "BoundedQueue.h"
+#include "TestCheck.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== 无锁有界队列测试 ===";
+
+    // 测试用例1：容量取整为2的幂，满时拒绝写入，先进先出，空时拒绝读取
+    {
+        BoundedQueue<QString> queue(3);
+        CHECK(queue.capacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            CHECK(queue.tryPush(QString::number(i)));
+        }
+        CHECK(!queue.tryPush(QString("溢出")));
+        CHECK(queue.depth() == 4);
+        QString value;
+        for (int i = 0; i < 4; ++i) {
+            CHECK(queue.tryPop(value) && value == QString::number(i));
+        }
+        CHECK(!queue.tryPop(value));
+        CHECK(queue.depth() == 0);
+        // 绕回一圈后仍然可用
+        for (int round = 0; round < 10; ++round) {
+            CHECK(queue.tryPush(QString::number(round)));
+            CHECK(queue.tryPop(value) && value == QString::number(round));
+        }
+        qDebug() << "测试1 - 满/空/先进先出：容量" << queue.capacity();
+    }
+
+    // 测试用例2：多生产者多消费者，每个元素恰好被取出一次
+    {
+        const int producers = 4;
+        const int consumers = 4;
+        const int perProducer = 200000;
+        const int total = producers * perProducer;
+
+        BoundedQueue<int> queue(256);
+        std::unique_ptr<std::atomic<int>[]> seen(new std::atomic<int>[total]);
+        for (int i = 0; i < total; ++i) seen[i].store(0, std::memory_order_relaxed);
+        std::atomic<int> popped{0};
+        std::atomic<long long> sum{0};
+
+        std::vector<QThread*> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.push_back(QThread::create([&queue, p, perProducer]() {
+                for (int i = 0; i < perProducer; ++i) {
+                    int value = p * perProducer + i;
+                    while (!queue.tryPush(std::move(value))) {
+                        value = p * perProducer + i;
+                        QThread::yieldCurrentThread();
+                    }
+                }
+            }));
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.push_back(QThread::create([&queue, &seen, &popped, &sum, total]() {
+                int value = 0;
+                while (popped.load(std::memory_order_relaxed) < total) {
+                    if (!queue.tryPop(value)) {
+                        QThread::yieldCurrentThread();
+                        continue;
+                    }
+                    seen[value].fetch_add(1, std::memory_order_relaxed);
+                    sum.fetch_add(value, std::memory_order_relaxed);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }));
+        }
+        for (QThread *thread : threads) thread->start();
+        for (QThread *thread : threads) {
+            thread->wait();
+            delete thread;
+        }
+
+        int duplicates = 0;
+        int missing = 0;
+        for (int i = 0; i < total; ++i) {
+            const int count = seen[i].load(std::memory_order_relaxed);
+            if (count == 0) missing++;
+            if (count > 1) duplicates++;
+        }
+        CHECK(popped.load() == total);
+        CHECK(missing == 0);
+        CHECK(duplicates == 0);
+        CHECK(sum.load() == static_cast<long long>(total - 1) * total / 2);
+        int leftover = 0;
+        CHECK(!queue.tryPop(leftover));
+        qDebug() << "测试2 -" << producers << "生产者 /" << consumers << "消费者：取出" << popped.load()
+                 << "，缺失" << missing << "，重复" << duplicates;
+    }
+
+    return testResult();
+}
@@ -0,0 +1,121 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include "ContentFingerprintStore.h"
+#include "TestCheck.h"
+
+using Change = ContentFingerprintStore::Change;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== 内容指纹表测试 ===";
+
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString path = dir.filePath("frontier/anjuke_pages.cfp");
+
+    // 测试用例1：哈希函数——空内容为0，ASCII文本按UTF-16与按UTF-8计算结果一致
+    {
+        CHECK(ContentFingerprintStore::hashText(QString()) == 0);
+        CHECK(ContentFingerprintStore::hashBytes(QByteArray()) == 0);
+        const QString html = "<div class=\"list-item\">500</div>";
+        CHECK(ContentFingerprintStore::hashText(html) == ContentFingerprintStore::hashBytes(html.toUtf8()));
+        CHECK(ContentFingerprintStore::hashText(html) != ContentFingerprintStore::hashText(html + " "));
+        CHECK(ContentFingerprintStore::hashText(QString::fromUtf8("浦东")) != 0);
+        qDebug() << "测试1 - 哈希函数";
+    }
+
+    // 测试用例1b：列表区域哈希——只看第一张卡片到最后一张卡片之后的结束标记，区域外的变化不影响
+    {
+        const QLatin1String card("<div class=\"item\"");
+        const QLatin1String end("<script");
+        const QString page = "<nav>1</nav><div class=\"item\">A</div><div class=\"item\">B</div><script>x=1</script>";
+        const quint64 h = ContentFingerprintStore::hashSlice(page, card, end);
+        CHECK(h == ContentFingerprintStore::hashText(QString("<div class=\"item\">A</div><div class=\"item\">B</div>")));
+        CHECK(h == ContentFingerprintStore::hashSlice(QString(page).replace("<nav>1", "<nav>2").replace("x=1", "x=2"), card, end));
+        CHECK(h != ContentFingerprintStore::hashSlice(QString(page).replace(">B<", ">C<"), card, end));
+        CHECK(ContentFingerprintStore::hashSlice(QString("<div class=\"item\">A"), card, end) != 0);   // 没有结束标记：到末尾
+        CHECK(ContentFingerprintStore::hashSlice(QString("<nav>1</nav>"), card, end) == 0);
+        qDebug() << "测试1b - 列表区域哈希";
+    }
+
+    // 测试用例2：新增/未变化/有变化，compare 只比较不记录
+    {
+        ContentFingerprintStore store;
+        CHECK(store.open(path));
+        CHECK(store.compare(1, 100) == Change::New);
+        CHECK(store.size() == 0);
+        CHECK(store.record(1, 100) == Change::New);
+        CHECK(store.record(1, 100) == Change::Unchanged);
+        CHECK(store.compare(1, 200) == Change::Changed);
+        CHECK(store.lookup(1) == 100 && store.lookup(9) == 0);
+        CHECK(store.record(1, 100) == Change::Unchanged);
+        CHECK(store.record(1, 200) == Change::Changed);
+        CHECK(store.record(2, 300) == Change::New);
+        CHECK(store.size() == 2);
+        qDebug() << "测试2 - 变化判断：条数" << store.size();
+    }
+
+    // 测试用例3：重启后保留最新哈希；写了一半的末尾记录被截掉，之后的追加照常可读
+    {
+        QFile file(path);
+        CHECK(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("12345");
+        file.close();
+    }
+    {
+        ContentFingerprintStore store;
+        CHECK(store.open(path));
+        CHECK(store.size() == 2);
+        CHECK(store.compare(1, 200) == Change::Unchanged);
+        CHECK(store.compare(1, 100) == Change::Changed);
+        CHECK(store.compare(2, 300) == Change::Unchanged);
+        CHECK((QFileInfo(path).size() - 8) % 16 == 0);
+        CHECK(store.record(3, 400) == Change::New);
+    }
+    {
+        ContentFingerprintStore store;
+        CHECK(store.open(path));
+        CHECK(store.size() == 3);
+        CHECK(store.compare(3, 400) == Change::Unchanged);
+        qDebug() << "测试3 - 重启与截断恢复：条数" << store.size();
+    }
+
+    // 测试用例4：过期记录过多时打开即压缩，每个键只留一条
+    {
+        ContentFingerprintStore store;
+        CHECK(store.open(path));
+        for (quint64 hash = 1000; hash < 3000; ++hash) {
+            store.record(1, hash);
+        }
+        CHECK(store.compare(1, 2999) == Change::Unchanged);
+    }
+    {
+        ContentFingerprintStore store;
+        CHECK(store.open(path));
+        CHECK(store.size() == 3);
+        CHECK(store.compare(1, 2999) == Change::Unchanged);
+        CHECK(store.compare(2, 300) == Change::Unchanged);
+        CHECK(QFileInfo(path).size() == 8 + 16 * 3);
+        qDebug() << "测试4 - 压缩：文件" << QFileInfo(path).size() << "字节";
+    }
+
+    // 测试用例5：不是指纹表的文件拒绝打开
+    {
+        const QString other = dir.filePath("other.cfp");
+        QFile file(other);
+        CHECK(file.open(QIODevice::WriteOnly));
+        file.write("NOTASTORE-------");
+        file.close();
+        ContentFingerprintStore store;
+        CHECK(!store.open(other));
+        CHECK(!store.isOpen());
+        qDebug() << "测试5 - 文件头校验";
+    }
+
+    return testResult();
+}
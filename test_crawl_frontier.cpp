@@ -0,0 +1,155 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QTemporaryDir>
+#include "CrawlFrontier.h"
+#include "TestCheck.h"
+
+static QString pageUrl(int i)
+{
+    return QString("https://sh.anjuke.com/sale/p%1/?kw=%2").arg(i).arg(QString::fromUtf8("浦东\t新区"));
+}
+
+static int logLines(const QString& prefix)
+{
+    QFile log(prefix + ".log");
+    if (!log.open(QIODevice::ReadOnly)) return -1;
+    return log.readAll().count('\n');
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== 爬取队列（frontier）测试 ===";
+
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+
+    // 测试用例1：崩溃恢复——在途URL重新排到队首，写了一半的末尾日志被丢弃
+    const QString prefix = dir.filePath("frontier/anjuke_search");
+    {
+        CrawlFrontier frontier;
+        CHECK(frontier.open(prefix));
+        frontier.reset("上海|二手房");
+        CHECK(frontier.enqueue(pageUrl(1), 0, "上海"));
+        CHECK(frontier.enqueue(pageUrl(2), 1, "上海"));
+        CHECK(frontier.enqueue(pageUrl(3), 1, "北京"));
+        CHECK(!frontier.enqueue(pageUrl(1)));
+        CHECK(frontier.takeNext() == pageUrl(1));
+        frontier.markDone(pageUrl(1));
+        CHECK(frontier.takeNext() == pageUrl(2));   // 在途时“崩溃”
+        frontier.close();
+
+        QFile log(prefix + ".log");
+        CHECK(log.open(QIODevice::WriteOnly | QIODevice::Append));
+        log.write("D\thttps://sh.anjuke.com/sale/p3");   // 没有换行：写了一半
+        log.close();
+    }
+    {
+        CrawlFrontier frontier;
+        CHECK(frontier.open(prefix));
+        CHECK(frontier.jobKey() == "上海|二手房");
+        CHECK(frontier.recoveredCount() == 1);
+        CHECK(frontier.isDone(pageUrl(1)));
+        CHECK(frontier.isQueued(pageUrl(2)));
+        CHECK(frontier.isQueued(pageUrl(3)));
+        CHECK(frontier.attempts(pageUrl(2)) == 1);
+        CHECK(frontier.depth(pageUrl(2)) == 1);
+        CHECK(frontier.tag(pageUrl(3)) == "北京");
+        CHECK(frontier.queuedUrls() == QStringList({ pageUrl(2), pageUrl(3) }));
+        CHECK(frontier.doneCount() == 1 && frontier.queuedCount() == 2 && frontier.inFlightCount() == 0);
+        CHECK(logLines(prefix) == 0);   // 打开时已重写快照
+        qDebug() << "测试1 - 崩溃恢复：排队" << frontier.queuedCount() << "，完成" << frontier.doneCount()
+                 << "，恢复" << frontier.recoveredCount();
+
+        // 为测试2准备两条日志记录
+        CHECK(frontier.enqueue(pageUrl(4), 2, "上海"));
+        CHECK(frontier.enqueue(pageUrl(5), 2, "上海"));
+    }
+
+    // 测试用例2：日志末尾记录被截断一部分，之前的记录照常重放
+    {
+        QFile log(prefix + ".log");
+        CHECK(log.size() > 3);
+        CHECK(log.resize(log.size() - 3));
+    }
+    {
+        CrawlFrontier frontier;
+        CHECK(frontier.open(prefix));
+        CHECK(frontier.isQueued(pageUrl(4)));
+        CHECK(!frontier.contains(pageUrl(5)));
+        CHECK(frontier.queuedUrls() == QStringList({ pageUrl(2), pageUrl(3), pageUrl(4) }));
+        qDebug() << "测试2 - 截断日志：排队" << frontier.queuedCount();
+    }
+
+    // 测试用例3：日志超过阈值时压缩为快照，重启后状态与压缩前一致
+    const QString bigPrefix = dir.filePath("frontier/anjuke_house");
+    const int total = CrawlFrontier::COMPACT_THRESHOLD + 100;
+    {
+        CrawlFrontier frontier;
+        CHECK(frontier.open(bigPrefix));
+        frontier.reset("上海|房源");
+        for (int i = 0; i < total; ++i) {
+            CHECK(frontier.enqueue(pageUrl(1000 + i), 2, "上海"));
+        }
+        CHECK(logLines(bigPrefix) < CrawlFrontier::COMPACT_THRESHOLD);
+        CHECK(QFile::exists(bigPrefix + ".snap"));
+        for (int i = 0; i < 10; ++i) {
+            CHECK(frontier.takeNext() == pageUrl(1000 + i));
+            frontier.markDone(pageUrl(1000 + i));
+        }
+        CHECK(frontier.takeNext() == pageUrl(1010));   // 在途
+    }
+    {
+        CrawlFrontier frontier;
+        CHECK(frontier.open(bigPrefix));
+        CHECK(frontier.jobKey() == "上海|房源");
+        CHECK(frontier.doneCount() == 10);
+        CHECK(frontier.queuedCount() == total - 10);
+        CHECK(frontier.recoveredCount() == 1);
+        const QStringList queued = frontier.queuedUrls();
+        CHECK(queued.size() == total - 10);
+        CHECK(!queued.isEmpty() && queued.first() == pageUrl(1010));
+        CHECK(!queued.isEmpty() && queued.last() == pageUrl(1000 + total - 1));
+        qDebug() << "测试3 - 日志压缩后重启：排队" << frontier.queuedCount() << "，完成" << frontier.doneCount();
+    }
+
+    // 测试用例4：超过最大尝试次数后放弃，重启后仍为放弃状态；中断不消耗尝试次数
+    const QString retryPrefix = dir.filePath("frontier/retry");
+    {
+        CrawlFrontier frontier(2);
+        CHECK(frontier.open(retryPrefix));
+        frontier.reset("retry");
+        CHECK(frontier.enqueue(pageUrl(1)));
+        CHECK(frontier.takeNext() == pageUrl(1));
+        CHECK(frontier.markFailed(pageUrl(1), false));
+        CHECK(frontier.attempts(pageUrl(1)) == 0);
+        CHECK(frontier.takeNext() == pageUrl(1));
+        CHECK(frontier.markFailed(pageUrl(1)));
+        CHECK(frontier.takeNext() == pageUrl(1));
+        CHECK(!frontier.markFailed(pageUrl(1)));
+        CHECK(frontier.failedCount() == 1);
+        CHECK(frontier.takeNext().isEmpty());
+    }
+    {
+        CrawlFrontier frontier(2);
+        CHECK(frontier.open(retryPrefix));
+        CHECK(frontier.failedCount() == 1);
+        CHECK(frontier.attempts(pageUrl(1)) == 2);
+        CHECK(!frontier.hasUnfinished());
+        qDebug() << "测试4 - 重试与放弃：放弃" << frontier.failedCount();
+
+        // 新任务清空旧记录
+        frontier.reset("retry-2");
+    }
+    {
+        CrawlFrontier frontier(2);
+        CHECK(frontier.open(retryPrefix));
+        CHECK(frontier.jobKey() == "retry-2");
+        CHECK(!frontier.contains(pageUrl(1)));
+        qDebug() << "测试5 - 重置任务：条目" << frontier.queuedCount() + frontier.doneCount() + frontier.failedCount();
+    }
+
+    return testResult();
+}
@@ -0,0 +1,143 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include "EntityResolver.h"
+#include "TestCheck.h"
+
+using Listing = EntityResolver::Listing;
+using Source = EntityResolver::Source;
+
+static Listing makeListing(quint64 key, Source source, quint32 community, const QString& title)
+{
+    Listing l;
+    l.key = key;
+    l.source = source;
+    l.cityId = 1;
+    l.communityId = community;
+    l.areaSqm = 89.5;
+    l.priceWan = 520;
+    l.rooms = 3;
+    l.halls = 2;
+    l.title = title;
+    return l;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== 跨来源实体识别测试 ===";
+
+    EntityResolver& resolver = EntityResolver::shared();
+    const QString title = QString::fromUtf8("世纪花园 精装三房！南北通透，满五唯一");
+
+    // 测试用例1：add——同小区、面积价格相近、标题相同的并入同一簇；户型不同或不同小区的不并
+    quint32 first = 0;
+    {
+        const int clustersBefore = resolver.clusterCount();
+        const EntityResolver::Match m1 = resolver.add(makeListing(1, Source::Anjuke, 10, title));
+        CHECK(!m1.merged && m1.clusterId > 0);
+        first = m1.clusterId;
+
+        // 同站重复发布：标题只差标点，面积/价格略有出入
+        Listing repost = makeListing(2, Source::Anjuke, 10, QString::fromUtf8("世纪花园精装三房 南北通透 满五唯一"));
+        repost.areaSqm = 89;
+        repost.priceWan = 515;
+        const EntityResolver::Match m2 = resolver.add(repost);
+        CHECK(m2.merged && !m2.crossSource);
+        CHECK(m2.clusterId == first && m2.matchedKey == 1);
+
+        // 另一个来源（拍卖）的同一套房子
+        Listing auction = makeListing(3, Source::Ali, 10, title);
+        auction.priceWan = 480;
+        const EntityResolver::Match m3 = resolver.add(auction);
+        CHECK(m3.merged && m3.crossSource && m3.clusterId == first);
+
+        Listing otherLayout = makeListing(4, Source::Anjuke, 10, title);
+        otherLayout.rooms = 2;
+        CHECK(!resolver.add(otherLayout).merged);
+        Listing otherArea = makeListing(5, Source::Anjuke, 10, title);
+        otherArea.areaSqm = 120;
+        CHECK(!resolver.add(otherArea).merged);
+        CHECK(!resolver.add(makeListing(6, Source::Anjuke, 11, title)).merged);
+
+        // 同一个 key 再加入直接返回已有的簇
+        const EntityResolver::Match again = resolver.add(makeListing(2, Source::Anjuke, 10, title));
+        CHECK(!again.merged && again.clusterId == first);
+        CHECK(resolver.clusterOf(3) == first);
+        CHECK(resolver.clusterOf(4) != first && resolver.clusterOf(4) > 0);
+        CHECK(resolver.clusterOf(999) == 0);
+        CHECK(resolver.clusterCount() - clustersBefore == 4);
+        qDebug() << "测试1 - 增量归并：" << resolver.summary();
+    }
+
+    // 测试用例2：城市、小区的写法差异（“北京市”/“北京”，“XX小区”/“XX”）归一后编号相同
+    {
+        HouseData listed;
+        listed.city = QString::fromUtf8("北京");
+        listed.communityName = QString::fromUtf8("金隅丽港城小区");
+        HouseInfo auctioned;
+        auctioned.city = QString::fromUtf8("北京市");
+        auctioned.communityName = QString::fromUtf8("金隅丽港城");
+        const Listing l1 = EntityResolver::listing(listed);
+        const Listing l2 = EntityResolver::listing(auctioned);
+        CHECK(l1.cityId == l2.cityId && l1.communityId == l2.communityId);
+        CHECK(l1.source == Source::Anjuke && l2.source == Source::Ali);
+        qDebug() << "测试2 - 地名归一";
+    }
+
+    // 测试用例3：restore 按簇编号合并（unite），簇编号取较小的那个，新簇从恢复的最大编号之后分配
+    {
+        const int clustersBefore = resolver.clusterCount();
+        CHECK(resolver.restore(makeListing(101, Source::Anjuke, 20, title), 5000));
+        CHECK(resolver.restore(makeListing(102, Source::Ali, 21, QString::fromUtf8("朝阳区某小区拍卖")), 5000));
+        CHECK(!resolver.restore(makeListing(101, Source::Anjuke, 20, title), 5000));   // 已收录
+        CHECK(!resolver.restore(makeListing(103, Source::Anjuke, 20, title), 0));      // 未识别
+        CHECK(resolver.clusterOf(102) == 5000);
+        CHECK(resolver.clusterCount() - clustersBefore == 1);
+
+        // 新房源先拿到更大的编号，并入后仍是原簇编号
+        const EntityResolver::Match joined = resolver.add(makeListing(104, Source::Anjuke, 20, title));
+        CHECK(joined.merged && joined.clusterId == 5000 && joined.matchedKey == 101);
+        const EntityResolver::Match fresh = resolver.add(makeListing(105, Source::Anjuke, 22, title));
+        CHECK(!fresh.merged && fresh.clusterId > 5000);
+        CHECK(resolver.clusterOf(1) == first);
+        qDebug() << "测试3 - 恢复与合并：" << resolver.summary();
+    }
+
+    // 测试用例4：超过 MAX_LISTINGS 时 compact 丢弃最早的一半；跨越分界的簇由留下的成员继承编号
+    {
+        const quint32 spanning = 9000000;
+        CHECK(resolver.restore(makeListing(201, Source::Anjuke, 30, title), spanning));
+        quint64 key = 1000000;
+        quint32 cluster = 10000000;
+        Listing filler;
+        filler.cityId = 2;
+        while (resolver.listingCount() < EntityResolver::MAX_LISTINGS - 1) {
+            filler.key = key++;
+            resolver.restore(filler, cluster++);
+        }
+        CHECK(resolver.restore(makeListing(202, Source::Ali, 31, title), spanning));
+        CHECK(resolver.listingCount() == EntityResolver::MAX_LISTINGS);
+        CHECK(resolver.clusterOf(201) == spanning && resolver.clusterOf(202) == spanning);
+
+        // 下一次加入触发压缩
+        const EntityResolver::Match trigger = resolver.add(makeListing(203, Source::Anjuke, 32, title));
+        CHECK(!trigger.merged);
+        CHECK(resolver.listingCount() == EntityResolver::MAX_LISTINGS / 2 + 1);
+        CHECK(resolver.clusterOf(1) == 0);            // 最早的房源已丢弃
+        CHECK(resolver.clusterOf(201) == 0);
+        CHECK(resolver.clusterOf(202) == spanning);   // 留下的成员成为新根
+        CHECK(resolver.clusterOf(key - 1) == cluster - 1);
+        CHECK(resolver.clusterCount() == resolver.listingCount());
+
+        // 压缩后按编号恢复的房源仍并入留下的簇，分块索引的下标也已前移
+        const int clustersBefore = resolver.clusterCount();
+        CHECK(resolver.restore(makeListing(204, Source::Anjuke, 33, title), spanning));
+        CHECK(resolver.clusterCount() == clustersBefore);
+        const EntityResolver::Match nearby = resolver.add(makeListing(205, Source::Anjuke, 31, title));
+        CHECK(nearby.merged && nearby.matchedKey == 202 && nearby.clusterId == spanning);
+        qDebug() << "测试4 - 压缩：" << resolver.summary();
+    }
+
+    return testResult();
+}
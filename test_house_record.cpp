@@ -0,0 +1,125 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QtMath>
+#include "HouseData.h"
+#include "HouseRecord.h"
+#include "TestCheck.h"
+
+using Level = HouseRecord::Level;
+
+static bool approx(double a, double b)
+{
+    return qAbs(a - b) < 1e-6;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== 房源数值字段解析测试 ===";
+
+    // 测试用例1：总价——万/亿/元三种单位，千分位，空格，无效文本
+    {
+        double wan = 0;
+        CHECK(HouseRecord::parsePriceWan(u"500万", wan) && approx(wan, 500));
+        CHECK(HouseRecord::parsePriceWan(u"520.5 万", wan) && approx(wan, 520.5));
+        CHECK(HouseRecord::parsePriceWan(u"1.2亿", wan) && approx(wan, 12000));
+        CHECK(HouseRecord::parsePriceWan(u"5,000,000元", wan) && approx(wan, 500));
+        CHECK(HouseRecord::parsePriceWan(u"1,250万", wan) && approx(wan, 1250));
+        CHECK(HouseRecord::parsePriceWan(u"¥844.34万", wan) && approx(wan, 844.34));
+        CHECK(HouseRecord::parsePriceWan(u"300", wan) && approx(wan, 300));   // 无单位按万
+
+        wan = 7;
+        CHECK(!HouseRecord::parsePriceWan(u"未知", wan));
+        CHECK(!HouseRecord::parsePriceWan(u"计算失败", wan));
+        CHECK(!HouseRecord::parsePriceWan(u"0万", wan));
+        CHECK(!HouseRecord::parsePriceWan(u"", wan));
+        CHECK(approx(wan, 7));   // 失败时不改动输出
+        qDebug() << "测试1 - 总价";
+    }
+
+    // 测试用例2：单价——元/㎡、万/㎡、千分位，无效文本
+    {
+        double yuan = 0;
+        CHECK(HouseRecord::parseUnitPrice(u"45000元/㎡", yuan) && approx(yuan, 45000));
+        CHECK(HouseRecord::parseUnitPrice(u"45,000元/㎡", yuan) && approx(yuan, 45000));
+        CHECK(HouseRecord::parseUnitPrice(u"4.5万/㎡", yuan) && approx(yuan, 45000));
+        CHECK(HouseRecord::parseUnitPrice(u"单价 58,321 元/平米", yuan) && approx(yuan, 58321));
+        CHECK(!HouseRecord::parseUnitPrice(u"未知", yuan));
+        CHECK(!HouseRecord::parseUnitPrice(u"计算失败", yuan));
+        qDebug() << "测试2 - 单价";
+    }
+
+    // 测试用例3：千分位只在逗号后紧跟数字时跳过，不拼接后面的另一个数字
+    {
+        double value = 0;
+        qsizetype end = 0;
+        CHECK(HouseRecord::firstNumber(u"约1,234.5㎡", value, &end) && approx(value, 1234.5) && end == 8);
+        CHECK(HouseRecord::firstNumber(u"89, 90", value) && approx(value, 89));
+        CHECK(HouseRecord::firstNumber(u"3室2厅", value) && approx(value, 3));
+        CHECK(!HouseRecord::firstNumber(u"暂无", value));
+        qDebug() << "测试3 - 第一个数字";
+    }
+
+    // 测试用例4：楼层——档位加“共N层”、只有“共N层”、只有“N层”、只有档位，无效文本
+    {
+        Level level = Level::Unknown;
+        int total = 0;
+        CHECK(HouseRecord::parseFloor(u"中楼层(共18层)", level, total) && level == Level::Middle && total == 18);
+        CHECK(HouseRecord::parseFloor(u"低楼层 (共 6 层)", level, total) && level == Level::Low && total == 6);
+        CHECK(HouseRecord::parseFloor(u"高层/共33层", level, total) && level == Level::High && total == 33);
+        CHECK(HouseRecord::parseFloor(u"共7层", level, total) && level == Level::Unknown && total == 7);
+        CHECK(HouseRecord::parseFloor(u"6层", level, total) && level == Level::Unknown && total == 6);
+        CHECK(HouseRecord::parseFloor(u"高楼层", level, total) && level == Level::High && total == 0);
+
+        level = Level::Low;
+        total = 5;
+        CHECK(!HouseRecord::parseFloor(u"未知", level, total));
+        CHECK(!HouseRecord::parseFloor(u"计算失败", level, total));
+        CHECK(!HouseRecord::parseFloor(u"", level, total));
+        CHECK(level == Level::Low && total == 5);
+
+        HouseRecord record;
+        record.setFloor(u"共12层");
+        CHECK(!record.has(HouseRecord::FloorLevel) && record.has(HouseRecord::TotalFloors));
+        CHECK(record.totalFloors == 12);
+        qDebug() << "测试4 - 楼层";
+    }
+
+    // 测试用例5：户型——几室几厅、只有室、无效文本
+    {
+        int rooms = 0;
+        int halls = 0;
+        CHECK(HouseRecord::parseLayout(u"3室2厅", rooms, halls) && rooms == 3 && halls == 2);
+        CHECK(HouseRecord::parseLayout(u"2 室 1 厅 1 卫", rooms, halls) && rooms == 2 && halls == 1);
+        CHECK(HouseRecord::parseLayout(u"1室", rooms, halls) && rooms == 1 && halls == 0);
+        CHECK(!HouseRecord::parseLayout(u"未知", rooms, halls));
+        CHECK(!HouseRecord::parseLayout(u"计算失败", rooms, halls));
+        CHECK(!HouseRecord::parseLayout(u"室厅", rooms, halls));
+        CHECK(rooms == 1 && halls == 0);
+        qDebug() << "测试5 - 户型";
+    }
+
+    // 测试用例6：整条记录——“未知”“计算失败”的字段不置有效位，入库写 -1
+    {
+        HouseData house;
+        house.price = QString::fromUtf8("1.05亿");
+        house.unitPrice = QString::fromUtf8("计算失败");
+        house.area = QString::fromUtf8("1,520.8㎡");
+        house.buildingYear = QString::fromUtf8("未知");
+        house.houseType = QString::fromUtf8("5室3厅");
+        house.floor = QString::fromUtf8("未知");
+
+        const HouseRecord record = HouseRecord::fromHouse(house);
+        CHECK(record.parsed);
+        CHECK(record.has(HouseRecord::Price) && approx(record.priceWan, 10500));
+        CHECK(!record.has(HouseRecord::UnitPrice) && approx(record.unitPriceForDb(), -1));
+        CHECK(record.has(HouseRecord::Area) && approx(record.areaSqm, 1520.8));
+        CHECK(!record.has(HouseRecord::BuildingYear) && record.buildingYearForDb() == -1);
+        CHECK(record.has(HouseRecord::Layout) && record.rooms == 5 && record.halls == 3);
+        CHECK(!record.has(HouseRecord::FloorLevel) && !record.has(HouseRecord::TotalFloors));
+        qDebug() << "测试6 - 整条记录：有效位" << Qt::hex << record.valid;
+    }
+
+    return testResult();
+}
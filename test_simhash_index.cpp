@@ -0,0 +1,130 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include "SimHashIndex.h"
+#include "TestCheck.h"
+
+static HouseData makeHouse(const QString& title, const QString& url)
+{
+    HouseData house;
+    house.houseTitle = title;
+    house.communityName = QString::fromUtf8("世纪花园");
+    house.price = QString::fromUtf8("520万");
+    house.area = QString::fromUtf8("89.5㎡");
+    house.houseType = QString::fromUtf8("3室2厅");
+    house.floor = QString::fromUtf8("中楼层(共18层)");
+    house.houseUrl = url;
+    return house;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== SimHash近重复索引测试 ===";
+
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString path = dir.filePath("frontier/anjuke_simhash.idx");
+
+    // 测试用例1：指纹——与URL无关，标题只比较字母数字且不分大小写，完全不同的房源距离很大
+    {
+        const HouseData first = makeHouse(QString::fromUtf8("近地铁！精装三房，LOFT满五唯一"),
+                                          "https://sh.anjuke.com/prop/view/A1");
+        const HouseData repost = makeHouse(QString::fromUtf8("近地铁 精装三房 loft 满五唯一"),
+                                           "https://sh.anjuke.com/prop/view/A2");
+        HouseData other = makeHouse(QString::fromUtf8("南北通透两房，学区房"), "https://sh.anjuke.com/prop/view/A3");
+        other.communityName = QString::fromUtf8("阳光小区");
+        other.price = QString::fromUtf8("260万");
+        other.area = QString::fromUtf8("56㎡");
+        other.houseType = QString::fromUtf8("2室1厅");
+        other.floor = QString::fromUtf8("高楼层(共6层)");
+
+        const quint64 h1 = SimHashIndex::fingerprint(first);
+        CHECK(h1 != 0);
+        CHECK(h1 == SimHashIndex::fingerprint(repost));
+        CHECK(SimHashIndex::distance(h1, SimHashIndex::fingerprint(other)) > SimHashIndex::MAX_DISTANCE);
+        CHECK(SimHashIndex::fingerprint(HouseData()) == 0);
+        qDebug() << "测试1 - 指纹：与另一套房子的距离" << SimHashIndex::distance(h1, SimHashIndex::fingerprint(other));
+    }
+
+    // 测试用例2：分块查找——距离≤3的指纹能查到（即使只有一段相同），距离4查不到，忽略自身
+    const quint64 base = 0x0123456789abcdefULL;
+    {
+        SimHashIndex index;
+        CHECK(index.open(path));
+        index.insert(1, base);
+        CHECK(index.size() == 1);
+
+        SimHashIndex::Hit hit;
+        const quint64 threeBlocks = base ^ (1ULL << 0) ^ (1ULL << 16) ^ (1ULL << 32);
+        CHECK(index.findNear(threeBlocks, 99, &hit));
+        CHECK(hit.key == 1 && hit.distance == 3);
+        const quint64 fourBlocks = threeBlocks ^ (1ULL << 48);
+        CHECK(!index.findNear(fourBlocks, 99));
+        CHECK(!index.findNear(base ^ 0xfULL, 99));
+        CHECK(!index.findNear(base, 1));       // 自身
+        CHECK(!index.findNear(0, 99));         // 空指纹
+
+        // 取距离最小的一条
+        index.insert(2, base ^ (1ULL << 40));
+        CHECK(index.findNear(base ^ (1ULL << 40) ^ (1ULL << 41), 99, &hit));
+        CHECK(hit.key == 2 && hit.distance == 1);
+
+        // 更新指纹后旧值不再命中
+        index.insert(1, ~base);
+        CHECK(index.size() == 2);
+        CHECK(index.findNear(base, 99, &hit));
+        CHECK(hit.key == 2 && hit.distance == 1);
+        CHECK(index.findNear(~base ^ 1ULL, 99, &hit));
+        CHECK(hit.key == 1 && hit.distance == 1);
+
+        index.insert(3, 0);                    // 空指纹不记录
+        CHECK(index.size() == 2);
+        qDebug() << "测试2 - 分块查找：条数" << index.size();
+    }
+
+    // 测试用例3：重启后恢复；写了一半的末尾记录被截掉
+    {
+        QFile file(path);
+        CHECK(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("1234567");
+        file.close();
+    }
+    {
+        SimHashIndex index;
+        CHECK(index.open(path));
+        CHECK(index.size() == 2);
+        SimHashIndex::Hit hit;
+        CHECK(index.findNear(~base, 99, &hit));
+        CHECK(hit.key == 1 && hit.distance == 0);
+        CHECK(index.findNear(base, 99, &hit));
+        CHECK(hit.key == 2);
+        CHECK((QFileInfo(path).size() - 8) % 16 == 0);
+        qDebug() << "测试3 - 重启与截断恢复：条数" << index.size();
+    }
+
+    // 测试用例4：过期记录过多时打开即压缩
+    {
+        SimHashIndex index;
+        CHECK(index.open(path));
+        for (quint64 i = 1; i <= 2000; ++i) {
+            index.insert(2, base ^ (i << 8));
+        }
+    }
+    {
+        SimHashIndex index;
+        CHECK(index.open(path));
+        CHECK(index.size() == 2);
+        CHECK(QFileInfo(path).size() == 8 + 16 * 2);
+        SimHashIndex::Hit hit;
+        CHECK(index.findNear(base ^ (2000ULL << 8), 99, &hit));
+        CHECK(hit.key == 2 && hit.distance == 0);
+        CHECK(!index.findNear(base ^ (1ULL << 8), 99));   // 旧指纹已被覆盖
+        qDebug() << "测试4 - 压缩：文件" << QFileInfo(path).size() << "字节";
+    }
+
+    return testResult();
+}
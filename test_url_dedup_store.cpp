@@ -0,0 +1,129 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QTemporaryDir>
+#include "UrlDedupStore.h"
+#include "TestCheck.h"
+
+static QString houseUrl(int i)
+{
+    return QString("https://sh.anjuke.com/prop/view/A%1").arg(i);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    qDebug() << "=== URL去重库测试 ===";
+
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString path = dir.filePath("dedup/seen.fps");
+
+    // 测试用例1：新建文件，插入/查询，首次打开可领取一次补齐
+    {
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        CHECK(store.claimSeed());
+        CHECK(!store.claimSeed());
+        CHECK(store.insert(houseUrl(1)));
+        CHECK(!store.insert(houseUrl(1)));
+        CHECK(store.contains(houseUrl(1)));
+        CHECK(!store.contains(houseUrl(2)));
+        CHECK(store.size() == 1);
+        qDebug() << "测试1 - 插入与查询：容量" << store.capacity() << "，条数" << store.size();
+    }
+
+    // 测试用例2：规范化后相同的URL视为同一个（片段、末尾斜杠、跟踪参数、域名大小写）
+    {
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        CHECK(store.insert("https://sh.anjuke.com/sale/123"));
+        CHECK(!store.insert("https://SH.Anjuke.com/sale/123/#top"));
+        CHECK(!store.insert("https://sh.anjuke.com/sale/123?spm=a.b.c&from=list"));
+        CHECK(store.insert("https://sh.anjuke.com/sale/124"));
+        CHECK(UrlDedupStore::fingerprint("https://sh.anjuke.com/sale/123/")
+              == UrlDedupStore::fingerprint("https://sh.anjuke.com/sale/123"));
+        qDebug() << "测试2 - URL规范化去重：条数" << store.size();
+    }
+
+    // 测试用例3：重启后（重新打开已有文件）仍能识别之前见过的URL，且不再要求补齐
+    {
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        CHECK(!store.claimSeed());
+        CHECK(store.size() == 3);
+        CHECK(store.contains(houseUrl(1)));
+        CHECK(!store.insert(houseUrl(1)));
+        CHECK(!store.insert("https://sh.anjuke.com/sale/124"));
+        qDebug() << "测试3 - 重启后去重：条数" << store.size();
+    }
+
+    // 测试用例4：超过装载率触发扩容，扩容前后及重启后所有键都还在
+    const int total = 5000;
+    {
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        const quint64 before = store.capacity();
+        int inserted = 0;
+        for (int i = 100; i < 100 + total; ++i) {
+            if (store.insert(houseUrl(i))) inserted++;
+        }
+        CHECK(inserted == total);
+        CHECK(store.capacity() > before);
+        CHECK(store.size() * 10 <= store.capacity() * 7);
+        int missing = 0;
+        for (int i = 100; i < 100 + total; ++i) {
+            if (!store.contains(houseUrl(i))) missing++;
+        }
+        CHECK(missing == 0);
+        CHECK(store.contains(houseUrl(1)));
+        CHECK(!store.insert(houseUrl(150)));
+        qDebug() << "测试4 - 扩容：容量" << before << "->" << store.capacity() << "，条数" << store.size();
+    }
+    {
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        CHECK(!store.claimSeed());
+        CHECK(store.size() == quint64(total) + 3);
+        int missing = 0;
+        for (int i = 100; i < 100 + total; ++i) {
+            if (!store.contains(houseUrl(i))) missing++;
+        }
+        CHECK(missing == 0);
+        int falseHits = 0;
+        for (int i = 100000; i < 100000 + total; ++i) {
+            if (store.contains(houseUrl(i))) falseHits++;
+        }
+        CHECK(falseHits == 0);
+        qDebug() << "测试5 - 扩容后重启：条数" << store.size() << "，Bloom直接判定" << store.bloomRejects() << "次";
+    }
+
+    // 测试用例6：文件损坏时重建为空表，并重新要求补齐
+    {
+        QFile broken(path);
+        CHECK(broken.open(QIODevice::ReadWrite));
+        broken.write("garbage!");
+        broken.close();
+
+        UrlDedupStore store;
+        CHECK(store.open(path));
+        CHECK(store.claimSeed());
+        CHECK(store.size() == 0);
+        CHECK(!store.contains(houseUrl(1)));
+        qDebug() << "测试6 - 损坏文件重建：条数" << store.size();
+    }
+
+    // 测试用例7：未打开时插入记不下，照常当作新键，但计入未记录数
+    {
+        UrlDedupStore store;
+        CHECK(store.unrecordedCount() == 0);
+        CHECK(store.insert(houseUrl(1)));
+        CHECK(store.insert(houseUrl(1)));
+        CHECK(!store.contains(houseUrl(1)));
+        CHECK(store.unrecordedCount() == 2);
+        qDebug() << "测试7 - 未打开：未记录" << store.unrecordedCount();
+    }
+
+    return testResult();
+}